@@ -124,24 +124,40 @@ void ANetworkController::handleDiscovery(const TerminalCommand &cmd)
         return;
     }
 
-    // Optional timeout argument
+    // Optional range, timeout, rate and ARP fallback
     int timeoutMs = 250;
-    std::string timeoutStr = cmd.getSubcommand();
+    int ratePps = 100;
+    bool arpFallback = false;
+    std::string cidr;
 
-    if (!timeoutStr.empty()) {
-        if (!argTransformer.isValidNumber(timeoutStr)) {
-            terminalView.println("Usage: discovery [timeout_ms]");
-            terminalView.println("Timeout must be a number between 5 and 5000 ms.");
-            return;
-        }
-
-        timeoutMs = argTransformer.parseHexOrDec32(timeoutStr);
+    std::vector<std::string> args;
+    if (!cmd.getSubcommand().empty()) args.push_back(cmd.getSubcommand());
+    for (auto& arg : argTransformer.splitArgs(cmd.getArgs())) {
+        if (!arg.empty()) args.push_back(arg);
+    }
 
-        if (timeoutMs < 5) {
-            timeoutMs = 5;
-        }
-        else if (timeoutMs > 5000) {
-            timeoutMs = 5000;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& argument = args[i];
+        if (argument == "-h" || argument == "--help") {
+            terminalView.println(icmpService.getDiscoveryHelp());
+            return;
+        } else if (argument == "-a") {
+            arpFallback = true;
+        } else if (argument == "-r") {
+            if (++i >= args.size() || !argTransformer.parseInt(args[i], ratePps) || ratePps <= 0) {
+                terminalView.println("Invalid rate value.");
+                return;
+            }
+            if (ratePps > 1000) ratePps = 1000;
+        } else if (argument.find('.') != std::string::npos) {
+            cidr = argument;
+        } else if (argTransformer.isValidNumber(argument)) {
+            timeoutMs = argTransformer.parseHexOrDec32(argument);
+            if (timeoutMs < 5) timeoutMs = 5;
+            else if (timeoutMs > 5000) timeoutMs = 5000;
+        } else {
+            terminalView.println(icmpService.getDiscoveryHelp());
+            return;
         }
     }
 
@@ -151,7 +167,7 @@ void ANetworkController::handleDiscovery(const TerminalCommand &cmd)
             : ethernetService.getLocalIP();
 
     // Start discovery task
-    icmpService.startDiscoveryTask(deviceIP, timeoutMs);
+    icmpService.startDiscoveryTask(deviceIP, timeoutMs, cidr, ratePps, arpFallback);
 
     while (!icmpService.isDiscoveryReady()) {
         // Display logs
@@ -164,25 +180,25 @@ void ANetworkController::handleDiscovery(const TerminalCommand &cmd)
         int terminalKey = terminalInput.readChar();
         if (terminalKey == '\n' || terminalKey == '\r') {
             icmpService.stopICMPService();
-            break;
         }
 
         char deviceKey = deviceInput.readChar();
         if (deviceKey == KEY_OK) {
             icmpService.stopICMPService();
-            break;
         }
 
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 
-    delay(500);
-
     // Flush final logs
     for (auto& line : icmpService.fetchICMPLog()) {
         terminalView.println(line);
     }
 
+    // Host table, partial if stopped
+    terminalView.println("");
+    terminalView.print(icmpService.getReport());
+
     ICMPService::clearICMPLogging();
     icmpService.clearDiscoveryFlag();
 }
@@ -2,9 +2,13 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include <Services/SpiService.h>
 #include "Interfaces/IInput.h"
 #include "Interfaces/ITerminalView.h"
+#include "Analyzers/PatternMatcher.h"
 
 struct BinaryBlockStats {
     float entropy;
@@ -35,23 +39,72 @@ public:
 
     BinaryAnalyzer(ITerminalView& view, IInput& input);
 
+    // Reads run in a task on the other core while this one analyzes. Bit-banged
+    // readers with tight timing pass serialFetch to keep fetch on the caller's core.
     AnalysisResult analyze(
         uint32_t start,
         uint32_t totalSize,
         std::function<void(uint32_t address, uint8_t* buffer, uint32_t size)> fetch,
-        uint32_t blockSize = 512
+        uint32_t blockSize = 512,
+        bool serialFetch = false
     );
     
     std::string formatAnalysis(const AnalysisResult& result);
 private:
     IInput& terminalInput;
     ITerminalView& terminalView;
+    PatternMatcher matcher;
+    uint32_t histogram[4][256];
+
+    // Pattern ids in the matcher, signatures come after the secrets
+    static constexpr uint16_t SIGNATURE_ID_BASE = 0x100;
+    // Signatures must start in the first bytes of a block
+    static constexpr size_t SIGNATURE_WINDOW = 64;
+    // Bytes re-read before each block, secrets may straddle blocks
+    static constexpr uint32_t BLOCK_OVERLAP = 32;
+    // Buffers in flight between the reader task and the analyzer
+    static constexpr uint8_t PIPELINE_SLOTS = 4;
+
+    struct PipelineBlock {
+        uint8_t slot;       // PIPELINE_SLOTS marks the end of the reads
+        uint32_t addr;
+        uint32_t readSize;
+    };
+
+    struct PipelineContext {
+        std::function<void(uint32_t address, uint8_t* buffer, uint32_t size)>* fetch;
+        uint32_t start;
+        uint32_t totalSize;
+        uint32_t blockSize;
+        std::vector<uint8_t> buffers;
+        QueueHandle_t freeSlots;
+        QueueHandle_t filledSlots;
+        volatile bool stop;
+    };
+
+    struct Accumulator {
+        float entropySum = 0;
+        uint32_t printableTotal = 0, nullsTotal = 0, ffTotal = 0, blocks = 0;
+        std::vector<std::string> foundFiles, foundSecrets;
+    };
+
+    static void readerTask(void* arg);
+    static void blockRange(uint32_t addr, uint32_t blockSize, uint32_t& readAddr, uint32_t& readSize);
+    void consumeBlock(const uint8_t* buffer, uint32_t addr, uint32_t readSize, uint32_t blockSize, Accumulator& acc);
+    bool analyzePipelined(uint32_t start, uint32_t totalSize,
+                          std::function<void(uint32_t address, uint8_t* buffer, uint32_t size)>& fetch,
+                          uint32_t blockSize, uint32_t dotInterval, Accumulator& acc);
+    bool userStopped();
 
     BinaryBlockStats analyzeBlock(const uint8_t* buffer, size_t size);
-    const char* detectFileSignature(const uint8_t* buf, size_t size);
-    const char* detectSensitivePattern(const uint8_t* buf, size_t size);
+    void detectPatterns(const uint8_t* buf, size_t size, size_t blockOffset, size_t blockSize,
+                        const char*& signature, const char*& secret) const;
+    void buildMatcher();
     std::vector<std::string> extractPrintableStrings(const uint8_t* buf, size_t size, size_t minLen = 8);
     static const FileSignature knownSignatures[];
     static const size_t knownSignaturesCount;
+    static const char* const sensitivePatterns[];
+    static const char* const sensitiveLabels[];
+    static const size_t sensitivePatternsCount;
 };
 
@@ -0,0 +1,360 @@
+#include "BusAnalyzer.h"
+#include <algorithm>
+
+// Level after edge k of a trace
+static inline bool levelAfter(const BusAnalyzer::Trace& trace, size_t k) {
+    return (k & 1) ? trace.startLevel : !trace.startLevel;
+}
+
+std::vector<BusAnalyzer::Guess> BusAnalyzer::analyze(const std::vector<Trace>& traces, uint32_t ticksPerUs) const {
+    std::vector<Guess> guesses;
+    std::vector<bool> used(traces.size(), false);
+
+    std::vector<ClockInfo> clocks(traces.size());
+    std::vector<size_t> order;
+    for (size_t i = 0; i < traces.size(); ++i) {
+        if (traces[i].edges.size() < MIN_CLOCK_EDGES) continue;
+        clocks[i] = clockInfo(traces[i]);
+        if (clocks[i].regular) order.push_back(i);
+    }
+
+    // Busiest clocks first, a data line never toggles more than its clock
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return traces[a].edges.size() > traces[b].edges.size();
+    });
+
+    for (size_t i : order) {
+        if (used[i]) continue;
+
+        // I2C pairs one data line with the clock
+        Guess best;
+        int bestData = -1;
+        for (size_t j = 0; j < traces.size(); ++j) {
+            if (j == i || used[j] || traces[j].edges.size() < MIN_DATA_EDGES) continue;
+            Guess g;
+            if (detectI2c(traces[i], traces[j], clocks[i], ticksPerUs, g) && g.confidencePct > best.confidencePct) {
+                best = g;
+                bestData = j;
+            }
+        }
+        if (bestData >= 0) {
+            used[i] = used[bestData] = true;
+            guesses.push_back(best);
+            continue;
+        }
+
+        // SPI takes every data line that follows the clock in the same mode
+        Guess spi;
+        for (size_t j = 0; j < traces.size(); ++j) {
+            if (j == i || used[j] || traces[j].edges.size() < MIN_DATA_EDGES) continue;
+            Guess g;
+            if (!detectSpi(traces[i], traces[j], clocks[i], ticksPerUs, g)) continue;
+            if (spi.pins.empty()) {
+                spi = g;
+            } else if (g.spiMode == spi.spiMode) {
+                spi.pins.push_back(traces[j].pin);
+                spi.confidencePct = std::max(spi.confidencePct, g.confidencePct);
+            } else {
+                continue;
+            }
+            used[j] = true;
+        }
+        if (spi.pins.empty()) continue;
+
+        used[i] = true;
+        int cs = findChipSelect(traces, traces[i], used);
+        if (cs >= 0) {
+            used[cs] = true;
+            spi.csPin = traces[cs].pin;
+            spi.confidencePct = std::min(95, spi.confidencePct + 10);
+        }
+        guesses.push_back(spi);
+    }
+
+    // Lone lines left over may be UART
+    for (size_t i = 0; i < traces.size(); ++i) {
+        if (used[i]) continue;
+        Guess g;
+        if (clocks[i].regular && traces[i].edges.size() >= MIN_CLOCK_EDGES) {
+            // A free running clock or PWM fits whole bit times too, UART needs idle gaps
+            Guess probe;
+            if (!detectUart(traces[i], ticksPerUs, probe) || probe.frames < 2) continue;
+            g = probe;
+        } else if (!detectUart(traces[i], ticksPerUs, g)) {
+            continue;
+        }
+        used[i] = true;
+        guesses.push_back(g);
+    }
+
+    std::sort(guesses.begin(), guesses.end(), [](const Guess& a, const Guess& b) {
+        return a.confidencePct > b.confidencePct;
+    });
+    return guesses;
+}
+
+BusAnalyzer::ClockInfo BusAnalyzer::clockInfo(const Trace& trace) const {
+    ClockInfo info;
+
+    std::vector<uint32_t> periods;
+    uint32_t lastRise = 0;
+    bool haveRise = false;
+    for (size_t k = 0; k < trace.edges.size(); ++k) {
+        if (!levelAfter(trace, k)) continue;
+        if (haveRise) periods.push_back(trace.edges[k] - lastRise);
+        lastRise = trace.edges[k];
+        haveRise = true;
+    }
+    if (periods.size() < MIN_CLOCK_EDGES / 2) return info;
+
+    // Gaps between bursts are long, the median of the short periods is the clock
+    uint32_t rough = median(periods);
+    std::vector<uint32_t> inBurst;
+    for (uint32_t p : periods) {
+        if (p <= rough * 2) inBurst.push_back(p);
+    }
+    uint32_t period = median(inBurst);
+    if (period == 0) return info;
+
+    size_t close = 0;
+    for (uint32_t p : inBurst) {
+        if (p * 4 >= period * 3 && p * 4 <= period * 5) ++close;
+    }
+
+    info.periodTicks = period;
+    info.gapTicks = period * 3;
+    info.regular = inBurst.size() >= MIN_CLOCK_EDGES / 2 && close * 4 >= inBurst.size() * 3;
+    return info;
+}
+
+bool BusAnalyzer::detectI2c(const Trace& scl, const Trace& sda, const ClockInfo& clock, uint32_t ticksPerUs, Guess& out) const {
+    // Open drain, both idle high
+    if (!scl.startLevel || !sda.startLevel) return false;
+
+    uint32_t dataMoves = 0;
+    std::vector<std::pair<uint32_t, bool>> conditions;     // time, true for START
+    for (size_t k = 0; k < sda.edges.size(); ++k) {
+        uint32_t t = sda.edges[k];
+        if (hasEdgeAt(scl, t)) continue;
+        if (!levelBefore(scl, t)) ++dataMoves;
+        else conditions.push_back({ t, !levelAfter(sda, k) });
+    }
+
+    uint32_t starts = 0, stops = 0;
+    for (auto& c : conditions) (c.second ? starts : stops)++;
+    if (starts == 0 || dataMoves < MIN_DATA_EDGES || dataMoves < starts) return false;
+
+    // START to the next START or STOP holds 9 clocks per byte, plus the
+    // rise that leaves SCL high for the next condition
+    uint32_t segments = 0, framed = 0;
+    for (size_t c = 0; c + 1 < conditions.size(); ++c) {
+        if (!conditions[c].second) continue;
+        uint32_t from = conditions[c].first;
+        uint32_t to = conditions[c + 1].first;
+        auto it = std::upper_bound(scl.edges.begin(), scl.edges.end(), from);
+        uint32_t rises = 0;
+        for (; it != scl.edges.end() && *it < to; ++it) {
+            if (levelAfter(scl, it - scl.edges.begin())) ++rises;
+        }
+        ++segments;
+        if (rises > 1 && rises % 9 == 1) ++framed;
+    }
+    if (segments && framed * 2 < segments) return false;
+
+    int conf = 55;
+    if (segments) conf += 30 * framed / segments;
+    if (stops) conf += 10;
+
+    out = Guess();
+    out.kind = BusKind::I2c;
+    out.confidencePct = std::min(conf, 95);
+    out.pins = { scl.pin, sda.pin };
+    out.rateHz = (uint32_t)((uint64_t)ticksPerUs * 1000000ULL / clock.periodTicks);
+    out.frames = starts;
+    return true;
+}
+
+bool BusAnalyzer::detectSpi(const Trace& sck, const Trace& data, const ClockInfo& clock, uint32_t ticksPerUs, Guess& out) const {
+    // Which clock edge each data change follows, changes far from any clock edge are between transfers
+    uint32_t follows[2] = { 0, 0 };
+    for (uint32_t t : data.edges) {
+        auto it = std::upper_bound(sck.edges.begin(), sck.edges.end(), t);
+        if (it == sck.edges.begin()) continue;
+        --it;
+        if (t - *it >= clock.periodTicks) continue;
+        follows[levelAfter(sck, it - sck.edges.begin()) ? 1 : 0]++;
+    }
+
+    uint32_t total = follows[0] + follows[1];
+    if (total < MIN_DATA_EDGES) return false;
+    bool onRise = follows[1] > follows[0];
+    uint32_t dominant = onRise ? follows[1] : follows[0];
+    if (dominant * 100 < total * 85) return false;
+
+    // Leading edge leaves the idle level, data moving on it means CPHA=1
+    bool cpol = sck.startLevel;
+    bool leadingRise = !cpol;
+    bool cpha = onRise == leadingRise;
+
+    // Clocks per burst, whole bytes add confidence
+    uint32_t bursts = 0, byteBursts = 0, rises = 0;
+    uint32_t lastRise = 0;
+    for (size_t k = 0; k < sck.edges.size(); ++k) {
+        if (!levelAfter(sck, k)) continue;
+        if (rises && sck.edges[k] - lastRise > clock.gapTicks) {
+            ++bursts;
+            if (rises % 8 == 0) ++byteBursts;
+            rises = 0;
+        }
+        ++rises;
+        lastRise = sck.edges[k];
+    }
+    if (rises) {
+        ++bursts;
+        if (rises % 8 == 0) ++byteBursts;
+    }
+
+    int conf = 45 + (int)(40 * (dominant * 100 / total - 85) / 15);
+    if (bursts && byteBursts * 2 >= bursts) conf += 10;
+
+    out = Guess();
+    out.kind = BusKind::Spi;
+    out.confidencePct = std::min(conf, 90);
+    out.pins = { sck.pin, data.pin };
+    out.spiMode = (cpol ? 2 : 0) | (cpha ? 1 : 0);
+    out.rateHz = (uint32_t)((uint64_t)ticksPerUs * 1000000ULL / clock.periodTicks);
+    out.frames = bursts;
+    return true;
+}
+
+int BusAnalyzer::findChipSelect(const std::vector<Trace>& traces, const Trace& sck, const std::vector<bool>& used) const {
+    int best = -1;
+    size_t bestInside = 0;
+    for (size_t i = 0; i < traces.size(); ++i) {
+        const Trace& cs = traces[i];
+        if (used[i] || cs.pin == sck.pin || cs.edges.size() < 2) continue;
+        if (!cs.startLevel || cs.edges.size() * 4 > sck.edges.size()) continue;
+
+        // Active low around nearly every clock edge
+        size_t inside = 0;
+        for (uint32_t t : sck.edges) {
+            if (!levelBefore(cs, t)) ++inside;
+        }
+        if (inside * 100 >= sck.edges.size() * 95 && inside > bestInside) {
+            best = i;
+            bestInside = inside;
+        }
+    }
+    return best;
+}
+
+bool BusAnalyzer::detectUart(const Trace& line, uint32_t ticksPerUs, Guess& out) const {
+    if (line.edges.size() < MIN_UART_EDGES) return false;
+
+    std::vector<uint32_t> durations;
+    durations.reserve(line.edges.size());
+    for (size_t k = 0; k + 1 < line.edges.size(); ++k) durations.push_back(line.edges[k + 1] - line.edges[k]);
+
+    // Bit time from the shortest pulses, then refined over every pulse inside a frame
+    std::vector<uint32_t> sorted = durations;
+    std::sort(sorted.begin(), sorted.end());
+    size_t shortest = std::max<size_t>(3, sorted.size() / 10);
+    sorted.resize(std::min(shortest, sorted.size()));
+    uint32_t bit = median(sorted);
+    if (bit == 0) return false;
+
+    uint64_t sumTicks = 0, sumBits = 0;
+    for (uint32_t d : durations) {
+        uint32_t n = (d + bit / 2) / bit;
+        if (n >= 1 && n <= 10) {
+            sumTicks += d;
+            sumBits += n;
+        }
+    }
+    if (!sumBits) return false;
+    double bitTicks = (double)sumTicks / (double)sumBits;
+
+    // Active level runs past 9.5 bits are a break or not UART, idle runs past 10.5 bits split frames
+    uint32_t considered = 0, whole = 0, tooLong = 0, gaps = 0;
+    for (size_t k = 0; k < durations.size(); ++k) {
+        double bits = durations[k] / bitTicks;
+        bool idleLevel = levelAfter(line, k) == line.startLevel;
+        if (idleLevel && bits > 10.5) {
+            ++gaps;
+            continue;
+        }
+        if (!idleLevel && bits > 9.5) {
+            ++tooLong;
+            continue;
+        }
+        ++considered;
+        double frac = bits - (uint32_t)(bits + 0.5);
+        if (frac < 0) frac = -frac;
+        if (frac <= 0.2) ++whole;
+    }
+    if (considered < MIN_UART_EDGES - 1 || tooLong * 10 > considered) return false;
+    if (whole * 100 < considered * 85) return false;
+
+    uint32_t baud = (uint32_t)((double)ticksPerUs * 1000000.0 / bitTicks + 0.5);
+    uint32_t snapped = snapBaud(baud);
+    int conf = 40 + (int)(50 * (whole * 100 / considered - 85) / 15);
+    if (snapped != baud) conf += 10;
+
+    out = Guess();
+    out.kind = BusKind::Uart;
+    out.confidencePct = std::min(conf, 90);
+    out.pins = { line.pin };
+    out.rateHz = snapped;
+    out.inverted = !line.startLevel;
+    out.frames = gaps + 1;
+    return true;
+}
+
+bool BusAnalyzer::levelBefore(const Trace& trace, uint32_t t) {
+    size_t before = std::lower_bound(trace.edges.begin(), trace.edges.end(), t) - trace.edges.begin();
+    return (before & 1) ? !trace.startLevel : trace.startLevel;
+}
+
+bool BusAnalyzer::hasEdgeAt(const Trace& trace, uint32_t t) {
+    return std::binary_search(trace.edges.begin(), trace.edges.end(), t);
+}
+
+uint32_t BusAnalyzer::median(std::vector<uint32_t> values) {
+    if (values.empty()) return 0;
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+uint32_t BusAnalyzer::snapBaud(uint32_t baud) {
+    static const uint32_t standard[] = {
+        300, 600, 1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 74880,
+        115200, 230400, 250000, 460800, 500000, 921600, 1000000, 2000000
+    };
+    for (uint32_t s : standard) {
+        uint32_t diff = baud > s ? baud - s : s - baud;
+        if (diff * 100 <= s * 6) return s;
+    }
+    return baud;
+}
+
+std::string BusAnalyzer::format(const Guess& guess) {
+    auto gpio = [](uint8_t pin) { return "GPIO " + std::to_string(pin); };
+    auto khz = [](uint32_t hz) { return std::to_string((hz + 500) / 1000) + " kHz"; };
+    std::string conf = " (" + std::to_string(guess.confidencePct) + "%): ";
+
+    switch (guess.kind) {
+        case BusKind::I2c:
+            return "I2C" + conf + "SCL=" + gpio(guess.pins[0]) + ", SDA=" + gpio(guess.pins[1]) +
+                   ", ~" + khz(guess.rateHz) + ", " + std::to_string(guess.frames) + " START";
+        case BusKind::Spi: {
+            std::string s = "SPI mode " + std::to_string(guess.spiMode) + conf + "SCK=" + gpio(guess.pins[0]) + ", DATA=";
+            for (size_t i = 1; i < guess.pins.size(); ++i) s += (i > 1 ? "/" : "") + std::to_string(guess.pins[i]);
+            if (guess.csPin >= 0) s += ", CS=" + gpio(guess.csPin);
+            return s + ", ~" + khz(guess.rateHz) + ", " + std::to_string(guess.frames) + " bursts";
+        }
+        case BusKind::Uart:
+        default:
+            return "UART" + conf + gpio(guess.pins[0]) + ", ~" + std::to_string(guess.rateHz) + " baud" +
+                   (guess.inverted ? ", inverted" : "") + ", " + std::to_string(guess.frames) + " bursts";
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Looks for buses across pins captured over the same window. Edges are
+// compared in capture ticks, so two lines changing in the same sample are
+// seen as simultaneous:
+//  - I2C: SDA only moves while SCL is low, except for START/STOP with SCL
+//    high, and START..STOP holds a multiple of 9 clocks.
+//  - SPI: data lines change right after one clock edge direction, which
+//    gives CPOL/CPHA, an optional CS stays low around the clock bursts.
+//  - UART: one idle-high (or idle-low) line whose pulses are all close to
+//    a whole number of bit times, the bit time gives the baud rate.
+class BusAnalyzer {
+public:
+    struct Trace {
+        uint8_t pin = 0;
+        bool startLevel = false;
+        std::vector<uint32_t> edges;    // ticks from the window start, ascending
+    };
+
+    enum class BusKind { I2c, Spi, Uart };
+
+    struct Guess {
+        BusKind kind = BusKind::Uart;
+        int confidencePct = 0;
+        std::vector<uint8_t> pins;      // I2C: SCL SDA, SPI: SCK data.. [CS last], UART: line
+        int csPin = -1;
+        uint32_t rateHz = 0;            // bus clock, or baud for UART
+        uint8_t spiMode = 0;
+        bool inverted = false;          // UART idling low
+        uint32_t frames = 0;            // I2C START count, SPI clock bursts, UART bursts between idle gaps
+    };
+
+    std::vector<Guess> analyze(const std::vector<Trace>& traces, uint32_t ticksPerUs) const;
+
+    static std::string format(const Guess& guess);
+
+private:
+    static constexpr size_t MIN_CLOCK_EDGES = 16;
+    static constexpr size_t MIN_DATA_EDGES = 4;
+    static constexpr size_t MIN_UART_EDGES = 12;
+
+    struct ClockInfo {
+        bool regular = false;
+        uint32_t periodTicks = 0;       // median rising to rising inside bursts
+        uint32_t gapTicks = 0;          // longer than this splits bursts
+    };
+
+    ClockInfo clockInfo(const Trace& trace) const;
+    bool detectI2c(const Trace& scl, const Trace& sda, const ClockInfo& clock, uint32_t ticksPerUs, Guess& out) const;
+    bool detectSpi(const Trace& sck, const Trace& data, const ClockInfo& clock, uint32_t ticksPerUs, Guess& out) const;
+    int findChipSelect(const std::vector<Trace>& traces, const Trace& sck, const std::vector<bool>& used) const;
+    bool detectUart(const Trace& line, uint32_t ticksPerUs, Guess& out) const;
+
+    // Level just before t, an edge at exactly t is not applied yet
+    static bool levelBefore(const Trace& trace, uint32_t t);
+    static bool hasEdgeAt(const Trace& trace, uint32_t t);
+    static uint32_t median(std::vector<uint32_t> values);
+    static uint32_t snapBaud(uint32_t baud);
+};
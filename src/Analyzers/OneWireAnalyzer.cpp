@@ -0,0 +1,102 @@
+#include "OneWireAnalyzer.h"
+#include <cstdio>
+
+void OneWireAnalyzer::reset() {
+    afterReset = false;
+    current = 0;
+    bitIndex = 0;
+    firstByte = false;
+}
+
+void OneWireAnalyzer::flush(std::vector<Event>& out) {
+    if (bitIndex > 0) {
+        out.push_back({ EventType::Bits, 0, current, bitIndex, false });
+    }
+    current = 0;
+    bitIndex = 0;
+}
+
+void OneWireAnalyzer::feedLow(uint32_t lowUs, uint32_t highBeforeUs, std::vector<Event>& out) {
+    // Presence must follow the reset pulse closely
+    if (afterReset) {
+        afterReset = false;
+        if (lowUs >= PRESENCE_MIN_US && lowUs <= PRESENCE_MAX_US && highBeforeUs <= PRESENCE_WAIT_MAX_US) {
+            out.push_back({ EventType::Presence, lowUs, 0, 0, false });
+            firstByte = true;
+            return;
+        }
+    }
+
+    if (lowUs >= NON_STANDARD_US) {
+        flush(out);
+        out.push_back({ EventType::NonStandard, lowUs, 0, 0, false });
+        return;
+    }
+
+    if (lowUs >= RESET_MIN_US) {
+        flush(out);
+        out.push_back({ EventType::Reset, lowUs, 0, 0, false });
+        afterReset = true;
+        firstByte = false;
+        return;
+    }
+
+    if (lowUs > BIT_ZERO_MAX_US) {
+        out.push_back({ EventType::Noise, lowUs, 0, 0, false });
+        return;
+    }
+
+    // Time slot, LSB first
+    if (lowUs < BIT_ONE_MAX_US) current |= (1u << bitIndex);
+    if (++bitIndex == 8) {
+        out.push_back({ EventType::Byte, lowUs, current, 8, firstByte });
+        firstByte = false;
+        current = 0;
+        bitIndex = 0;
+    }
+}
+
+const char* OneWireAnalyzer::romCommandName(uint8_t command) {
+    switch (command) {
+        case 0x33: return "Read ROM";
+        case 0x55: return "Match ROM";
+        case 0xCC: return "Skip ROM";
+        case 0xF0: return "Search ROM";
+        case 0xEC: return "Alarm Search";
+        case 0x3C: return "Overdrive Skip ROM";
+        case 0x69: return "Overdrive Match ROM";
+        case 0xA5: return "Resume";
+        default:   return nullptr;
+    }
+}
+
+std::string OneWireAnalyzer::format(const Event& event) {
+    char buf[64];
+
+    switch (event.type) {
+        case EventType::Reset:
+            snprintf(buf, sizeof(buf), "[Reset] LOW for %lu µs", (unsigned long)event.durationUs);
+            return buf;
+        case EventType::Presence:
+            snprintf(buf, sizeof(buf), "[Presence] LOW for %lu µs", (unsigned long)event.durationUs);
+            return buf;
+        case EventType::Byte: {
+            const char* name = event.romCommand ? romCommandName(event.value) : nullptr;
+            if (name) snprintf(buf, sizeof(buf), "[Byte] 0x%02X (%s)", event.value, name);
+            else snprintf(buf, sizeof(buf), "[Byte] 0x%02X", event.value);
+            return buf;
+        }
+        case EventType::Bits: {
+            std::string bits = "[Bits] ";
+            for (uint8_t i = 0; i < event.bitCount; ++i) bits += (event.value >> i) & 1 ? '1' : '0';
+            return bits;
+        }
+        case EventType::NonStandard:
+            snprintf(buf, sizeof(buf), "[Non-Standard Pulse] %lu µs", (unsigned long)event.durationUs);
+            return buf;
+        case EventType::Noise:
+        default:
+            snprintf(buf, sizeof(buf), "[Noise] LOW for %lu µs", (unsigned long)event.durationUs);
+            return buf;
+    }
+}
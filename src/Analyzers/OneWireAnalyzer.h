@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Decodes 1-Wire traffic from LOW pulse durations, so it can run on edges
+// captured earlier instead of sampling the line live. Slots are classified
+// by their LOW time only: a master write-1 or a slave read-1 releases the
+// line before ~15 us, a 0 holds it for 60 us or more.
+class OneWireAnalyzer {
+public:
+    enum class EventType { Reset, Presence, Byte, Bits, NonStandard, Noise };
+
+    struct Event {
+        EventType type;
+        uint32_t durationUs;    // LOW time, reset/presence/noise
+        uint8_t value;          // byte or partial bits, LSB first
+        uint8_t bitCount;       // 8 for a byte
+        bool romCommand;        // first byte after a presence
+    };
+
+    // Feed one LOW pulse and the HIGH time before it, events are appended to out
+    void feedLow(uint32_t lowUs, uint32_t highBeforeUs, std::vector<Event>& out);
+
+    // Line went idle, emit the partial byte if any
+    void flush(std::vector<Event>& out);
+
+    void reset();
+
+    static std::string format(const Event& event);
+    static const char* romCommandName(uint8_t command);
+
+private:
+    static constexpr uint32_t RESET_MIN_US = 480;
+    static constexpr uint32_t NON_STANDARD_US = 3000;
+    static constexpr uint32_t PRESENCE_MIN_US = 60;
+    static constexpr uint32_t PRESENCE_MAX_US = 240;
+    static constexpr uint32_t PRESENCE_WAIT_MAX_US = 70;     // device waits 15..60 us after reset
+    static constexpr uint32_t BIT_ONE_MAX_US = 15;
+    static constexpr uint32_t BIT_ZERO_MAX_US = 120;
+
+    bool afterReset = false;
+    uint8_t current = 0;
+    uint8_t bitIndex = 0;
+    bool firstByte = false;     // the byte after a presence is a ROM command
+};
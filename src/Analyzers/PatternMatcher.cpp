@@ -0,0 +1,94 @@
+#include "PatternMatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+void PatternMatcher::addPattern(uint16_t id, const uint8_t* pattern, size_t length, bool caseSensitive) {
+    if (length == 0) return;
+    patterns.push_back({id, bytes.size(), length, caseSensitive});
+    bytes.insert(bytes.end(), pattern, pattern + length);
+    built = false;
+}
+
+void PatternMatcher::build() {
+    states.clear();
+    outputs.clear();
+    states.emplace_back();
+
+    // Trie of case folded patterns
+    for (uint16_t p = 0; p < patterns.size(); ++p) {
+        uint16_t state = 0;
+        for (size_t k = 0; k < patterns[p].length; ++k) {
+            uint8_t symbol = fold(bytes[patterns[p].offset + k]);
+            int16_t target = findEdge(state, symbol);
+            if (target < 0) {
+                target = (int16_t)states.size();
+                states.emplace_back();
+                auto& edges = states[state].edges;
+                Edge edge{symbol, (uint16_t)target};
+                edges.insert(std::upper_bound(edges.begin(), edges.end(), edge,
+                    [](const Edge& a, const Edge& b) { return a.symbol < b.symbol; }), edge);
+            }
+            state = (uint16_t)target;
+        }
+        outputs.push_back({p, states[state].output});
+        states[state].output = (uint16_t)(outputs.size() - 1);
+    }
+
+    // Dense root row, missing symbols loop on the root
+    for (int c = 0; c < 256; ++c) {
+        int16_t target = findEdge(0, (uint8_t)c);
+        rootNext[c] = target < 0 ? 0 : (uint16_t)target;
+    }
+
+    // Failure links in BFS order, outputs of the fail state are chained
+    std::deque<uint16_t> queue;
+    for (const auto& e : states[0].edges) {
+        states[e.target].fail = 0;
+        queue.push_back(e.target);
+    }
+    while (!queue.empty()) {
+        uint16_t s = queue.front();
+        queue.pop_front();
+        for (const auto& e : states[s].edges) {
+            uint16_t f = next(states[s].fail, e.symbol);
+            states[e.target].fail = f;
+
+            // Append the fail state output list
+            uint16_t inherited = states[f].output;
+            if (inherited != NO_OUTPUT) {
+                uint16_t out = states[e.target].output;
+                if (out == NO_OUTPUT) {
+                    states[e.target].output = inherited;
+                } else {
+                    while (outputs[out].next != NO_OUTPUT) out = outputs[out].next;
+                    outputs[out].next = inherited;
+                }
+            }
+            queue.push_back(e.target);
+        }
+    }
+
+    built = true;
+}
+
+int16_t PatternMatcher::findEdge(uint16_t state, uint8_t symbol) const {
+    const auto& edges = states[state].edges;
+    auto it = std::lower_bound(edges.begin(), edges.end(), symbol,
+        [](const Edge& e, uint8_t s) { return e.symbol < s; });
+    if (it != edges.end() && it->symbol == symbol) return (int16_t)it->target;
+    return -1;
+}
+
+uint16_t PatternMatcher::next(uint16_t state, uint8_t symbol) const {
+    while (state != 0) {
+        int16_t target = findEdge(state, symbol);
+        if (target >= 0) return (uint16_t)target;
+        state = states[state].fail;
+    }
+    return rootNext[symbol];
+}
+
+bool PatternMatcher::equals(const uint8_t* buf, const Pattern& p) const {
+    return memcmp(buf, bytes.data() + p.offset, p.length) == 0;
+}
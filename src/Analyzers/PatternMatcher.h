@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+Aho-Corasick multi pattern matcher.
+Patterns are matched case insensitive in a single pass, case sensitive
+patterns are verified on the original bytes once the automaton hits.
+*/
+class PatternMatcher {
+public:
+    struct Match {
+        uint16_t id;       // pattern id given to addPattern
+        uint32_t position; // offset of the first byte in the buffer
+    };
+
+    // Register a pattern, call build() once all are added
+    void addPattern(uint16_t id, const uint8_t* pattern, size_t length, bool caseSensitive);
+    void build();
+    bool isBuilt() const { return built; }
+
+    // Call onMatch for each hit, stop scanning if it returns false
+    template <typename Callback>
+    void scan(const uint8_t* buf, size_t size, Callback onMatch) const {
+        uint16_t state = 0;
+        for (size_t i = 0; i < size; ++i) {
+            state = next(state, fold(buf[i]));
+            for (uint16_t out = states[state].output; out != NO_OUTPUT; out = outputs[out].next) {
+                const Pattern& p = patterns[outputs[out].pattern];
+                uint32_t pos = (uint32_t)(i + 1 - p.length);
+                if (p.caseSensitive && !equals(buf + pos, p)) continue;
+                if (!onMatch(Match{p.id, pos})) return;
+            }
+        }
+    }
+
+private:
+    static constexpr uint16_t NO_OUTPUT = 0xFFFF;
+
+    struct Edge {
+        uint8_t symbol;
+        uint16_t target;
+    };
+
+    struct State {
+        std::vector<Edge> edges;   // sorted by symbol
+        uint16_t fail = 0;
+        uint16_t output = NO_OUTPUT;
+    };
+
+    struct Pattern {
+        uint16_t id;
+        size_t offset;             // in bytes
+        size_t length;
+        bool caseSensitive;
+    };
+
+    struct Output {
+        uint16_t pattern;
+        uint16_t next;
+    };
+
+    std::vector<State> states;
+    std::vector<Pattern> patterns;
+    std::vector<Output> outputs;
+    std::vector<uint8_t> bytes;    // raw pattern storage
+    uint16_t rootNext[256];        // dense transitions out of the root
+    bool built = false;
+
+    static uint8_t fold(uint8_t c) { return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+    int16_t findEdge(uint16_t state, uint8_t symbol) const;
+    uint16_t next(uint16_t state, uint8_t symbol) const;
+    bool equals(const uint8_t* buf, const Pattern& p) const;
+};
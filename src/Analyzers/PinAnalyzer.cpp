@@ -6,39 +6,11 @@
 PinAnalyzer::PinAnalyzer(PinService& pinService)
 : pinService(pinService) {}
 
-void PinAnalyzer::begin(uint8_t pin_) {
+void PinAnalyzer::begin() {
     end(); // clean up if rebeginning
     pulseRing = new uint32_t[PULSE_RING];
     riseUs    = new uint32_t[RISE_RING];
-
-    pin = pin_;
-    pinService.setInput(pin);
-
-    lastLevel = pinService.read(pin);
-    startLevel = lastLevel;
-
-    windowStartMs = millis();
-    lastChangeUs = micros();
-
-    edges = 0;
-    highUs = 0;
-    lowUs  = 0;
-    minPulseUs = 0xFFFFFFFF;
-    maxPulseUs = 0;
-    basePulseUs = 0;
-
-    bursts = 0;
-    burstEdges = 0;
-    maxGapUs = 0;
-    inBurst = false;
-
-    pulseCount = 0;
-    pulseHead = 0;
-
-    riseCount = 0;
-    riseHead = 0;
-    lastRiseUs = 0;
-    lastHighPulseUs = 0;
+    resetCounters(false);
 }
 
 void PinAnalyzer::end() {
@@ -53,18 +25,9 @@ void PinAnalyzer::end() {
     }
 }
 
-bool PinAnalyzer::shouldReport(unsigned long nowMs) const {
-    return (nowMs - windowStartMs) >= ANALYZE_DURATION_MS;
-}
-
-void PinAnalyzer::sample() {
-    bool v = pinService.read(pin);
-    if (v == lastLevel) return;
-    onEdge(v, micros());
-}
-
 void PinAnalyzer::onEdge(bool newLevel, uint32_t nowUs) {
     uint32_t dt = nowUs - lastChangeUs;
+    if (edgeListener) edgeListener(lastLevel, dt);
 
     // Accumulate time spent in last level
     if (lastLevel) highUs += dt;
@@ -115,16 +78,21 @@ void PinAnalyzer::closeTail(uint32_t nowUs) {
     uint32_t dt = nowUs - lastChangeUs;
     if (lastLevel) highUs += dt;
     else           lowUs  += dt;
+    if (edgeListener) edgeListener(lastLevel, dt);
 
     // Don’t push tail into pulse ring
     lastChangeUs = nowUs;
 }
 
-void PinAnalyzer::resetWindow() {
-    // Start a fresh window from current state
-    windowStartMs = millis();
-    lastChangeUs = micros();
-    startLevel = lastLevel;
+void PinAnalyzer::setEdgeListener(std::function<void(bool, uint32_t)> listener) {
+    edgeListener = std::move(listener);
+}
+
+void PinAnalyzer::resetCounters(bool level) {
+    // Start a fresh window from the given level
+    lastLevel = level;
+    startLevel = level;
+    lastChangeUs = 0;
 
     edges = 0;
     highUs = 0;
@@ -147,6 +115,24 @@ void PinAnalyzer::resetWindow() {
     lastHighPulseUs = 0;
 }
 
+PinAnalyzer::Report PinAnalyzer::analyzeEdges(uint8_t pin_, bool level, const std::vector<uint32_t>& edgeTicks,
+                                              uint32_t ticksPerUs, uint32_t windowTicks, bool doPullTest) {
+    if (!pulseRing || !riseUs) begin();
+    if (ticksPerUs == 0) ticksPerUs = 1;
+
+    pin = pin_;
+    resetCounters(level);
+
+    // Same accumulators as live sampling, replayed from the capture
+    for (uint32_t t : edgeTicks) {
+        onEdge(!lastLevel, t / ticksPerUs);
+    }
+
+    uint32_t windowUs = windowTicks / ticksPerUs;
+    closeTail(windowUs);
+    return makeReport(windowUs, doPullTest);
+}
+
 void PinAnalyzer::collectPulses(std::vector<uint32_t>& out) const {
     out.clear();
     out.reserve(pulseCount);
@@ -456,16 +442,12 @@ std::string PinAnalyzer::runPullTest() {
     return "";
 }
 
-PinAnalyzer::Report PinAnalyzer::buildReport(bool doPullTest) {
+PinAnalyzer::Report PinAnalyzer::makeReport(uint32_t elapsedUs, bool doPullTest) {
     Report r;
 
-    // Close tail to include the last stable segment time in high/low
-    closeTail(micros());
-
-    uint32_t elapsedMs = (uint32_t)(millis() - windowStartMs);
-    if (elapsedMs == 0) elapsedMs = 1;
+    if (elapsedUs == 0) elapsedUs = 1;
     r.edges = edges; // raw count
-    r.edgesPerSec = (uint32_t)((uint64_t)edges * 1000ULL / elapsedMs);
+    r.edgesPerSec = (uint32_t)((uint64_t)edges * 1000000ULL / elapsedUs);
     r.highUs = highUs;
     r.lowUs  = lowUs;
     r.minPulseUs = minPulseUs;
@@ -477,7 +459,7 @@ PinAnalyzer::Report PinAnalyzer::buildReport(bool doPullTest) {
     uint32_t totalUs = highUs + lowUs;
     r.dutyPct = (totalUs ? (100.0f * (float)highUs) / (float)totalUs : 0.f);
 
-    float seconds = elapsedMs / 1000.0f;
+    float seconds = elapsedUs / 1000000.0f;
     r.approxHz = (seconds > 0.f) ? ((edges / 2.0f) / seconds) : 0.f;
 
 
@@ -642,3 +624,16 @@ std::string PinAnalyzer::formatWizardReport(uint8_t pin, const Report& r) const
     oss << "\r\n";
     return oss.str();
 }
+
+std::string PinAnalyzer::formatSummary(uint8_t pin, const Report& r) const {
+    std::string label = "GPIO " + std::to_string(pin);
+    if (label.size() < 9) label.append(9 - label.size(), ' ');
+
+    std::string s = label + kindToStr(r.top1.kind) + " (" + std::to_string(r.top1.confidencePct) + "%)";
+    int hzInt = (int)(r.approxHz + 0.5f);
+    int dutyInt = clampInt((int)(r.dutyPct + 0.5f), 0, 100);
+    s += " ~" + std::to_string(hzInt) + " Hz, " + std::to_string(dutyInt) + "% HIGH";
+    if (!r.top1.extra.empty()) s += " [" + r.top1.extra + "]";
+    if (r.bursts >= 2) s += ", " + std::to_string(r.bursts) + " bursts";
+    return s;
+}
@@ -56,21 +56,25 @@ public:
 public:
     explicit PinAnalyzer(PinService& pinService);
 
-    void begin(uint8_t pin);
+    void begin();
     void end();
-    void sample(); 
-    bool shouldReport(unsigned long nowMs) const; 
-    Report buildReport(bool doPullTest);
+
+    // Batch pass over one pin of a shared capture, edges are ticks from the window start
+    Report analyzeEdges(uint8_t pin, bool startLevel, const std::vector<uint32_t>& edgeTicks,
+                        uint32_t ticksPerUs, uint32_t windowTicks, bool doPullTest = false);
     std::string formatWizardReport(uint8_t pin, const Report& r) const;
-    void resetWindow();
+
+    // One line per pin for the multi-pin wizard
+    std::string formatSummary(uint8_t pin, const Report& r) const;
+
+    // Called with the level that just ended and how long it lasted
+    void setEdgeListener(std::function<void(bool, uint32_t)> listener);
 
 private:
     PinService& pinService;
     uint8_t pin = 0;
 
     // Window timing
-    unsigned long windowStartMs = 0;
-    unsigned long nextReportMs  = 0;
     uint32_t lastChangeUs = 0;
 
     // State
@@ -105,11 +109,13 @@ private:
     uint32_t lastRiseUs = 0;
     uint32_t lastHighPulseUs = 0;
 
-    static const uint32_t ANALYZE_DURATION_MS = 8000;
+    std::function<void(bool, uint32_t)> edgeListener;
 
 private:
     void onEdge(bool newLevel, uint32_t nowUs);
     void closeTail(uint32_t nowUs);
+    void resetCounters(bool level);
+    Report makeReport(uint32_t elapsedUs, bool doPullTest);
 
     // Stats helpers
     static uint32_t medianOf(std::vector<uint32_t>& v);
@@ -1,4 +1,5 @@
 #include "Controllers/BluetoothController.h"
+#include <algorithm>
 
 /*
 Constructor
@@ -108,32 +109,87 @@ void BluetoothController::handleStatus() {
 Sniff
 */
 void BluetoothController::handleSniff(const TerminalCommand& cmd) {
-    terminalView.println("Bluetooth Sniff: Started... Press [ENTER] to stop.\n");
+    const bool detail = cmd.getSubcommand() == "detail";
 
     bluetoothService.switchToMode(BluetoothMode::CLIENT);
-    BluetoothService::startPassiveBluetoothSniffing();
+    if (!BluetoothService::startPassiveBluetoothSniffing()) {
+        terminalView.println("Bluetooth Sniff: Not enough memory for the table.\n");
+        return;
+    }
+    terminalView.println("Bluetooth Sniff: Started... Press [ENTER] to stop.\n");
 
-    unsigned long lastPull = 0;
+    std::vector<BleAdvertisementTable::Entry> rows(BluetoothService::getBluetoothSniffCapacity());
+    unsigned long lastDraw = 0;
+    size_t drawnLines = 0;
 
     while (true) {
         // Enter press
         char key = terminalInput.readChar();
         if (key == '\r' || key == '\n') break;
 
-        // Show paquets if any
-        if (millis() - lastPull > 200) { 
-            auto logs = BluetoothService::getBluetoothSniffLog();
-            for (const auto& line : logs) {
-                terminalView.println(line);
-            }
-            lastPull = millis();
+        // Redraw the table in place
+        if (millis() - lastDraw > SNIFF_REFRESH_MS) {
+            size_t n = BluetoothService::getBluetoothSniffTable(rows.data(), rows.size());
+            drawnLines = renderSniffTable(rows.data(), std::min(n, SNIFF_LIVE_ROWS), drawnLines);
+            lastDraw = millis();
         }
 
         delay(10);
     }
 
     BluetoothService::stopPassiveBluetoothSniffing();
-    terminalView.println("Bluetooth Sniff: Stopped by user.\n");
+
+    size_t unique = 0;
+    auto stats = BluetoothService::getBluetoothSniffStats(unique);
+    terminalView.println("\nBluetooth Sniff: Stopped by user.");
+    terminalView.println("  Advertisements: " + std::to_string(stats.received) +
+                         ", unique: " + std::to_string(stats.inserted) +
+                         ", in table: " + std::to_string(unique) +
+                         ", evicted: " + std::to_string(stats.evicted) + "\n");
+
+    if (!detail) return;
+
+    // Decoded AD structures of each entry still in the table
+    size_t n = BluetoothService::getBluetoothSniffTable(rows.data(), rows.size());
+    for (size_t i = 0; i < n; ++i) {
+        const auto& e = rows[i];
+        terminalView.println("[" + e.formatAddress() + "] x" + std::to_string(e.count) +
+                             " RSSI " + std::to_string(e.rssiAvg()) + " dBm");
+        std::string ads = BluetoothService::parseAdTypes(e.payload, e.payloadLen);
+        if (!ads.empty()) terminalView.println(ads);
+        terminalView.println("");
+    }
+}
+
+size_t BluetoothController::renderSniffTable(const BleAdvertisementTable::Entry* rows, size_t count, size_t previousLines) {
+    // Back to the top of the previous draw
+    if (previousLines) terminalView.print("\r\x1b[" + std::to_string(previousLines) + "A");
+
+    const uint32_t now = millis();
+    size_t lines = 0;
+    auto printLine = [&](const std::string& line) {
+        terminalView.println("\x1b[2K" + line);
+        lines++;
+    };
+
+    printLine("ADDRESS            AVG  MIN  MAX   COUNT   AGE  NAME / MANUFACTURER");
+    for (size_t i = 0; i < count; ++i) {
+        const auto& e = rows[i];
+        std::string label = e.name;
+        std::string mfr = e.describeManufacturer();
+        if (!mfr.empty()) label += label.empty() ? mfr : " | " + mfr;
+        if (label.empty()) label = e.connectable ? "(connectable)" : "-";
+
+        char line[64];
+        snprintf(line, sizeof(line), "%s  %4d %4d %4d  %6lu  %3lus  ",
+                 e.formatAddress().c_str(), e.rssiAvg(), e.rssiMin, e.rssiMax,
+                 (unsigned long)e.count, (unsigned long)((now - e.lastSeenMs) / 1000));
+        printLine(std::string(line) + label.substr(0, SNIFF_LABEL_WIDTH));
+    }
+
+    // Blank what a longer previous draw left below
+    while (lines < previousLines) printLine("");
+    return lines;
 }
 
 /*
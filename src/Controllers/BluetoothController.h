@@ -41,6 +41,10 @@ private:
     HelpShell& helpShell;
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
+
+    static constexpr unsigned long SNIFF_REFRESH_MS = 500;
+    static constexpr size_t SNIFF_LIVE_ROWS = 16;
+    static constexpr size_t SNIFF_LABEL_WIDTH = 48;
     
     // Scan for BT devices
     void handleScan();
@@ -72,6 +76,9 @@ private:
     // Sniff BT server I/O
     void handleSniff(const TerminalCommand& cmd);
 
+    // Draw the sniff table over the previous draw, returns the lines printed
+    size_t renderSniffTable(const BleAdvertisementTable::Entry* rows, size_t count, size_t previousLines);
+
     // Available BT commands
     void handleHelp();
 
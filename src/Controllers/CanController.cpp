@@ -1,15 +1,18 @@
 #include "CanController.h"
+#include <esp_timer.h>
 
 CanController::CanController(ITerminalView& terminalView,
                              IInput& terminalInput,
                              UserInputManager& userInputManager,
                              CanService& canService,
+                             LittleFsService& littleFsService,
                              ArgTransformer& argTransformer,
                              HelpShell& helpShell)
     : terminalView(terminalView),
       terminalInput(terminalInput),
       userInputManager(userInputManager),
       canService(canService),
+      littleFsService(littleFsService),
       argTransformer(argTransformer),
       helpShell(helpShell) {}
 
@@ -17,7 +20,8 @@ CanController::CanController(ITerminalView& terminalView,
 Entry point for CAN commands
 */
 void CanController::handleCommand(const TerminalCommand& cmd) {
-    if (cmd.getRoot() == "sniff")          handleSniff();
+    if (cmd.getRoot() == "sniff")          handleSniff(cmd);
+    else if (cmd.getRoot() == "filter")    handleFilter(cmd);
     else if (cmd.getRoot() == "send")      handleSend(cmd);
     else if (cmd.getRoot() == "receive")   handleReceive(cmd);
     else if (cmd.getRoot() == "status")    handleStatus();
@@ -28,34 +32,198 @@ void CanController::handleCommand(const TerminalCommand& cmd) {
 /*
 Sniff all CAN frames
 */
-void CanController::handleSniff() {
+void CanController::handleSniff(const TerminalCommand& cmd) {
+    // sniff [log] [stats]
+    std::string args = cmd.getSubcommand() + " " + cmd.getArgs();
+    bool log = args.find("log") != std::string::npos;
+    bool stats = args.find("stats") != std::string::npos;
+
+    std::string logPath;
+    if (log) {
+        logPath = openLog();
+        if (logPath.empty()) return;
+    }
+
     canService.reset();
-    
-    terminalView.println("CAN Sniff: Waiting for frame... Press [ENTER] to stop.\n");
-    
-    unsigned long lastFrameTime = millis();
-    while (true) {
-        auto frame = canService.readFrameAsString();
 
-        // Received frame
-        if (!frame.empty()) {
-            terminalView.println(" 📥 " + frame);
-            lastFrameTime = millis();  // reset timer
+    // Frames are drained by a reader task, this loop only prints them
+    uint8_t intPin = state.getCanIntPin();
+    if (!canService.startCapture(intPin)) {
+        terminalView.println("\n❌ CAN Sniff: Failed to start the reader task.");
+        return;
+    }
+
+    terminalView.println("CAN Sniff: Waiting for frame... Press [ENTER] to stop.");
+    if (intPin == CAN_INT_PIN_NONE) {
+        terminalView.println(" [ℹ️  INFORMATION] INT pin not set, polling every tick. Busy buses may overrun.");
+    }
+    if (!canService.getAcceptanceFilters().empty()) {
+        terminalView.println(" Hardware filters active, see 'filter'.");
+    }
+    terminalView.println("");
+
+    CanCapturedFrame frames[SNIFF_BATCH];
+    std::string logBuffer;
+    bool logOk = !logPath.empty();
+    uint64_t startUs = esp_timer_get_time();
+    uint32_t startMs = millis();
+    uint32_t lastStatsMs = startMs;
+    CanCaptureStats last;
+
+    while (true) {
+        size_t n = canService.readCaptured(frames, SNIFF_BATCH);
+        if (n > 0) {
+            // One print per batch
+            std::string out;
+            for (size_t i = 0; i < n; ++i) {
+                out += " 📥 " + CanService::formatFrame(frames[i].frame) + "\r\n";
+                if (logOk) logBuffer += CanService::formatCandump(frames[i], startUs);
+            }
+            terminalView.print(out);
+
+            if (logOk && logBuffer.size() >= LOG_FLUSH_SIZE) {
+                logOk = littleFsService.write(logPath, logBuffer, true);
+                logBuffer.clear();
+            }
         }
 
-        // Reset CAN if no frame for 3 seconds
-        if (millis() - lastFrameTime > 3000) {
-            canService.reset();
-            lastFrameTime = millis();
+        // Rates and losses
+        uint32_t now = millis();
+        if (stats && now - lastStatsMs >= STATS_INTERVAL_MS) {
+            CanCaptureStats cur = canService.getCaptureStats();
+            uint32_t fps = (uint64_t)(cur.frames - last.frames) * 1000 / (now - lastStatsMs);
+            terminalView.println("[stats] " + std::to_string(fps) + " frames/s, " +
+                                 std::to_string(cur.hwOverruns) + " overruns, " +
+                                 std::to_string(cur.ringDrops) + " dropped, " +
+                                 std::to_string(cur.errors) + " errors");
+            last = cur;
+            lastStatsMs = now;
         }
 
         // Abort if ENTER is pressed
         char ch = terminalInput.readChar();
-        if (ch == '\n' || ch == '\r') {
-            terminalView.println("\nCan Sniff: Stopped by user.");
-            break;
+        if (ch == '\n' || ch == '\r') break;
+
+        if (n == 0) vTaskDelay(1);
+    }
+
+    canService.stopCapture();
+
+    // Frames still in the ring go to the log only
+    size_t n;
+    while (logOk && (n = canService.readCaptured(frames, SNIFF_BATCH)) > 0) {
+        for (size_t i = 0; i < n; ++i) logBuffer += CanService::formatCandump(frames[i], startUs);
+    }
+    if (logOk && !logBuffer.empty()) logOk = littleFsService.write(logPath, logBuffer, true);
+
+    CanCaptureStats total = canService.getCaptureStats();
+    uint32_t elapsedMs = millis() - startMs;
+    terminalView.println("\nCan Sniff: Stopped by user.");
+    terminalView.println("  " + std::to_string(total.frames) + " frames in " + std::to_string(elapsedMs / 1000) + " s" +
+                         " (avg " + std::to_string(elapsedMs ? (uint64_t)total.frames * 1000 / elapsedMs : 0) + " frames/s)" +
+                         ", " + std::to_string(total.hwOverruns) + " overruns" +
+                         ", " + std::to_string(total.ringDrops) + " dropped" +
+                         ", " + std::to_string(total.errors) + " errors");
+    if (!logPath.empty()) {
+        if (logOk) terminalView.println("  Log saved to " + logPath);
+        else terminalView.println("  ❌ Log write failed: " + logPath);
+    }
+    terminalView.println("");
+}
+
+/*
+Hardware acceptance filters
+*/
+void CanController::handleFilter(const TerminalCommand& cmd) {
+    // filter <id>[/mask] ... | filter clear
+    std::vector<std::string> tokens = argTransformer.splitArgs(cmd.getSubcommand() + " " + cmd.getArgs());
+
+    if (tokens.empty()) {
+        const auto& current = canService.getAcceptanceFilters();
+        if (current.empty()) {
+            terminalView.println("\nCAN Filter: None, all frames accepted.");
+        } else {
+            terminalView.println("\nCAN Filter:");
+            for (const auto& f : current) {
+                int width = f.extended ? 8 : 3;
+                terminalView.println("  ID 0x" + argTransformer.toHex(f.id, width) + " / mask 0x" + argTransformer.toHex(f.mask, width));
+            }
         }
+        terminalView.println("\nUsage: filter <id>[/mask] ... (up to 6), filter clear\n");
+        return;
+    }
+
+    if (tokens[0] == "clear") {
+        canService.clearAcceptanceFilters();
+        terminalView.println("\nCAN Filter: ✅ Cleared, all frames accepted.\n");
+        return;
+    }
+
+    if (tokens.size() > 6) {
+        terminalView.println("\n❌ The MCP2515 has 6 acceptance filters.\n");
+        return;
+    }
+
+    std::vector<CanAcceptanceFilter> filters;
+    for (const auto& token : tokens) {
+        size_t slash = token.find('/');
+        std::string idStr = token.substr(0, slash);
+        std::string maskStr = slash == std::string::npos ? "" : token.substr(slash + 1);
+
+        if (!argTransformer.isValidNumber(idStr) || (!maskStr.empty() && !argTransformer.isValidNumber(maskStr))) {
+            terminalView.println("\n❌ Invalid filter: " + token + "\n");
+            return;
+        }
+
+        CanAcceptanceFilter f;
+        f.id = argTransformer.parseHexOrDec32(idStr);
+        f.extended = f.id > 0x7FF;
+        if (f.id > 0x1FFFFFFF) {
+            terminalView.println("\n❌ ID out of range: " + token + "\n");
+            return;
+        }
+        f.mask = maskStr.empty() ? (f.extended ? 0x1FFFFFFF : 0x7FF) : argTransformer.parseHexOrDec32(maskStr);
+        filters.push_back(f);
+    }
+
+    if (!canService.setAcceptanceFilters(filters)) {
+        terminalView.println("\n❌ Standard and extended IDs can't be mixed.\n");
+        return;
     }
+
+    // Two masks for six filters, a shared mask may let more through
+    terminalView.println("\nCAN Filter: ✅ " + std::to_string(filters.size()) + " filter(s) applied.");
+    if (filters.size() > 1) {
+        terminalView.println(" Masks are shared per RX buffer (IDs 1-2 and 3-6).");
+    }
+    terminalView.println("");
+}
+
+/*
+Open a candump log
+*/
+std::string CanController::openLog() {
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("\n ❌ LittleFS not mounted.");
+            return "";
+        }
+    }
+    if (littleFsService.freeBytes() < LOG_MIN_FREE_BYTES) {
+        terminalView.println("\n❌ Not enough LittleFS space.");
+        return "";
+    }
+
+    std::string defName = "can_" + std::to_string(millis() % 1000000);
+    std::string name = userInputManager.readSanitizedString("File name", defName, false);
+    if (name.empty()) name = defName;
+
+    std::string path = std::string(LOG_DIR) + name + ".log";
+    if (littleFsService.exists(path)) littleFsService.removeFile(path);
+
+    terminalView.println("Logging to " + path + " (candump format)");
+    return path;
 }
 
 /*
@@ -193,6 +361,15 @@ void CanController::handleConfig() {
     uint8_t so = userInputManager.readValidatedPinNumber("MCP2515 SO (MISO) pin", state.getCanSoPin(), forbidden);
     state.setCanSoPin(so);
 
+    // INT lets the reader wake on each frame instead of polling
+    bool hasInt = userInputManager.readYesNo("MCP2515 INT pin wired?", state.getCanIntPin() != CAN_INT_PIN_NONE);
+    if (hasInt) {
+        uint8_t defInt = state.getCanIntPin() != CAN_INT_PIN_NONE ? state.getCanIntPin() : 4;
+        state.setCanIntPin(userInputManager.readValidatedPinNumber("MCP2515 INT pin", defInt, forbidden));
+    } else {
+        state.setCanIntPin(CAN_INT_PIN_NONE);
+    }
+
     // Configure bitrate
     uint32_t kbps = userInputManager.readValidatedUint32("Speed in kbps", state.getCanKbps());
     uint32_t adjusted = canService.closestSupportedBitrate(kbps);
@@ -5,6 +5,7 @@
 #include "Interfaces/IInput.h"
 #include "Models/TerminalCommand.h"
 #include "Services/CanService.h"
+#include "Services/LittleFsService.h"
 #include "Transformers/ArgTransformer.h"
 #include "Managers/UserInputManager.h"
 #include "States/GlobalState.h"
@@ -13,7 +14,8 @@
 class CanController {
 public:
     CanController(ITerminalView& terminalView, IInput& terminalInput, UserInputManager& userInputManager,
-                  CanService& canService, ArgTransformer& argTransformer, HelpShell& helpShell);
+                  CanService& canService, LittleFsService& littleFsService, ArgTransformer& argTransformer,
+                  HelpShell& helpShell);
     
     // Entry point to handle CAN commands
     void handleCommand(const TerminalCommand& cmd);
@@ -25,14 +27,24 @@ private:
     ITerminalView& terminalView;
     IInput& terminalInput;
     CanService& canService;
+    LittleFsService& littleFsService;
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
     HelpShell& helpShell;
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
-    
+
+    static constexpr size_t SNIFF_BATCH = 32;
+    static constexpr uint32_t STATS_INTERVAL_MS = 1000;
+    static constexpr size_t LOG_FLUSH_SIZE = 4096;
+    static constexpr size_t LOG_MIN_FREE_BYTES = 16 * 1024;
+    inline static constexpr const char* LOG_DIR = "/captures/";
+
     // Sniffing all CAN frames
-    void handleSniff();
+    void handleSniff(const TerminalCommand& cmd);
+
+    // Hardware acceptance masks and filters
+    void handleFilter(const TerminalCommand& cmd);
 
     // Status of the CAN controller
     void handleStatus();
@@ -46,6 +58,9 @@ private:
     // Configuring the CAN controller
     void handleConfig();
 
+    // Open a candump log on LittleFS, empty path on failure
+    std::string openLog();
+
     // Help message for CAN commands
     void handleHelp();
 };
@@ -10,6 +10,7 @@ DioController::DioController(
     IInput& terminalInput,
     IDeviceView& deviceView,
     PinService& pinService,
+    EdgeCaptureService& edgeCaptureService,
     ArgTransformer& argTransformer,
     HelpShell& helpShell,
     UserInputManager& userInputManager
@@ -18,6 +19,7 @@ DioController::DioController(
       terminalInput(terminalInput),
       deviceView(deviceView),
       pinService(pinService),
+      edgeCaptureService(edgeCaptureService),
       argTransformer(argTransformer),
       helpShell(helpShell),
       userInputManager(userInputManager) {}
@@ -389,43 +391,68 @@ void DioController::handleSniff(const TerminalCommand& cmd) {
     else if (pull == PinService::PULL_DOWN) pinService.setInputPullDown(pin);
     else                                   pinService.setInput(pin);
 
+    // Edges are timestamped by interrupt, printing can lag without losing any
+    uint32_t startUs = micros();
+    if (!edgeCaptureService.start(pin)) {
+        terminalView.println("DIO Sniff: Failed to attach the edge interrupt.");
+        return;
+    }
+
     terminalView.println("DIO Sniff: Pin " + std::to_string(pin) + "... Press [ENTER] to stop");
-    uint8_t last = pinService.read(pin);
-    terminalView.println("\nInitial state: " + std::string(last ? "HIGH" : "LOW"));
+    terminalView.println("\nInitial state: " + std::string(edgeCaptureService.getInitialLevel() ? "HIGH" : "LOW"));
     terminalView.println("");
 
-    uint32_t lastEdgeUs = micros();
-    uint32_t lastKeyPollMs = millis();
+    EdgeCaptureService::Edge edges[64];
+    EdgeCaptureService::Edge prev{};
+    bool havePrev = false;
+    uint32_t reportedDrops = 0;
+    const std::string prefix = "Pin " + std::to_string(pin) + ": ";
 
     while (true) {
-        // check ENTER every 10ms
-        if (millis() - lastKeyPollMs > 10) {
-            lastKeyPollMs = millis();
-            char c = terminalInput.readChar();
-            if (c == '\r' || c == '\n') {
-                terminalView.println("\nDIO Sniff: Stopped.");
-                break;
-            }
+        char c = terminalInput.readChar();
+        if (c == '\r' || c == '\n') {
+            terminalView.println("\nDIO Sniff: Stopped.");
+            break;
         }
 
-        int current = pinService.read(pin);
-        if (current != last) {
-            uint32_t nowUs = micros();
-            uint32_t dtUs = nowUs - lastEdgeUs;
-            lastEdgeUs = nowUs;
+        size_t n = edgeCaptureService.read(edges, sizeof(edges) / sizeof(edges[0]));
+        if (n == 0) {
+            vTaskDelay(1);
+            continue;
+        }
+
+        std::string out;
+        for (size_t i = 0; i < n; ++i) {
+            const auto& e = edges[i];
+
+            // Sub-microsecond deltas between captured edges, plain µs before the first one
+            std::string delta;
+            uint32_t ns = havePrev ? edgeCaptureService.elapsedNs(prev, e) : UINT32_MAX;
+            if (ns != UINT32_MAX) {
+                char buf[24];
+                snprintf(buf, sizeof(buf), "%lu.%03lu", (unsigned long)(ns / 1000), (unsigned long)(ns % 1000));
+                delta = buf;
+            } else {
+                delta = std::to_string(havePrev ? edgeCaptureService.elapsedUs(prev, e) : e.us - startUs);
+            }
 
-            std::string transition = (last == 0 && current == 1)
-                ? "LOW  -> HIGH"
-                : "HIGH -> LOW ";
+            out += prefix + (e.level ? "LOW  -> HIGH" : "HIGH -> LOW ") + " | delta=" + delta + "us";
+            if (e.merged) out += " (short pulse)";
+            out += "\r\n";
 
-            terminalView.println(
-                "Pin " + std::to_string(pin) + ": " + transition +
-                " | delta=" + std::to_string(dtUs) + "us"
-            );
+            prev = e;
+            havePrev = true;
+        }
+        terminalView.print(out);
 
-            last = current;
+        uint32_t drops = edgeCaptureService.getDroppedCount();
+        if (drops != reportedDrops) {
+            terminalView.println("[Overflow] " + std::to_string(drops - reportedDrops) + " edges dropped");
+            reportedDrops = drops;
         }
     }
+
+    edgeCaptureService.stop();
 }
 
 /*
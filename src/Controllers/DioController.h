@@ -6,6 +6,7 @@
 #include "Interfaces/IInput.h"
 #include "Interfaces/IDeviceView.h"
 #include "Services/PinService.h"
+#include "Services/EdgeCaptureService.h"
 #include "Models/TerminalCommand.h"
 #include "Models/PinoutConfig.h"
 #include "States/GlobalState.h"
@@ -16,7 +17,7 @@
 class DioController {
 public:
     // Constructor
-    DioController(ITerminalView& terminalView, IInput& terminalInput, IDeviceView& deviceView, PinService& pinService, ArgTransformer& argTransformer, HelpShell& helpShell, UserInputManager& userInputManager);
+    DioController(ITerminalView& terminalView, IInput& terminalInput, IDeviceView& deviceView, PinService& pinService, EdgeCaptureService& edgeCaptureService, ArgTransformer& argTransformer, HelpShell& helpShell, UserInputManager& userInputManager);
 
     // Entry point to handle a DIO command
     void handleCommand(const TerminalCommand& cmd);
@@ -29,6 +30,7 @@ private:
     IInput& terminalInput;
     IDeviceView& deviceView;
     PinService& pinService;
+    EdgeCaptureService& edgeCaptureService;
     ArgTransformer& argTransformer;
     HelpShell& helpShell;
     UserInputManager& userInputManager;
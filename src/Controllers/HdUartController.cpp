@@ -5,16 +5,17 @@ Constructor
 */
 HdUartController::HdUartController(ITerminalView& terminalView, IInput& terminalInput, IInput& deviceInput,
                                    HdUartService& hdUartService, UartService& uartService, ArgTransformer& argTransformer, 
-                                   UserInputManager& userInputManager, HelpShell& helpShell)
+                                   UserInputManager& userInputManager, HelpShell& helpShell,
+                                   UartBridgeShell& uartBridgeShell)
     : terminalView(terminalView), terminalInput(terminalInput), deviceInput(deviceInput),
       hdUartService(hdUartService), uartService(uartService), argTransformer(argTransformer), 
-      userInputManager(userInputManager), helpShell(helpShell) {}
+      userInputManager(userInputManager), helpShell(helpShell), uartBridgeShell(uartBridgeShell) {}
 
 /*
 Entry point for HDUART commands
 */
 void HdUartController::handleCommand(const TerminalCommand& cmd) {
-    if      (cmd.getRoot() == "bridge") handleBridge();
+    if      (cmd.getRoot() == "bridge") handleBridge(cmd);
     else if (cmd.getRoot() == "config") handleConfig();
     else    handleHelp();
 }
@@ -23,46 +24,33 @@ void HdUartController::handleCommand(const TerminalCommand& cmd) {
 Entry point for HDUART instructions
 */
 void HdUartController::handleInstruction(const std::vector<ByteCode>& bytecodes) {
-    auto result = hdUartService.executeByteCode(bytecodes);
     terminalView.println("");
     terminalView.print("HDUART Read: ");
-    terminalView.println(result.empty() ? "No data" : "\n\n" + result);
+
+    // Received text is printed as it comes
+    TerminalResultSink sink(terminalView, "\n", false);
+    hdUartService.executeByteCode(bytecodes, sink);
+    sink.flush();
+
+    terminalView.println(sink.getByteCount() > 0 ? "" : "No data");
     terminalView.println("");
 }
 
 /*
 Bridge mode read/write
 */
-void HdUartController::handleBridge() {
-    terminalView.println("HDUART Bridge: In progress... Press [ANY ESP32 BUTTON] to stop.");
-
-    std::string echoBuffer;
-
-    while (true) {
-        // Receive UART
-        while (hdUartService.available()) {
-            char incoming = hdUartService.read();
-            if (!echoBuffer.empty() && incoming == echoBuffer.front()) {
-                echoBuffer.erase(0, 1); // Filter for echo line
-            } else {
-                terminalView.print(std::string(1, incoming));
-            }
-        }
-
-        // Terminal input
-        char c = terminalInput.readChar();
-        if (c != KEY_NONE) {
-            hdUartService.write(c);
-            echoBuffer += c; // echo char
-        }
-
-        // Device input
-        c = deviceInput.readChar();
-        if (c != KEY_NONE) {
-            terminalView.println("\nHDUART Bridge: Stopped by user.");
-            break;
-        }
-    }
+void HdUartController::handleBridge(const TerminalCommand& cmd) {
+    // bridge [stats] [cap]
+    std::string args = cmd.getSubcommand() + " " + cmd.getArgs();
+
+    UartBridgeShell::Port port;
+    port.name = "HDUART";
+    port.read = [this](uint8_t* buf, size_t len) { return hdUartService.readBytes(buf, len); };
+    port.write = [this](const uint8_t* buf, size_t len) { return hdUartService.writeBytes(buf, len); };
+    port.overflows = [this]() { return hdUartService.pollOverflows(); };
+    port.halfDuplex = true;
+
+    uartBridgeShell.run(port, args.find("cap") != std::string::npos, args.find("stats") != std::string::npos);
 }
 
 /*
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Interfaces/ITerminalView.h"
+#include "Views/TerminalResultSink.h"
 #include "Interfaces/IInput.h"
 #include "Models/ByteCode.h"
 #include "Models/TerminalCommand.h"
@@ -10,12 +11,14 @@
 #include "States/GlobalState.h"
 #include "Managers/UserInputManager.h"
 #include "Shells/HelpShell.h"
+#include "Shells/UartBridgeShell.h"
 
 class HdUartController {
 public:
     HdUartController(ITerminalView& terminalView, IInput& terminalInput, IInput& deviceInput,
                      HdUartService& hdUartService, UartService& uartService, ArgTransformer& argTransformer, 
-                     UserInputManager& userInputManager, HelpShell& helpShell);
+                     UserInputManager& userInputManager, HelpShell& helpShell,
+                     UartBridgeShell& uartBridgeShell);
     
     // Entry point for HDUART command
     void handleCommand(const TerminalCommand& cmd);
@@ -35,12 +38,13 @@ private:
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
     HelpShell& helpShell;
+    UartBridgeShell& uartBridgeShell;
     GlobalState& state = GlobalState::getInstance();
     
     bool configured = false;
     
     // HDUART Bridge mode read/write on one line
-    void handleBridge();
+    void handleBridge(const TerminalCommand& cmd);
 
     // Configure HDUART
     void handleConfig();
@@ -51,11 +51,9 @@ void I2cController::handleCommand(const TerminalCommand& cmd) {
 Entry point to handle I2C instruction
 */
 void I2cController::handleInstruction(const std::vector<ByteCode>& bytecodes) {
-    auto result = i2cService.executeByteCode(bytecodes);
-    if (!result.empty()) {
-        terminalView.println("I2C Read:\n");
-        terminalView.println(result);
-    }
+    TerminalResultSink sink(terminalView, "I2C Read:\n", true, "I2C Write:\n");
+    i2cService.executeByteCode(bytecodes, sink);
+    sink.flush();
 }
 
 /*
@@ -397,158 +395,66 @@ void I2cController::handleDump(const TerminalCommand& cmd) {
         len = argTransformer.parseHexOrDec16(args[0]);
     }
     if (len == 0) len = 1;
-    if (len > 256) len = 256;
-
-    std::vector<uint8_t> values(len, 0xFF);
-    std::vector<bool> valid(len, false);
+    if (len > MAX_DUMP_LENGTH) len = MAX_DUMP_LENGTH;
 
     terminalView.println("I2C Dump: 0x" + argTransformer.toHex(addr) +
                          " from 0x" + argTransformer.toHex(start) +
                          " for " + std::to_string(len) + " bytes... Press [ENTER] to stop.\n");
 
     // Try register style
-    performRegisterRead(addr, start, len, values, valid);
-
-    bool any = std::any_of(valid.begin(), valid.end(), [](bool b){ return b; });
+    I2cDumpEngine::Result result;
+    performRegisterRead(addr, start, len, result);
+    if (result.cancelled) return;
 
     // fallback raw if nothing read
-    if (!any) {
+    if (!result.any()) {
         terminalView.println("\nI2C Dump: register read failed — trying raw read...");
-        performRawRead(addr, start, len, values, valid);
-        any = std::any_of(valid.begin(), valid.end(), [](bool b){ return b; });
+        performRawRead(addr, start, len, result);
+        if (result.cancelled) return;
     }
 
-    if (!any) {
+    if (!result.any()) {
         terminalView.println("I2C Dump: Unable to read any data — device NACKed or unsupported protocol.\n");
         return;
     }
 
-    printHexDump(start, len, values, valid);
+    printHexDump(result);
+    terminalView.println("I2C Dump: " + std::to_string(result.transactions) + " transactions, bursts " +
+                         std::to_string(result.minBurst) + ".." + std::to_string(result.maxBurst) + " bytes, " +
+                         std::to_string(result.elapsedUs / 1000) + " ms.\n");
 }
 
-void I2cController::performRegisterRead(uint8_t addr, uint16_t start, uint16_t len,
-                                        std::vector<uint8_t>& values, std::vector<bool>& valid) {
-    const uint8_t CHUNK_SIZE = 16;
+void I2cController::performRegisterRead(uint8_t addr, uint16_t start, uint16_t len, I2cDumpEngine::Result& result) {
+    // 16-bit register pointer once the range goes past 0xFF
     const bool use16bitAddr = (start + len - 1) > 0xFF;
 
-    for (uint16_t offset = 0; offset < len; offset += CHUNK_SIZE) {
-        uint16_t reg = start + offset;
-        uint8_t toRead = (offset + CHUNK_SIZE <= len) ? CHUNK_SIZE : (uint8_t)(len - offset);
-
-        // set register pointer
-        i2cService.beginTransmission(addr);
-        if (use16bitAddr) {
-            i2cService.write((uint8_t)((reg >> 8) & 0xFF));
-            i2cService.write((uint8_t)(reg & 0xFF));
-        } else {
-            i2cService.write((uint8_t)(reg & 0xFF));
-        }
-        if (i2cService.endTransmission(false) != 0) {
-            // NACK on pointer write
-            continue;
-        }
-
-        // Try burst read
-        uint8_t received = i2cService.requestFrom(addr, toRead, true);
-
-        if (received == 0) {
-            // fallback, try single-byte read at this reg
-            i2cService.beginTransmission(addr);
-            if (!use16bitAddr) i2cService.write((uint8_t)(reg & 0xFF));
-            else { i2cService.write((uint8_t)((reg >> 8) & 0xFF)); i2cService.write((uint8_t)(reg & 0xFF)); }
-            if (i2cService.endTransmission(false) == 0) {
-                received = i2cService.requestFrom(addr, (uint8_t)1, true);
-            }
-        }
-
-        // Read whatever available
-        for (uint8_t i = 0; i < received; ++i) {
-            char key = terminalInput.readChar();
-            if (key == '\r' || key == '\n') {
-                terminalView.println("I2C Dump: Cancelled by user.");
-                return;
-            }
-
-            if (i2cService.available()) {
-                values[offset + i] = (uint8_t)i2cService.read();
-                valid[offset + i] = true;
-            } else {
-                break;
-            }
-        }
-
-        // Flush remaining just in case
-        while (i2cService.available()) (void)i2cService.read();
-
-        delay(1);
-    }
+    i2cService.readRegisters(addr, start, len, use16bitAddr, result, [&]() {
+        char key = terminalInput.readChar();
+        return key == '\r' || key == '\n';
+    });
+    if (result.cancelled) terminalView.println("I2C Dump: Cancelled by user.");
 }
 
-void I2cController::performRawRead(uint8_t addr, uint16_t start,
-                                   uint16_t len,
-                                   std::vector<uint8_t>& values,
-                                   std::vector<bool>& valid) {
-    values.assign(len, 0xFF);
-    valid.assign(len, false);
-
+void I2cController::performRawRead(uint8_t addr, uint16_t start, uint16_t len, I2cDumpEngine::Result& result) {
     terminalView.println("I2C Dump: Trying read raw...");
 
-    // Set starting point 
-    i2cService.beginTransmission(addr);
-    i2cService.write((uint8_t)(start & 0xFF));
-    if (i2cService.endTransmission(false) != 0) {
-        return; // NACK
-    }
-
-    const uint8_t CHUNK = 16;
-    uint16_t pos = 0;
-
-    while (pos < len) {
+    i2cService.readRaw(addr, start, len, result, [&]() {
         char key = terminalInput.readChar();
-        if (key == '\r' || key == '\n') {
-            terminalView.println("I2C Dump: Cancelled by user.");
-            return;
-        }
-
-        uint8_t want = (uint8_t)((len - pos) > CHUNK ? CHUNK : (len - pos));
-
-        uint8_t got = i2cService.requestFrom(addr, want, true);
-
-        if (got == 0) {
-            // Fallback: try read 1 byte 
-            got = i2cService.requestFrom(addr, (uint8_t)1, true);
-            if (got == 0) {
-                // Nothing more available
-                break;
-            }
-        }
-
-        for (uint8_t i = 0; i < got && pos < len; ++i, ++pos) {
-            if (i2cService.available()) {
-                values[pos] = (uint8_t)i2cService.read();
-                valid[pos] = true;
-            } else {
-                break;
-            }
-        }
-
-        while (i2cService.available()) (void)i2cService.read();
-
-        // If device consistently returns short, don't spin forever
-        if (got < want) {
-            break;
-        }
-
-        delay(1);
-    }
+        return key == '\r' || key == '\n';
+    });
+    if (result.cancelled) terminalView.println("I2C Dump: Cancelled by user.");
 }
 
-void I2cController::printHexDump(uint16_t start, uint16_t len,
-                                 const std::vector<uint8_t>& values, const std::vector<bool>& valid) {
+void I2cController::printHexDump(const I2cDumpEngine::Result& result) {
+    const uint16_t len = result.values.size();
+    const auto& values = result.values;
+    const auto& valid = result.valid;
+    const char* addrFormat = (result.start + len - 1) > 0xFF ? "%04X:" : "%02X:";
+
     for (uint16_t lineStart = 0; lineStart < len; lineStart += 16) {
         std::string line;
         char addrStr[8];
-        snprintf(addrStr, sizeof(addrStr), "%02X:", start + lineStart);
+        snprintf(addrStr, sizeof(addrStr), addrFormat, result.start + lineStart);
         line += addrStr;
 
         for (uint8_t i = 0; i < 16; ++i) {
@@ -777,34 +683,33 @@ void I2cController::handleMonitor(const TerminalCommand& cmd) {
 
     terminalView.println("I2C Monitor: Monitoring register changes at 0x" + argTransformer.toHex(addr) + "... Press [ENTER] to stop.\n");
 
-    std::vector<uint8_t> prev(len, 0xFF);
-    std::vector<uint8_t> curr(len, 0xFF);
-    std::vector<bool> valid(len, false);
+    I2cDumpEngine::Result curr;
 
     // First read to initialize prev
     if (i2cService.isReadableDevice(addr, 0x00)) {
-        performRegisterRead(addr, 0x00, len, prev, valid);
+        performRegisterRead(addr, 0x00, len, curr);
     } else {
-        performRawRead(addr, 0x00, len, prev, valid);
+        performRawRead(addr, 0x00, len, curr);
     }
+    std::vector<uint8_t> prev = curr.values;
 
     while (true) {
         // Try register read
         if (i2cService.isReadableDevice(addr, 0x00)) {
-            performRegisterRead(addr, 0x00, len, curr, valid);
+            performRegisterRead(addr, 0x00, len, curr);
         } else {
-            performRawRead(addr, 0x00, len, curr, valid);
+            performRawRead(addr, 0x00, len, curr);
         }
 
         // Compare and show changes
         for (uint16_t i = 0; i < len; ++i) {
-            if (valid[i] && curr[i] != prev[i]) {
+            if (curr.valid[i] && curr.values[i] != prev[i]) {
                 std::stringstream ss;
                 ss << "0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << i
                    << ": 0x" << std::setw(2) << (int)prev[i]
-                   << " -> 0x" << std::setw(2) << (int)curr[i];
+                   << " -> 0x" << std::setw(2) << (int)curr.values[i];
                 terminalView.println(ss.str());
-                prev[i] = curr[i];
+                prev[i] = curr.values[i];
             }
         }
 
@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include "Interfaces/ITerminalView.h"
+#include "Views/TerminalResultSink.h"
 #include "Interfaces/IInput.h"
 #include "Services/I2cService.h"
 #include "Models/TerminalCommand.h"
@@ -64,6 +65,8 @@ private:
     HelpShell& helpShell;
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
+
+    static constexpr uint16_t MAX_DUMP_LENGTH = 4096;
     
     // Ping an I2C address
     void handlePing(const TerminalCommand& cmd);
@@ -124,11 +127,8 @@ private:
 
     // Dump I2C registers content
     void handleDump(const TerminalCommand& cmd);
-    void performRegisterRead(uint8_t addr, uint16_t, uint16_t len,
-                            std::vector<uint8_t>& values, std::vector<bool>& valid);
-    void performRawRead(uint8_t addr, uint16_t, uint16_t len,
-                        std::vector<uint8_t>& values, std::vector<bool>& valid);
-    void printHexDump(uint16_t, uint16_t len,
-                    const std::vector<uint8_t>& values, const std::vector<bool>& valid);
+    void performRegisterRead(uint8_t addr, uint16_t start, uint16_t len, I2cDumpEngine::Result& result);
+    void performRawRead(uint8_t addr, uint16_t start, uint16_t len, I2cDumpEngine::Result& result);
+    void printHexDump(const I2cDumpEngine::Result& result);
     std::string identifyToString(uint8_t address, bool includeHeader = false);
 };
@@ -18,7 +18,8 @@ InfraredController::InfraredController(
     InfraredRemoteTransformer& infraredRemoteTransformer,
     UserInputManager&        userInputManager,
     UniversalRemoteShell&    universalRemoteShell,
-    HelpShell&               helpShell
+    HelpShell&               helpShell,
+    CaptureExportShell&      captureExportShell
 )
     : terminalView(view),
       terminalInput(terminalInput),
@@ -30,7 +31,8 @@ InfraredController::InfraredController(
       infraredRemoteTransformer(infraredRemoteTransformer),
       userInputManager(userInputManager),
       universalRemoteShell(universalRemoteShell),
-      helpShell(helpShell)
+      helpShell(helpShell),
+      captureExportShell(captureExportShell)
 {}
 
 /*
@@ -92,6 +94,14 @@ Receive
 void InfraredController::handleReceive() {
     bool decode = userInputManager.readYesNo("Decode infrared signal?", true);
 
+    // Raw frames can be streamed to a VCD/sigrok file for offline decoding
+    std::unique_ptr<ICaptureWriter> capture;
+    if (!decode && userInputManager.readYesNo("Record raw frames to a capture file?", false)) {
+        capture = captureExportShell.open("ir");
+        if (capture && !capture->begin({ "IR" }, 1000000)) capture.reset();
+    }
+    uint32_t lastFrameUs = micros();
+
     terminalView.println("INFRARED Receive: Waiting for signal...");
     terminalView.println("Press [ENTER] to stop.\n");
 
@@ -156,11 +166,35 @@ void InfraredController::handleReceive() {
                     mark = !mark;
                 }
                 terminalView.println("");
+
+                if (capture) recordRawFrame(*capture, timings, lastFrameUs);
             }
         }
     }
 
     infraredService.stopReceiver();
+    captureExportShell.close(capture);
+}
+
+/*
+Record raw frame
+*/
+void InfraredController::recordRawFrame(ICaptureWriter& capture, const std::vector<uint16_t>& timings, uint32_t& lastFrameUs) {
+    uint32_t frameUs = 0;
+    for (uint16_t t : timings) frameUs += t;
+
+    // Frames are handed over after they end, estimate the idle time before this one
+    uint32_t now = micros();
+    uint32_t elapsed = now - lastFrameUs;
+    capture.append(0, elapsed > frameUs ? elapsed - frameUs : 1);
+    lastFrameUs = now;
+
+    // Marks first, then alternating spaces
+    bool mark = true;
+    for (uint16_t t : timings) {
+        capture.append(mark ? 1 : 0, t);
+        mark = !mark;
+    }
 }
 
 /* 
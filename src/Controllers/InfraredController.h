@@ -20,6 +20,7 @@
 #include "States/GlobalState.h"
 #include "Shells/UniversalRemoteShell.h"
 #include "Shells/HelpShell.h"
+#include "Shells/CaptureExportShell.h"
 
 class InfraredController {
 public:
@@ -27,7 +28,8 @@ public:
     InfraredController(ITerminalView& view, IInput& terminalInput, IDeviceView& deviceView,
                        InfraredService& service, LittleFsService& littleFsService, I2cService& i2cService,  
                        ArgTransformer& argTransformer, InfraredRemoteTransformer& infraredRemoteTransformer,
-                       UserInputManager& userInputManager, UniversalRemoteShell& universalRemoteShell, HelpShell& helpShell);
+                       UserInputManager& userInputManager, UniversalRemoteShell& universalRemoteShell, HelpShell& helpShell,
+                       CaptureExportShell& captureExportShell);
 
     // Entry point for Infraredcommand dispatch
     void handleCommand(const TerminalCommand& command);
@@ -48,6 +50,7 @@ private:
     UniversalRemoteShell& universalRemoteShell;
     LittleFsService& littleFsService;
     HelpShell& helpShell;
+    CaptureExportShell& captureExportShell;
     
     bool configured = false;
     uint8_t MAX_IR_FRAMES = 64; // Maximum frames to record
@@ -67,6 +70,9 @@ private:
 
     // Receive IR commands
     void handleReceive();
+
+    // Append a raw frame to a capture file, idle time since the previous frame included
+    void recordRawFrame(ICaptureWriter& capture, const std::vector<uint16_t>& timings, uint32_t& lastFrameUs);
     
     // Send "device-b-gone" style power-off signals
     void handleDeviceBgone();
@@ -1,4 +1,5 @@
 #include "JtagController.h"
+#include <algorithm>
 
 /*
 Constructor
@@ -7,11 +8,15 @@ JtagController::JtagController(
     ITerminalView& terminalView,
     IInput& terminalInput,
     JtagService& jtagService,
+    LittleFsService& littleFsService,
+    SdService& sdService,
     UserInputManager& userInputManager,
     HelpShell& helpShell
 ) : terminalView(terminalView),
     terminalInput(terminalInput),
     jtagService(jtagService),
+    littleFsService(littleFsService),
+    sdService(sdService),
     userInputManager(userInputManager),
     helpShell(helpShell) {}
 /*
@@ -19,6 +24,7 @@ Entry point that handles JTAG commands
 */
 void JtagController::handleCommand(const TerminalCommand& cmd) {
     if (cmd.getRoot() == "scan") handleScan(cmd); 
+    else if (cmd.getRoot() == "play") handlePlay(cmd);
     else if (cmd.getRoot() == "config") handleConfig();
     else handleHelp();
 }
@@ -34,26 +40,60 @@ void JtagController::handleScan(const TerminalCommand& cmd) {
     else terminalView.println("Usage: 'scan swd' or 'scan jtag'.");
 }
 
+/*
+Progress
+*/
+JtagService::ScanProgress JtagController::makeProgress(const char* name) {
+    uint32_t startMs = millis();
+    uint32_t lastMs = startMs;
+    std::string lastPhase;
+
+    return [this, name, startMs, lastMs, lastPhase](const char* phase, size_t done, size_t total) mutable {
+        uint32_t now = millis();
+        if (now - lastMs < 500 && lastPhase == phase && done < total) return true;
+        lastMs = now;
+        lastPhase = phase;
+
+        // ENTER cancels
+        char c = terminalInput.readChar();
+        if (c == '\r' || c == '\n') return false;
+
+        // Remaining time from the average pass so far
+        uint32_t elapsed = now - startMs;
+        uint32_t etaMs = done ? (uint64_t)elapsed * (total - done) / done : 0;
+        terminalView.println("  " + std::string(name) + " " + phase + " pass " + std::to_string(done) + "/" +
+                             std::to_string(total) + ", ETA " + std::to_string((etaMs + 999) / 1000) + " s");
+        return true;
+    };
+}
+
 /*
 Scan SWD
 */
 void JtagController::handleScanSwd() {
-    terminalView.println("JTAG: Scanning for SWD devices...");
+    terminalView.println("JTAG: Scanning for SWD devices... Press [ENTER] to stop.");
 
     uint8_t swdio, swclk;
     uint32_t idcode;
     std::vector<uint8_t> swdCandidates = state.getJtagScanPins();
 
-    bool found = jtagService.scanSwdDevice(swdCandidates, swdio, swclk, idcode);
+    uint32_t startMs = millis();
+    bool found = jtagService.scanSwdDevice(swdCandidates, swdio, swclk, idcode, makeProgress("SWD"));
+    std::string stats = std::to_string(jtagService.getLastScanCycles()) + " SWCLK cycles in " +
+                        std::to_string(millis() - startMs) + " ms";
 
     if (found) {
+        char buf[11];
+        snprintf(buf, sizeof(buf), "0x%08X", (unsigned int)idcode);
         terminalView.println("\n SWD device found!");
         terminalView.println("  • SWDIO  : GPIO " + std::to_string(swdio));
         terminalView.println("  • SWCLK  : GPIO " + std::to_string(swclk));
-        terminalView.println("  • IDCODE : 0x" + std::to_string(idcode));
-        terminalView.println("  ✅ SWD scan done.\n");
+        terminalView.println("  • IDCODE : " + std::string(buf));
+        terminalView.println("  ✅ SWD scan done, " + stats + ".\n");
+    } else if (jtagService.wasLastScanAborted()) {
+        terminalView.println("\nJTAG: SWD scan stopped by user.");
     } else {
-        terminalView.println("\nJTAG: No SWD device found on available GPIOs.");
+        terminalView.println("\nJTAG: No SWD device found on available GPIOs (" + stats + ").");
     }
 }
 
@@ -61,20 +101,23 @@ void JtagController::handleScanSwd() {
 Scan JTAG
 */
 void JtagController::handleScanJtag() {    
-    terminalView.println("JTAG: Scanning for JTAG devices...");
+    terminalView.println("JTAG: Scanning for JTAG devices... Press [ENTER] to stop.");
 
     std::vector<uint8_t> jtagCandidates = state.getJtagScanPins();
     uint8_t tdi, tdo, tck, tms;
     int trst;
     std::vector<uint32_t> ids;
 
+    uint32_t startMs = millis();
     bool found = jtagService.scanJtagDevice(
         jtagCandidates,
         tdi, tdo, tck, tms, trst,
         ids,
-        true, // detect pullup
-        nullptr // callback progression
+        true, // pull-ups on idle pins
+        makeProgress("JTAG")
     );
+    std::string stats = std::to_string(jtagService.getLastScanCycles()) + " TCK cycles in " +
+                        std::to_string(millis() - startMs) + " ms";
 
     if (found) {
         terminalView.println("\n JTAG device(s) found!");
@@ -86,16 +129,155 @@ void JtagController::handleScanJtag() {
             terminalView.println("  • TRST  : GPIO " + std::to_string(trst));
         }
 
+        // Defaults for play
+        state.setJtagTckPin(tck);
+        state.setJtagTmsPin(tms);
+        state.setJtagTdiPin(tdi);
+        state.setJtagTdoPin(tdo);
+        state.setJtagTrstPin(trst >= 0 ? trst : 0xFF);
+
         for (size_t i = 0; i < ids.size(); ++i) {
             char buf[11];
             snprintf(buf, sizeof(buf), "0x%08X", ids[i]);
             terminalView.println("  • IDCODE[" + std::to_string(i) + "] : " + buf);
         }
 
-        terminalView.println("  ✅ Scan complete.\n");
+        if (ids.empty()) {
+            terminalView.println("  • IDCODE : none, TAP resets to BYPASS");
+        }
+
+        terminalView.println("  ✅ Scan complete, " + stats + ".\n");
+    } else if (jtagService.wasLastScanAborted()) {
+        terminalView.println("\nJTAG: Scan stopped by user.");
+    } else {
+        terminalView.println("\nJTAG: No device found on available GPIOs (" + stats + ").");
+    }
+}
+
+/*
+Play SVF / XSVF
+*/
+void JtagController::handlePlay(const TerminalCommand& cmd) {
+    std::string path = cmd.getSubcommand();
+    if (path.empty()) {
+        terminalView.println("Usage: play <file.svf|file.xsvf>");
+        return;
+    }
+    if (path[0] != '/') path = "/" + path;
+
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    auto endsWith = [&](const std::string& ext) {
+        return lower.size() > ext.size() && lower.compare(lower.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    bool xsvf = endsWith(".xsvf");
+    if (!xsvf && !endsWith(".svf")) {
+        terminalView.println("JTAG: Only .svf and .xsvf files can be played.");
+        return;
+    }
+
+    // LittleFS first, then the SD card
+    if (!littleFsService.mounted()) littleFsService.begin();
+    bool onLittleFs = littleFsService.mounted() && littleFsService.exists(path);
+    File sdFile;
+    size_t fileSize = 0;
+    if (onLittleFs) {
+        fileSize = littleFsService.getFileSize(path);
     } else {
-        terminalView.println("\nJTAG: No device found on available GPIOs.");
+        bool sdMounted = sdService.configure(state.getSpiCLKPin(), state.getSpiMISOPin(),
+                                             state.getSpiMOSIPin(), state.getSpiCSPin());
+        if (sdMounted) sdFile = sdService.openFileRead(path);
+        if (!sdFile) {
+            terminalView.println("JTAG: " + path + " not found on LittleFS or SD card.");
+            sdService.end();
+            return;
+        }
+        fileSize = sdFile.size();
     }
+
+    configurePlayPins();
+    terminalView.println("\nJTAG: Playing " + path + " (" + std::to_string(fileSize) + " bytes)... Press [ENTER] to stop.");
+
+    // Progress every 2 s, ENTER stops between chunks
+    size_t done = 0;
+    uint32_t lastMs = millis();
+    auto forward = [&](const JtagService::VectorSink& sink, const uint8_t* data, size_t len) {
+        done += len;
+        uint32_t now = millis();
+        if (now - lastMs >= 2000) {
+            lastMs = now;
+            char c = terminalInput.readChar();
+            if (c == '\r' || c == '\n') return false;
+            terminalView.println("  " + std::to_string(done) + "/" + std::to_string(fileSize) + " bytes");
+        }
+        return sink(data, len);
+    };
+
+    JtagService::PlaybackReport report;
+    bool ok = jtagService.playVectors(xsvf, [&](const JtagService::VectorSink& sink) {
+        if (onLittleFs) {
+            return littleFsService.readChunks(path, [&](const uint8_t* data, size_t len) {
+                return forward(sink, data, len);
+            });
+        }
+        std::vector<uint8_t> buf(4096);
+        while (true) {
+            int n = sdFile.read(buf.data(), buf.size());
+            if (n <= 0) return n == 0;
+            if (!forward(sink, buf.data(), (size_t)n)) return false;
+        }
+    }, report);
+
+    if (!onLittleFs) {
+        sdFile.close();
+        sdService.end();
+    }
+
+    // Average over the whole file, waits included
+    uint32_t elapsedMs = report.elapsedUs / 1000;
+    uint32_t avgKhz = report.elapsedUs ? (uint32_t)(report.cycles * 1000 / report.elapsedUs) : 0;
+    std::string stats = std::to_string(report.cycles) + " TCK cycles in " + std::to_string(elapsedMs) + " ms, " +
+                        "average " + std::to_string(avgKhz) + " kHz, " +
+                        std::to_string(report.busMaxHz / 1000) + " kHz without delays";
+
+    if (ok) {
+        terminalView.println("\n  ✅ Played " + std::to_string(report.statements) + (xsvf ? " instructions, " : " statements, ") +
+                             std::to_string(report.shiftedBits) + " bits shifted.");
+        terminalView.println("  " + stats + ".\n");
+    } else if (report.stopped) {
+        terminalView.println("\nJTAG: Playback stopped (" + stats + ").");
+    } else {
+        std::string where = xsvf ? "offset " + std::to_string(report.position) : "line " + std::to_string(report.position);
+        terminalView.println("\nJTAG: ❌ " + report.error + " at " + where + ".");
+        terminalView.println("  " + stats + ".\n");
+    }
+}
+
+/*
+Play pins
+*/
+void JtagController::configurePlayPins() {
+    const std::vector<uint8_t> protectedPins = state.getProtectedPins();
+
+    uint8_t tck = userInputManager.readValidatedPinNumber("TCK pin", state.getJtagTckPin(), protectedPins);
+    uint8_t tms = userInputManager.readValidatedPinNumber("TMS pin", state.getJtagTmsPin(), protectedPins);
+    uint8_t tdi = userInputManager.readValidatedPinNumber("TDI pin", state.getJtagTdiPin(), protectedPins);
+    uint8_t tdo = userInputManager.readValidatedPinNumber("TDO pin", state.getJtagTdoPin(), protectedPins);
+    state.setJtagTckPin(tck);
+    state.setJtagTmsPin(tms);
+    state.setJtagTdiPin(tdi);
+    state.setJtagTdoPin(tdo);
+
+    bool hasTrst = userInputManager.readYesNo("TRST pin wired?", state.getJtagTrstPin() != 0xFF);
+    if (hasTrst) {
+        uint8_t defTrst = state.getJtagTrstPin() != 0xFF ? state.getJtagTrstPin() : 9;
+        state.setJtagTrstPin(userInputManager.readValidatedPinNumber("TRST pin", defTrst, protectedPins));
+    } else {
+        state.setJtagTrstPin(0xFF);
+    }
+
+    int trst = state.getJtagTrstPin() != 0xFF ? state.getJtagTrstPin() : -1;
+    jtagService.configureJtag(tck, tms, tdi, tdo, trst);
 }
 
 /*
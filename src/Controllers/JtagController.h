@@ -4,6 +4,8 @@
 #include "Interfaces/IInput.h"
 #include "Models/TerminalCommand.h"
 #include "Services/JtagService.h" 
+#include "Services/LittleFsService.h"
+#include "Services/SdService.h"
 #include "States/GlobalState.h"
 #include "Managers/UserInputManager.h"
 #include "Shells/HelpShell.h"
@@ -11,7 +13,7 @@
 class JtagController {
 public:
     // Constructor
-    JtagController(ITerminalView& terminalView, IInput& terminalInput, JtagService& jtagService, UserInputManager& userInputManager, HelpShell& helpShell);
+    JtagController(ITerminalView& terminalView, IInput& terminalInput, JtagService& jtagService, LittleFsService& littleFsService, SdService& sdService, UserInputManager& userInputManager, HelpShell& helpShell);
 
     // Entry point for dispatch incoming JTAG command
     void handleCommand(const TerminalCommand& cmd);
@@ -23,6 +25,8 @@ private:
     ITerminalView& terminalView;
     IInput& terminalInput;
     JtagService& jtagService;
+    LittleFsService& littleFsService;
+    SdService& sdService;
     UserInputManager& userInputManager;
     HelpShell& helpShell;
     bool configured = false;
@@ -37,6 +41,15 @@ private:
     // JTAG scan
     void handleScanJtag();
 
+    // Progress line with an ETA, ENTER cancels the scan
+    JtagService::ScanProgress makeProgress(const char* name);
+
+    // Play an SVF or XSVF file from LittleFS or the SD card
+    void handlePlay(const TerminalCommand& cmd);
+
+    // Ask for the TAP pins, defaults come from the last scan
+    void configurePlayPins();
+
     // Handle user configuration
     void handleConfig();
 
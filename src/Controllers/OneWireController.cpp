@@ -7,6 +7,8 @@ OneWireController::OneWireController(
     ITerminalView& terminalView, 
     IInput& terminalInput, 
     OneWireService& service, 
+    EdgeCaptureService& edgeCaptureService,
+    OneWireAnalyzer& oneWireAnalyzer,
     ArgTransformer& argTransformer,
     UserInputManager& userInputManager, 
     IbuttonShell& ibuttonShell,
@@ -16,6 +18,8 @@ OneWireController::OneWireController(
     : terminalView(terminalView), 
       terminalInput(terminalInput), 
       oneWireService(service), 
+      edgeCaptureService(edgeCaptureService),
+      oneWireAnalyzer(oneWireAnalyzer),
       argTransformer(argTransformer), 
       userInputManager(userInputManager), 
       ibuttonShell(ibuttonShell),
@@ -43,11 +47,9 @@ void OneWireController::handleCommand(const TerminalCommand& command) {
 Entry point for instructions
 */
 void OneWireController::handleInstruction(std::vector<ByteCode>& bytecodes) {
-    auto result = oneWireService.executeByteCode(bytecodes);
-    if (!result.empty()) {
-        terminalView.println("OneWire Read:\n");
-        terminalView.println(result);
-    }
+    TerminalResultSink sink(terminalView, "OneWire Read:\n");
+    oneWireService.executeByteCode(bytecodes, sink);
+    sink.flush();
 }
 
 /*
@@ -368,75 +370,72 @@ Sniff
 void OneWireController::handleSniff() {
     terminalView.println("OneWire Sniff: Oberserving data line... Press [ENTER] to stop.\n");
 
-    if (state.getTerminalMode() != TerminalTypeEnum::Standalone) {
-        terminalView.println(" [ℹ️  INFORMATION] ");
-        terminalView.println(" This feature uses very fast timing.");
-        terminalView.println(" The Web CLI may miss some signals,");
-        terminalView.println(" use Serial CLI for best results.\n");
-    }
-
-    // Init the pin to read passively
+    // Init the pin to read passively, edges are timestamped by interrupt
     uint8_t pin = state.getOneWirePin();
     pinMode(pin, INPUT);
+    oneWireAnalyzer.reset();
+    if (!edgeCaptureService.start(pin)) {
+        terminalView.println("OneWire Sniff: Failed to attach the edge interrupt.");
+        return;
+    }
 
-    // Read initial state of pin
-    int prev = digitalRead(pin);
-    unsigned long lastFall = micros();
+    EdgeCaptureService::Edge edges[128];
+    EdgeCaptureService::Edge lastFall{}, lastRise{};
+    bool haveFall = false, haveRise = false, idle = true;
+    std::vector<OneWireAnalyzer::Event> events;
+    uint32_t lastActivityMs = millis();
+    uint32_t reportedDrops = 0;
 
     while (true) {
         // Enter press
         auto c = terminalInput.readChar();
         if (c == '\r' || c == '\n' ) break;
-        
-        // Read current state of pin
-        int current = digitalRead(pin);
-        unsigned long now = micros();
 
-        // Detect a falling edge
-        if (prev == HIGH && current == LOW) {
-            lastFall = now;
+        size_t n = edgeCaptureService.read(edges, sizeof(edges) / sizeof(edges[0]));
+        for (size_t i = 0; i < n; ++i) {
+            const auto& e = edges[i];
+            if (!e.level) {
+                lastFall = e;
+                haveFall = true;
+            } else {
+                // Rising edge ends a LOW pulse, merged edges come out as a ~0 µs slot (a 1)
+                if (haveFall) {
+                    uint32_t lowUs = edgeCaptureService.elapsedUs(lastFall, e);
+                    uint32_t highUs = haveRise ? edgeCaptureService.elapsedUs(lastRise, lastFall) : UINT32_MAX;
+                    oneWireAnalyzer.feedLow(lowUs, highUs, events);
+                }
+                lastRise = e;
+                haveRise = true;
+            }
         }
 
-        // Detect a rising edge (end of a LOW pulse)
-        if (prev == LOW && current == HIGH) {
-            // Calculate duration of the LOW pulse
-            unsigned long duration = now - lastFall;
-            
-            // Too long, not mean anything
-            if (duration >= 3000) {
-                terminalView.println("[Non-Standard Pulse] " + std::to_string(duration) + " µs");
-            }
-            // Most likely a reset pulse
-            else if (duration >= 480) {
-                terminalView.println("[Reset] LOW for " + std::to_string(duration) + " µs");
-
-            // Most likely a presence pulse
-            } else if (duration >= 60 && duration <= 240) {
-                terminalView.println("[Presence] LOW for " + std::to_string(duration) + " µs");
-            
-            // Most likely a bit transmission
-            } else if (duration >= 10 && duration <= 70) {
-                // Want to sample ~15 µs after the falling edge
-                // which is the standard sampling time in the 1-Wire protocol
-                long elapsed = now - lastFall;
-                if (elapsed < 15) {
-                    delayMicroseconds(15 - elapsed);
-                }
-                
-                // Read the bit
-                int sample = digitalRead(pin);
-                terminalView.println("[Bit] LOW " + std::to_string(duration) +
-                                     " µs, Sample = " + std::to_string(sample));
+        if (n > 0) {
+            lastActivityMs = millis();
+            idle = false;
+        } else if (!idle && millis() - lastActivityMs > 20) {
+            // Bus went quiet, print what is left of the current byte
+            oneWireAnalyzer.flush(events);
+            idle = true;
+        }
 
-            // Unrecognized or noisy signal
-            } else {
-                terminalView.println("[Noise] LOW for " + std::to_string(duration) + " µs");
-            }
+        // One print per batch
+        if (!events.empty()) {
+            std::string out;
+            for (const auto& ev : events) out += OneWireAnalyzer::format(ev) + "\r\n";
+            terminalView.print(out);
+            events.clear();
+        }
+
+        uint32_t drops = edgeCaptureService.getDroppedCount();
+        if (drops != reportedDrops) {
+            terminalView.println("[Overflow] " + std::to_string(drops - reportedDrops) + " edges dropped");
+            reportedDrops = drops;
         }
 
-        // Update
-        prev = current;
+        if (n == 0) vTaskDelay(1);
     }
+
+    edgeCaptureService.stop();
     terminalView.println("\n\nOneWire Sniff: Stopped by user.");
 }
 
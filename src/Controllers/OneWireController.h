@@ -3,8 +3,11 @@
 #include <iomanip>
 
 #include "Services/OneWireService.h"
+#include "Services/EdgeCaptureService.h"
+#include "Analyzers/OneWireAnalyzer.h"
 #include "Interfaces/IInput.h"
 #include "Interfaces/ITerminalView.h"
+#include "Views/TerminalResultSink.h"
 #include "Models/TerminalCommand.h"
 #include "States/GlobalState.h"
 #include "Transformers/ArgTransformer.h"
@@ -20,6 +23,8 @@ public:
       ITerminalView& terminalView, 
       IInput& terminalInput, 
       OneWireService& service, 
+      EdgeCaptureService& edgeCaptureService,
+      OneWireAnalyzer& oneWireAnalyzer,
       ArgTransformer& argTransformer,
       UserInputManager& userInputManager, 
       IbuttonShell& ibuttonShell,
@@ -40,6 +45,8 @@ private:
     ITerminalView& terminalView;
     IInput& terminalInput;
     OneWireService& oneWireService;
+    EdgeCaptureService& edgeCaptureService;
+    OneWireAnalyzer& oneWireAnalyzer;
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
     IbuttonShell& ibuttonShell;
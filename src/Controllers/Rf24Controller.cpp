@@ -1,5 +1,6 @@
 #include "Controllers/Rf24Controller.h"
 #include "Vendors/wifi_atks.h"
+#include <algorithm>
 
 /*
 Entry point for rf24 commands
@@ -269,32 +270,40 @@ void Rf24Controller::handleSend() {
 Scan
 */
 void Rf24Controller::handleScan() {
-    uint32_t dwell = 128; // µs 
-    uint8_t levelHold[126 + 1] = {0}; // 0..200
+    uint8_t levelHold[Rf24Service::SWEEP_CHANNELS] = {0}; // 0..200
     uint8_t threshold = userInputManager.readValidatedUint8("High threshold (10..200)?", 20, 10, 200);
     int bestCh = -1;
     uint8_t bestVal = 0;
-    const uint8_t DECAY = 6;  // decay per sweep
+    const uint8_t DECAY = 6;  // decay per frame
     
     terminalView.println("RF24: Scanning channel 0 to 125... Press [ENTER] to stop.\n");
-    
-    rf24Service.initRx();
+
+    // The sweep runs on the other core, printing never slows it down
+    if (!rf24Service.startSweep()) {
+        terminalView.println("RF24: Failed to start the sweep.\n");
+        return;
+    }
+
+    Rf24Service::SweepTotals previous;
+    rf24Service.readSweep(previous);
+    uint8_t activity[Rf24Service::SWEEP_CHANNELS];
+    unsigned long lastFrame = millis();
+
     while (true) {
         // Cancel
         char c = terminalInput.readChar();
         if (c == '\n' || c == '\r') break;
 
-        // Sweep
-        for (uint8_t ch = 0; ch <= 125; ++ch) {
-            rf24Service.setChannel(ch);
-            rf24Service.startListening();
-            delayMicroseconds(dwell);
-            rf24Service.stopListening();
+        if (millis() - lastFrame < SCAN_FRAME_MS) {
+            delay(5);
+            continue;
+        }
+        lastFrame = millis();
+        if (!readSweepFrame(previous, activity)) continue;
 
-            // Measure
-            uint8_t instant = 0;
-            if (rf24Service.testRpd())          instant = 200;
-            else if (rf24Service.testCarrier()) instant = 120;
+        for (uint8_t ch = 0; ch < Rf24Service::SWEEP_CHANNELS; ++ch) {
+            // Any hit in the frame, stronger when the channel was busy for most sweeps
+            uint8_t instant = activity[ch] ? 120 + (activity[ch] * 80) / 100 : 0;
 
             // Decrease hold level
             if (levelHold[ch] > DECAY) levelHold[ch] -= DECAY;
@@ -320,6 +329,8 @@ void Rf24Controller::handleScan() {
         }
     }
 
+    rf24Service.stopSweep();
+
     // Result
     terminalView.println("");
     if (bestCh >= 0) {
@@ -342,6 +353,22 @@ void Rf24Controller::handleScan() {
     }
 }
 
+uint32_t Rf24Controller::readSweepFrame(Rf24Service::SweepTotals& previous, uint8_t* activity) {
+    Rf24Service::SweepTotals now;
+    rf24Service.readSweep(now);
+
+    uint32_t sweeps = now.sweeps - previous.sweeps;
+    if (sweeps == 0) return 0;
+
+    // Share of the frame's sweeps where the channel had energy
+    for (uint8_t ch = 0; ch < Rf24Service::SWEEP_CHANNELS; ++ch) {
+        uint32_t hits = now.hits[ch] - previous.hits[ch];
+        activity[ch] = (uint8_t)std::min<uint32_t>(100, (hits * 100 + sweeps - 1) / sweeps);
+    }
+    previous = now;
+    return sweeps;
+}
+
 /*
 Jam
 */
@@ -431,54 +458,56 @@ Sweep
 */
 void Rf24Controller::handleSweep() {
     // Params
-    int dwellMs  = userInputManager.readValidatedInt("Hold time per channel (ms)", 10, 10, 1000);
-    int samples  = userInputManager.readValidatedInt("Samples per channel", 80, 1, 100);
-    int thrPct   = userInputManager.readValidatedInt("Activity threshold (%)", 1, 0, 100);
+    int frameMs = userInputManager.readValidatedInt("Report interval (ms)", 500, 50, 10000);
+    int thrPct  = userInputManager.readValidatedInt("Activity threshold (%)", 1, 0, 100);
 
     terminalView.println("\nRF24 Sweep: channels 0–125"
-                         " | hold=" + std::to_string(dwellMs) + " ms"
-                         " | samples=" + std::to_string(samples) +
+                         " | report=" + std::to_string(frameMs) + " ms"
                          " | thr=" + std::to_string(thrPct) + "%... Press [ENTER] to stop.\n");
 
-    bool run = true;
-    while (run) {
-        for (int ch = 0; ch <= 125 && run; ++ch) {
-            // Cancel
-            char c = terminalInput.readChar();
-            if (c == '\n' || c == '\r') { run = false; break; }
-
-            rf24Service.setChannel(static_cast<uint8_t>(ch));
-
-            // Analyze activity
-            int hits = 0;
-            for (int s = 0; s < samples; ++s) {
-                rf24Service.startListening();
-                delayMicroseconds((dwellMs * 1000) / samples);
-                rf24Service.stopListening();
-                if (rf24Service.testRpd()) {
-                    hits += 2;
-                }
+    if (!rf24Service.startSweep()) {
+        terminalView.println("RF24 Sweep: Failed to start.\n");
+        return;
+    }
 
-                if  (rf24Service.testCarrier()) {
-                    hits++;
-                }
-            }
+    Rf24Service::SweepTotals previous;
+    rf24Service.readSweep(previous);
+    uint8_t activity[Rf24Service::SWEEP_CHANNELS];
+    unsigned long lastFrame = millis();
 
-            int activityPct = (hits * 100) / samples;
-            if (activityPct > 100) activityPct = 100;
+    while (true) {
+        // Cancel
+        char c = terminalInput.readChar();
+        if (c == '\n' || c == '\r') break;
 
-            // Log if above threshold
-            if (activityPct >= thrPct) {
-                terminalView.println(
-                    "  Channel " + std::to_string(ch) + " (" +
-                    std::to_string(2400 + ch) + " MHz)" +
-                    "  activity=" + std::to_string(activityPct) + "%"
-                );
-            }
+        if (millis() - lastFrame < (unsigned long)frameMs) {
+            delay(5);
+            continue;
+        }
+        unsigned long elapsed = millis() - lastFrame;
+        lastFrame = millis();
+
+        uint32_t sweeps = readSweepFrame(previous, activity);
+        if (!sweeps) continue;
+
+        bool any = false;
+        for (uint8_t ch = 0; ch < Rf24Service::SWEEP_CHANNELS; ++ch) {
+            // Log if above threshold, a channel with no hit never shows even at 0%
+            if (activity[ch] == 0 || activity[ch] < thrPct) continue;
+            terminalView.println(
+                "  Channel " + std::to_string(ch) + " (" +
+                std::to_string(2400 + ch) + " MHz)" +
+                "  activity=" + std::to_string(activity[ch]) + "%"
+            );
+            any = true;
+        }
+        if (any) {
+            terminalView.println("  -- " + std::to_string(sweeps) + " sweeps, " +
+                                 std::to_string(elapsed * 1000 / sweeps) + " us per sweep\n");
         }
     }
 
-    rf24Service.flushRx();
+    rf24Service.stopSweep();
     terminalView.println("\nRF24 Sweep: Stopped by user.\n");
 }
 
@@ -487,78 +516,63 @@ Waterfall
 */
 void Rf24Controller::handleWaterfall()
 {
-    // Window ms per channel
-    int dwellMs = userInputManager.readValidatedInt("Hold time per channel (ms)", 10, 2, 2000);
+    // One screen refresh per frame, the sweep runs underneath at full speed
+    int frameMs = userInputManager.readValidatedInt("Refresh period (ms)", 100, 20, 2000);
 
     terminalView.println("\nRF24 Waterfall: Displaying on the ESP32 screen... Press [ENTER] to stop.\n");
-    
-    // sampling period 160µs so RPD has time to latch
-    const uint8_t SAMPLE_PERIOD_US = 160;
-    int samples = (dwellMs * 1000) / SAMPLE_PERIOD_US;
-    uint8_t ch = 0;
-    int bestChannel = -1;
-    int bestLevel   = 0;
-    std::string title = "Peak: --";
 
-    rf24Service.initRx();
+    if (!rf24Service.startSweep()) {
+        terminalView.println("RF24 Waterfall: Failed to start.\n");
+        return;
+    }
+
+    Rf24Service::SweepTotals previous;
+    rf24Service.readSweep(previous);
+    uint8_t activity[Rf24Service::SWEEP_CHANNELS];
+    unsigned long lastFrame = millis();
 
     while (true) {
         // Cancel on ENTER
         char c = terminalInput.readChar();
         if (c == '\n' || c == '\r') break;
 
-        rf24Service.setChannel((uint8_t)ch);
-
-        // Same logic as sweep
-        int hits = 0;
-        for (int s = 0; s < samples; ++s) {
-            rf24Service.startListening();
-            delayMicroseconds((dwellMs * 1000) / samples);
-            rf24Service.stopListening();
-
-            if (rf24Service.testRpd())   hits += 2;
-            if (rf24Service.testCarrier()) hits += 1;
+        if (millis() - lastFrame < (unsigned long)frameMs) {
+            delay(2);
+            continue;
         }
-
-        // normalization
-        int level = (hits * 100) / samples;
-        if (level < 1) level = 1; // see the waterfall progress
-        if (level > 100) level = 100;
-
-        if (level > bestLevel) {
-            bestLevel = level;
-            bestChannel = ch;
+        lastFrame = millis();
+        if (!readSweepFrame(previous, activity)) continue;
+
+        // Peak of the frame for the title
+        int bestChannel = -1;
+        int bestLevel = 1;
+        for (uint8_t ch = 0; ch < Rf24Service::SWEEP_CHANNELS; ++ch) {
+            if (activity[ch] > bestLevel) {
+                bestLevel = activity[ch];
+                bestChannel = ch;
+            }
         }
-
-        // Update title with best channel
-        if (bestChannel >= 0 && bestLevel > 1) {
-            title = "Peak: CH" + std::to_string(bestChannel) +
-                    " (" + std::to_string(2400 + bestChannel) + "MHz)";
+        std::string title = bestChannel >= 0
+            ? "Peak: CH" + std::to_string(bestChannel) + " (" + std::to_string(2400 + bestChannel) + "MHz)"
+            : "Peak: --";
+
+        // Draw the whole band
+        for (uint8_t ch = 0; ch < Rf24Service::SWEEP_CHANNELS; ++ch) {
+            int level = activity[ch];
+            if (level < 1) level = 1; // see the waterfall progress
+            deviceView.drawWaterfall(
+                title,
+                0.0f,
+                125.0f,
+                "ch",
+                ch,
+                Rf24Service::SWEEP_CHANNELS,
+                level
+            );
         }
-
-        // Draw the line for this channel
-        deviceView.drawWaterfall(
-            title,
-            0.0f,
-            125.0f,
-            "ch",
-            ch,
-            126,
-            level
-        );
-
-        // Update channel, reset at 0
-        if (ch == 0) {
-            title = "Peak: --";
-            bestChannel = -1;
-            bestLevel = 0;
-        }
-        ch++;
-        if (ch > 125) ch = 0;
     }
 
-    rf24Service.stopListening();
-    rf24Service.flushRx();
+    rf24Service.stopSweep();
     terminalView.println("RF24 Waterfall: Stopped by user.\n");
 }
 
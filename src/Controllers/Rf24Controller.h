@@ -52,6 +52,9 @@ private:
     void handleSetChannel();
     void handleHelp();
 
+    // Activity per channel (0..100) since the previous frame, returns the sweeps it covers
+    uint32_t readSweepFrame(Rf24Service::SweepTotals& previous, uint8_t* activity);
+
 private:
     ITerminalView& terminalView;
     IInput& terminalInput;
@@ -64,4 +67,6 @@ private:
     GlobalState& state = GlobalState::getInstance();
 
     bool configured = false;
+
+    static constexpr unsigned long SCAN_FRAME_MS = 100;
 };
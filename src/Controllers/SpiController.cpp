@@ -39,11 +39,9 @@ void SpiController::handleCommand(const TerminalCommand& cmd) {
 Entry point for instructions
 */
 void SpiController::handleInstruction(const std::vector<ByteCode>& bytecodes) {
-    auto result = spiService.executeByteCode(bytecodes);
-    if (!result.empty()) {
-        terminalView.println("SPI Read:\n");
-        terminalView.println(result);
-    }
+    TerminalResultSink sink(terminalView, "SPI Read:\n");
+    spiService.executeByteCode(bytecodes, sink);
+    sink.flush();
 }
 
 /*
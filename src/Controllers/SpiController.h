@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Interfaces/ITerminalView.h"
+#include "Views/TerminalResultSink.h"
 #include "Services/SpiService.h" 
 #include "Services/SdService.h"
 #include "Interfaces/IInput.h"
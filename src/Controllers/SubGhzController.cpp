@@ -1,4 +1,5 @@
 #include "SubGhzController.h"
+#include <esp_timer.h>
 
 /*
 Entry point for commands
@@ -43,7 +44,8 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
     int rssiThr = userInputManager.readValidatedInt("RSSI threshold detection (dBm):", -67, -127, 0);
 
     // Prepare the scan
-    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true)) {
+    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true) ||
+        !subGhzService.prepareScan(freqs)) {
         terminalView.println("SUBGHZ: Not detected. Run 'config' first.");
         return;
     }
@@ -53,6 +55,7 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
 
     std::vector<int>  best(freqs.size(), -127);
     std::vector<bool> wasAbove(freqs.size(), false);
+    SubGhzService::ScanFrame frame;
     bool stopRequested = false;
 
     // Scanning
@@ -62,17 +65,15 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
             int c = terminalInput.readChar();
             if (c == '\n' || c == '\r') { stopRequested = true; break; }
 
-            // Set the freq
-            float f = freqs[i];
-            subGhzService.tune(f);
-
-            // Measure peak on freq for ms
-            int peak = subGhzService.measurePeakRssi(holdMs);
+            // Retune and measure peak on freq for ms
+            subGhzService.scanStep(i, holdMs * 1000, frame);
+            int peak = frame.peak;
             if (peak > best[i]) best[i] = peak;
 
             // Log spike if any
             if (peak >= rssiThr && !wasAbove[i]) {
-                terminalView.println(" [PEAK] f=" + argTransformer.toFixed2(f) + " MHz  RSSI=" + std::to_string(peak) + " dBm");
+                terminalView.println(" [PEAK] f=" + argTransformer.toFixed2(frame.mhz) + " MHz  RSSI=" + std::to_string(peak) +
+                                     " dBm  avg=" + std::to_string(frame.avg) + " dBm");
                 wasAbove[i] = true;
             } else if (peak < rssiThr - 2) {
                 wasAbove[i] = false;
@@ -80,6 +81,8 @@ void SubGhzController::handleScan(const TerminalCommand& cmd) {
         }
     }
 
+    subGhzService.endScan();
+
     // Summary
     std::vector<size_t> idx(freqs.size());
     std::iota(idx.begin(), idx.end(), 0);
@@ -418,16 +421,18 @@ void SubGhzController::handleRaw(const TerminalCommand&) {
     terminalView.println("SUBGHZ Raw: Frequency @ " + std::to_string(f) + " MHz... Press [ENTER] to stop\n");
     
     subGhzService.startRawSniffer(state.getSubGhzGdoPin());
+    std::vector<rmt_symbol_word_t> symbols;
     while (true) {
         char c = terminalInput.readChar();
         if (c == '\n' || c == '\r') {
             break;
         }
 
-        auto [line, pulseCount] = subGhzService.readRawPulses();
+        auto [line, pulseCount] = subGhzService.readRawPulses(capture ? &symbols : nullptr);
         if (pulseCount > 8) { // ignore too short frames, likely noise
             count += pulseCount;
             terminalView.println(line);
+            if (capture) recordSymbols(symbols);
         }
     }
     subGhzService.stopRawSniffer();
@@ -468,6 +473,7 @@ void SubGhzController::handleDecode(const TerminalCommand&) {
         if (!frame.empty() && frame.size() >= 5) {
             auto result = subGhzAnalyzer.analyzeFrame(frame, subGhzService.getRxTickPerUs());
             terminalView.println(result);
+            if (capture) recordSymbols(frame);
         }
     }
 
@@ -481,11 +487,46 @@ Receive
 void SubGhzController::handleReceive(const TerminalCommand& cmd) {
     // Ask for raw or decoded
     auto confirm = userInputManager.readYesNo("Decode received signals to frames?", true);
+
+    // Pulses can be streamed to a VCD/sigrok file for offline decoding
+    if (userInputManager.readYesNo("Record pulses to a capture file?", false)) {
+        capture = captureExportShell.open("subghz");
+        uint32_t rate = subGhzService.getRxTickPerUs() * 1000000UL;
+        if (capture && !capture->begin({ "GDO0" }, rate ? rate : 1000000UL)) capture.reset();
+        lastFrameUs = esp_timer_get_time();
+    }
+
     if (confirm) {
         handleDecode(cmd);
     } else {
         handleRaw(cmd);
     }
+
+    captureExportShell.close(capture);
+}
+
+/*
+Record symbols
+*/
+void SubGhzController::recordSymbols(const std::vector<rmt_symbol_word_t>& symbols) {
+    uint32_t tickPerUs = subGhzService.getRxTickPerUs();
+    if (tickPerUs == 0) tickPerUs = 1;
+
+    uint32_t frameTicks = 0;
+    for (const auto& s : symbols) frameTicks += s.duration0 + s.duration1;
+
+    // Frames are handed over after they end, estimate the idle time before this one
+    // 64-bit, at 80 ticks/us a 32-bit product wraps after under a minute of silence
+    uint64_t now = esp_timer_get_time();
+    uint64_t elapsedTicks = (now - lastFrameUs) * tickPerUs;
+    uint64_t idleTicks = elapsedTicks > frameTicks ? elapsedTicks - frameTicks : 1;
+    capture->append(0, (uint32_t)std::min<uint64_t>(idleTicks, UINT32_MAX));
+    lastFrameUs = now;
+
+    for (const auto& s : symbols) {
+        if (s.duration0) capture->append(s.level0, s.duration0);
+        if (s.duration1) capture->append(s.level1, s.duration1);
+    }
 }
 
 /*
@@ -556,7 +597,8 @@ void SubGhzController::handleWaterfall()
     int windowMs = userInputManager.readValidatedInt("Hold time per frequency (ms)", defaultWindow, 2, 2000);
 
     // Profile
-    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true)) {
+    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true) ||
+        !subGhzService.prepareScan(freqs)) {
         terminalView.println("SUBGHZ: Not configured. Run 'config' first.");
         return;
     }
@@ -571,6 +613,7 @@ void SubGhzController::handleWaterfall()
     int bestDbm = -127;
     float bestFreq = 0.0f;
     std::string title;
+    SubGhzService::ScanFrame frame;
     size_t i = 0;
 
     while (true) {
@@ -590,15 +633,12 @@ void SubGhzController::handleWaterfall()
             bestFreq = 0.0f;
         }
 
-        // tune
-        float f = freqs[i];
-        subGhzService.tune(f);
-
-        // measure
-        int peak = subGhzService.measurePeakRssi(windowMs);
+        // tune and measure
+        subGhzService.scanStep(i, windowMs * 1000, frame);
+        int peak = frame.peak;
         if (peak > bestDbm) {
             bestDbm = peak;
-            bestFreq = f;
+            bestFreq = frame.mhz;
         }
 
         // Clamp RSSI
@@ -626,6 +666,7 @@ void SubGhzController::handleWaterfall()
         if (i >= freqs.size()) i = 0;
     }
 
+    subGhzService.endScan();
     subGhzService.tune(state.getSubGhzFrequency());
     terminalView.println("SUBGHZ Waterfall: Stopped by user.\n");
 }
@@ -650,7 +691,8 @@ void SubGhzController::handleSweep() {
     int thrDbm   = userInputManager.readValidatedInt("RSSI threshold (dBm)",        -67, -120, 0);
 
     // Scan profile
-    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true)) {
+    if (!subGhzService.applyScanProfile(4.8f, 200.0f, 2 /* OOK */, true) ||
+        !subGhzService.prepareScan(freqs)) {
         terminalView.println("SUBGHZ: Not configured. Run 'config' first.");
         return;
     }
@@ -661,6 +703,7 @@ void SubGhzController::handleSweep() {
                          " | thr=" + std::to_string(thrDbm) + " dBm... Press [ENTER] to stop.\n");
     
     // Sweep and analyze each frequency
+    SubGhzService::ScanFrame frame;
     bool run = true;
     while (run) {
         for (size_t i = 0; i < freqs.size() && run; ++i) {
@@ -670,12 +713,15 @@ void SubGhzController::handleSweep() {
 
             // Tune
             float f = freqs[i];
-            subGhzService.tune(f);
+            subGhzService.retuneScan(i);
 
-            // Analyze
+            // Analyze, windows are sampled on the same tuning
             auto line = subGhzAnalyzer.analyzeFrequencyActivity(dwellMs, windowMs, thrDbm,
                 // measure(windowMs)
-                [&](int winMs){ return subGhzService.measurePeakRssi(winMs); },
+                [&](int winMs){
+                    subGhzService.sampleRssi(winMs * 1000, frame);
+                    return frame.peak;
+                },
                 // shouldAbort()
                 [&](){
                     char cc = terminalInput.readChar();
@@ -691,6 +737,8 @@ void SubGhzController::handleSweep() {
         }
     }
 
+    subGhzService.endScan();
+    subGhzService.tune(state.getSubGhzFrequency());
     terminalView.println("\nSUBGHZ Sweep: Stopped by user.\n");
 }
 
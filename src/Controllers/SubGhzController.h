@@ -21,6 +21,7 @@
 #include "Services/I2sService.h"
 #include "Data/SubGhzProtocols.h"
 #include "Shells/HelpShell.h"
+#include "Shells/CaptureExportShell.h"
 
 class SubGhzController {
 public:
@@ -35,7 +36,8 @@ public:
                      SubGhzTransformer& subGhzTransformer,
                      UserInputManager& userInputManager,
                      SubGhzAnalyzer& subGhzAnalyzer,
-                     HelpShell& helpShell)
+                     HelpShell& helpShell,
+                     CaptureExportShell& captureExportShell)
     : terminalView(terminalView),
       terminalInput(terminalInput),
       deviceView(deviceView),
@@ -47,7 +49,8 @@ public:
       subGhzTransformer(subGhzTransformer),
       userInputManager(userInputManager),
       subGhzAnalyzer(subGhzAnalyzer),
-      helpShell(helpShell) {}
+      helpShell(helpShell),
+      captureExportShell(captureExportShell) {}
 
     // Entry point for subghz commands
     void handleCommand(const TerminalCommand& cmd);
@@ -83,6 +86,9 @@ private:
     // Decode signals or receive raw symbols
     void handleReceive(const TerminalCommand& cmd);
 
+    // Append received symbols to the open capture file
+    void recordSymbols(const std::vector<rmt_symbol_word_t>& symbols);
+
     // Show signal trace
     void handleTrace();
 
@@ -126,7 +132,12 @@ private:
     UserInputManager& userInputManager;
     SubGhzAnalyzer& subGhzAnalyzer;
     HelpShell& helpShell;
+    CaptureExportShell& captureExportShell;
     GlobalState& state = GlobalState::getInstance();
 
     bool configured = false;
+
+    // Optional capture file for receive
+    std::unique_ptr<ICaptureWriter> capture;
+    uint64_t lastFrameUs = 0;
 };
@@ -16,7 +16,8 @@ UartController::UartController(
     UserInputManager& userInputManager,
     UartAtShell& uartAtShell,
     HelpShell& helpShell,
-    UartEmulationShell& uartEmulationShell
+    UartEmulationShell& uartEmulationShell,
+    UartBridgeShell& uartBridgeShell
 )
     : terminalView(terminalView),
       terminalInput(terminalInput),
@@ -29,7 +30,8 @@ UartController::UartController(
       userInputManager(userInputManager),
       uartAtShell(uartAtShell),
       helpShell(helpShell),
-      uartEmulationShell(uartEmulationShell)
+      uartEmulationShell(uartEmulationShell),
+      uartBridgeShell(uartBridgeShell)
 {}
 
 
@@ -45,7 +47,7 @@ void UartController::handleCommand(const TerminalCommand& cmd) {
     else if (cmd.getRoot() == "readraw") handleRaw();
     else if (cmd.getRoot() == "readhex") handleRaw();
     else if (cmd.getRoot() == "write") handleWrite(cmd);
-    else if (cmd.getRoot() == "bridge") handleBridge();
+    else if (cmd.getRoot() == "bridge") handleBridge(cmd);
     else if (cmd.getRoot() == "at") handleAtCommand(cmd);
     else if (cmd.getRoot() == "emulator") handleEmulation();
     else if (cmd.getRoot() == "trigger") handleTrigger(cmd);
@@ -61,13 +63,16 @@ void UartController::handleCommand(const TerminalCommand& cmd) {
 Entry point for instructions
 */
 void UartController::handleInstruction(const std::vector<ByteCode>& bytecodes) {
-    auto result = uartService.executeByteCode(bytecodes);
     terminalView.println("");
     terminalView.print("UART Read: ");
-    if (!result.empty()) {
-        terminalView.println("");
+
+    // Received text is printed as it comes
+    TerminalResultSink sink(terminalView, "\n", false);
+    uartService.executeByteCode(bytecodes, sink);
+    sink.flush();
+
+    if (sink.getByteCount() > 0) {
         terminalView.println("");
-        terminalView.println(result);
         uartService.clearUartBuffer();
     } else {
         terminalView.print("No data");
@@ -78,28 +83,26 @@ void UartController::handleInstruction(const std::vector<ByteCode>& bytecodes) {
 /*
 Bridge
 */
-void UartController::handleBridge() {
-    terminalView.println("Uart Bridge: In progress... Press [ANY ESP32 BUTTON] to stop.\n");
-    while (true) {
-        // Read from UART and print to terminal
-        if (uartService.available()) {
-            char c = uartService.read();
-            terminalView.print(std::string(1, c));
-        }
-
-        // Read from user input and write to UART
-        char c = terminalInput.readChar();
-        if (c != KEY_NONE) {
-            uartService.write(c);
-        }
-        
-        // Read from device input and stop bridge if any
-        c = deviceInput.readChar();
-        if (c != KEY_NONE) {  
-            terminalView.println("\r\nUart Bridge: Stopped by user.\n");
-            break;
-        }
-    }
+void UartController::handleBridge(const TerminalCommand& cmd) {
+    // bridge [stats] [cap]
+    std::string args = cmd.getSubcommand() + " " + cmd.getArgs();
+    bool stats = args.find("stats") != std::string::npos;
+    bool capture = args.find("cap") != std::string::npos;
+
+    UartBridgeShell::Port port;
+    port.name = "UART";
+    port.read = [this](uint8_t* buf, size_t len) { return uartService.readBytes(buf, len); };
+    port.write = [this](const uint8_t* buf, size_t len) { return uartService.writeBytes(buf, len); };
+    port.overflows = [this, seen = (uint32_t)0]() mutable {
+        uint32_t count = uartService.getOverflowCount();
+        uint32_t delta = count - seen;
+        seen = count;
+        return delta;
+    };
+
+    uartService.startOverflowCounter();
+    uartBridgeShell.run(port, capture, stats);
+    uartService.stopOverflowCounter();
 }
 
 /*
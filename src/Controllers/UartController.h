@@ -9,6 +9,7 @@
 #include "Services/HdUartService.h"
 #include "Services/SdService.h"
 #include "Interfaces/ITerminalView.h"
+#include "Views/TerminalResultSink.h"
 #include "Interfaces/IInput.h"
 #include "Interfaces/IDeviceView.h"
 #include "States/GlobalState.h"
@@ -17,6 +18,7 @@
 #include "Shells/UartAtShell.h"
 #include "Shells/HelpShell.h"
 #include "Shells/UartEmulationShell.h"
+#include "Shells/UartBridgeShell.h"
 
 class UartController {
 public:
@@ -32,7 +34,8 @@ public:
                    UserInputManager& userInputManager,
                    UartAtShell& uartAtShell,
                    HelpShell& helpShell,
-                   UartEmulationShell& uartEmulationShell);
+                   UartEmulationShell& uartEmulationShell,
+                   UartBridgeShell& uartBridgeShell);
     
     // Entry point for UART command
     void handleCommand(const TerminalCommand& cmd);
@@ -45,7 +48,7 @@ public:
     
 private:
     // Start bidirectional UART bridge
-    void handleBridge();
+    void handleBridge(const TerminalCommand& cmd);
     
     // Perform ascii read
     void handleRead(const TerminalCommand& cmd);
@@ -110,6 +113,7 @@ private:
     UartAtShell& uartAtShell;
     HelpShell& helpShell;
     UartEmulationShell& uartEmulationShell;
+    UartBridgeShell& uartBridgeShell;
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
     bool scanCancelled = false;
@@ -1,4 +1,5 @@
 #include "Controllers/UtilityController.h"
+#include "driver/gpio.h"
 
 /*
 Constructor
@@ -8,31 +9,41 @@ UtilityController::UtilityController(
     IDeviceView& deviceView,
     IInput& terminalInput,
     PinService& pinService,
+    LogicCaptureService& logicCaptureService,
     I2sService& i2sService,
     UserInputManager& userInputManager,
+    BatchEdgeCaptureService& batchEdgeCaptureService,
     PinAnalyzer& pinAnalyzer,
+    BusAnalyzer& busAnalyzer,
     AliasManager& aliasManager,
     ArgTransformer& argTransformer,
     TerminalCommandTransformer& commandTransformer,
+    PinoutTransformer& pinoutTransformer,
     SysInfoShell& sysInfoShell,
     GuideShell& guideShell,
     HelpShell& helpShell,
-    ProfileShell& profileShell
+    ProfileShell& profileShell,
+    CaptureExportShell& captureExportShell
 )
     : terminalView(terminalView),
       deviceView(deviceView),
       terminalInput(terminalInput),
       pinService(pinService),
+      logicCaptureService(logicCaptureService),
       i2sService(i2sService),
       userInputManager(userInputManager),
+      batchEdgeCaptureService(batchEdgeCaptureService),
       pinAnalyzer(pinAnalyzer),
+      busAnalyzer(busAnalyzer),
       aliasManager(aliasManager),
       commandTransformer(commandTransformer),
       argTransformer(argTransformer),
+      pinoutTransformer(pinoutTransformer),
       sysInfoShell(sysInfoShell),
       guideShell(guideShell),
       helpShell(helpShell),
-      profileShell(profileShell)
+      profileShell(profileShell),
+      captureExportShell(captureExportShell)
 {}
 
 /*
@@ -233,37 +244,103 @@ Logic
 */
 void UtilityController::handleLogicAnalyzer(const TerminalCommand& cmd) {
 
-    uint16_t tDelay = 500;
+    uint16_t tDelay = 500; // sample period in us
     uint16_t inc = 100; // tDelay will be decremented/incremented by inc
     uint8_t step = 1; // step of the trace display kind of a zoom
 
     if (cmd.getSubcommand().empty() || !argTransformer.isValidNumber(cmd.getSubcommand())) {
-        terminalView.println("Usage: logic <pin>");
+        terminalView.println("Usage: logic <pin> [pin ...] [trig]");
         return;
     }
 
-    // Verify protected pin
-    uint8_t pin = argTransformer.toUint8(cmd.getSubcommand());
-    /*
-    auto forbidden = state.getProtectedPins();
-    if (std::find(forbidden.begin(), forbidden.end(), pin) != forbidden.end()) {
-        terminalView.println("Logic Analyzer: This pin is protected or reserved.");
+    // Channels and options
+    std::vector<uint8_t> pins = { argTransformer.toUint8(cmd.getSubcommand()) };
+    bool withTrigger = false;
+    for (const auto& arg : argTransformer.splitArgs(cmd.getArgs())) {
+        if (arg == "trig" || arg == "t") {
+            withTrigger = true;
+        } else if (argTransformer.isValidNumber(arg)) {
+            uint8_t p = argTransformer.toUint8(arg);
+            if (std::find(pins.begin(), pins.end(), p) == pins.end()) pins.push_back(p);
+        } else {
+            terminalView.println("Usage: logic <pin> [pin ...] [trig]");
+            return;
+        }
+    }
+
+    if (pins.size() > LogicCaptureService::MAX_CHANNELS) {
+        terminalView.println("Logic Analyzer: Up to " + std::to_string(LogicCaptureService::MAX_CHANNELS) + " pins can be captured.");
         return;
     }
-*/
-    if (state.isPinProtected(pin)) {
-        terminalView.println("Logic Analyzer: This pin is protected or reserved.");
+
+    // Verify protected pins
+    for (auto pin : pins) {
+        if (state.isPinProtected(pin)) {
+            terminalView.println("Logic Analyzer: Pin " + std::to_string(pin) + " is protected or reserved.");
+            return;
+        }
+    }
+
+    // Trigger setup
+    LogicTriggerEnum trigger = LogicTriggerEnum::None;
+    uint8_t triggerChannel = 0, patternMask = 0, patternValue = 0;
+    uint32_t preTrigger = 0;
+    uint32_t postTrigger = LOGIC_TRACE_SAMPLES;
+    if (withTrigger) {
+        std::vector<std::string> choices = {
+            LogicTriggerEnumMapper::toString(LogicTriggerEnum::Rising),
+            LogicTriggerEnumMapper::toString(LogicTriggerEnum::Falling),
+            LogicTriggerEnumMapper::toString(LogicTriggerEnum::Edge),
+            LogicTriggerEnumMapper::toString(LogicTriggerEnum::Pattern)
+        };
+        int index = userInputManager.readValidatedChoiceIndex("Trigger", choices, 0);
+        trigger = static_cast<LogicTriggerEnum>(index + 1);
+
+        if (trigger == LogicTriggerEnum::Pattern) {
+            uint8_t all = (1u << pins.size()) - 1;
+            patternMask = userInputManager.readValidatedHex("Pattern mask (bit n = pin n)", all, 0, all);
+            patternValue = userInputManager.readValidatedHex("Pattern value", 0, 0, all);
+        } else if (pins.size() > 1) {
+            triggerChannel = userInputManager.readValidatedChoiceIndex("Trigger pin", std::vector<int>(pins.begin(), pins.end()), 0);
+        }
+
+        uint32_t rate = userInputManager.readValidatedUint32("Sample rate (Hz)", 1000000UL / tDelay);
+        tDelay = rate ? std::max<uint32_t>(1, std::min<uint32_t>(10000, 1000000UL / rate)) : tDelay;
+        preTrigger = userInputManager.readValidatedUint32("Pre-trigger samples", LOGIC_TRACE_SAMPLES / 4);
+        postTrigger = userInputManager.readValidatedUint32("Post-trigger samples", LOGIC_TRACE_SAMPLES);
+        if (postTrigger == 0) postTrigger = 1;
+    }
+
+    for (auto pin : pins) pinService.setInput(pin);
+    if (!logicCaptureService.configure(pins, 1000000UL / tDelay)) {
+        terminalView.println("Logic Analyzer: Invalid pin selection.");
         return;
     }
-    terminalView.println("\nLogic Analyzer: Monitoring pin " + std::to_string(pin) + "... Press [ENTER] to stop.");
-    terminalView.println("Displaying waveform on the ESP32 screen...\n");
+    logicCaptureService.setTrigger(trigger, triggerChannel, patternMask, patternValue);
 
+    bool started = withTrigger ? logicCaptureService.start(preTrigger, postTrigger)
+                               : logicCaptureService.startFreeRunning(LOGIC_TRACE_SAMPLES);
+    if (!started) {
+        terminalView.println("Logic Analyzer: Failed to start capture, not enough memory.");
+        logicCaptureService.release();
+        return;
+    }
 
-    pinService.setInput(pin);
-    std::vector<uint8_t> buffer;
-    buffer.reserve(320); // 320 samples
+    std::string pinList;
+    for (auto pin : pins) pinList += (pinList.empty() ? "" : ", ") + std::to_string(pin);
+    terminalView.println("\nLogic Analyzer: Monitoring pin " + pinList + "... Press [ENTER] to stop.");
+    if (pins.size() > 1) terminalView.println("Press [c] to change the pin shown on the ESP32 screen.");
+    if (withTrigger) {
+        terminalView.println("Trigger: " + LogicTriggerEnumMapper::toString(trigger) + ", [r] to re-arm, [a]/[d] to scroll, [w] to save.");
+        terminalView.println("Waiting for trigger...");
+    }
+    terminalView.println("Displaying waveform on the ESP32 screen...\n");
 
     unsigned long lastCheck = millis();
+    uint8_t channel = 0;
+    uint32_t viewStart = 0;
+    bool captured = false;
+    bool redraw = false;
     deviceView.clear();
     deviceView.topBar("Logic Analyzer", false, false);
 
@@ -275,7 +352,7 @@ void UtilityController::handleLogicAnalyzer(const TerminalCommand& cmd) {
             if (c == '\r' || c == '\n') {
                 // fdufnews 2025/10/24 added to restore cursor position when leaving
                 if (state.getTerminalMode() == TerminalTypeEnum::SerialPort)
-                    terminalView.print("\n\n\n\n\r"); // 4 lines down to place cursor just under the logic trace
+                    terminalView.print(std::string(pins.size() + 3, '\n') + "\r"); // lines down to place cursor just under the logic traces
                 terminalView.println("Logic Analyzer: Stopped by user.");
                 break;
             }
@@ -283,10 +360,16 @@ void UtilityController::handleLogicAnalyzer(const TerminalCommand& cmd) {
                 if (tDelay > inc){
                     tDelay -= inc;
                     terminalView.println("delay : " + std::to_string(tDelay) + "\n");
+                } else if (tDelay > 1) {
+                    tDelay /= 2;
+                    terminalView.println("delay : " + std::to_string(tDelay) + "\n");
                 }
             };
             if (c == 'S'){
-                if (tDelay < 10000){
+                if (tDelay < inc){
+                    tDelay = std::min<uint16_t>(inc, tDelay * 2);
+                    terminalView.println("delay : " + std::to_string(tDelay) + "\n");
+                } else if (tDelay < 10000){
                     tDelay += inc;
                     terminalView.println("delay : " + std::to_string(tDelay) + "\n");
                 }
@@ -295,37 +378,135 @@ void UtilityController::handleLogicAnalyzer(const TerminalCommand& cmd) {
                 if (step > 1){
                     step--;
                     terminalView.println("step : " + std::to_string(step) + "\n");
+                    redraw = captured;
                 }
             };
             if (c == 'Z'){
                 if (step < 4){
                     step++;
                     terminalView.println("step : " + std::to_string(step) + "\n");
+                    redraw = captured;
                 }
             };
+            if (c == 'c' && pins.size() > 1) {
+                channel = (channel + 1) % pins.size();
+                redraw = captured;
+            }
+            if (withTrigger && captured) {
+                uint32_t total = logicCaptureService.getSampleCount();
+                if (c == 'a' && viewStart > 0) {
+                    viewStart = viewStart > LOGIC_TRACE_SAMPLES / 2 ? viewStart - LOGIC_TRACE_SAMPLES / 2 : 0;
+                    redraw = true;
+                }
+                if (c == 'd' && viewStart + LOGIC_TRACE_SAMPLES < total) {
+                    viewStart += LOGIC_TRACE_SAMPLES / 2;
+                    redraw = true;
+                }
+                if (c == 'w') {
+                    if (state.getTerminalMode() == TerminalTypeEnum::SerialPort)
+                        terminalView.print(std::string(pins.size() + 3, '\n') + "\r");
+                    saveLogicCapture();
+                    redraw = true;
+                }
+                if (c == 'r') {
+                    logicCaptureService.setSampleRate(1000000UL / tDelay);
+                    if (logicCaptureService.start(preTrigger, postTrigger)) {
+                        captured = false;
+                        terminalView.println("Waiting for trigger...");
+                    } else {
+                        terminalView.println("Logic Analyzer: Failed to re-arm, previous capture kept.");
+                    }
+                }
+            }
         }
 
-        // Draw
-        if (buffer.size() >= 320) {
-            buffer.resize(320);
-            deviceView.drawLogicTrace(pin, buffer, step);
-
-            // The poor man's drawLogicTrace() on terminal
-            // draws a 132 samples sub part of the buffer to speed up the things
-            if (state.getTerminalMode() == TerminalTypeEnum::SerialPort){
-                terminalView.println("");
-                uint8_t pos = 0;
-                for(size_t i = 0; i < 132; i++, pos++){
-                     terminalView.print(buffer[i]?"-":"_");
-                }
-                terminalView.print("\r\x1b[A");  // Up 1 line to put cursor at the correct place for the next draw
+        if (redraw) {
+            drawLogicCapture(channel, viewStart, step);
+            redraw = false;
+        }
+
+        // Free running, the sampler task waits on each frame until it is drawn
+        if (!withTrigger) {
+            if (logicCaptureService.isFrameReady()) {
+                drawLogicCapture(channel, 0, step);
+                logicCaptureService.setSampleRate(1000000UL / tDelay);
+                logicCaptureService.nextFrame();
             }
-            buffer.clear();
+            continue;
         }
 
-        buffer.push_back(pinService.read(pin));
-        delayMicroseconds(tDelay);
+        if (captured || logicCaptureService.isRunning()) continue;
+
+        // Capture completed
+
+        captured = true;
+        uint32_t triggerAt = logicCaptureService.getTriggerSample();
+        viewStart = triggerAt > LOGIC_TRACE_SAMPLES / 4 ? triggerAt - LOGIC_TRACE_SAMPLES / 4 : 0;
+        terminalView.println("Triggered at sample " + std::to_string(triggerAt) +
+                             ", " + std::to_string(logicCaptureService.getSampleCount()) + " samples captured" +
+                             (logicCaptureService.isTruncated() ? " (buffer full)" : "") + "\n");
+        if (logicCaptureService.getOverruns()) terminalView.println("Warning: " + logicOverrunText() + "\n");
+        drawLogicCapture(channel, viewStart, step);
+    }
+
+    if (!logicCaptureService.stop()) {
+        terminalView.println("Logic Analyzer: Sampler did not stop, capture buffer kept.");
+    }
+}
+
+/*
+Logic capture export
+*/
+void UtilityController::saveLogicCapture() {
+    std::vector<std::string> channels;
+    for (auto pin : logicCaptureService.getPins()) channels.push_back("GPIO" + std::to_string(pin));
+
+    auto capture = captureExportShell.open("logic");
+    if (!capture) return;
+
+    if (logicCaptureService.getOverruns()) capture->setComment(logicOverrunText());
+    if (capture->begin(channels, logicCaptureService.getSampleRate())) {
+        // Runs go straight from the RLE ring to the file
+        logicCaptureService.forEachRun([&capture](uint8_t value, uint32_t run) {
+            return capture->append(value, run);
+        });
     }
+    captureExportShell.close(capture);
+}
+
+std::string UtilityController::logicOverrunText() {
+    return "sampler preempted " + std::to_string(logicCaptureService.getOverruns()) + " times, " +
+           std::to_string(logicCaptureService.getMissedSamples()) + " samples held at the previous value";
+}
+
+/*
+Logic capture rendering
+*/
+void UtilityController::drawLogicCapture(uint8_t channel, uint32_t start, uint8_t step) {
+    const auto& pins = logicCaptureService.getPins();
+    std::vector<uint8_t> trace;
+
+    if (logicCaptureService.readChannel(channel, start, LOGIC_TRACE_SAMPLES, trace) < 2) return;
+    deviceView.drawLogicTrace(pins[channel], trace, step);
+
+    // The poor man's drawLogicTrace() on terminal
+    // draws a 132 samples sub part of the buffer to speed up the things
+    if (state.getTerminalMode() != TerminalTypeEnum::SerialPort) return;
+
+    terminalView.println("");
+    for (size_t ch = 0; ch < pins.size(); ++ch) {
+        logicCaptureService.readChannel(ch, start, LOGIC_TERMINAL_SAMPLES, trace);
+        std::string line;
+        line.reserve(LOGIC_TERMINAL_SAMPLES + 4);
+        if (pins.size() > 1) {
+            std::string label = std::to_string(pins[ch]);
+            line += std::string(3 - std::min<size_t>(3, label.size()), ' ') + label + " ";
+        }
+        for (auto bit : trace) line += bit ? '-' : '_';
+        terminalView.print(line);
+        if (ch + 1 < pins.size()) terminalView.print("\r\n");
+    }
+    terminalView.print("\r\x1b[" + std::to_string(pins.size()) + "A");  // Up to put cursor at the correct place for the next draw
 }
 
 /*
@@ -441,9 +622,15 @@ void UtilityController::handleGuide() {
 Wizard
 */
 void UtilityController::handleWizard(const TerminalCommand& cmd) {
+    // Every free pin at once
+    if (cmd.getSubcommand() == "all") {
+        handleWizardAll();
+        return;
+    }
+
     // Validate pin argument
-    if (cmd.getSubcommand().empty() || !argTransformer.isValidNumber(cmd.getSubcommand())) {
-        terminalView.println("Usage: wizard <pin>");
+    if (!argTransformer.isValidNumber(cmd.getSubcommand())) {
+        terminalView.println("Usage: wizard <pin|all> [rec]");
         return;
     }
 
@@ -454,34 +641,159 @@ void UtilityController::handleWizard(const TerminalCommand& cmd) {
         return;
     }
 
+    // Edges can be streamed to a VCD/sigrok file while analyzing
+    std::unique_ptr<ICaptureWriter> capture;
+    if (cmd.getArgs() == "rec") {
+        capture = captureExportShell.open("wizard");
+        if (capture && !capture->begin({ "GPIO" + std::to_string(pin) }, 1000000)) capture.reset();
+    }
+
+    pinService.setInput(pin);
+    if (!batchEdgeCaptureService.configure({ pin })) {
+        terminalView.println("Wizard: Failed to configure capture.");
+        captureExportShell.close(capture);
+        return;
+    }
+
     terminalView.println("\nWizard: Please wait, analyzing pin " + std::to_string(pin) + "... Press [ENTER] to stop.\n");
-    pinAnalyzer.begin(pin);
+    pinAnalyzer.begin();
+    if (capture) {
+        pinAnalyzer.setEdgeListener([&capture](bool level, uint32_t durationUs) {
+            capture->append(level ? 1 : 0, durationUs);
+        });
+    }
     const bool doPullTest = false; // TODO: add argument to enable pull test if needed
+    std::vector<uint32_t> edges;
+
+    while (true) {
+        // Check for ENTER press to stop, between two capture windows
+        char key = terminalInput.readChar();
+        if (key == '\r' || key == '\n') {
+            terminalView.println("\nWizard: Stopped by user.");
+            break;
+        }
+
+        if (!batchEdgeCaptureService.capture(WIZARD_WINDOW_MS)) {
+            terminalView.println("Wizard: Not enough memory for the capture buffer.");
+            break;
+        }
+
+        // Classify the window
+        batchEdgeCaptureService.getEdges(pin, edges);
+        auto report = pinAnalyzer.analyzeEdges(
+            pin,
+            batchEdgeCaptureService.getInitialLevel(pin),
+            edges,
+            batchEdgeCaptureService.getCyclesPerUs(),
+            batchEdgeCaptureService.getWindowCycles(),
+            doPullTest
+        );
+        terminalView.print(pinAnalyzer.formatWizardReport(pin, report));
+        if (batchEdgeCaptureService.isTruncated()) {
+            uint32_t ms = batchEdgeCaptureService.getWindowCycles() / batchEdgeCaptureService.getCyclesPerUs() / 1000;
+            terminalView.println("Wizard: Buffer full after " + std::to_string(ms) + " ms, window shortened.");
+        }
+        terminalView.println("Wizard: Analyzing pin " + std::to_string(pin) + "... Press [ENTER] to stop.\n");
+    }
+
+    // Cleanup buffers
+    pinAnalyzer.setEdgeListener(nullptr);
+    pinAnalyzer.end();
+    batchEdgeCaptureService.release();
+    captureExportShell.close(capture);
+}
+
+/*
+Wizard All
+*/
+void UtilityController::handleWizardAll() {
+    // Flash, PSRAM and USB pins are never touched, whatever the board profile says
+    uint64_t skipped = WIZARD_RESERVED_MASK;
+
+    // Pins of the current bus stay configured for it
+    for (uint8_t pin : pinoutTransformer.buildPins(state.getCurrentMode())) {
+        if (pin < 64) skipped |= 1ULL << pin;
+    }
+
+    // All GPIO 0 to 48 except the ones above, protected and not bonded out
+    std::vector<uint8_t> pins;
+    pins.reserve(49);
+    for (uint8_t pin = 0; pin <= 48; ++pin) {
+        if (!GPIO_IS_VALID_GPIO(pin) || state.isPinProtected(pin)) continue;
+        if (skipped & (1ULL << pin)) continue;
+        pins.push_back(pin);
+    }
+
+    if (pins.empty()) {
+        terminalView.println("Wizard: No usable pins (all protected or in use?).");
+        return;
+    }
 
+    for (uint8_t pin : pins) pinService.setInput(pin);
+    batchEdgeCaptureService.configure(pins);
+    pinAnalyzer.begin();
+
+    terminalView.println("\nWizard: Please wait, analyzing " + std::to_string(pins.size()) + " pins... Press [ENTER] to stop.\n");
+
+    std::vector<BusAnalyzer::Trace> traces(pins.size());
     while (true) {
-        // Check for ENTER press to stop
+        // Check for ENTER press to stop, between two capture windows
         char key = terminalInput.readChar();
         if (key == '\r' || key == '\n') {
             terminalView.println("\nWizard: Stopped by user.");
             break;
         }
 
-        // Sample pin
-        for (int i = 0; i < 2048; i++) {
-            pinAnalyzer.sample();
+        if (!batchEdgeCaptureService.capture(WIZARD_WINDOW_MS)) {
+            terminalView.println("Wizard: Not enough memory for the capture buffer.");
+            break;
+        }
+
+        // Split the shared capture per pin
+        const uint32_t cyclesPerUs = batchEdgeCaptureService.getCyclesPerUs();
+        const uint32_t windowCycles = batchEdgeCaptureService.getWindowCycles();
+        for (size_t i = 0; i < pins.size(); ++i) {
+            traces[i].pin = pins[i];
+            traces[i].startLevel = batchEdgeCaptureService.getInitialLevel(pins[i]);
+            batchEdgeCaptureService.getEdges(pins[i], traces[i].edges);
+        }
+
+        uint32_t windowMs = windowCycles / cyclesPerUs / 1000;
+        uint32_t windowUs = windowCycles / cyclesPerUs;
+        uint32_t rateKHz = windowUs ? (uint32_t)((uint64_t)batchEdgeCaptureService.getSampleCount() * 1000 / windowUs) : 0;
+        terminalView.println("[Wizard report on " + std::to_string(pins.size()) + " pins, " +
+                             std::to_string(windowMs) + " ms at ~" + std::to_string(rateKHz) + " kS/s]");
+
+        // Pins that move together
+        auto buses = busAnalyzer.analyze(traces, cyclesPerUs);
+        for (const auto& bus : buses) {
+            terminalView.println("  " + BusAnalyzer::format(bus));
+        }
+        if (buses.empty()) terminalView.println("  No I2C, SPI or UART pattern found.");
+
+        // Per pin classification, idle pins only listed
+        std::string idleHigh, idleLow;
+        for (const auto& trace : traces) {
+            if (trace.edges.empty()) {
+                std::string& list = trace.startLevel ? idleHigh : idleLow;
+                list += " " + std::to_string(trace.pin);
+                continue;
+            }
+            auto report = pinAnalyzer.analyzeEdges(trace.pin, trace.startLevel, trace.edges, cyclesPerUs, windowCycles);
+            terminalView.println("  " + pinAnalyzer.formatSummary(trace.pin, report));
         }
+        if (!idleHigh.empty()) terminalView.println("  Idle HIGH:" + idleHigh);
+        if (!idleLow.empty())  terminalView.println("  Idle LOW:" + idleLow);
 
-        // Check if it's time to report and report activity
-        if (pinAnalyzer.shouldReport(millis())) {
-            auto report = pinAnalyzer.buildReport(doPullTest);
-            terminalView.print(pinAnalyzer.formatWizardReport(pin, report));
-            pinAnalyzer.resetWindow();
-            terminalView.println("Wizard: Analyzing pin " + std::to_string(pin) + "... Press [ENTER] to stop.\n");
+        if (batchEdgeCaptureService.isTruncated()) {
+            terminalView.println("  Buffer full after " + std::to_string(windowMs) + " ms, window shortened by fast lines.");
         }
+        terminalView.println("\nWizard: Analyzing " + std::to_string(pins.size()) + " pins... Press [ENTER] to stop.\n");
     }
 
     // Cleanup buffers
     pinAnalyzer.end();
+    batchEdgeCaptureService.release();
 }
 
 /*
@@ -12,16 +12,22 @@
 #include "States/GlobalState.h"
 #include "Enums/ModeEnum.h"
 #include "Services/PinService.h"
+#include "Services/LogicCaptureService.h"
+#include "Enums/LogicTriggerEnum.h"
 #include "Services/I2sService.h"
 #include "Managers/UserInputManager.h"
+#include "Services/BatchEdgeCaptureService.h"
 #include "Analyzers/PinAnalyzer.h"
+#include "Analyzers/BusAnalyzer.h"
 #include "Managers/AliasManager.h"
 #include "Transformers/ArgTransformer.h"
 #include "Transformers/TerminalCommandTransformer.h"
+#include "Transformers/PinoutTransformer.h"
 #include "Shells/SysInfoShell.h"
 #include "Shells/GuideShell.h"
 #include "Shells/HelpShell.h"
 #include "Shells/ProfileShell.h"
+#include "Shells/CaptureExportShell.h"
 
 class UtilityController {
 public:
@@ -31,16 +37,21 @@ public:
         IDeviceView& deviceView, 
         IInput& terminalInput, 
         PinService& pinService,
+        LogicCaptureService& logicCaptureService,
         I2sService& i2sService,
         UserInputManager& userInputManager,
+        BatchEdgeCaptureService& batchEdgeCaptureService,
         PinAnalyzer& pinAnalyzer,
+        BusAnalyzer& busAnalyzer,
         AliasManager& aliasManager,
         ArgTransformer& argTransformer,
         TerminalCommandTransformer& terminalCommandTransformer,
+        PinoutTransformer& pinoutTransformer,
         SysInfoShell& sysInfoShell,
         GuideShell& guideShell,
         HelpShell& helpShell,
-        ProfileShell& profileShell
+        ProfileShell& profileShell,
+        CaptureExportShell& captureExportShell
     );
 
     // Entry point for global utility commands
@@ -80,6 +91,9 @@ private:
     // Pin diagnostic with periodic report
     void handleWizard(const TerminalCommand& cmd);
 
+    // All free pins captured together, with bus detection
+    void handleWizardAll();
+
     // Pin activity to audio
     void handleListen(const TerminalCommand& cmd);
 
@@ -92,19 +106,39 @@ private:
     // Alias command to create custom shortcuts for commands
     void handleAlias();
 
+    // Save the logic capture buffer as VCD or sigrok session
+    void saveLogicCapture();
+
+    // Sampler overruns of the last capture, for the terminal and the export header
+    std::string logicOverrunText();
+
+    // Render the logic capture buffer on device screen and serial terminal
+    void drawLogicCapture(uint8_t channel, uint32_t start, uint8_t step);
+
+    static constexpr uint16_t LOGIC_TRACE_SAMPLES = 320;
+    static constexpr uint16_t LOGIC_TERMINAL_SAMPLES = 132;
+    static constexpr uint32_t WIZARD_WINDOW_MS = 2000;
+    // S3 pins wired to the USB PHY (19, 20), the SPI flash (26-32) and the octal PSRAM (33-37)
+    static constexpr uint64_t WIZARD_RESERVED_MASK = (1ULL << 19) | (1ULL << 20) | (0xFFFULL << 26);
+
     ITerminalView& terminalView;
     IDeviceView& deviceView;
     IInput& terminalInput;
     PinService& pinService;
+    LogicCaptureService& logicCaptureService;
     I2sService& i2sService;
     UserInputManager& userInputManager;
+    BatchEdgeCaptureService& batchEdgeCaptureService;
     PinAnalyzer& pinAnalyzer;
+    BusAnalyzer& busAnalyzer;
     AliasManager& aliasManager;
     ArgTransformer& argTransformer;
     TerminalCommandTransformer& commandTransformer;
+    PinoutTransformer& pinoutTransformer;
     SysInfoShell& sysInfoShell;
     GuideShell& guideShell;
     HelpShell& helpShell;
     ProfileShell& profileShell;
+    CaptureExportShell& captureExportShell;
     GlobalState& state = GlobalState::getInstance();
 };
@@ -1,5 +1,33 @@
 #include "Controllers/WifiController.h"
 #include "Vendors/wifi_atks.h"
+#include <algorithm>
+
+WifiController::WifiController(
+    ITerminalView& terminalView,
+    IDeviceView& deviceView,
+    IInput& terminalInput,
+    IInput& deviceInput,
+    WifiService& wifiService,
+    WifiOpenScannerService& wifiOpenNetworkService,
+    EthernetService& ethernetService,
+    SshService& sshService,
+    NetcatService& netcatService,
+    NmapService& nmapService,
+    ICMPService& icmpService,
+    NvsService& nvsService,
+    HttpService& httpService,
+    TelnetService& telnetService,
+    ArgTransformer& argTransformer,
+    JsonTransformer& jsonTransformer,
+    UserInputManager& userInputManager,
+    ModbusShell& modbusShell,
+    HelpShell& helpShell,
+    LittleFsService& littleFsService
+)
+: ANetworkController(terminalView, deviceView, terminalInput, deviceInput, wifiService, wifiOpenNetworkService,
+                     ethernetService, sshService, netcatService, nmapService, icmpService, nvsService, httpService,
+                     telnetService, argTransformer, jsonTransformer, userInputManager, modbusShell, helpShell),
+  littleFsService(littleFsService) {}
 
 /*
 Entry point for command
@@ -19,6 +47,7 @@ void WifiController::handleCommand(const TerminalCommand &cmd)
     else if (root == "probe") handleProbe();
     else if (root == "ping") handlePing(cmd);
     else if (root == "sniff") handleSniff(cmd);
+    else if (root == "hop") handleHop(cmd);
     else if (root == "webui") handleWebUi(cmd);
     else if (root == "ssh") handleSsh(cmd);
     else if (root == "telnet") handleTelnet(cmd);
@@ -365,6 +394,13 @@ void WifiController::handleProbe()
     }
     wifiOpenScannerService.clearProbeLog();
 
+    // Same channel selection as sniff and waterfall
+    uint16_t channelMask = 0;
+    for (uint8_t ch = 1; ch <= ChannelHopScheduler::MAX_CHANNEL; ++ch) {
+        if (channelHop.isEnabled(ch)) channelMask |= (1u << ch);
+    }
+    wifiOpenScannerService.setChannels(channelMask, channelHop.getPinned());
+
     // Start the open probe service
     if (!wifiOpenScannerService.startOpenProbe()) {
         terminalView.println("WIFI: Failed to start probe.\n");
@@ -403,13 +439,25 @@ Sniff
 */
 void WifiController::handleSniff(const TerminalCommand &cmd)
 {
-    terminalView.println("WiFi Sniffing started... Press [ENTER] to stop.\n");
+    PcapTransformer::Sink sink;
+    std::string pcapPath;
+    if (cmd.getSubcommand() == "pcap") {
+        sink = openPcapSink(pcapPath);
+        if (!sink) return;
+    }
 
-    wifiService.startPassiveSniffing();
-    wifiService.switchChannel(1);
+    if (!wifiService.startPassiveSniffing(sink)) {
+        terminalView.println("WiFi Sniffing: Failed to start.\n");
+        return;
+    }
+    channelHop.setDwellRange(SNIFF_MIN_DWELL_MS, SNIFF_MAX_DWELL_MS);
+    channelHop.resetStats();
+    uint8_t channel = channelHop.start();
+    wifiService.switchChannel(channel);
+    terminalView.println("WiFi Sniffing started... Press [ENTER] to stop.\n");
 
-    uint8_t channel = 1;
-    unsigned long lastHop = 0;
+    WifiChannelCounters mark = wifiService.getChannelCounters(channel);
+    unsigned long dwellStart = millis();
     unsigned long lastPull = 0;
 
     while (true)
@@ -430,12 +478,10 @@ void WifiController::handleSniff(const TerminalCommand &cmd)
             lastPull = millis();
         }
 
-        // Switch channel every 100ms
-        if (millis() - lastHop > 100)
+        // Busy channels are held longer than quiet ones
+        if (millis() - dwellStart >= channelHop.dwellMs())
         {
-            channel = (channel % 13) + 1; // channel 1 to 13
-            wifiService.switchChannel(channel);
-            lastHop = millis();
+            hopChannel(mark, dwellStart);
         }
 
         delay(5);
@@ -443,6 +489,165 @@ void WifiController::handleSniff(const TerminalCommand &cmd)
 
     wifiService.stopPassiveSniffing();
     terminalView.println("WiFi Sniffing stopped.\n");
+    printSniffSummary();
+    printHopStats();
+
+    auto stats = wifiService.getSniffStats();
+    terminalView.println("Frames: " + std::to_string(stats.received) +
+                         ", ring drops: " + std::to_string(stats.dropped) +
+                         ", log drops: " + std::to_string(stats.logDropped));
+
+    if (sink) {
+        if (stats.pcapError) {
+            terminalView.println("❌ Failed to write: " + pcapPath);
+        } else {
+            terminalView.println("✅ Saved " + pcapPath + " (" + std::to_string(stats.saved) + " frames, " +
+                                 std::to_string(stats.savedBytes) + " bytes)");
+        }
+    }
+    terminalView.println("");
+}
+
+PcapTransformer::Sink WifiController::openPcapSink(std::string& path)
+{
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("\n ❌ LittleFS not mounted.");
+            return nullptr;
+        }
+    }
+    if (littleFsService.freeBytes() < PCAP_MIN_FREE_BYTES) {
+        terminalView.println("\n❌ Not enough LittleFS space.");
+        return nullptr;
+    }
+
+    std::string defName = "wifi_" + std::to_string(millis() % 1000000);
+    std::string name = userInputManager.readSanitizedString("File name", defName, false);
+    if (name.empty()) name = defName;
+
+    path = std::string(CAPTURE_DIR) + name + ".pcap";
+    if (littleFsService.exists(path)) littleFsService.removeFile(path);
+
+    // Radiotap PCAP, appended one flush block at a time by the sniff task
+    std::string target = path;
+    terminalView.println("Recording to " + path);
+    return [this, target](const uint8_t* data, size_t len) {
+        return littleFsService.write(target, data, len, true);
+    };
+}
+
+void WifiController::printSniffSummary()
+{
+    auto nodes = wifiService.getSniffNodes();
+    if (nodes.empty()) return;
+
+    std::sort(nodes.begin(), nodes.end(), [](const WifiSniffNode& a, const WifiSniffNode& b) {
+        return a.frames > b.frames;
+    });
+
+    terminalView.println("MAC                KIND  CH  RSSI  FRAMES  BSSID              SSID");
+    size_t rows = std::min(nodes.size(), SNIFF_SUMMARY_ROWS);
+    for (size_t i = 0; i < rows; ++i) {
+        const auto& n = nodes[i];
+        char line[96];
+        snprintf(line, sizeof(line), "%-17s  %-4s  %2u  %4d  %6lu  %-17s  ",
+                 n.mac.c_str(), n.accessPoint ? "AP" : "STA", n.channel, n.rssi,
+                 (unsigned long)n.frames, n.bssid.empty() ? "-" : n.bssid.c_str());
+        terminalView.println(std::string(line) + n.ssid);
+    }
+    if (nodes.size() > rows) {
+        terminalView.println("... " + std::to_string(nodes.size() - rows) + " more");
+    }
+    terminalView.println("");
+}
+
+/*
+Channel hopping
+*/
+void WifiController::handleHop(const TerminalCommand& cmd)
+{
+    const auto sub = cmd.getSubcommand();
+
+    if (sub.empty()) {
+        printHopStats();
+        return;
+    }
+
+    if (sub == "all") {
+        channelHop.reset();
+        terminalView.println("WiFi Hop: Channels 1-13, no pin.\n");
+        return;
+    }
+
+    if (sub == "unpin") {
+        channelHop.unpin();
+        terminalView.println("WiFi Hop: Hopping again.\n");
+        return;
+    }
+
+    auto args = argTransformer.splitArgs(cmd.getArgs());
+    if ((sub != "pin" && sub != "skip" && sub != "use") || args.empty()) {
+        terminalView.println("Usage: hop                 Show channel stats");
+        terminalView.println("       hop pin <ch>        Stay on one channel");
+        terminalView.println("       hop skip <ch> [ch]  Exclude channels");
+        terminalView.println("       hop use <ch> [ch]   Include channels");
+        terminalView.println("       hop unpin | all     Resume hopping, all resets the channels");
+        return;
+    }
+
+    for (const auto& arg : args) {
+        if (!argTransformer.isValidNumber(arg)) {
+            terminalView.println("WiFi Hop: Invalid channel " + arg);
+            return;
+        }
+        uint8_t ch = argTransformer.toUint8(arg);
+
+        bool ok = sub == "pin"  ? channelHop.pin(ch)
+                : sub == "skip" ? channelHop.exclude(ch)
+                :                 channelHop.include(ch);
+        if (!ok) {
+            terminalView.println("WiFi Hop: Cannot " + sub + " channel " + arg);
+            return;
+        }
+        if (sub == "pin") break;
+    }
+    printHopStats();
+}
+
+WifiChannelCounters WifiController::hopChannel(WifiChannelCounters& mark, unsigned long& dwellStart)
+{
+    uint8_t channel = channelHop.current();
+    WifiChannelCounters now = wifiService.getChannelCounters(channel);
+    unsigned long elapsed = millis() - dwellStart;
+
+    WifiChannelCounters seen;
+    seen.frames = now.frames - mark.frames;
+    seen.beacons = now.beacons - mark.beacons;
+    seen.beaconRssiSum = now.beaconRssiSum - mark.beaconRssiSum;
+
+    // The callback stays registered, only the radio channel moves
+    uint8_t next = channelHop.advance(seen.frames, elapsed);
+    if (next != channel) wifiService.switchChannel(next);
+
+    mark = wifiService.getChannelCounters(next);
+    dwellStart = millis();
+    return seen;
+}
+
+void WifiController::printHopStats()
+{
+    uint8_t pinned = channelHop.getPinned();
+    terminalView.println("CH  STATE  FRAMES/S   TIME(ms)   FRAMES");
+    for (const auto& st : channelHop.getStats()) {
+        const char* stateStr = st.channel == pinned ? "pin" : (st.enabled ? "on" : "off");
+        char line[64];
+        snprintf(line, sizeof(line), "%2u  %-5s  %8.1f  %9lu  %7lu",
+                 st.channel, stateStr, st.framesPerSec,
+                 (unsigned long)st.timeMs, (unsigned long)st.frames);
+        terminalView.println(line);
+    }
+    terminalView.println("");
 }
 
 /*
@@ -674,88 +879,100 @@ void WifiController::handleWaterfall()
     std::string title = "Peak: --";
     uint16_t pktDwellMs = userInputManager.readValidatedInt("Hold time per channel (ms)", 50, 5, 500);
     
-    // Scale packet count to keep waterfall bars visually 
-    // consistent across different dwell times
-    // reference is [dwell 80ms, 1 packet = +5]
+    // Scale the frame rate to keep waterfall bars visually consistent
+    // reference is [80ms window, 1 packet = +5]
     // meaning 10 packets received in 80ms = max score
     const float refDwellMs = 80.0f;
     const float refMul = 5.0f;
-    const float timeScale = refDwellMs / (float)pktDwellMs; 
 
     terminalView.println("\nWiFi Waterfall: Displaying on the ESP32 screen... Press [ENTER] to stop.");
-    wifiService.startPassiveSniffing();
-
-    while (true)
-    {
-        int8_t bestCh = -1;
-        int8_t bestRssi = -127;
-        int8_t bestLevel = -1;
-        int8_t channel = -1;
-
-        for (uint8_t idx = 0; idx < 13; ++idx)
-        {
-            channel = idx + 1;
-
-            // Enter press to stop
-            char c = terminalInput.readChar();
-            if (c == '\n' || c == '\r') {
-                terminalView.println("WiFi Waterfall: Stopped by user.\n");
-                wifiService.stopPassiveSniffing();
-                return;
-            }
 
-            // Get RSSI on channel
-            int8_t rssi = wifiService.scanRssiOnChannel(channel);
-
-            // Get packet count on channel
-            uint32_t pkts = wifiService.countPacketsOnChannel(channel, pktDwellMs);
+    // Counters only, the hold time is the shortest dwell, busy channels get up to 4 times more
+    if (!wifiService.startPassiveSniffing(nullptr, false)) {
+        terminalView.println("WiFi Waterfall: Failed to start.\n");
+        return;
+    }
+    channelHop.setDwellRange(pktDwellMs, pktDwellMs * 4);
+    channelHop.resetStats();
+    wifiService.switchChannel(channelHop.start());
 
-            // RSSI, score 0 to 50
-            int rssiPart = 0;
-            if (rssi != -127) {
-                int rr = rssi;
-                if (rr < -100) rr = -100;
-                if (rr > -30)  rr = -30;
-                rssiPart = (rr + 100) * 50 / 70;
+    WifiChannelCounters mark = wifiService.getChannelCounters(channelHop.current());
+    unsigned long dwellStart = millis();
+    int8_t bestLevel = -1;
+    uint8_t lastChannel = 0xFF;
 
-                if (rssiPart < 0) rssiPart = 0;
-                if (rssiPart > 50) rssiPart = 50;
-            }
+    while (true)
+    {
+        // Enter press to stop
+        char c = terminalInput.readChar();
+        if (c == '\n' || c == '\r') {
+            terminalView.println("WiFi Waterfall: Stopped by user.\n");
+            wifiService.stopPassiveSniffing();
+            printHopStats();
+            return;
+        }
 
-            // Packets, score 0 to 50
-            int pktPart = (int)((float)pkts * refMul * timeScale);
-            if (pktPart > 50) pktPart = 50;
-            if (pktPart < 0)  pktPart = 0;
-
-            // Final level
-            // 50% RSSI and 50% packets
-            int8_t level = rssiPart + pktPart;
-            if (level < 1) level = 1; // show progress
-
-            // Draw the channel line
-            deviceView.drawWaterfall(
-                title,
-                1.0f, 13.0f,
-                "ch",
-                idx,
-                13,
-                level
-            );
+        unsigned long elapsed = millis() - dwellStart;
+        if (elapsed < channelHop.dwellMs()) {
+            delay(1);
+            continue;
+        }
 
-            // printed each start of loop, hack to reset after printing
-            if (idx == 0) title = "Peak: --";
+        uint8_t channel = channelHop.current();
+        WifiChannelCounters seen = hopChannel(mark, dwellStart);
+
+        // Mean beacon RSSI of the dwell, score 0 to 50
+        int8_t rssi = -127;
+        int rssiPart = 0;
+        if (seen.beacons > 0) {
+            int rr = seen.beaconRssiSum / (int32_t)seen.beacons;
+            rssi = (int8_t)rr;
+            if (rr < -100) rr = -100;
+            if (rr > -30)  rr = -30;
+            rssiPart = (rr + 100) * 50 / 70;
+
+            if (rssiPart < 0) rssiPart = 0;
+            if (rssiPart > 50) rssiPart = 50;
+        }
 
-            // best peak
-            if (rssi != -127 && (level > bestLevel)) {
-                bestLevel = level;
-                bestRssi = rssi;
-                bestCh = channel;
+        // Packets, score 0 to 50
+        float perRef = (float)seen.frames * refDwellMs / (float)(elapsed ? elapsed : 1);
+        int pktPart = (int)(perRef * refMul);
+        if (pktPart > 50) pktPart = 50;
+        if (pktPart < 0)  pktPart = 0;
+
+        // Final level
+        // 50% RSSI and 50% packets
+        int8_t level = rssiPart + pktPart;
+        if (level < 1) level = 1; // show progress
+
+        // Channel 14 has no row on the waterfall
+        if (channel > 13) continue;
+
+        // Back to a lower channel, a new sweep starts
+        bool sweepStart = channel <= lastChannel;
+        lastChannel = channel;
+        if (sweepStart) bestLevel = -1;
+
+        // Draw the channel line
+        deviceView.drawWaterfall(
+            title,
+            1.0f, 13.0f,
+            "ch",
+            channel - 1,
+            13,
+            level
+        );
 
-                title = "Peak: CH" + std::to_string(bestCh) +
-                        " (" + std::to_string(2407 + bestCh * 5) + "MHz) " +
-                        std::to_string(bestRssi) + " dBm";
-            }
+        // printed each start of sweep, hack to reset after printing
+        if (sweepStart) title = "Peak: --";
 
+        // best peak
+        if (rssi != -127 && (level > bestLevel)) {
+            bestLevel = level;
+            title = "Peak: CH" + std::to_string(channel) +
+                    " (" + std::to_string(2407 + channel * 5) + "MHz) " +
+                    std::to_string(rssi) + " dBm";
         }
     }
 }
@@ -9,6 +9,8 @@
 #include <Services/NmapService.h>
 #include <Services/ICMPService.h>
 #include <Services/WifiOpenScannerService.h>
+#include <Services/LittleFsService.h>
+#include <Services/ChannelHopScheduler.h>
 #include <Transformers/ArgTransformer.h>
 #include <Managers/UserInputManager.h>
 #include <Models/TerminalCommand.h>
@@ -18,7 +20,28 @@
 
 class WifiController : public ANetworkController {
 public:
-    using ANetworkController::ANetworkController;
+    WifiController(
+        ITerminalView& terminalView,
+        IDeviceView& deviceView,
+        IInput& terminalInput,
+        IInput& deviceInput,
+        WifiService& wifiService,
+        WifiOpenScannerService& wifiOpenNetworkService,
+        EthernetService& ethernetService,
+        SshService& sshService,
+        NetcatService& netcatService,
+        NmapService& nmapService,
+        ICMPService& icmpService,
+        NvsService& nvsService,
+        HttpService& httpService,
+        TelnetService& telnetService,
+        ArgTransformer& argTransformer,
+        JsonTransformer& jsonTransformer,
+        UserInputManager& userInputManager,
+        ModbusShell& modbusShell,
+        HelpShell& helpShell,
+        LittleFsService& littleFsService
+    );
 
     //  Entry point for Wi-Fi command
     void handleCommand(const TerminalCommand& cmd);
@@ -30,6 +53,14 @@ public:
     std::vector<std::string> buildWiFiLines();
 
 private:
+    inline static constexpr const char* CAPTURE_DIR = "/captures/";
+    inline static constexpr size_t PCAP_MIN_FREE_BYTES = 16 * 1024;
+    inline static constexpr size_t SNIFF_SUMMARY_ROWS = 20;
+    inline static constexpr uint16_t SNIFF_MIN_DWELL_MS = 50;
+    inline static constexpr uint16_t SNIFF_MAX_DWELL_MS = 500;
+
+    LittleFsService& littleFsService;
+    ChannelHopScheduler channelHop;     // shared by sniff and waterfall, kept between runs
     GlobalState& state = GlobalState::getInstance();
     bool configured = false;
     Preferences preferences;
@@ -58,6 +89,21 @@ private:
     // Start packet sniffing
     void handleSniff(const TerminalCommand& cmd);
 
+    // Ask for a LittleFS file and return a PCAP sink writing to it
+    PcapTransformer::Sink openPcapSink(std::string& path);
+
+    // Stations and access points seen by the last sniff
+    void printSniffSummary();
+
+    // Pin, skip or show channels used by sniff and waterfall
+    void handleHop(const TerminalCommand& cmd);
+
+    // End the dwell on the current channel, switch to the next one and return what the dwell saw
+    WifiChannelCounters hopChannel(WifiChannelCounters& mark, unsigned long& dwellStart);
+
+    // Per channel frames/s and time on channel
+    void printHopStats();
+
     // Show WebUI IP
     void handleWebUi(const TerminalCommand& cmd);
 
@@ -40,7 +40,7 @@ static const char* const autoCompleteWords[] = {
     // --- WIFI ---
     "connect","probe","deauth","disconnect","ap", "ap spam",
     "ssh","telnet","nc","nmap","modbus", "repeater", "extender",
-    "http","lookup","webui", "flood",
+    "http","lookup","webui", "flood", "hop",
 
     // --- JTAG ---
     "scan swd","scan jtag",
@@ -58,6 +58,9 @@ static const char* const autoCompleteWords[] = {
     // --- RF24 ---
     "setchannel",
 
+    // --- CAN ---
+    "filter",
+
     // ---- FM ---
     "broadcast",
 
@@ -24,6 +24,7 @@ struct NmapOptions {
     bool hasTrash = false;  // Did user pass non-option tokens?
     bool help = false;      // -h or --help
     bool pingOnly = false;  // -sn
+    int minParallelism = 0; // --min-parallelism, 0 keeps the engine default
 };
 
 enum class Layer4Protocol
@@ -41,6 +42,7 @@ struct PortService {
 
 static const int CONNECT_TIMEOUT_MS = 600;
 static const int SMALL_DELAY_MS = 5;
+static const int NMAP_MAX_PARALLELISM = 12;   // lwIP has 16 sockets, keep some for the web UI
 
 static constexpr PortService TOP100_TCP_MAP[] = {
     {7,    Layer4Protocol::TCP, "echo"},
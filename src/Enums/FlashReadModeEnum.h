@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+enum class FlashReadModeEnum {
+    Standard,   // 0x03 READ, no dummy, low max clock
+    Fast        // 0x0B FAST READ, 8 dummy clocks, rated clock
+};
+
+class FlashReadModeEnumMapper {
+public:
+    static std::string toString(FlashReadModeEnum mode) {
+        switch (mode) {
+            case FlashReadModeEnum::Standard: return "Read (0x03)";
+            case FlashReadModeEnum::Fast:     return "Fast Read (0x0B)";
+            default:                          return "Unknown";
+        }
+    }
+};
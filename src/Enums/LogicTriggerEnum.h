@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+
+enum class LogicTriggerEnum {
+    None,       // free running, capture starts immediately
+    Rising,     // low to high on the trigger channel
+    Falling,    // high to low on the trigger channel
+    Edge,       // any transition on the trigger channel
+    Pattern     // (sample & mask) == value across all channels
+};
+
+class LogicTriggerEnumMapper {
+public:
+    static std::string toString(LogicTriggerEnum trigger) {
+        switch (trigger) {
+            case LogicTriggerEnum::None:    return "None";
+            case LogicTriggerEnum::Rising:  return "Rising edge";
+            case LogicTriggerEnum::Falling: return "Falling edge";
+            case LogicTriggerEnum::Edge:    return "Any edge";
+            case LogicTriggerEnum::Pattern: return "Pattern";
+            default:                        return "Unknown";
+        }
+    }
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+
+enum class ResultEventEnum {
+    Start,
+    Stop,
+    Ack,
+    Nack,
+    Read,   // following data and conditions belong to a read
+    Write   // following conditions belong to a write
+};
+
+class ResultEventEnumMapper {
+public:
+    static std::string toString(ResultEventEnum event) {
+        switch (event) {
+            case ResultEventEnum::Start: return "START";
+            case ResultEventEnum::Stop:  return "STOP";
+            case ResultEventEnum::Ack:   return "ACK";
+            case ResultEventEnum::Nack:  return "NACK";
+            case ResultEventEnum::Read:  return "READ";
+            case ResultEventEnum::Write: return "WRITE";
+            default:                     return "Unknown";
+        }
+    }
+};
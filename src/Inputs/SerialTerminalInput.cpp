@@ -17,4 +17,9 @@ char SerialTerminalInput::readChar() {
         return Serial.read();
     }
     return KEY_NONE;
-}
\ No newline at end of file
+}
+size_t SerialTerminalInput::readBytes(uint8_t* buffer, size_t length) {
+    int available = Serial.available();
+    if (available <= 0) return 0;
+    return Serial.read(buffer, std::min<size_t>(length, available));
+}
@@ -9,4 +9,5 @@ public:
     char handler() override;
     void waitPress(uint32_t timeoutMs) override;
     char readChar() override;
+    size_t readBytes(uint8_t* buffer, size_t length) override;
 };
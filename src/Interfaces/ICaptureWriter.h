@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ICaptureWriter {
+public:
+    virtual ~ICaptureWriter() = default;
+
+    // Free text kept in the file header, set before begin()
+    virtual void setComment(const std::string& text) { comment = text; }
+
+    // Header, one name per channel (bit n of a sample is channels[n])
+    virtual bool begin(const std::vector<std::string>& channels, uint32_t sampleRateHz) = 0;
+
+    // Hold 'sample' for 'samples' sample periods, called while the capture runs
+    virtual bool append(uint8_t sample, uint32_t samples) = 0;
+
+    // Trailer and final flush
+    virtual bool end() = 0;
+
+    // Bytes handed to the sink so far
+    virtual size_t getBytesWritten() const = 0;
+
+protected:
+    std::string comment;
+};
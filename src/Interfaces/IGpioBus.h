@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// A group of GPIOs driven and sampled together, one bit per GPIO number.
+// Lets pin discovery code run against the real registers or a simulation.
+class IGpioBus {
+public:
+    virtual ~IGpioBus() = default;
+
+    // Pins in mask drive their output level, every other pin is an input
+    virtual void setOutputs(uint64_t mask) = 0;
+
+    // Set the pins in high, clear the pins in low, in one bus access
+    virtual void write(uint64_t high, uint64_t low) = 0;
+
+    // Level of every pin
+    virtual uint64_t read() = 0;
+
+    virtual void delayUs(uint32_t us) = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Whole I2C transactions on one bus, 7-bit addresses.
+// Lets the EEPROM engine run against Wire or a simulated device.
+class II2cBus {
+public:
+    virtual ~II2cBus() = default;
+
+    // Address then data in one transaction, false if anything was NACKed.
+    // An empty write is an address probe.
+    virtual bool write(uint8_t address, const uint8_t* data, size_t len, bool sendStop = true) = 0;
+
+    // Bytes actually received, fewer than len if the device stopped answering
+    virtual size_t read(uint8_t address, uint8_t* out, size_t len) = 0;
+
+    // Largest payload the driver moves in one transaction
+    virtual size_t maxTransfer() const = 0;
+
+    virtual uint32_t nowUs() = 0;
+    virtual void delayUs(uint32_t us) = 0;
+};
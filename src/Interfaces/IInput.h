@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include "Inputs/InputKeys.h"
 
@@ -19,5 +20,16 @@ public:
 
     // Wait an inpout
     virtual void waitPress(uint32_t timeoutMs = 0) = 0;
+
+    // Non blocking block read, stops at the first KEY_NONE unless overridden
+    virtual size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length) {
+            char c = readChar();
+            if (c == KEY_NONE) break;
+            buffer[n++] = static_cast<uint8_t>(c);
+        }
+        return n;
+    }
     
 };
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <Enums/ResultEventEnum.h>
+
+class IResultSink {
+public:
+    virtual ~IResultSink() = default;
+
+    // Bytes received from the bus, called as they arrive
+    virtual void onData(const uint8_t* data, size_t length) = 0;
+
+    // Bus condition between data
+    virtual void onEvent(ResultEventEnum event) = 0;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <Enums/TerminalTypeEnum.h>
@@ -17,6 +18,14 @@ public:
     virtual void print(const std::string& text) = 0;
     virtual void print(const uint8_t data) = 0;
     virtual void println(const std::string& text) = 0;
+
+    // Raw bytes, NUL safe
+    virtual void write(const uint8_t* data, size_t length) {
+        print(std::string(reinterpret_cast<const char*>(data), length));
+    }
+
+    // Output bytes lost on the way to the client, since boot
+    virtual uint32_t getDroppedBytes() const { return 0; }
     virtual void printPrompt(const std::string& mode = "HIZ") = 0;
 
     // Wait press
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Enums/ByteCodeEnum.h"
+
+// Pre-resolved operation, repeats are already expanded or folded
+struct CompiledOp {
+    ByteCodeEnum command;
+    uint32_t offset;   // Write: first byte in the data pool
+    uint32_t length;   // Write/Read: byte count, DelayUs: microseconds, others: repeat
+};
+
+class CompiledByteCode {
+public:
+    // Append a write, merged with the previous one if any
+    void appendWrite(uint8_t value, uint32_t repeat) {
+        if (ops.empty() || ops.back().command != ByteCodeEnum::Write) {
+            ops.push_back({ByteCodeEnum::Write, (uint32_t)pool.size(), 0});
+        }
+        pool.insert(pool.end(), repeat, value);
+        ops.back().length += repeat;
+    }
+
+    // Append a read, merged with the previous one if any
+    void appendRead(uint32_t count) {
+        if (ops.empty() || ops.back().command != ByteCodeEnum::Read) {
+            ops.push_back({ByteCodeEnum::Read, 0, 0});
+        }
+        ops.back().length += count;
+    }
+
+    // Append a delay, consecutive delays become one op until its 32-bit length is full
+    void appendDelayUs(uint64_t us) {
+        do {
+            if (ops.empty() || ops.back().command != ByteCodeEnum::DelayUs || ops.back().length == UINT32_MAX) {
+                ops.push_back({ByteCodeEnum::DelayUs, 0, 0});
+            }
+            uint32_t room = UINT32_MAX - ops.back().length;
+            uint32_t add = us < room ? (uint32_t)us : room;
+            ops.back().length += add;
+            us -= add;
+        } while (us > 0);
+    }
+
+    // Any other command, kept as is
+    void appendOp(ByteCodeEnum command, uint32_t repeat) {
+        ops.push_back({command, 0, repeat});
+    }
+
+    const std::vector<CompiledOp>& getOps() const { return ops; }
+    const uint8_t* getData(const CompiledOp& op) const { return pool.data() + op.offset; }
+
+private:
+    std::vector<CompiledOp> ops;
+    std::vector<uint8_t> pool;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+// Parameters decoded from the SFDP Basic Flash Parameter Table (JESD216)
+struct FlashSfdpInfo {
+    struct EraseType {
+        uint32_t size = 0;  // bytes, 0 if unused
+        uint8_t opcode = 0;
+    };
+
+    struct ReadMode {
+        bool supported = false;
+        uint8_t opcode = 0;
+        uint8_t dummyClocks = 0; // wait states + mode clocks
+    };
+
+    bool valid = false;
+    uint8_t revisionMajor = 0;
+    uint8_t revisionMinor = 0;
+    uint32_t capacityBytes = 0;
+    uint32_t pageSize = 256;
+
+    EraseType eraseTypes[4];
+
+    ReadMode fastRead;           // 1-1-1, 0x0B, always present with SFDP
+    ReadMode dualOutputRead;     // 1-1-2
+    ReadMode quadOutputRead;     // 1-1-4
+    ReadMode dualIoRead;         // 1-2-2
+    ReadMode quadIoRead;         // 1-4-4
+
+    bool address3Byte = true;
+    bool address4Byte = false;
+
+    // 16th DWORD: ways to enter and exit 4-byte addressing, JESD216B and later
+    static constexpr uint8_t ENTER_4B_B7            = 0x01; // 0xB7
+    static constexpr uint8_t ENTER_4B_WREN_B7       = 0x02; // 0x06 then 0xB7
+    static constexpr uint8_t ENTER_4B_BANK_REGISTER = 0x08; // 0x17 with EXTADD bit 7
+    static constexpr uint8_t ENTER_4B_OPCODES       = 0x20; // dedicated 4-byte opcodes
+    static constexpr uint8_t ENTER_4B_ALWAYS        = 0x40; // always 4-byte
+    static constexpr uint16_t EXIT_4B_E9            = 0x001; // 0xE9
+    static constexpr uint16_t EXIT_4B_WREN_E9       = 0x002; // 0x06 then 0xE9
+    static constexpr uint16_t EXIT_4B_BANK_REGISTER = 0x008; // 0x17 with EXTADD cleared
+
+    uint8_t enter4ByteMethods = 0;  // 0 if the table doesn't say
+    uint16_t exit4ByteMethods = 0;
+
+    // Largest erase block, falls back on 4 KB sector erase
+    EraseType largestErase() const {
+        EraseType best;
+        best.size = 4096;
+        best.opcode = 0x20;
+        for (const auto& e : eraseTypes) {
+            if (e.size > best.size && e.opcode != 0x00 && e.opcode != 0xFF) best = e;
+        }
+        return best;
+    }
+};
@@ -21,6 +21,9 @@ DependencyProvider::DependencyProvider(ITerminalView &terminalView, IDeviceView
       infraredService(),
       spiService(),
       pinService(),
+      logicCaptureService(),
+      edgeCaptureService(),
+      batchEdgeCaptureService(),
       bluetoothService(),
       wifiService(),
       wifiScannerService(),
@@ -57,11 +60,13 @@ DependencyProvider::DependencyProvider(ITerminalView &terminalView, IDeviceView
       userInputManager(terminalView, terminalInput, argTransformer),
       subGhzAnalyzer(),
       pinAnalyzer(pinService),
+      busAnalyzer(),
+      oneWireAnalyzer(),
       aliasManager(),
 
       // Shells
       sdCardShell(sdService, terminalView, terminalInput, argTransformer, userInputManager),
-      spiFlashShell(spiService, terminalView, terminalInput, argTransformer, userInputManager, binaryAnalyzer),
+      spiFlashShell(spiService, terminalView, terminalInput, argTransformer, userInputManager, binaryAnalyzer, littleFsService),
       spiEepromShell(spiService, terminalView, terminalInput, argTransformer, userInputManager, binaryAnalyzer),
       smartCardShell(twoWireService, terminalView, terminalInput, argTransformer, userInputManager),
       universalRemoteShell(terminalView, terminalInput, infraredService, argTransformer, userInputManager),
@@ -79,6 +84,8 @@ DependencyProvider::DependencyProvider(ITerminalView &terminalView, IDeviceView
       cellCallShell(terminalView, terminalInput, userInputManager, argTransformer, atTransformer, cellService),
       cellSmsShell(terminalView, terminalInput, userInputManager, argTransformer, atTransformer, cellService),
       fmBroadcastShell(terminalView, terminalInput, userInputManager, argTransformer, fmService),
+      captureExportShell(terminalView, terminalInput, userInputManager, littleFsService),
+      uartBridgeShell(terminalView, deviceView, terminalInput, deviceInput, userInputManager, littleFsService),
 
       // Selectors
       horizontalSelector(deviceView, deviceInput),
@@ -87,23 +94,23 @@ DependencyProvider::DependencyProvider(ITerminalView &terminalView, IDeviceView
       terminalTypeConfigurator(horizontalSelector),
 
       // Controllers
-      uartController(terminalView, terminalInput, deviceView, deviceInput, uartService, sdService, hdUartService, argTransformer, userInputManager, uartAtShell, helpShell, uartEmulationShell),
+      uartController(terminalView, terminalInput, deviceView, deviceInput, uartService, sdService, hdUartService, argTransformer, userInputManager, uartAtShell, helpShell, uartEmulationShell, uartBridgeShell),
       i2cController(terminalView, terminalInput, i2cService, argTransformer, userInputManager, i2cEepromShell, helpShell),
-      oneWireController(terminalView, terminalInput, oneWireService, argTransformer, userInputManager, ibuttonShell, oneWireEepromShell, helpShell),
-      infraredController(terminalView, terminalInput, deviceView, infraredService, littleFsService, i2cService, argTransformer, infraredTransformer, userInputManager, universalRemoteShell, helpShell),
-      utilityController(terminalView, deviceView, terminalInput, pinService, i2sService, userInputManager, pinAnalyzer, aliasManager, argTransformer, commandTransformer, sysInfoShell, guideShell, helpShell, profileShell),
-      hdUartController(terminalView, terminalInput, deviceInput, hdUartService, uartService, argTransformer, userInputManager, helpShell),
+      oneWireController(terminalView, terminalInput, oneWireService, edgeCaptureService, oneWireAnalyzer, argTransformer, userInputManager, ibuttonShell, oneWireEepromShell, helpShell),
+      infraredController(terminalView, terminalInput, deviceView, infraredService, littleFsService, i2cService, argTransformer, infraredTransformer, userInputManager, universalRemoteShell, helpShell, captureExportShell),
+      utilityController(terminalView, deviceView, terminalInput, pinService, logicCaptureService, i2sService, userInputManager, batchEdgeCaptureService, pinAnalyzer, busAnalyzer, aliasManager, argTransformer, commandTransformer, pinoutTransformer, sysInfoShell, guideShell, helpShell, profileShell, captureExportShell),
+      hdUartController(terminalView, terminalInput, deviceInput, hdUartService, uartService, argTransformer, userInputManager, helpShell, uartBridgeShell),
       spiController(terminalView, terminalInput, spiService, sdService, argTransformer, userInputManager, binaryAnalyzer, sdCardShell, spiFlashShell, spiEepromShell, helpShell),
-      jtagController(terminalView, terminalInput, jtagService, userInputManager, helpShell),
+      jtagController(terminalView, terminalInput, jtagService, littleFsService, sdService, userInputManager, helpShell),
       twoWireController(terminalView, terminalInput, userInputManager, twoWireService, smartCardShell, helpShell),
       threeWireController(terminalView, terminalInput, userInputManager, threeWireService, argTransformer, threeWireEepromShell, helpShell),
-      dioController(terminalView, terminalInput, deviceView, pinService, argTransformer, helpShell, userInputManager),
+      dioController(terminalView, terminalInput, deviceView, pinService, edgeCaptureService, argTransformer, helpShell, userInputManager),
       ledController(terminalView, terminalInput, ledService, argTransformer, userInputManager, helpShell),
       bluetoothController(terminalView, terminalInput, deviceInput, bluetoothService, argTransformer, userInputManager, helpShell),
       i2sController(terminalView, terminalInput, i2sService, argTransformer, userInputManager, helpShell),
-      wifiController(terminalView, deviceView, terminalInput, deviceInput, wifiService, wifiScannerService, ethernetService, sshService, netcatService, nmapService, icmpService, nvsService, httpService, telnetService, argTransformer, jsonTransformer, userInputManager, modbusShell, helpShell),
-      canController(terminalView, terminalInput, userInputManager, canService, argTransformer, helpShell),
-      subGhzController(terminalView, terminalInput, deviceView, subGhzService, pinService, i2sService, littleFsService, argTransformer, subGhzTransformer, userInputManager, subGhzAnalyzer, helpShell),
+      wifiController(terminalView, deviceView, terminalInput, deviceInput, wifiService, wifiScannerService, ethernetService, sshService, netcatService, nmapService, icmpService, nvsService, httpService, telnetService, argTransformer, jsonTransformer, userInputManager, modbusShell, helpShell, littleFsService),
+      canController(terminalView, terminalInput, userInputManager, canService, littleFsService, argTransformer, helpShell),
+      subGhzController(terminalView, terminalInput, deviceView, subGhzService, pinService, i2sService, littleFsService, argTransformer, subGhzTransformer, userInputManager, subGhzAnalyzer, helpShell, captureExportShell),
       rfidController(terminalView, terminalInput, rfidService, userInputManager, argTransformer, helpShell),
       rf24Controller(terminalView, terminalInput, deviceView, rf24Service, pinService, argTransformer, userInputManager, helpShell),
       ethernetController(terminalView, deviceView, terminalInput, deviceInput, wifiService, wifiScannerService, ethernetService, sshService, netcatService, nmapService, icmpService, nvsService, httpService, telnetService, argTransformer, jsonTransformer, userInputManager, modbusShell, helpShell),
@@ -134,6 +141,9 @@ UsbS3Service &DependencyProvider::getUsbService() { return usbService; }
 SpiService &DependencyProvider::getSpiService() { return spiService; }
 HdUartService &DependencyProvider::getHdUartService() { return hdUartService; }
 PinService &DependencyProvider::getPinService() { return pinService; }
+LogicCaptureService &DependencyProvider::getLogicCaptureService() { return logicCaptureService; }
+EdgeCaptureService &DependencyProvider::getEdgeCaptureService() { return edgeCaptureService; }
+BatchEdgeCaptureService &DependencyProvider::getBatchEdgeCaptureService() { return batchEdgeCaptureService; }
 WifiService &DependencyProvider::getWifiService() { return wifiService; }
 BluetoothService &DependencyProvider::getBluetoothService() { return bluetoothService; }
 I2sService &DependencyProvider::getI2sService() { return i2sService; }
@@ -194,6 +204,8 @@ UserInputManager &DependencyProvider::getUserInputManager() { return userInputMa
 BinaryAnalyzer &DependencyProvider::getBinaryAnalyzer() { return binaryAnalyzer; }
 SubGhzAnalyzer &DependencyProvider::getSubGhzAnalyzer() { return subGhzAnalyzer; }
 PinAnalyzer &DependencyProvider::getPinAnalyzer() { return pinAnalyzer; }
+BusAnalyzer &DependencyProvider::getBusAnalyzer() { return busAnalyzer; }
+OneWireAnalyzer &DependencyProvider::getOneWireAnalyzer() { return oneWireAnalyzer; }
 AliasManager &DependencyProvider::getAliasManager() { return aliasManager; }
 
 // Shells
@@ -216,6 +228,8 @@ ProfileShell &DependencyProvider::getProfileShell() { return profileShell; }
 CellCallShell &DependencyProvider::getCellCallShell() { return cellCallShell; }
 CellSmsShell &DependencyProvider::getCellSmsShell() { return cellSmsShell; }
 FmBroadcastShell &DependencyProvider::getFmBroadcastShell() { return fmBroadcastShell; }
+CaptureExportShell &DependencyProvider::getCaptureExportShell() { return captureExportShell; }
+UartBridgeShell &DependencyProvider::getUartBridgeShell() { return uartBridgeShell; }
 
 // Selectors
 HorizontalSelector &DependencyProvider::getHorizontalSelector() { return horizontalSelector; }
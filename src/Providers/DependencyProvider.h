@@ -20,6 +20,9 @@ and injecting shared instances of core components
 #include "Services/HdUartService.h"
 #include "Services/SpiService.h"
 #include "Services/PinService.h"
+#include "Services/LogicCaptureService.h"
+#include "Services/BatchEdgeCaptureService.h"
+#include "Services/EdgeCaptureService.h"
 #include "Services/BluetoothService.h"
 #include "Services/WifiService.h"
 #include "Services/WifiOpenScannerService.h"
@@ -78,6 +81,8 @@ and injecting shared instances of core components
 #include "Analyzers/BinaryAnalyzer.h"
 #include "Managers/UserInputManager.h"
 #include "Analyzers/PinAnalyzer.h"
+#include "Analyzers/BusAnalyzer.h"
+#include "Analyzers/OneWireAnalyzer.h"
 #include "Analyzers/SubGhzAnalyzer.h"
 #include "Managers/AliasManager.h"
 #include "Shells/SdCardShell.h"
@@ -99,6 +104,8 @@ and injecting shared instances of core components
 #include "Shells/CellCallShell.h"
 #include "Shells/CellSmsShell.h"
 #include "Shells/FmBroadcastShell.h"
+#include "Shells/CaptureExportShell.h"
+#include "Shells/UartBridgeShell.h"
 #include "Config/TerminalTypeConfigurator.h"
 
 class DependencyProvider
@@ -129,6 +136,9 @@ public:
     SpiService &getSpiService();
     HdUartService &getHdUartService();
     PinService &getPinService();
+    LogicCaptureService &getLogicCaptureService();
+    EdgeCaptureService &getEdgeCaptureService();
+    BatchEdgeCaptureService &getBatchEdgeCaptureService();
     BluetoothService &getBluetoothService();
     WifiService &getWifiService();
     WifiOpenScannerService &getWifiScannerService();
@@ -195,6 +205,8 @@ public:
     BinaryAnalyzer &getBinaryAnalyzer();
     SubGhzAnalyzer &getSubGhzAnalyzer();
     PinAnalyzer &getPinAnalyzer();
+    BusAnalyzer &getBusAnalyzer();
+    OneWireAnalyzer &getOneWireAnalyzer();
     AliasManager &getAliasManager();
 
     // Shells
@@ -217,6 +229,8 @@ public:
     CellCallShell &getCellCallShell();
     CellSmsShell &getCellSmsShell();
     FmBroadcastShell &getFmBroadcastShell();
+    CaptureExportShell &getCaptureExportShell();
+    UartBridgeShell &getUartBridgeShell();
 
     // Selectors
     HorizontalSelector &getHorizontalSelector();
@@ -248,6 +262,9 @@ private:
     HdUartService hdUartService;
     SpiService spiService;
     PinService pinService;
+    LogicCaptureService logicCaptureService;
+    EdgeCaptureService edgeCaptureService;
+    BatchEdgeCaptureService batchEdgeCaptureService;
     WifiService wifiService;
     WifiOpenScannerService wifiScannerService;
     BluetoothService bluetoothService;
@@ -314,6 +331,8 @@ private:
     BinaryAnalyzer binaryAnalyzer;
     SubGhzAnalyzer subGhzAnalyzer;
     PinAnalyzer pinAnalyzer;
+    BusAnalyzer busAnalyzer;
+    OneWireAnalyzer oneWireAnalyzer;
     AliasManager aliasManager;
 
     // Shells
@@ -336,6 +355,8 @@ private:
     CellCallShell cellCallShell;
     CellSmsShell cellSmsShell;
     FmBroadcastShell fmBroadcastShell;
+    CaptureExportShell captureExportShell;
+    UartBridgeShell uartBridgeShell;
 
     // Selectors
     HorizontalSelector horizontalSelector;
@@ -16,6 +16,17 @@ void WebSocketServer::setupRoutes() {
     };
 
     httpd_register_uri_handler(server, &ws_uri);
+
+    // Flushes output left behind by commands that print and then go quiet
+    if (!flushTimer) {
+        esp_timer_create_args_t args = {};
+        args.callback = &WebSocketServer::flushTimerCallback;
+        args.arg = this;
+        args.name = "ws_flush";
+        if (esp_timer_create(&args, &flushTimer) == ESP_OK) {
+            esp_timer_start_periodic(flushTimer, FLUSH_INTERVAL_MS * 1000);
+        }
+    }
 }
 
 esp_err_t WebSocketServer::wsHandler(httpd_req_t *req) {
@@ -56,6 +67,7 @@ esp_err_t WebSocketServer::wsHandler(httpd_req_t *req) {
 }
 
 char WebSocketServer::readCharBlocking() {
+    flush(); // nothing left behind while waiting for the user
     while (buffer.empty()) {
         delay(10);
     }
@@ -65,7 +77,13 @@ char WebSocketServer::readCharBlocking() {
 }
 
 char WebSocketServer::readCharNonBlocking() {
-    if (buffer.empty()) return KEY_NONE;
+    if (buffer.empty()) {
+        poll();
+        return KEY_NONE;
+    }
+
+    // Typed input, send the echo of the previous key as its own frame
+    flush();
 
     char c = buffer.front();
     buffer.pop_front();
@@ -74,49 +92,123 @@ char WebSocketServer::readCharNonBlocking() {
 }
 
 void WebSocketServer::sendText(const std::string& msg) {
-    if (clientFd < 0) return;
+    if (clientFd < 0 || msg.empty()) return;
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (pending.empty()) {
+        pendingSinceMs = millis();
+        pending.reserve(FLUSH_BYTES * 2);
+    }
+    pending += msg;
+
+    if (pending.size() >= FLUSH_BYTES || millis() - pendingSinceMs >= FLUSH_INTERVAL_MS) {
+        flushLocked(true);
+    }
+}
+
+void WebSocketServer::sendBinary(const uint8_t* data, size_t len) {
+    if (clientFd < 0 || !data || len == 0) return;
+
+    // Keep ordering with the text already buffered
+    std::lock_guard<std::mutex> lock(outputMutex);
+    flushLocked(true);
+    queueFrame(std::string(reinterpret_cast<const char*>(data), len), HTTPD_WS_TYPE_BINARY);
+}
+
+void WebSocketServer::poll() {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    if (!pending.empty() && millis() - pendingSinceMs >= FLUSH_INTERVAL_MS) {
+        flushLocked(true);
+    }
+}
+
+void WebSocketServer::flush() {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    flushLocked(true);
+}
 
-    // Sanitize UTF8
-    std::string safeMsg = sanitizeUtf8(msg);
+void WebSocketServer::flushTimerCallback(void* arg) {
+    auto* self = static_cast<WebSocketServer*>(arg);
+
+    // Never wait here, the producer flushes itself when it holds the lock
+    if (!self->outputMutex.try_lock()) return;
+    if (!self->pending.empty() && millis() - self->pendingSinceMs >= FLUSH_INTERVAL_MS &&
+        inFlight.load() < MAX_INFLIGHT_FRAMES) {
+        self->flushLocked(false);
+    }
+    self->outputMutex.unlock();
+}
+
+void WebSocketServer::flushLocked(bool wait) {
+    if (pending.empty()) return;
+    if (clientFd < 0) {
+        pending.clear();
+        return;
+    }
+
+    // Browsers close the socket on invalid UTF-8 text, raw bytes go out as binary
+    httpd_ws_type_t type = isValidUtf8(pending) ? HTTPD_WS_TYPE_TEXT : HTTPD_WS_TYPE_BINARY;
+    queueFrame(std::move(pending), type, wait);
+    pending = std::string();
+}
+
+bool WebSocketServer::queueFrame(std::string&& payload, httpd_ws_type_t type, bool wait) {
+    // Backpressure, the caller waits while the socket drains
+    uint32_t start = millis();
+    while (inFlight.load() >= MAX_INFLIGHT_FRAMES) {
+        if (!wait || millis() - start >= BACKPRESSURE_TIMEOUT_MS) {
+            droppedBytes += payload.size();
+            ESP_LOGW(TAG, "Client too slow, %u bytes dropped", (unsigned)payload.size());
+            return false;
+        }
+        vTaskDelay(1);
+    }
+
+    auto* frame = new OutgoingFrame{ server, clientFd, type, std::move(payload) };
+    inFlight++;
+
+    // Sent from the httpd task, so the caller never blocks on the socket itself
+    if (httpd_queue_work(server, sendFrameWork, frame) != ESP_OK) {
+        inFlight--;
+        droppedBytes += frame->payload.size();
+        delete frame;
+        return false;
+    }
+    return true;
+}
+
+void WebSocketServer::sendFrameWork(void* arg) {
+    auto* frame = static_cast<OutgoingFrame*>(arg);
 
     httpd_ws_frame_t ws_pkt = {};
-    ws_pkt.type = HTTPD_WS_TYPE_TEXT;
-    ws_pkt.payload = (uint8_t*) safeMsg.c_str();
-    ws_pkt.len = safeMsg.length();
+    ws_pkt.type = frame->type;
+    ws_pkt.payload = (uint8_t*) frame->payload.data();
+    ws_pkt.len = frame->payload.size();
+    httpd_ws_send_frame_async(frame->server, frame->fd, &ws_pkt);
 
-    httpd_ws_send_frame_async(server, clientFd, &ws_pkt);
+    delete frame;
+    inFlight--;
 }
 
-std::string WebSocketServer::sanitizeUtf8(const std::string& input) {
-    std::string output;
+bool WebSocketServer::isValidUtf8(const std::string& input) {
     size_t i = 0;
+    const size_t n = input.size();
 
-    while (i < input.size()) {
+    while (i < n) {
         unsigned char c = input[i];
+        size_t extra;
+
+        if (c <= 0x7F)                extra = 0;
+        else if ((c & 0xE0) == 0xC0)  extra = 1;
+        else if ((c & 0xF0) == 0xE0)  extra = 2;
+        else if ((c & 0xF8) == 0xF0)  extra = 3;
+        else return false;
 
-        if (c <= 0x7F) {  // ASCII
-            output += c;
-            i++;
-        } else if ((c & 0xE0) == 0xC0 && i + 1 < input.size() &&
-                   (input[i+1] & 0xC0) == 0x80) {
-            output += input.substr(i, 2);
-            i += 2;
-        } else if ((c & 0xF0) == 0xE0 && i + 2 < input.size() &&
-                   (input[i+1] & 0xC0) == 0x80 &&
-                   (input[i+2] & 0xC0) == 0x80) {
-            output += input.substr(i, 3);
-            i += 3;
-        } else if ((c & 0xF8) == 0xF0 && i + 3 < input.size() &&
-                   (input[i+1] & 0xC0) == 0x80 &&
-                   (input[i+2] & 0xC0) == 0x80 &&
-                   (input[i+3] & 0xC0) == 0x80) {
-            output += input.substr(i, 4);
-            i += 4;
-        } else {
-            // Invalid byte or sequence, skip it
-            i++;
+        if (i + extra >= n && extra) return false;
+        for (size_t k = 1; k <= extra; ++k) {
+            if ((input[i + k] & 0xC0) != 0x80) return false;
         }
+        i += extra + 1;
     }
-
-    return output;
-}
\ No newline at end of file
+    return true;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <deque>
+#include <atomic>
+#include <mutex>
+#include <esp_timer.h>
 #include <esp_http_server.h>
 #include <vector>
 #include <string>
@@ -15,12 +18,44 @@ public:
 
     char readCharBlocking();
     char readCharNonBlocking();
+
+    // Output is coalesced and sent every FLUSH_INTERVAL_MS or FLUSH_BYTES
     void sendText(const std::string& msg);
-    std::string sanitizeUtf8(const std::string& input);
+    void sendBinary(const uint8_t* data, size_t len);
+    void flush();
+    void poll();
+
+    static bool isValidUtf8(const std::string& input);
+    uint32_t getDroppedBytes() const { return droppedBytes; }
 
 private:
+    static constexpr size_t FLUSH_BYTES = 1024;
+    static constexpr uint32_t FLUSH_INTERVAL_MS = 20;
+    static constexpr uint8_t MAX_INFLIGHT_FRAMES = 4;
+    static constexpr uint32_t BACKPRESSURE_TIMEOUT_MS = 2000;
+
+    struct OutgoingFrame {
+        httpd_handle_t server;
+        int fd;
+        httpd_ws_type_t type;
+        std::string payload;
+    };
+
     static esp_err_t wsHandler(httpd_req_t *req);
+    static void sendFrameWork(void* arg);
+    static void flushTimerCallback(void* arg);
+    void flushLocked(bool wait);
+    bool queueFrame(std::string&& payload, httpd_ws_type_t type, bool wait = true);
+
     httpd_handle_t server;
     static inline std::deque<char> buffer;
     static inline int clientFd = -1; 
+
+    // Coalesced output
+    std::string pending;
+    uint32_t pendingSinceMs = 0;
+    uint32_t droppedBytes = 0;
+    std::mutex outputMutex;
+    esp_timer_handle_t flushTimer = nullptr;
+    static inline std::atomic<uint8_t> inFlight{0};
 };
@@ -0,0 +1,127 @@
+#include "BatchEdgeCaptureService.h"
+#include <esp_heap_caps.h>
+#include <soc/gpio_reg.h>
+
+BatchEdgeCaptureService::~BatchEdgeCaptureService() {
+    release();
+}
+
+bool BatchEdgeCaptureService::configure(const std::vector<uint8_t>& newPins) {
+    if (newPins.empty()) return false;
+
+    pins = newPins;
+    maskLow = 0;
+    maskHigh = 0;
+    for (uint8_t pin : pins) {
+        if (pin < 32) maskLow |= 1u << pin;
+        else          maskHigh |= 1u << (pin - 32);
+    }
+    count = 0;
+    windowCycles = 0;
+    sampleCount = 0;
+    truncated = false;
+    return true;
+}
+
+/*
+Capture
+*/
+bool BatchEdgeCaptureService::capture(uint32_t windowMs) {
+    if (pins.empty() || !allocate()) return false;
+    if (windowMs == 0) windowMs = 1;
+    if (windowMs > MAX_WINDOW_MS) windowMs = MAX_WINDOW_MS;
+
+    cyclesPerUs = getCpuFrequencyMhz();
+    const uint32_t limit = windowMs * 1000 * cyclesPerUs;
+    const uint32_t mLow = maskLow;
+    const uint32_t mHigh = maskHigh;
+    Transition* out = transitions;
+    const uint32_t cap = capacity;
+
+    uint32_t n = 0;
+    uint32_t samples = 1;
+    uint32_t lastLow = REG_READ(GPIO_IN_REG) & mLow;
+    uint32_t lastHigh = REG_READ(GPIO_IN1_REG) & mHigh;
+    const uint32_t start = ESP.getCycleCount();
+    uint32_t elapsed = 0;
+    initialLow = lastLow;
+    initialHigh = lastHigh;
+    truncated = false;
+
+    // Both banks are read every pass, the comparison is cheaper than a branch on the mask
+    while (elapsed < limit) {
+        uint32_t low = REG_READ(GPIO_IN_REG) & mLow;
+        uint32_t high = REG_READ(GPIO_IN1_REG) & mHigh;
+        elapsed = ESP.getCycleCount() - start;
+        samples++;
+        if (low == lastLow && high == lastHigh) continue;
+
+        if (n == cap) {
+            truncated = true;
+            break;
+        }
+        out[n].cycles = elapsed;
+        out[n].low = low;
+        out[n].high = high;
+        n++;
+        lastLow = low;
+        lastHigh = high;
+    }
+
+    count = n;
+    windowCycles = elapsed ? elapsed : 1;
+    sampleCount = samples;
+    return true;
+}
+
+void BatchEdgeCaptureService::release() {
+    if (transitions) {
+        heap_caps_free(transitions);
+        transitions = nullptr;
+    }
+    capacity = 0;
+    count = 0;
+}
+
+bool BatchEdgeCaptureService::allocate() {
+    if (transitions) return true;
+
+    // Deep buffer in PSRAM when the board has it, short one in internal RAM otherwise
+    transitions = (Transition*) heap_caps_malloc(PSRAM_TRANSITIONS * sizeof(Transition), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (transitions) {
+        capacity = PSRAM_TRANSITIONS;
+        return true;
+    }
+
+    transitions = (Transition*) heap_caps_malloc(INTERNAL_TRANSITIONS * sizeof(Transition), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (transitions) {
+        capacity = INTERNAL_TRANSITIONS;
+        return true;
+    }
+
+    capacity = 0;
+    return false;
+}
+
+bool BatchEdgeCaptureService::isTruncated() const { return truncated; }
+uint32_t BatchEdgeCaptureService::getTransitionCount() const { return count; }
+uint32_t BatchEdgeCaptureService::getCapacity() const { return capacity; }
+uint32_t BatchEdgeCaptureService::getWindowCycles() const { return windowCycles; }
+uint32_t BatchEdgeCaptureService::getSampleCount() const { return sampleCount; }
+uint32_t BatchEdgeCaptureService::getCyclesPerUs() const { return cyclesPerUs; }
+const std::vector<uint8_t>& BatchEdgeCaptureService::getPins() const { return pins; }
+
+bool BatchEdgeCaptureService::getInitialLevel(uint8_t pin) const {
+    return levelOf(initialLow, initialHigh, pin);
+}
+
+void BatchEdgeCaptureService::getEdges(uint8_t pin, std::vector<uint32_t>& out) const {
+    out.clear();
+    bool level = getInitialLevel(pin);
+    for (uint32_t i = 0; i < count; ++i) {
+        bool next = levelOf(transitions[i].low, transitions[i].high, pin);
+        if (next == level) continue;
+        out.push_back(transitions[i].cycles);
+        level = next;
+    }
+}
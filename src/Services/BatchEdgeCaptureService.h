@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+// Records level changes on many pins at once. GPIO_IN_REG and GPIO_IN1_REG
+// are polled in a tight loop and only the reads that differ from the previous
+// one are stored, stamped with the CPU cycle counter. Every pin then shares
+// the same timebase, which is what bus detection needs.
+class BatchEdgeCaptureService {
+public:
+    static constexpr uint32_t MAX_WINDOW_MS = 10000;
+
+    struct Transition {
+        uint32_t cycles;    // from the window start
+        uint32_t low;       // GPIO 0..31 after the change
+        uint32_t high;      // GPIO 32..48 after the change
+    };
+
+    ~BatchEdgeCaptureService();
+
+    // Pins to watch, others are masked out of the comparison
+    bool configure(const std::vector<uint8_t>& pins);
+
+    // Blocking capture, stops early when the buffer is full
+    bool capture(uint32_t windowMs);
+    void release();
+
+    bool isTruncated() const;
+    uint32_t getTransitionCount() const;
+    uint32_t getCapacity() const;
+    uint32_t getWindowCycles() const;
+    uint32_t getSampleCount() const;
+    uint32_t getCyclesPerUs() const;
+    const std::vector<uint8_t>& getPins() const;
+
+    // One pin out of the shared capture, edges are in cycles from the window start
+    bool getInitialLevel(uint8_t pin) const;
+    void getEdges(uint8_t pin, std::vector<uint32_t>& out) const;
+
+private:
+    static constexpr size_t PSRAM_TRANSITIONS = 32 * 1024;
+    static constexpr size_t INTERNAL_TRANSITIONS = 2 * 1024;
+
+    bool allocate();
+    static inline bool levelOf(uint32_t low, uint32_t high, uint8_t pin) {
+        return ((pin < 32 ? low >> pin : high >> (pin - 32)) & 1u) != 0;
+    }
+
+    std::vector<uint8_t> pins;
+    uint32_t maskLow = 0;
+    uint32_t maskHigh = 0;
+
+    Transition* transitions = nullptr;
+    uint32_t capacity = 0;
+    uint32_t count = 0;
+    uint32_t initialLow = 0;
+    uint32_t initialHigh = 0;
+    uint32_t windowCycles = 0;
+    uint32_t sampleCount = 0;
+    uint32_t cyclesPerUs = 1;
+    bool truncated = false;
+};
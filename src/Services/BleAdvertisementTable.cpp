@@ -0,0 +1,286 @@
+#include "BleAdvertisementTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace {
+
+const char* companyName(uint16_t id) {
+    switch (id) {
+        case 0x0006: return "Microsoft";
+        case 0x004C: return "Apple";
+        case 0x0059: return "Nordic";
+        case 0x0075: return "Samsung";
+        case 0x0087: return "Garmin";
+        case 0x00E0: return "Google";
+        case 0x012D: return "Sony";
+        case 0x0171: return "Amazon";
+        case 0x02E5: return "Espressif";
+        case 0x038F: return "Xiaomi";
+        case 0x0499: return "Ruuvi";
+        default:     return nullptr;
+    }
+}
+
+const char* appleType(uint8_t type) {
+    switch (type) {
+        case 0x02: return "iBeacon";
+        case 0x05: return "AirDrop";
+        case 0x07: return "Proximity Pairing";
+        case 0x09: return "AirPlay";
+        case 0x0C: return "Handoff";
+        case 0x0F: return "Nearby Action";
+        case 0x10: return "Nearby Info";
+        case 0x12: return "Find My";
+        default:   return nullptr;
+    }
+}
+
+}
+
+BleAdvertisementTable::~BleAdvertisementTable() {
+    release();
+}
+
+bool BleAdvertisementTable::allocate(size_t cap) {
+    if (entries && capacity == cap) return true;
+    release();
+    if (cap == 0 || cap > 0x7FFF) return false;
+
+    // Twice as many buckets as entries keeps the chains short
+    size_t bucketCount = 1;
+    while (bucketCount < cap * 2) bucketCount <<= 1;
+
+    entries = new (std::nothrow) Entry[cap];
+    links = new (std::nothrow) Link[cap];
+    buckets = new (std::nothrow) int16_t[bucketCount];
+    if (!entries || !links || !buckets) {
+        release();
+        return false;
+    }
+
+    capacity = cap;
+    bucketMask = bucketCount - 1;
+    clear();
+    return true;
+}
+
+void BleAdvertisementTable::release() {
+    delete[] entries;
+    delete[] links;
+    delete[] buckets;
+    entries = nullptr;
+    links = nullptr;
+    buckets = nullptr;
+    capacity = 0;
+    bucketMask = 0;
+    used = 0;
+    head = tail = NONE;
+}
+
+void BleAdvertisementTable::clear() {
+    if (buckets) std::fill(buckets, buckets + bucketMask + 1, NONE);
+    used = 0;
+    head = tail = NONE;
+    stats = Stats();
+}
+
+/*
+Update
+*/
+void BleAdvertisementTable::update(const uint8_t address[6], uint8_t addressType, int8_t rssi,
+                                   const uint8_t* payload, size_t len, uint32_t nowMs) {
+    if (!entries) return;
+    if (len > MAX_PAYLOAD) len = MAX_PAYLOAD;
+    stats.received++;
+
+    const uint32_t advHash = hashPayload(payload, len);
+    int16_t idx = find(address, advHash);
+
+    if (idx != NONE) {
+        Entry& e = entries[idx];
+        e.lastSeenMs = nowMs;
+        e.count++;
+        e.rssiSum += rssi;
+        if (rssi < e.rssiMin) e.rssiMin = rssi;
+        if (rssi > e.rssiMax) e.rssiMax = rssi;
+        if (idx != head) {
+            unlinkLru(idx);
+            pushFront(idx);
+        }
+        return;
+    }
+
+    // New advertisement, take a free slot or the least recently seen one
+    if (used < capacity) {
+        idx = (int16_t)used++;
+    } else {
+        idx = tail;
+        unlinkLru(idx);
+        unlinkBucket(idx);
+        stats.evicted++;
+    }
+
+    Entry& e = entries[idx];
+    memcpy(e.address, address, 6);
+    e.addressType = addressType;
+    e.advHash = advHash;
+    e.firstSeenMs = nowMs;
+    e.lastSeenMs = nowMs;
+    e.count = 1;
+    e.rssiMin = rssi;
+    e.rssiMax = rssi;
+    e.rssiSum = rssi;
+    e.payloadLen = (uint8_t)len;
+    memcpy(e.payload, payload, len);
+    decode(e, payload, len);
+
+    size_t b = bucketOf(address, advHash);
+    links[idx].chain = buckets[b];
+    buckets[b] = idx;
+    pushFront(idx);
+    stats.inserted++;
+}
+
+size_t BleAdvertisementTable::snapshot(Entry* out, size_t max) const {
+    size_t n = 0;
+    for (int16_t idx = head; idx != NONE && n < max; idx = links[idx].next) {
+        out[n++] = entries[idx];
+    }
+    return n;
+}
+
+uint32_t BleAdvertisementTable::hashPayload(const uint8_t* payload, size_t len) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= payload[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+Index
+*/
+size_t BleAdvertisementTable::bucketOf(const uint8_t address[6], uint32_t advHash) const {
+    uint32_t h = advHash;
+    for (int i = 0; i < 6; ++i) {
+        h ^= address[i];
+        h *= 16777619u;
+    }
+    return h & bucketMask;
+}
+
+int16_t BleAdvertisementTable::find(const uint8_t address[6], uint32_t advHash) const {
+    for (int16_t idx = buckets[bucketOf(address, advHash)]; idx != NONE; idx = links[idx].chain) {
+        const Entry& e = entries[idx];
+        if (e.advHash == advHash && memcmp(e.address, address, 6) == 0) return idx;
+    }
+    return NONE;
+}
+
+void BleAdvertisementTable::unlinkLru(int16_t idx) {
+    Link& l = links[idx];
+    if (l.prev != NONE) links[l.prev].next = l.next;
+    else head = l.next;
+    if (l.next != NONE) links[l.next].prev = l.prev;
+    else tail = l.prev;
+    l.prev = l.next = NONE;
+}
+
+void BleAdvertisementTable::pushFront(int16_t idx) {
+    links[idx].prev = NONE;
+    links[idx].next = head;
+    if (head != NONE) links[head].prev = idx;
+    head = idx;
+    if (tail == NONE) tail = idx;
+}
+
+void BleAdvertisementTable::unlinkBucket(int16_t idx) {
+    int16_t* slot = &buckets[bucketOf(entries[idx].address, entries[idx].advHash)];
+    while (*slot != NONE) {
+        if (*slot == idx) {
+            *slot = links[idx].chain;
+            return;
+        }
+        slot = &links[*slot].chain;
+    }
+}
+
+/*
+Decode
+*/
+void BleAdvertisementTable::decode(Entry& e, const uint8_t* payload, size_t len) {
+    e.connectable = false;
+    e.name[0] = '\0';
+    e.hasManufacturer = false;
+    e.companyId = 0;
+    e.manufacturerLen = 0;
+
+    for (size_t i = 0; i + 1 < len;) {
+        uint8_t fieldLen = payload[i];
+        if (fieldLen == 0 || i + fieldLen + 1 > len) break;
+
+        uint8_t adType = payload[i + 1];
+        const uint8_t* data = payload + i + 2;
+        size_t dataLen = fieldLen - 1;
+
+        if (adType == 0x01 && dataLen >= 1) {
+            // LE General Discoverable, same rule as isLikelyConnectable
+            e.connectable = (data[0] & 0x02) != 0;
+        } else if ((adType == 0x09 || (adType == 0x08 && !e.name[0])) && dataLen > 0) {
+            size_t n = std::min(dataLen, MAX_NAME);
+            memcpy(e.name, data, n);
+            e.name[n] = '\0';
+        } else if (adType == 0xFF && dataLen >= 2) {
+            e.hasManufacturer = true;
+            e.companyId = data[0] | (data[1] << 8);
+            e.manufacturerLen = (uint8_t)std::min(dataLen - 2, MAX_MANUFACTURER);
+            memcpy(e.manufacturer, data + 2, e.manufacturerLen);
+        }
+
+        i += fieldLen + 1;
+    }
+}
+
+std::string BleAdvertisementTable::Entry::formatAddress() const {
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X",
+             address[0], address[1], address[2], address[3], address[4], address[5]);
+    return buf;
+}
+
+std::string BleAdvertisementTable::Entry::describeManufacturer() const {
+    if (!hasManufacturer) return "";
+
+    char buf[64];
+    const char* company = companyName(companyId);
+    if (company) snprintf(buf, sizeof(buf), "%s", company);
+    else snprintf(buf, sizeof(buf), "0x%04X", companyId);
+    std::string out = buf;
+
+    if (companyId == 0x004C && manufacturerLen >= 1) {
+        const char* type = appleType(manufacturer[0]);
+
+        // iBeacon: type, length, UUID, major, minor, TX power
+        if (manufacturer[0] == 0x02 && manufacturerLen >= 23) {
+            const uint8_t* u = manufacturer + 2;
+            snprintf(buf, sizeof(buf), " iBeacon %02X%02X%02X%02X-..-%02X%02X %u/%u",
+                     u[0], u[1], u[2], u[3], u[14], u[15],
+                     (unsigned)((u[16] << 8) | u[17]), (unsigned)((u[18] << 8) | u[19]));
+            return out + buf;
+        }
+        if (type) return out + " " + type;
+    }
+
+    // Raw bytes after the company ID, enough to tell devices apart
+    size_t shown = std::min<size_t>(manufacturerLen, 8);
+    for (size_t i = 0; i < shown; ++i) {
+        snprintf(buf, sizeof(buf), "%s%02X", i ? "" : " ", manufacturer[i]);
+        out += buf;
+    }
+    if (manufacturerLen > shown) out += "..";
+    return out;
+}
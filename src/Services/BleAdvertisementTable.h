@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Fixed capacity table of BLE advertisements seen while sniffing.
+// One entry per address and advertisement payload, repeats only update the
+// counters. Lookups go through a chained hash index, the least recently
+// seen entry is evicted when the table is full. Nothing is allocated after
+// allocate(), so update() is safe from the scan callback.
+class BleAdvertisementTable {
+public:
+    static constexpr size_t MAX_PAYLOAD = 31;
+    static constexpr size_t MAX_NAME = 24;
+    static constexpr size_t MAX_MANUFACTURER = 24;
+
+    struct Entry {
+        uint8_t address[6];
+        uint8_t addressType;
+        bool connectable;
+        uint32_t advHash;
+        uint32_t firstSeenMs;
+        uint32_t lastSeenMs;
+        uint32_t count;
+        int8_t rssiMin;
+        int8_t rssiMax;
+        int64_t rssiSum;
+        char name[MAX_NAME + 1];
+        bool hasManufacturer;
+        uint16_t companyId;
+        uint8_t manufacturerLen;
+        uint8_t manufacturer[MAX_MANUFACTURER];   // after the company ID
+        uint8_t payloadLen;
+        uint8_t payload[MAX_PAYLOAD];
+
+        int rssiAvg() const { return count ? (int)(rssiSum / (int64_t)count) : 0; }
+        std::string formatAddress() const;
+
+        // Company and, when known, what the payload announces (iBeacon, Find My...)
+        std::string describeManufacturer() const;
+    };
+
+    struct Stats {
+        uint32_t received = 0;
+        uint32_t inserted = 0;
+        uint32_t evicted = 0;
+    };
+
+    ~BleAdvertisementTable();
+
+    bool allocate(size_t capacity = 128);
+    void release();
+    void clear();
+
+    void update(const uint8_t address[6], uint8_t addressType, int8_t rssi,
+                const uint8_t* payload, size_t len, uint32_t nowMs);
+
+    // Copies up to max entries, most recently seen first
+    size_t snapshot(Entry* out, size_t max) const;
+
+    size_t size() const { return used; }
+    size_t getCapacity() const { return capacity; }
+    const Stats& getStats() const { return stats; }
+
+    static uint32_t hashPayload(const uint8_t* payload, size_t len);
+
+private:
+    static constexpr int16_t NONE = -1;
+
+    struct Link {
+        int16_t prev;       // LRU order, head is the most recent
+        int16_t next;
+        int16_t chain;      // next entry in the same bucket
+    };
+
+    Entry* entries = nullptr;
+    Link* links = nullptr;
+    int16_t* buckets = nullptr;
+    size_t capacity = 0;
+    size_t bucketMask = 0;
+    size_t used = 0;
+    int16_t head = NONE;
+    int16_t tail = NONE;
+    Stats stats;
+
+    size_t bucketOf(const uint8_t address[6], uint32_t advHash) const;
+    int16_t find(const uint8_t address[6], uint32_t advHash) const;
+    void unlinkLru(int16_t idx);
+    void pushFront(int16_t idx);
+    void unlinkBucket(int16_t idx);
+    static void decode(Entry& e, const uint8_t* payload, size_t len);
+};
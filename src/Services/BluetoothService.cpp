@@ -3,10 +3,7 @@
 
 
 // Static var for the sniffer
-std::vector<std::string> BluetoothService::bluetoothSniffLog;
-portMUX_TYPE BluetoothService::bluetoothSniffMux = portMUX_INITIALIZER_UNLOCKED;
 BLEScan* BluetoothService::bleScan = nullptr;
-std::string BluetoothService::lastAdParsed = "";
 
 // Callback connect/disconnect
 class BluetoothServerCallbacks : public BLEServerCallbacks {
@@ -306,59 +303,38 @@ bool BluetoothService::spoofMacAddress(const std::string& macStr) {
 }
 
 void BluetoothService::PassiveAdvertisedDeviceCallbacks::onResult(BLEAdvertisedDevice advertisedDevice) {
-
-    String name = advertisedDevice.getName().isEmpty() ? "(unknown)" : advertisedDevice.getName();
-    String addr = advertisedDevice.getAddress().toString();
-    int rssi = advertisedDevice.getRSSI();
-
-    std::string type = isLikelyConnectable(advertisedDevice)
-        ? "Connectable"
-        : "Non-Connectable";
-
-    std::string adParsed = parseAdTypes(
-        advertisedDevice.getPayload(),
-        advertisedDevice.getPayloadLength()
-    );
-
-    // No AD duplicate
-    if (adParsed == lastAdParsed) return;
-    lastAdParsed = adParsed;
-
-    //  Build formatted frame
-    std::string logEntry;
-
-    logEntry += "[BLUETOOTH FRAME #" + std::to_string(receivedFramesCount+1) + "]\r\n";
-    logEntry += "  Addr : " + std::string(addr.c_str()) + "\r\n";
-    logEntry += "  Name : " + std::string(name.c_str()) + "\r\n";
-    logEntry += "  RSSI : " + std::to_string(rssi) + " dBm\r\n";
-    logEntry += "  Type : " + type + "\r\n";
-
-    if (!adParsed.empty()) {
-        logEntry += adParsed;
-        logEntry += "\r\n";
+    // Runs in the BLE host task, repeats only bump counters in the table
+    uint8_t addr[6];
+    unsigned values[6];
+    String addrStr = advertisedDevice.getAddress().toString();
+    if (sscanf(addrStr.c_str(), "%x:%x:%x:%x:%x:%x",
+               &values[0], &values[1], &values[2],
+               &values[3], &values[4], &values[5]) != 6) {
+        return;
     }
+    for (int i = 0; i < 6; ++i) addr[i] = (uint8_t)values[i];
 
-    //  Store
-    portENTER_CRITICAL(&BluetoothService::bluetoothSniffMux);
-
-    if (bluetoothSniffLog.size() > 200)
-        bluetoothSniffLog.erase(bluetoothSniffLog.begin());
-
-    BluetoothService::bluetoothSniffLog.push_back(logEntry);
-    portEXIT_CRITICAL(&BluetoothService::bluetoothSniffMux);
-
-    receivedFramesCount++;
+    portENTER_CRITICAL(&sniffTableMux);
+    sniffTable.update(addr, (uint8_t)advertisedDevice.getAddressType(), (int8_t)advertisedDevice.getRSSI(),
+                      advertisedDevice.getPayload(), advertisedDevice.getPayloadLength(), millis());
+    portEXIT_CRITICAL(&sniffTableMux);
 }
 
-void BluetoothService::startPassiveBluetoothSniffing() {
+bool BluetoothService::startPassiveBluetoothSniffing() {
+    if (!sniffTable.allocate()) return false;
+    portENTER_CRITICAL(&sniffTableMux);
+    sniffTable.clear();
+    portEXIT_CRITICAL(&sniffTableMux);
+
     if (!BLEDevice::getInitialized()) {
         BLEDevice::init("Sniffer");
     }
 
     bleScan = BLEDevice::getScan();
-    bleScan->setAdvertisedDeviceCallbacks(new PassiveAdvertisedDeviceCallbacks(), false);
+    bleScan->setAdvertisedDeviceCallbacks(new PassiveAdvertisedDeviceCallbacks(), true);
     bleScan->setActiveScan(false);
     bleScan->start(0, nullptr);
+    return true;
 }
 
 void BluetoothService::stopPassiveBluetoothSniffing() {
@@ -368,15 +344,21 @@ void BluetoothService::stopPassiveBluetoothSniffing() {
         bleScan->clearResults();
         bleScan = nullptr;
     }
-    bluetoothSniffLog.clear();
 }
 
-std::vector<std::string> BluetoothService::getBluetoothSniffLog() {
-    std::vector<std::string> copy;
-    portENTER_CRITICAL(&bluetoothSniffMux);
-    copy.swap(bluetoothSniffLog);
-    portEXIT_CRITICAL(&bluetoothSniffMux);
-    return copy;
+size_t BluetoothService::getBluetoothSniffTable(BleAdvertisementTable::Entry* out, size_t max) {
+    portENTER_CRITICAL(&sniffTableMux);
+    size_t n = sniffTable.snapshot(out, max);
+    portEXIT_CRITICAL(&sniffTableMux);
+    return n;
+}
+
+BleAdvertisementTable::Stats BluetoothService::getBluetoothSniffStats(size_t& unique) {
+    portENTER_CRITICAL(&sniffTableMux);
+    BleAdvertisementTable::Stats stats = sniffTable.getStats();
+    unique = sniffTable.size();
+    portEXIT_CRITICAL(&sniffTableMux);
+    return stats;
 }
 
 bool BluetoothService::isLikelyConnectable(BLEAdvertisedDevice& device) {
@@ -7,6 +7,7 @@
 #include "BLEHIDDevice.h"
 #include "HIDTypes.h"
 #include "Data/AsciiHid.h"
+#include "Services/BleAdvertisementTable.h"
 
 enum class BluetoothMode {
     NONE,
@@ -31,8 +32,8 @@ private:
     static const uint8_t HID_REPORT_MAP[];
     BluetoothMode mode = BluetoothMode::NONE;
     static BLEScan* bleScan;
-    static std::string lastAdParsed;
-    inline static uint32_t receivedFramesCount = 0;
+    inline static BleAdvertisementTable sniffTable;
+    inline static portMUX_TYPE sniffTableMux = portMUX_INITIALIZER_UNLOCKED;
 
 public:
     class PassiveAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
@@ -79,12 +80,13 @@ public:
     
     // Bluetooth sniffing
     class PassiveBLEAdvertisedDeviceCallbacks;
-    static void startPassiveBluetoothSniffing();
+    static bool startPassiveBluetoothSniffing();
     static void stopPassiveBluetoothSniffing();
-    static std::vector<std::string> getBluetoothSniffLog();
+    // Advertisements seen so far, most recent first
+    static size_t getBluetoothSniffTable(BleAdvertisementTable::Entry* out, size_t max);
+    static BleAdvertisementTable::Stats getBluetoothSniffStats(size_t& unique);
+    static size_t getBluetoothSniffCapacity() { return sniffTable.getCapacity(); }
     static bool isLikelyConnectable(BLEAdvertisedDevice& device);
     static std::string parseAdTypes(const uint8_t* payload, size_t len);
-    static std::vector<std::string> bluetoothSniffLog;
-    static portMUX_TYPE bluetoothSniffMux;
 };
 
@@ -2,6 +2,8 @@
 #include <SPI.h>
 #include <cstdio>
 #include <cstring>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
 
 void CanService::configure(uint8_t cs, uint8_t sck, uint8_t miso, uint8_t mosi, uint32_t bitrateKbps) {
     // Save to use with reset()
@@ -21,6 +23,7 @@ void CanService::reset() {
     delay(50);
     mcp2515.reset();
     mcp2515.setBitrate(resolveBitrate(kbps));
+    applyAcceptanceFilters();
     mcp2515.setNormalMode();
 }
 
@@ -44,18 +47,264 @@ bool CanService::readFrame(struct can_frame& outFrame) {
 std::string CanService::readFrameAsString() {
     struct can_frame frame;
     if (!readFrame(frame)) return "";
+    return formatFrame(frame);
+}
 
+std::string CanService::formatFrame(const struct can_frame& frame) {
     char buffer[64];
-    snprintf(buffer, sizeof(buffer), "| ID: 0x%03X | DLC: %d | Data:", frame.can_id, frame.can_dlc);
+    bool extended = frame.can_id & CAN_EFF_FLAG;
+    uint32_t id = frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    uint8_t dlc = frame.can_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : frame.can_dlc;
+
+    snprintf(buffer, sizeof(buffer), extended ? "| ID: 0x%08lX | DLC: %d | Data:" : "| ID: 0x%03lX | DLC: %d | Data:",
+             (unsigned long)id, dlc);
 
     std::string result = buffer;
-    for (int i = 0; i < frame.can_dlc; ++i) {
+    if (frame.can_id & CAN_RTR_FLAG) return result + " RTR";
+    for (int i = 0; i < dlc; ++i) {
         snprintf(buffer, sizeof(buffer), " %02X", frame.data[i]);
         result += buffer;
     }
     return result;
 }
 
+std::string CanService::formatCandump(const CanCapturedFrame& captured, uint64_t baseUs, const char* interfaceName) {
+    static const char hex[] = "0123456789ABCDEF";
+    const struct can_frame& frame = captured.frame;
+    bool extended = frame.can_id & CAN_EFF_FLAG;
+    uint32_t id = frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+    uint64_t t = captured.timestampUs - baseUs;
+
+    // candump -l: "(1.000123) can0 123#DEADBEEF"
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), extended ? "(%llu.%06llu) %s %08lX#" : "(%llu.%06llu) %s %03lX#",
+             (unsigned long long)(t / 1000000), (unsigned long long)(t % 1000000), interfaceName, (unsigned long)id);
+
+    std::string line = buffer;
+    if (frame.can_id & CAN_RTR_FLAG) {
+        line += 'R';
+    } else {
+        uint8_t dlc = frame.can_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : frame.can_dlc;
+        for (int i = 0; i < dlc; ++i) {
+            line += hex[frame.data[i] >> 4];
+            line += hex[frame.data[i] & 0x0F];
+        }
+    }
+    line += '\n';
+    return line;
+}
+
+void IRAM_ATTR CanService::intIsr(void* arg) {
+    CanService* self = reinterpret_cast<CanService*>(arg);
+    BaseType_t woken = pdFALSE;
+    if (self->captureTaskHandle) vTaskNotifyGiveFromISR(self->captureTaskHandle, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void CanService::captureTask(void* arg) {
+    CanService* self = reinterpret_cast<CanService*>(arg);
+    const bool useInt = self->captureIntPin != CAN_INT_PIN_NONE;
+
+    while (self->captureRunning) {
+        // INT is active low and stays low while a flag is set, no edge is missed
+        // as long as we keep draining until it goes back high
+        if (useInt) {
+            if (gpio_get_level((gpio_num_t)self->captureIntPin) != 0) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+            }
+        } else {
+            vTaskDelay(1);
+        }
+        if (!self->captureRunning) break;
+        self->drainController();
+    }
+
+    self->captureTaskDone = true;
+    vTaskDelete(nullptr);
+}
+
+void CanService::pushFrame(const struct can_frame& frame, uint64_t timestampUs) {
+    frameCount.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= CAN_CAPTURE_RING_SIZE) {
+        ringDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CanCapturedFrame& slot = ring[h & (CAN_CAPTURE_RING_SIZE - 1)];
+    slot.timestampUs = timestampUs;
+    slot.frame = frame;
+    head.store(h + 1, std::memory_order_release);
+}
+
+void CanService::drainController() {
+    // Both RX buffers, the rollover lands in RXB1 while RXB0 is being read
+    struct can_frame frame;
+    while (mcp2515.readMessage(&frame) == MCP2515::ERROR_OK) {
+        pushFrame(frame, esp_timer_get_time());
+    }
+
+    // Error flags keep INT low until cleared, only touch the ones we handled
+    uint8_t irq = mcp2515.getInterrupts();
+    if (irq & (MCP2515::CANINTF_ERRIF | MCP2515::CANINTF_MERRF)) {
+        uint8_t eflg = mcp2515.getErrorFlags();
+        if (eflg & (MCP2515::EFLG_RX0OVR | MCP2515::EFLG_RX1OVR)) {
+            hwOverruns.fetch_add(1, std::memory_order_relaxed);
+            mcp2515.clearRXnOVRFlags();
+        } else {
+            errorCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (irq & MCP2515::CANINTF_ERRIF) mcp2515.clearERRIF();
+        if (irq & MCP2515::CANINTF_MERRF) mcp2515.clearMERR();
+    }
+}
+
+bool CanService::startCapture(uint8_t intPin) {
+    stopCapture();
+
+    if (!ring) {
+        ring = (CanCapturedFrame*)heap_caps_malloc(sizeof(CanCapturedFrame) * CAN_CAPTURE_RING_SIZE, MALLOC_CAP_8BIT);
+        if (!ring) return false;
+    }
+
+    head.store(0);
+    tail.store(0);
+    frameCount.store(0);
+    ringDrops.store(0);
+    hwOverruns.store(0);
+    errorCount.store(0);
+
+    captureIntPin = intPin;
+    captureRunning = true;
+    captureTaskDone = false;
+
+    // Above the CLI loop so printing never delays a drain
+    if (xTaskCreatePinnedToCore(captureTask, "CanCapture", CAN_CAPTURE_TASK_STACK, this, 5, &captureTaskHandle, 1) != pdPASS) {
+        captureTaskHandle = nullptr;
+        captureRunning = false;
+        captureTaskDone = true;
+        return false;
+    }
+
+    if (intPin != CAN_INT_PIN_NONE) {
+        esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+            stopCapture();
+            return false;
+        }
+        pinMode(intPin, INPUT_PULLUP);
+        gpio_set_intr_type((gpio_num_t)intPin, GPIO_INTR_NEGEDGE);
+        if (gpio_isr_handler_add((gpio_num_t)intPin, &CanService::intIsr, this) != ESP_OK) {
+            stopCapture();
+            return false;
+        }
+        gpio_intr_enable((gpio_num_t)intPin);
+        xTaskNotifyGive(captureTaskHandle);   // frames may already be waiting
+    }
+    return true;
+}
+
+void CanService::stopCapture() {
+    if (!captureRunning && captureTaskDone) return;
+
+    if (captureIntPin != CAN_INT_PIN_NONE) {
+        gpio_intr_disable((gpio_num_t)captureIntPin);
+        gpio_set_intr_type((gpio_num_t)captureIntPin, GPIO_INTR_DISABLE);
+        gpio_isr_handler_remove((gpio_num_t)captureIntPin);
+    }
+
+    captureRunning = false;
+    if (captureTaskHandle) xTaskNotifyGive(captureTaskHandle);
+
+    // The task owns the SPI bus until it exits, it wakes at least every 50 ms
+    while (!captureTaskDone) delay(1);
+    captureTaskHandle = nullptr;
+    captureIntPin = CAN_INT_PIN_NONE;
+}
+
+size_t CanService::readCaptured(CanCapturedFrame* out, size_t max) {
+    if (!ring) return 0;
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    size_t n = 0;
+
+    while (t != h && n < max) {
+        out[n++] = ring[t & (CAN_CAPTURE_RING_SIZE - 1)];
+        ++t;
+    }
+
+    tail.store(t, std::memory_order_release);
+    return n;
+}
+
+CanCaptureStats CanService::getCaptureStats() const {
+    CanCaptureStats stats;
+    stats.frames = frameCount.load();
+    stats.ringDrops = ringDrops.load();
+    stats.hwOverruns = hwOverruns.load();
+    stats.errors = errorCount.load();
+    return stats;
+}
+
+bool CanService::setAcceptanceFilters(const std::vector<CanAcceptanceFilter>& filters) {
+    // Six filters in hardware, one frame format for all of them
+    if (filters.size() > 6) return false;
+    for (const auto& f : filters) {
+        if (f.extended != filters.front().extended) return false;
+    }
+    acceptanceFilters = filters;
+
+    mcp2515.setConfigMode();
+    applyAcceptanceFilters();
+    mcp2515.setNormalMode();
+    return true;
+}
+
+void CanService::clearAcceptanceFilters() {
+    setAcceptanceFilters({});
+}
+
+void CanService::applyAcceptanceFilters() {
+    // Caller is in config mode. RXB0 has MASK0 with RXF0-1, RXB1 has MASK1
+    // with RXF2-5. Entries 1-2 go to RXB0 and 3-6 to RXB1, a bank mask is
+    // the AND of its entries' masks so it can only accept more, never less.
+    const MCP2515::RXF rxf[] = {
+        MCP2515::RXF0, MCP2515::RXF1, MCP2515::RXF2, MCP2515::RXF3, MCP2515::RXF4, MCP2515::RXF5
+    };
+
+    if (acceptanceFilters.empty()) {
+        // Same as after a reset, everything goes through
+        mcp2515.setFilterMask(MCP2515::MASK0, false, 0);
+        mcp2515.setFilterMask(MCP2515::MASK1, false, 0);
+        for (auto f : rxf) mcp2515.setFilter(f, false, 0);
+        return;
+    }
+
+    size_t count = acceptanceFilters.size();
+    auto entryFor = [&](size_t slot) -> const CanAcceptanceFilter& {
+        // Unused slots repeat an entry of their bank, RXB1 mirrors RXB0 if empty
+        if (slot < 2) return acceptanceFilters[slot < count ? slot : 0];
+        if (count <= 2) return acceptanceFilters[(slot - 2) % count];
+        return acceptanceFilters[slot < count ? slot : 2];
+    };
+
+    const bool ext = acceptanceFilters.front().extended;
+    const uint32_t idMask = ext ? CAN_EFF_MASK : CAN_SFF_MASK;
+    uint32_t mask0 = idMask, mask1 = idMask;
+    for (size_t slot = 0; slot < 6; ++slot) {
+        if (slot < 2) mask0 &= entryFor(slot).mask;
+        else          mask1 &= entryFor(slot).mask;
+    }
+
+    mcp2515.setFilterMask(MCP2515::MASK0, ext, mask0);
+    mcp2515.setFilterMask(MCP2515::MASK1, ext, mask1);
+    for (size_t slot = 0; slot < 6; ++slot) {
+        mcp2515.setFilter(rxf[slot], ext, entryFor(slot).id & idMask);
+    }
+}
+
 std::string CanService::getStatus() {
     uint8_t status = mcp2515.getStatus();
     uint8_t interrupts = mcp2515.getInterrupts();
@@ -2,8 +2,10 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
 #include <mcp2515.h>
 #include <Arduino.h>
+#include "driver/gpio.h"
 
 // Must be global to work, cs pin needs to be set at compile time
 #ifdef DEVICE_TEMBEDS3CC1101
@@ -12,6 +14,28 @@
     MCP2515 mcp2515 = MCP2515(CAN_CS_PIN);
 #endif
 
+#define CAN_INT_PIN_NONE 0xFF
+#define CAN_CAPTURE_RING_SIZE 1024   // frames, power of two
+#define CAN_CAPTURE_TASK_STACK 4096
+
+struct CanCapturedFrame {
+    uint64_t timestampUs;
+    struct can_frame frame;
+};
+
+struct CanCaptureStats {
+    uint32_t frames = 0;        // frames pulled out of the MCP2515
+    uint32_t ringDrops = 0;     // frames lost because the consumer fell behind
+    uint32_t hwOverruns = 0;    // RXB0/RXB1 overflow flags, frames lost in the chip
+    uint32_t errors = 0;        // ERRIF/MERRF interrupts
+};
+
+struct CanAcceptanceFilter {
+    uint32_t id;
+    uint32_t mask;
+    bool extended;
+};
+
 class CanService {
 public:
     void configure(uint8_t csPin, uint8_t sck, uint8_t miso, uint8_t mosi, uint32_t bitrateKbps = 125);
@@ -22,6 +46,20 @@ public:
     bool sendFrame(uint32_t id, const std::vector<uint8_t>& data);
     bool readFrame(struct can_frame& outFrame);
     std::string readFrameAsString();  // pour affichage
+    static std::string formatFrame(const struct can_frame& frame);
+    static std::string formatCandump(const CanCapturedFrame& captured, uint64_t baseUs, const char* interfaceName = "can0");
+
+    // Reader task, drains the MCP2515 on INT (or by polling without it) into a frame ring
+    bool startCapture(uint8_t intPin);
+    void stopCapture();
+    bool isCapturing() const { return captureRunning; }
+    size_t readCaptured(CanCapturedFrame* out, size_t max);
+    CanCaptureStats getCaptureStats() const;
+
+    // Hardware acceptance filters, kept across reset()
+    bool setAcceptanceFilters(const std::vector<CanAcceptanceFilter>& filters);
+    void clearAcceptanceFilters();
+    const std::vector<CanAcceptanceFilter>& getAcceptanceFilters() const { return acceptanceFilters; }
 
     void setBitrate(uint32_t bitrateKbps);
     uint32_t closestSupportedBitrate(uint32_t kbps);
@@ -36,4 +74,24 @@ private:
     uint8_t csPin, sckPin, misoPin, mosiPin;
     uint32_t kbps;
 
+    void applyAcceptanceFilters();
+    std::vector<CanAcceptanceFilter> acceptanceFilters;
+
+    static void IRAM_ATTR intIsr(void* arg);
+    static void captureTask(void* arg);
+    void drainController();
+    void pushFrame(const struct can_frame& frame, uint64_t timestampUs);
+
+    CanCapturedFrame* ring = nullptr;
+    std::atomic<uint32_t> head{0};     // written by the reader task
+    std::atomic<uint32_t> tail{0};     // written by the consumer
+    std::atomic<uint32_t> frameCount{0};
+    std::atomic<uint32_t> ringDrops{0};
+    std::atomic<uint32_t> hwOverruns{0};
+    std::atomic<uint32_t> errorCount{0};
+
+    TaskHandle_t captureTaskHandle = nullptr;
+    volatile bool captureRunning = false;
+    volatile bool captureTaskDone = true;
+    uint8_t captureIntPin = CAN_INT_PIN_NONE;
 };
@@ -0,0 +1,121 @@
+#include "ChannelHopScheduler.h"
+#include <algorithm>
+
+ChannelHopScheduler::ChannelHopScheduler() {
+    reset();
+}
+
+void ChannelHopScheduler::setDwellRange(uint16_t minMs, uint16_t maxMs) {
+    minDwellMs = std::max<uint16_t>(1, minMs);
+    maxDwellMs = std::max(minDwellMs, maxMs);
+}
+
+bool ChannelHopScheduler::exclude(uint8_t channel) {
+    if (channel < 1 || channel > MAX_CHANNEL) return false;
+    if (slots[channel].enabled && enabledCount() == 1) return false;
+    slots[channel].enabled = false;
+    if (pinned == channel) pinned = 0;
+    return true;
+}
+
+bool ChannelHopScheduler::include(uint8_t channel) {
+    if (channel < 1 || channel > MAX_CHANNEL) return false;
+    slots[channel].enabled = true;
+    return true;
+}
+
+bool ChannelHopScheduler::pin(uint8_t channel) {
+    if (channel < 1 || channel > MAX_CHANNEL) return false;
+    slots[channel].enabled = true;
+    pinned = channel;
+    return true;
+}
+
+bool ChannelHopScheduler::isEnabled(uint8_t channel) const {
+    return channel >= 1 && channel <= MAX_CHANNEL && slots[channel].enabled;
+}
+
+void ChannelHopScheduler::reset() {
+    for (uint8_t ch = 0; ch <= MAX_CHANNEL; ++ch) {
+        slots[ch] = Slot();
+        slots[ch].enabled = ch >= 1 && ch <= 13;
+    }
+    pinned = 0;
+    currentChannel = 1;
+}
+
+void ChannelHopScheduler::resetStats() {
+    for (auto& slot : slots) {
+        slot.visited = false;
+        slot.frames = 0;
+        slot.timeMs = 0;
+        slot.rate = 0;
+    }
+}
+
+uint8_t ChannelHopScheduler::start() {
+    if (pinned) currentChannel = pinned;
+    else if (!isEnabled(currentChannel)) currentChannel = nextEnabled(currentChannel);
+    return currentChannel;
+}
+
+uint16_t ChannelHopScheduler::dwellMs() const {
+    const Slot& slot = slots[currentChannel];
+    float peak = peakRate();
+    if (!slot.visited || peak <= 0) return minDwellMs;
+
+    float share = slot.rate / peak;
+    return (uint16_t)(minDwellMs + share * (maxDwellMs - minDwellMs));
+}
+
+uint8_t ChannelHopScheduler::advance(uint32_t frames, uint32_t elapsedMs) {
+    Slot& slot = slots[currentChannel];
+    slot.frames += frames;
+    slot.timeMs += elapsedMs;
+
+    if (elapsedMs > 0) {
+        float rate = frames * 1000.0f / elapsedMs;
+        slot.rate = slot.visited ? slot.rate + SMOOTHING * (rate - slot.rate) : rate;
+        slot.visited = true;
+    }
+
+    if (!pinned) currentChannel = nextEnabled(currentChannel);
+    return currentChannel;
+}
+
+std::vector<ChannelHopScheduler::ChannelStats> ChannelHopScheduler::getStats() const {
+    std::vector<ChannelStats> out;
+    out.reserve(MAX_CHANNEL);
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ++ch) {
+        ChannelStats s;
+        s.channel = ch;
+        s.enabled = slots[ch].enabled;
+        s.frames = slots[ch].frames;
+        s.timeMs = slots[ch].timeMs;
+        s.framesPerSec = slots[ch].rate;
+        out.push_back(s);
+    }
+    return out;
+}
+
+uint8_t ChannelHopScheduler::nextEnabled(uint8_t from) const {
+    for (uint8_t i = 1; i <= MAX_CHANNEL; ++i) {
+        uint8_t ch = (uint8_t)((from + i - 1) % MAX_CHANNEL + 1);
+        if (slots[ch].enabled) return ch;
+    }
+    return from;
+}
+
+uint8_t ChannelHopScheduler::enabledCount() const {
+    uint8_t n = 0;
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ++ch) n += slots[ch].enabled;
+    return n;
+}
+
+float ChannelHopScheduler::peakRate() const {
+    float peak = 0;
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ++ch) {
+        if (slots[ch].enabled && slots[ch].rate > peak) peak = slots[ch].rate;
+    }
+    return peak;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Picks the next Wi-Fi channel and how long to stay on it.
+// Enabled channels are visited in turn, the dwell time of each one follows
+// its smoothed frame rate: empty channels get the minimum dwell, the
+// busiest one the maximum. A pinned channel disables hopping.
+class ChannelHopScheduler {
+public:
+    static constexpr uint8_t MAX_CHANNEL = 14;
+
+    struct ChannelStats {
+        uint8_t channel = 0;
+        bool enabled = false;
+        uint32_t frames = 0;
+        uint32_t timeMs = 0;        // total time spent on the channel
+        float framesPerSec = 0;     // smoothed over the last dwells
+    };
+
+    ChannelHopScheduler();
+
+    void setDwellRange(uint16_t minMs, uint16_t maxMs);
+    uint16_t getMinDwellMs() const { return minDwellMs; }
+    uint16_t getMaxDwellMs() const { return maxDwellMs; }
+
+    // Channel selection, false for a channel out of 1..14 or the last enabled one
+    bool exclude(uint8_t channel);
+    bool include(uint8_t channel);
+    bool pin(uint8_t channel);
+    void unpin() { pinned = 0; }
+    uint8_t getPinned() const { return pinned; }
+    bool isEnabled(uint8_t channel) const;
+
+    // Channels 1..13 enabled, no pin, stats cleared
+    void reset();
+    void resetStats();
+
+    // First channel of a run
+    uint8_t start();
+    uint8_t current() const { return currentChannel; }
+
+    // How long to stay on the current channel
+    uint16_t dwellMs() const;
+
+    // Frames seen on the current channel during the dwell that just ended, returns the next channel
+    uint8_t advance(uint32_t frames, uint32_t elapsedMs);
+
+    std::vector<ChannelStats> getStats() const;
+
+private:
+    static constexpr float SMOOTHING = 0.3f;   // weight of the last dwell in the rate
+
+    struct Slot {
+        bool enabled = false;
+        bool visited = false;
+        uint32_t frames = 0;
+        uint32_t timeMs = 0;
+        float rate = 0;
+    };
+
+    Slot slots[MAX_CHANNEL + 1];    // index is the channel number
+    uint8_t pinned = 0;
+    uint8_t currentChannel = 1;
+    uint16_t minDwellMs = 50;
+    uint16_t maxDwellMs = 400;
+
+    uint8_t nextEnabled(uint8_t from) const;
+    uint8_t enabledCount() const;
+    float peakRate() const;
+};
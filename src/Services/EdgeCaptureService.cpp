@@ -0,0 +1,122 @@
+#include "EdgeCaptureService.h"
+#include <esp_heap_caps.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+
+EdgeCaptureService::~EdgeCaptureService() {
+    stop();
+    if (ring) heap_caps_free(ring);
+}
+
+void IRAM_ATTR EdgeCaptureService::isrThunk(void* arg) {
+    reinterpret_cast<EdgeCaptureService*>(arg)->onEdge();
+}
+
+inline void IRAM_ATTR EdgeCaptureService::push(uint32_t cycles, uint32_t us, uint8_t level, bool merged) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Slot& s = ring[h & RING_MASK];
+    s.cycles = (cycles & ~3u) | (merged ? 2u : 0u) | level;
+    s.us = us;
+    head.store(h + 1, std::memory_order_release);
+}
+
+void IRAM_ATTR EdgeCaptureService::onEdge() {
+    uint32_t cycles = esp_cpu_get_cycle_count();
+    uint32_t us = (uint32_t)esp_timer_get_time();
+    if (!running) return;
+
+    uint32_t in = highBank ? REG_READ(GPIO_IN1_REG) : REG_READ(GPIO_IN_REG);
+    uint8_t level = (in & pinMask) ? 1 : 0;
+
+    // Both edges of a pulse shorter than the ISR latency land here with no
+    // level change, keep the stream alternating and flag it
+    if (level == lastLevel) {
+        push(cycles, us, level ^ 1, true);
+    }
+    push(cycles, us, level, false);
+    lastLevel = level;
+}
+
+bool EdgeCaptureService::start(uint8_t newPin) {
+    stop();
+
+    if (!ring) {
+        ring = (Slot*)heap_caps_malloc(sizeof(Slot) * RING_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!ring) return false;
+    }
+
+    // Same flags as the other sniffers, the first installer wins
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;
+
+    pin = newPin;
+    highBank = pin >= 32;
+    pinMask = 1u << (pin & 31);
+    cpuMhz = getCpuFrequencyMhz();
+
+    head.store(0);
+    tail.store(0);
+    dropped.store(0);
+
+    uint32_t in = highBank ? REG_READ(GPIO_IN1_REG) : REG_READ(GPIO_IN_REG);
+    initialLevel = (in & pinMask) ? 1 : 0;
+    lastLevel = initialLevel;
+
+    gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_ANYEDGE);
+    if (gpio_isr_handler_add((gpio_num_t)pin, &EdgeCaptureService::isrThunk, this) != ESP_OK) return false;
+    running = true;
+    gpio_intr_enable((gpio_num_t)pin);
+    return true;
+}
+
+void EdgeCaptureService::stop() {
+    if (!running) return;
+    running = false;
+
+    gpio_intr_disable((gpio_num_t)pin);
+    gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_DISABLE);
+    gpio_isr_handler_remove((gpio_num_t)pin);
+}
+
+size_t EdgeCaptureService::read(Edge* out, size_t max) {
+    if (!ring) return 0;
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    size_t n = 0;
+
+    while (t != h && n < max) {
+        const Slot& s = ring[t & RING_MASK];
+        out[n].cycles = s.cycles & ~3u;
+        out[n].us = s.us;
+        out[n].level = s.cycles & 1u;
+        out[n].merged = s.cycles & 2u;
+        ++n;
+        ++t;
+    }
+
+    tail.store(t, std::memory_order_release);
+    return n;
+}
+
+uint32_t EdgeCaptureService::elapsedNs(const Edge& from, const Edge& to) const {
+    uint32_t us = to.us - from.us;
+
+    // The cycle counter wraps every ~17 s at 240 MHz
+    if (us > 10000000) return UINT32_MAX;
+    uint64_t cycles = (uint32_t)(to.cycles - from.cycles);
+    uint64_t ns = cycles * 1000 / cpuMhz;
+    return ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+uint32_t EdgeCaptureService::elapsedUs(const Edge& from, const Edge& to) const {
+    uint32_t us = to.us - from.us;
+    if (us > 10000000) return us;
+    return (uint32_t)((uint64_t)(uint32_t)(to.cycles - from.cycles) / cpuMhz);
+}
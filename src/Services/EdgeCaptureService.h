@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "driver/gpio.h"
+
+// Timestamps every edge of one pin from a GPIO interrupt into a lock-free
+// single producer / single consumer ring. The ISR only stores the cycle
+// counter and the new level, decoding and printing stay in the caller's loop
+// so a slow terminal never makes the capture miss a pulse.
+class EdgeCaptureService {
+public:
+    struct Edge {
+        uint32_t cycles;    // CPU cycle counter, same core for every edge
+        uint32_t us;        // esp_timer low word, for gaps longer than a cycle wrap
+        bool level;         // level after the edge
+        bool merged;        // ISR found the pin back at the old level, a pulse shorter than the latency
+    };
+
+    ~EdgeCaptureService();
+
+    bool start(uint8_t pin);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Consumer side, returns the number of edges copied
+    size_t read(Edge* out, size_t max);
+
+    uint8_t getInitialLevel() const { return initialLevel; }
+    uint32_t getDroppedCount() const { return dropped.load(); }
+
+    // Time between two edges, cycle accurate below a counter wrap
+    uint32_t elapsedNs(const Edge& from, const Edge& to) const;
+    uint32_t elapsedUs(const Edge& from, const Edge& to) const;
+
+private:
+    static constexpr size_t RING_SIZE = 2048;        // power of two
+    static constexpr size_t RING_MASK = RING_SIZE - 1;
+
+    struct Slot {
+        uint32_t cycles;    // bit 0 level, bit 1 merged
+        uint32_t us;
+    };
+
+    static void IRAM_ATTR isrThunk(void* arg);
+    void IRAM_ATTR onEdge();
+    inline void IRAM_ATTR push(uint32_t cycles, uint32_t us, uint8_t level, bool merged);
+
+    Slot* ring = nullptr;
+    std::atomic<uint32_t> head{0};      // written by the ISR
+    std::atomic<uint32_t> tail{0};      // written by the consumer
+    std::atomic<uint32_t> dropped{0};
+
+    volatile bool running = false;
+    uint8_t pin = 0xFF;
+    uint32_t pinMask = 0;
+    bool highBank = false;
+    volatile uint8_t lastLevel = 0;
+    uint8_t initialLevel = 0;
+    uint32_t cpuMhz = 240;
+};
@@ -22,7 +22,8 @@ void HdUartService::configure(unsigned long baud, uint8_t dataBits, char parity,
     }
 
     // Apply UART config
-    uart_driver_install(HD_UART_PORT, UART_RX_BUFFER_SIZE, 0, 0, NULL, 0);
+    // Event queue only carries FIFO/ring overflows for the bridge counters
+    uart_driver_install(HD_UART_PORT, UART_RX_BUFFER_SIZE, 0, UART_EVENT_QUEUE_SIZE, &eventQueue, 0);
     uart_param_config(HD_UART_PORT, &uart_config);
 
     // Route UART signals to shared pin
@@ -32,6 +33,7 @@ void HdUartService::configure(unsigned long baud, uint8_t dataBits, char parity,
 
 void HdUartService::end() {
     uart_driver_delete(HD_UART_PORT);
+    eventQueue = nullptr;
 }
 
 
@@ -57,46 +59,67 @@ char HdUartService::read() {
     return (len == 1) ? static_cast<char>(c) : '\0';
 }
 
-std::string HdUartService::executeByteCode(const std::vector<ByteCode>& bytecodes) {
-    std::string result;
+size_t HdUartService::readBytes(uint8_t* buffer, size_t length) {
+    size_t buffered = 0;
+    uart_get_buffered_data_len(HD_UART_PORT, &buffered);
+    if (buffered == 0) return 0;
+    int n = uart_read_bytes(HD_UART_PORT, buffer, std::min(length, buffered), 0);
+    return n > 0 ? n : 0;
+}
+
+size_t HdUartService::writeBytes(const uint8_t* data, size_t length) {
+    int n = uart_write_bytes(HD_UART_PORT, data, length);
+    uart_wait_tx_done(HD_UART_PORT, pdMS_TO_TICKS(100 + length));
+    return n > 0 ? n : 0;
+}
+
+uint32_t HdUartService::pollOverflows() {
+    if (!eventQueue) return 0;
+
+    uint32_t count = 0;
+    uart_event_t event;
+    while (xQueueReceive(eventQueue, &event, 0) == pdTRUE) {
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) count++;
+    }
+    return count;
+}
+
+void HdUartService::executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink) {
+    CompiledByteCode program = ByteCodeTransformer::compile(bytecodes);
     uint32_t timeout = 2000;
-    uint32_t received = 0;
-    uint32_t start;
 
-    for (const ByteCode& code : bytecodes) {
-        switch (code.getCommand()) {
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
             case ByteCodeEnum::Write:
-                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                    write(code.getData());
-                }
+                uart_write_bytes(HD_UART_PORT, program.getData(op), op.length);
+                uart_wait_tx_done(HD_UART_PORT, pdMS_TO_TICKS(100 + op.length));
                 break;
 
-            case ByteCodeEnum::Read:
-                start = millis();
-                while (received < code.getRepeat() && (millis() - start < timeout)) {
-                    if (available()) {
-                        result += read();
-                        ++received;
-                    } else {
-                        delay(1);
+            case ByteCodeEnum::Read: {
+                uint32_t received = 0;
+                uint32_t start = millis();
+                while (received < op.length && (millis() - start < timeout)) {
+                    // Block on the driver ring instead of polling byte per byte
+                    uint8_t buf[64];
+                    size_t want = std::min<size_t>(sizeof(buf), op.length - received);
+                    int n = uart_read_bytes(HD_UART_PORT, buf, want, pdMS_TO_TICKS(10));
+                    if (n > 0) {
+                        sink.onData(buf, n);
+                        received += n;
                     }
                 }
                 break;
-
-            case ByteCodeEnum::DelayMs:
-                delay(code.getRepeat());
-                break;
+            }
 
             case ByteCodeEnum::DelayUs:
-                delayMicroseconds(code.getRepeat());
+                if (op.length >= 1000) delay(op.length / 1000);
+                delayMicroseconds(op.length % 1000);
                 break;
 
             default:
                 break;
         }
     }
-
-    return result;
 }
 
 uart_config_t HdUartService::buildUartConfig(unsigned long baud, uint8_t bits, char parity, uint8_t stop) {
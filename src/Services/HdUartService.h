@@ -8,19 +8,25 @@
 #include "hal/uart_types.h"
 #include "soc/uart_periph.h"
 #include "Models/ByteCode.h"
+#include "Transformers/ByteCodeTransformer.h"
+#include "Interfaces/IResultSink.h"
 
 #define HD_UART_PORT UART_NUM_2
-#define UART_RX_BUFFER_SIZE 256
+#define UART_RX_BUFFER_SIZE 2048
+#define UART_EVENT_QUEUE_SIZE 16
 
 class HdUartService {
 public:
     void configure(unsigned long baud, uint8_t dataBits, char parity, uint8_t stopBits, uint8_t ioPin, bool inverted);
     void write(uint8_t data);
     void write(const std::string& str);
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t writeBytes(const uint8_t* data, size_t length);
+    uint32_t pollOverflows();
     bool available() const;
     char read();
     std::string readLine();
-    std::string executeByteCode(const std::vector<ByteCode>& bytecodes);
+    void executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink);
     void flush();
     uart_config_t buildUartConfig(unsigned long baud, uint8_t bits, char parity, uint8_t stop);
     void end();
@@ -30,5 +36,6 @@ private:
     unsigned long baudRate;
     uint32_t serialConfig;
     bool isInverted;
+    QueueHandle_t eventQueue = nullptr;
 
 };
@@ -0,0 +1,132 @@
+#include "I2cDumpEngine.h"
+#include <algorithm>
+
+bool I2cDumpEngine::Result::any() const {
+    return std::find(valid.begin(), valid.end(), true) != valid.end();
+}
+
+I2cDumpEngine::I2cDumpEngine(II2cBus& bus) : bus(bus) {}
+
+void I2cDumpEngine::begin(Result& out, uint16_t start, uint16_t len) {
+    out = Result();
+    out.start = start;
+    out.values.assign(len, 0xFF);
+    out.valid.assign(len, false);
+}
+
+uint16_t I2cDumpEngine::maxBurst() const {
+    return (uint16_t)std::max<size_t>(1, std::min<size_t>(bus.maxTransfer(), 0xFFFF));
+}
+
+/*
+Registers
+*/
+void I2cDumpEngine::readRegisters(uint8_t address, uint16_t start, uint16_t len, bool wide, Result& out,
+                                  const Cancel& cancel) {
+    begin(out, start, len);
+    const uint32_t t0 = bus.nowUs();
+    const uint16_t limit = maxBurst();
+
+    std::deque<Transaction> queue;
+    uint16_t burst = limit;
+    uint16_t next = 0;      // first offset not queued yet
+    uint8_t clean = 0;
+
+    while (next < len || !queue.empty()) {
+        if (cancel && cancel()) {
+            out.cancelled = true;
+            break;
+        }
+
+        if (queue.empty()) {
+            uint16_t n = std::min<uint16_t>(burst, len - next);
+            queue.push_back({ next, n });
+            next += n;
+        }
+
+        Transaction t = queue.front();
+        queue.pop_front();
+
+        if (runTransaction(address, start + t.offset, wide, &out.values[t.offset], t.len, out)) {
+            std::fill(out.valid.begin() + t.offset, out.valid.begin() + t.offset + t.len, true);
+            if (!out.minBurst || t.len < out.minBurst) out.minBurst = t.len;
+            if (t.len > out.maxBurst) out.maxBurst = t.len;
+
+            // Clean run, try longer bursts again for what is not queued yet
+            if (++clean >= GROW_AFTER && burst < limit) {
+                burst = std::min<uint16_t>(limit, burst * 2);
+                clean = 0;
+            }
+            continue;
+        }
+
+        // NACK somewhere in the burst, narrow it down, a single register that fails stays unknown
+        clean = 0;
+        if (t.len == 1) continue;
+        uint16_t half = t.len / 2;
+        burst = half;
+        queue.push_front({ (uint16_t)(t.offset + half), (uint16_t)(t.len - half) });
+        queue.push_front({ t.offset, half });
+    }
+
+    out.elapsedUs = bus.nowUs() - t0;
+}
+
+bool I2cDumpEngine::runTransaction(uint8_t address, uint16_t reg, bool wide, uint8_t* dst, uint16_t len, Result& out) {
+    uint8_t pointer[2];
+    size_t pointerLen = 0;
+    if (wide) pointer[pointerLen++] = (uint8_t)(reg >> 8);
+    pointer[pointerLen++] = (uint8_t)reg;
+
+    // Repeated start between the pointer and the read
+    out.transactions++;
+    if (!bus.write(address, pointer, pointerLen, false)) return false;
+
+    out.transactions++;
+    return bus.read(address, dst, len) == len;
+}
+
+/*
+Raw
+*/
+void I2cDumpEngine::readRaw(uint8_t address, uint16_t start, uint16_t len, Result& out, const Cancel& cancel) {
+    begin(out, start, len);
+    const uint32_t t0 = bus.nowUs();
+
+    uint8_t pointer = (uint8_t)start;
+    out.transactions++;
+    if (!bus.write(address, &pointer, 1, false)) {
+        out.elapsedUs = bus.nowUs() - t0;
+        return;
+    }
+
+    uint16_t burst = maxBurst();
+    uint16_t pos = 0;
+    while (pos < len) {
+        if (cancel && cancel()) {
+            out.cancelled = true;
+            break;
+        }
+
+        uint16_t want = std::min<uint16_t>(burst, len - pos);
+        out.transactions++;
+        size_t got = bus.read(address, &out.values[pos], want);
+
+        if (got == 0) {
+            // Nothing at this size, retry smaller before giving up
+            if (burst == 1) break;
+            burst /= 2;
+            continue;
+        }
+
+        std::fill(out.valid.begin() + pos, out.valid.begin() + pos + got, true);
+        if (!out.minBurst || got < out.minBurst) out.minBurst = got;
+        if (got > out.maxBurst) out.maxBurst = got;
+        pos += got;
+
+        // Device ended the stream early
+        if (got < want) break;
+    }
+
+    out.elapsedUs = bus.nowUs() - t0;
+}
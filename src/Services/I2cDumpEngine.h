@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "Interfaces/II2cBus.h"
+
+// Register dumps as a queue of pointer-write/read transactions run back to
+// back. Bursts start at the driver transfer limit. A burst the device NACKs
+// is split in two and requeued, so the burst size shrinks around registers
+// that refuse a read and grows back after a run of clean transfers.
+class I2cDumpEngine {
+public:
+    struct Result {
+        uint16_t start = 0;
+        std::vector<uint8_t> values;
+        std::vector<bool> valid;        // packed, one bit per register
+        uint32_t transactions = 0;
+        uint32_t elapsedUs = 0;
+        uint16_t minBurst = 0;
+        uint16_t maxBurst = 0;
+        bool cancelled = false;
+
+        bool any() const;
+    };
+
+    // Checked between transactions, true stops the dump
+    using Cancel = std::function<bool()>;
+
+    explicit I2cDumpEngine(II2cBus& bus);
+
+    // Pointer write then read for every burst, 16-bit pointer when wide
+    void readRegisters(uint8_t address, uint16_t start, uint16_t len, bool wide, Result& out,
+                       const Cancel& cancel = nullptr);
+
+    // One pointer write, then current address reads until the device stops answering
+    void readRaw(uint8_t address, uint16_t start, uint16_t len, Result& out,
+                 const Cancel& cancel = nullptr);
+
+private:
+    struct Transaction {
+        uint16_t offset;
+        uint16_t len;
+    };
+
+    static constexpr uint8_t GROW_AFTER = 4;    // clean bursts before doubling again
+
+    II2cBus& bus;
+
+    bool runTransaction(uint8_t address, uint16_t reg, bool wide, uint8_t* dst, uint16_t len, Result& out);
+    void begin(Result& out, uint16_t start, uint16_t len);
+    uint16_t maxBurst() const;
+};
@@ -0,0 +1,239 @@
+#include "I2cEepromEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "Transformers/Crc32Transformer.h"
+
+namespace {
+
+std::string hexAddress(uint32_t address) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%05X", (unsigned)address);
+    return buf;
+}
+
+}
+
+I2cEepromEngine::I2cEepromEngine(II2cBus& bus) : bus(bus) {}
+
+void I2cEepromEngine::setGeometry(const Geometry& g) {
+    geometry = g;
+    if (geometry.pageSize == 0) geometry.pageSize = 1;
+    if (geometry.addressBytes < 1) geometry.addressBytes = 1;
+    if (geometry.addressBytes > 2) geometry.addressBytes = 2;
+}
+
+/*
+Read
+*/
+bool I2cEepromEngine::read(uint32_t address, uint8_t* out, uint32_t len, const Progress& onProgress) {
+    return readSpan(address, out, len, nullptr, onProgress);
+}
+
+bool I2cEepromEngine::crc(uint32_t address, uint32_t len, uint32_t& out, const Progress& onProgress) {
+    out = 0;
+    return readSpan(address, nullptr, len, &out, onProgress);
+}
+
+bool I2cEepromEngine::readSpan(uint32_t address, uint8_t* out, uint32_t len, uint32_t* crcOut, const Progress& onProgress) {
+    error.clear();
+    if (!checkRange(address, len)) return false;
+
+    uint8_t scratch[MAX_CHUNK];
+    const uint32_t block = blockBytes();
+    uint32_t done = 0;
+    bool addressed = false;
+
+    while (done < len) {
+        uint32_t at = address + done;
+        uint32_t n = std::min(len - done, readChunk());
+
+        // The address counter rolls over inside a device block, a new block needs a new address
+        uint32_t toBoundary = block - (at % block);
+        if (n > toBoundary) n = toBoundary;
+
+        if (!addressed || at % block == 0) {
+            uint8_t header[2];
+            size_t headerLen = putAddress(at, header);
+            stats.transactions++;
+            if (!bus.write(deviceFor(at), header, headerLen, false)) {
+                error = "No ACK when addressing " + hexAddress(at);
+                return false;
+            }
+            addressed = true;
+        }
+
+        // Current address read, continues where the previous chunk stopped
+        uint8_t* dst = out ? out + done : scratch;
+        stats.transactions++;
+        if (bus.read(deviceFor(at), dst, n) != n) {
+            error = "Short read at " + hexAddress(at);
+            return false;
+        }
+        if (crcOut) *crcOut = Crc32Transformer::update(*crcOut, dst, n);
+
+        done += n;
+        if (onProgress && !onProgress(done, len)) {
+            error = "Stopped";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Write
+*/
+bool I2cEepromEngine::write(uint32_t address, const uint8_t* data, uint32_t len, const Progress& onProgress) {
+    return writeSpan(address, len, onProgress, [&](uint32_t offset, uint8_t* dst, uint32_t n) {
+        memcpy(dst, data + offset, n);
+    });
+}
+
+bool I2cEepromEngine::fill(uint32_t address, uint8_t value, uint32_t len, const Progress& onProgress) {
+    return writeSpan(address, len, onProgress, [&](uint32_t, uint8_t* dst, uint32_t n) {
+        memset(dst, value, n);
+    });
+}
+
+bool I2cEepromEngine::writeSpan(uint32_t address, uint32_t len, const Progress& onProgress,
+                                const std::function<void(uint32_t, uint8_t*, uint32_t)>& source) {
+    error.clear();
+    if (!checkRange(address, len)) return false;
+
+    uint8_t page[MAX_CHUNK];
+    uint32_t done = 0;
+
+    while (done < len) {
+        uint32_t at = address + done;
+
+        // Never cross a page, the chip would wrap to the page start
+        uint32_t n = std::min(len - done, writeChunk());
+        uint32_t toPageEnd = geometry.pageSize - (at % geometry.pageSize);
+        if (n > toPageEnd) n = toPageEnd;
+
+        source(done, page, n);
+        if (!writePage(at, page, n)) return false;
+
+        done += n;
+        if (onProgress && !onProgress(done, len)) {
+            error = "Stopped";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool I2cEepromEngine::writePage(uint32_t address, const uint8_t* data, uint32_t len) {
+    uint8_t frame[2 + MAX_CHUNK];
+    size_t headerLen = putAddress(address, frame);
+    memcpy(frame + headerLen, data, len);
+
+    stats.transactions++;
+    if (!bus.write(deviceFor(address), frame, headerLen + len)) {
+        // Still busy with a cycle started outside the engine, wait once and retry
+        if (!waitReady()) return false;
+        stats.transactions++;
+        if (!bus.write(deviceFor(address), frame, headerLen + len)) {
+            error = "Write NACK at " + hexAddress(address);
+            return false;
+        }
+    }
+    stats.pages++;
+    return waitReady();
+}
+
+bool I2cEepromEngine::waitReady() {
+    const uint32_t start = bus.nowUs();
+    const uint32_t timeoutUs = (uint32_t)geometry.writeTimeoutMs * 1000;
+
+    // The chip ignores its address until the internal write cycle ends
+    while (true) {
+        stats.transactions++;
+        if (bus.write(geometry.deviceAddress, nullptr, 0)) break;
+        stats.polls++;
+        if (bus.nowUs() - start > timeoutUs) {
+            error = "Write cycle did not end within " + std::to_string(geometry.writeTimeoutMs) + " ms";
+            stats.writeWaitUs += bus.nowUs() - start;
+            return false;
+        }
+    }
+    stats.writeWaitUs += bus.nowUs() - start;
+    return true;
+}
+
+/*
+Verify
+*/
+bool I2cEepromEngine::verify(uint32_t address, const uint8_t* data, uint32_t len) {
+    uint32_t got = 0;
+    if (!crc(address, len, got)) return false;
+
+    uint32_t expected = Crc32Transformer::update(0, data, len);
+    if (got != expected) {
+        error = "Verify failed, CRC " + hexAddress(got) + " expected " + hexAddress(expected);
+        return false;
+    }
+    return true;
+}
+
+bool I2cEepromEngine::verifyFill(uint32_t address, uint8_t value, uint32_t len) {
+    uint32_t got = 0;
+    if (!crc(address, len, got)) return false;
+
+    uint8_t pattern[MAX_CHUNK];
+    memset(pattern, value, sizeof(pattern));
+    uint32_t expected = 0;
+    for (uint32_t done = 0; done < len; ) {
+        uint32_t n = std::min<uint32_t>(len - done, sizeof(pattern));
+        expected = Crc32Transformer::update(expected, pattern, n);
+        done += n;
+    }
+
+    if (got != expected) {
+        error = "Verify failed, CRC " + hexAddress(got) + " expected " + hexAddress(expected);
+        return false;
+    }
+    return true;
+}
+
+bool I2cEepromEngine::checkRange(uint32_t address, uint32_t len) {
+    if (geometry.sizeBytes == 0) {
+        error = "EEPROM size is not set";
+        return false;
+    }
+    if (address > geometry.sizeBytes || len > geometry.sizeBytes - address) {
+        error = "Range " + hexAddress(address) + "+" + std::to_string(len) + " is beyond the EEPROM size";
+        return false;
+    }
+    return true;
+}
+
+uint8_t I2cEepromEngine::deviceFor(uint32_t address) const {
+    // 24x04/08/16 and the 1 Mbit+ parts put the high address bits in the device address
+    uint32_t high = address >> (8 * geometry.addressBytes);
+    return (uint8_t)(geometry.deviceAddress | (high << geometry.blockShift)) & 0x7F;
+}
+
+size_t I2cEepromEngine::putAddress(uint32_t address, uint8_t* out) const {
+    if (geometry.addressBytes == 2) {
+        out[0] = (uint8_t)(address >> 8);
+        out[1] = (uint8_t)address;
+        return 2;
+    }
+    out[0] = (uint8_t)address;
+    return 1;
+}
+
+uint32_t I2cEepromEngine::blockBytes() const {
+    return 1u << (8 * geometry.addressBytes);
+}
+
+uint32_t I2cEepromEngine::readChunk() const {
+    return (uint32_t)std::min(bus.maxTransfer(), MAX_CHUNK);
+}
+
+uint32_t I2cEepromEngine::writeChunk() const {
+    size_t max = bus.maxTransfer() > geometry.addressBytes ? bus.maxTransfer() - geometry.addressBytes : 1;
+    return (uint32_t)std::min(max, MAX_CHUNK);
+}
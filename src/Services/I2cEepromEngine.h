@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "Interfaces/II2cBus.h"
+
+// Bulk access to 24Cxx style EEPROMs.
+// Writes are cut at page boundaries and each page is followed by ACK polling,
+// so the next page starts as soon as the chip finishes its internal cycle
+// instead of after a worst case delay. Reads are sequential: the address is
+// sent once per device block, the rest are current address reads split only
+// at the driver transfer limit.
+class I2cEepromEngine {
+public:
+    struct Geometry {
+        uint8_t deviceAddress = 0x50;
+        uint32_t sizeBytes = 0;
+        uint16_t pageSize = 8;
+        uint8_t addressBytes = 1;
+        uint8_t blockShift = 0;         // device address bit receiving the memory address bits above addressBytes
+        uint16_t writeTimeoutMs = 25;   // ACK polling gives up after this
+    };
+
+    struct Stats {
+        uint32_t transactions = 0;
+        uint32_t pages = 0;
+        uint32_t polls = 0;             // NACKed probes while a page was being written
+        uint32_t writeWaitUs = 0;       // total time spent polling
+    };
+
+    // Bytes done so far, return false to stop
+    using Progress = std::function<bool(uint32_t, uint32_t)>;
+
+    explicit I2cEepromEngine(II2cBus& bus);
+
+    void setGeometry(const Geometry& geometry);
+    const Geometry& getGeometry() const { return geometry; }
+
+    bool read(uint32_t address, uint8_t* out, uint32_t len, const Progress& onProgress = nullptr);
+    bool write(uint32_t address, const uint8_t* data, uint32_t len, const Progress& onProgress = nullptr);
+    bool fill(uint32_t address, uint8_t value, uint32_t len, const Progress& onProgress = nullptr);
+
+    // CRC32 of a range read back from the chip
+    bool crc(uint32_t address, uint32_t len, uint32_t& out, const Progress& onProgress = nullptr);
+
+    // Compare the CRC of a range read back with the CRC of what was written
+    bool verify(uint32_t address, const uint8_t* data, uint32_t len);
+    bool verifyFill(uint32_t address, uint8_t value, uint32_t len);
+
+    // Poll the device address until the chip ACKs again
+    bool waitReady();
+
+    const std::string& getError() const { return error; }
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats(); }
+
+private:
+    static constexpr size_t MAX_CHUNK = 256;
+
+    II2cBus& bus;
+    Geometry geometry;
+    Stats stats;
+    std::string error;
+
+    bool checkRange(uint32_t address, uint32_t len);
+    bool readSpan(uint32_t address, uint8_t* out, uint32_t len, uint32_t* crcOut, const Progress& onProgress);
+    bool writePage(uint32_t address, const uint8_t* data, uint32_t len);
+    bool writeSpan(uint32_t address, uint32_t len, const Progress& onProgress,
+                   const std::function<void(uint32_t, uint8_t*, uint32_t)>& source);
+    uint8_t deviceFor(uint32_t address) const;
+    size_t putAddress(uint32_t address, uint8_t* out) const;
+    uint32_t blockBytes() const;
+    uint32_t readChunk() const;
+    uint32_t writeChunk() const;
+};
@@ -1,6 +1,39 @@
 #include "I2cService.h"
 #include "driver/gpio.h"
 
+namespace {
+
+// Wire transactions for the EEPROM engine
+class WireI2cBus : public II2cBus {
+public:
+    explicit WireI2cBus(size_t maxTransfer) : limit(maxTransfer) {}
+
+    bool write(uint8_t address, const uint8_t* data, size_t len, bool sendStop) override {
+        Wire.beginTransmission(address);
+        if (len && Wire.write(data, len) != len) {
+            Wire.endTransmission(true);
+            return false;
+        }
+        return Wire.endTransmission(sendStop) == 0;
+    }
+
+    size_t read(uint8_t address, uint8_t* out, size_t len) override {
+        size_t got = Wire.requestFrom((uint16_t)address, len, true);
+        size_t n = 0;
+        while (n < got && Wire.available()) out[n++] = Wire.read();
+        return n;
+    }
+
+    size_t maxTransfer() const override { return limit; }
+    uint32_t nowUs() override { return micros(); }
+    void delayUs(uint32_t us) override { delayMicroseconds(us); }
+
+private:
+    size_t limit;
+};
+
+}
+
 void I2cService::configure(uint8_t sda, uint8_t scl, uint32_t frequency) {
     Wire.end();
     Wire.begin(sda, scl, frequency);
@@ -34,68 +67,97 @@ bool I2cService::end() const {
     return Wire.end();
 }
 
-std::string I2cService::executeByteCode(const std::vector<ByteCode>& bytecodes) {
-    std::string result;
+void I2cService::executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink) {
+    CompiledByteCode program = ByteCodeTransformer::compile(bytecodes);
+    uint8_t buffer[READ_CHUNK_SIZE];
     uint8_t currentAddress = 0;
     bool transmissionStarted = false;
     bool expectAddress = false;
 
-    for (const auto& code : bytecodes) {
-        switch (code.getCommand()) {
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
             case ByteCodeEnum::Start:
                 expectAddress = true;
+                sink.onEvent(ResultEventEnum::Start);
                 break;
 
             case ByteCodeEnum::Stop:
                 if (transmissionStarted) {
-                    Wire.endTransmission();
+                    uint8_t err = Wire.endTransmission();
                     transmissionStarted = false;
+                    sink.onEvent(err == 0 ? ResultEventEnum::Ack : ResultEventEnum::Nack);
                 }
+                sink.onEvent(ResultEventEnum::Stop);
                 break;
 
-            case ByteCodeEnum::Write:
+            case ByteCodeEnum::Write: {
+                const uint8_t* data = program.getData(op);
+                uint32_t offset = 0;
+
+                // First byte after a start is the address
                 if (expectAddress) {
-                    currentAddress = code.getData();
+                    currentAddress = data[0];
+                    sink.onEvent(ResultEventEnum::Write);
                     Wire.beginTransmission(currentAddress);
                     transmissionStarted = true;
                     expectAddress = false;
-                } else {
-                    if (!transmissionStarted) {
-                        Wire.beginTransmission(currentAddress);
-                        transmissionStarted = true;
-                    }
-                    for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                        Wire.write(code.getData());
-                    }
+                    offset = 1;
+                }
+
+                if (offset < op.length && !transmissionStarted) {
+                    sink.onEvent(ResultEventEnum::Write);
+                    Wire.beginTransmission(currentAddress);
+                    transmissionStarted = true;
                 }
-                break;
 
-                case ByteCodeEnum::Read: {
-                    if (transmissionStarted) {
-                        Wire.endTransmission(false);  // release bus
+                // Wire keeps the whole transmission in its TX buffer, a repeated start once full
+                while (offset < op.length) {
+                    uint32_t toWrite = std::min<uint32_t>(op.length - offset, WRITE_CHUNK_SIZE);
+                    Wire.write(data + offset, toWrite);
+                    offset += toWrite;
+                    if (offset == op.length) break;
+
+                    uint8_t err = Wire.endTransmission(false);
+                    sink.onEvent(err == 0 ? ResultEventEnum::Ack : ResultEventEnum::Nack);
+                    if (err != 0) { // device gone, drop the rest
                         transmissionStarted = false;
+                        break;
                     }
+                    Wire.beginTransmission(currentAddress);
+                }
+                break;
+            }
 
-                    uint8_t toRead = code.getRepeat();
-                    uint8_t readAddr = currentAddress;
+            case ByteCodeEnum::Read: {
+                if (transmissionStarted) {
+                    uint8_t err = Wire.endTransmission(false);  // release bus
+                    transmissionStarted = false;
+                    sink.onEvent(err == 0 ? ResultEventEnum::Ack : ResultEventEnum::Nack);
+                }
 
-                    Wire.requestFrom(readAddr, toRead);
-                    
-                    for (uint8_t i = 0; i < toRead && Wire.available(); ++i) {
-                        uint8_t val = Wire.read();
-                        char hex[5];
-                        snprintf(hex, sizeof(hex), "%02X ", val);
-                        result += hex;
+                // Split only at the driver buffer limit
+                sink.onEvent(ResultEventEnum::Read);
+                uint32_t remaining = op.length;
+                while (remaining > 0) {
+                    uint8_t toRead = std::min<uint32_t>(remaining, READ_CHUNK_SIZE);
+                    uint8_t got = Wire.requestFrom(currentAddress, toRead);
+                    size_t n = 0;
+                    while (n < got && Wire.available()) {
+                        buffer[n++] = Wire.read();
                     }
-                    break;
+                    sink.onData(buffer, n);
+                    if (got < toRead) { // NACK, device stopped answering
+                        sink.onEvent(ResultEventEnum::Nack);
+                        break;
+                    }
+                    remaining -= toRead;
                 }
-
-            case ByteCodeEnum::DelayMs:
-                delay(code.getRepeat());
                 break;
+            }
 
             case ByteCodeEnum::DelayUs:
-                delayMicroseconds(code.getRepeat());
+                if (op.length >= 1000) delay(op.length / 1000);
+                delayMicroseconds(op.length % 1000);
                 break;
 
             default:
@@ -105,10 +167,10 @@ std::string I2cService::executeByteCode(const std::vector<ByteCode>& bytecodes)
 
     // If no end stop
     if (transmissionStarted) {
-        Wire.endTransmission();
+        uint8_t err = Wire.endTransmission();
+        sink.onEvent(err == 0 ? ResultEventEnum::Ack : ResultEventEnum::Nack);
+        sink.onEvent(ResultEventEnum::Stop);
     }
-
-    return result;
 }
 
 bool I2cService::isReadableDevice(uint8_t addr, uint8_t startReg) {
@@ -508,9 +570,59 @@ void I2cService::injectRandomGlitch(uint8_t scl, uint8_t sda, uint32_t freqHz) {
     }
 }
 
+void I2cService::readRegisters(uint8_t addr, uint16_t start, uint16_t len, bool wide,
+                               I2cDumpEngine::Result& out, const I2cDumpEngine::Cancel& cancel) {
+    WireI2cBus bus(READ_CHUNK_SIZE);
+    I2cDumpEngine engine(bus);
+    engine.readRegisters(addr, start, len, wide, out, cancel);
+}
+
+void I2cService::readRaw(uint8_t addr, uint16_t start, uint16_t len,
+                         I2cDumpEngine::Result& out, const I2cDumpEngine::Cancel& cancel) {
+    WireI2cBus bus(READ_CHUNK_SIZE);
+    I2cDumpEngine engine(bus);
+    engine.readRaw(addr, start, len, out, cancel);
+}
+
 bool I2cService::initEeprom(uint16_t chipSizeKb, uint8_t addr) {
     eeprom.setMemoryType(chipSizeKb);
-    return eeprom.begin(addr);
+    if (!eeprom.begin(addr)) return false;
+
+    // Same geometry for the bulk engine, the library only moves a page at a time
+    eepromGeometry = I2cEepromEngine::Geometry();
+    eepromGeometry.deviceAddress = addr;
+    eepromGeometry.sizeBytes = eeprom.length();
+    eepromGeometry.pageSize = eeprom.getPageSizeBytes();
+    eepromGeometry.addressBytes = eeprom.getAddressBytes();
+    eepromGeometry.writeTimeoutMs = std::max<uint16_t>(25, eeprom.getWriteTimeMs() * 3);
+    return true;
+}
+
+void I2cService::eepromSetBlockShift(uint8_t shift) {
+    eepromGeometry.blockShift = shift;
+}
+
+bool I2cService::runEeprom(const std::function<bool(I2cEepromEngine&)>& op) {
+    WireI2cBus bus(READ_CHUNK_SIZE);
+    I2cEepromEngine engine(bus);
+    engine.setGeometry(eepromGeometry);
+
+    bool ok = op(engine);
+    eepromStats = engine.getStats();
+    eepromError = engine.getError();
+    return ok;
+}
+
+bool I2cService::eepromRead(uint32_t address, uint8_t* out, uint32_t len) {
+    return runEeprom([&](I2cEepromEngine& engine) {
+        return engine.read(address, out, len);
+    });
+}
+
+bool I2cService::eepromWrite(uint32_t address, const uint8_t* data, uint32_t len, bool verify) {
+    return runEeprom([&](I2cEepromEngine& engine) {
+        return engine.write(address, data, len) && (!verify || engine.verify(address, data, len));
+    });
 }
 
 bool I2cService::eepromWriteByte(uint16_t address, uint8_t value) {
@@ -533,8 +645,11 @@ bool I2cService::eepromGetString(uint32_t address, std::string& outStr) {
     return true;
 }
 
-void I2cService::eepromErase(uint8_t fill) {
-    eeprom.erase(fill);
+bool I2cService::eepromErase(uint8_t fill, bool verify) {
+    uint32_t size = eepromGeometry.sizeBytes;
+    return runEeprom([&](I2cEepromEngine& engine) {
+        return engine.fill(0, fill, size) && (!verify || engine.verifyFill(0, fill, size));
+    });
 }
 
 bool I2cService::eepromDetectMemorySize() {
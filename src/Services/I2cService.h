@@ -4,6 +4,10 @@
 #include <Wire.h>
 #include <vector>
 #include "Models/ByteCode.h"
+#include "Transformers/ByteCodeTransformer.h"
+#include "Interfaces/IResultSink.h"
+#include "Services/I2cEepromEngine.h"
+#include "Services/I2cDumpEngine.h"
 #include <SparkFun_External_EEPROM.h>
 
 struct I2cRegProbeResult {
@@ -33,6 +37,12 @@ public:
     bool writeReg(uint8_t addr, uint8_t reg, uint8_t val);
     bool probeRegRW(uint8_t addr, uint8_t reg, I2cRegProbeResult& out);
 
+    // Register dumps, queued pointer/read bursts at the configured clock
+    void readRegisters(uint8_t addr, uint16_t start, uint16_t len, bool wide,
+                       I2cDumpEngine::Result& out, const I2cDumpEngine::Cancel& cancel = nullptr);
+    void readRaw(uint8_t addr, uint16_t start, uint16_t len,
+                 I2cDumpEngine::Result& out, const I2cDumpEngine::Cancel& cancel = nullptr);
+
     // I2C Bit bang
     void i2cBitBangDelay(uint32_t delayUs);
     void i2cBitBangSetLevel(uint8_t pin, bool level);
@@ -66,7 +76,7 @@ public:
     void injectRandomGlitch(uint8_t sclPin, uint8_t sdaPin, uint32_t freqHz);
 
     // Instructions
-    std::string executeByteCode(const std::vector<ByteCode>& bytecodes);
+    void executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink);
 
     // EEPROM
     bool initEeprom(uint16_t chipSizeKb = 512, uint8_t addr=0x50);
@@ -81,17 +91,36 @@ public:
     uint8_t  eepromAddressBytes();
     bool     eepromIsConnected();
     bool     eepromIsBusy();
-    void     eepromErase(uint8_t fill = 0xFF);
+    bool     eepromErase(uint8_t fill = 0xFF, bool verify = false);
     bool     eepromDetectMemorySize();
     uint8_t  eepromDetectAddressBytes();
     uint16_t eepromDetectPageSize();
     uint8_t  eepromDetectWriteTime(uint8_t testCount = 8);
 
+    // EEPROM bulk, page writes with ACK polling and sequential reads
+    bool eepromRead(uint32_t address, uint8_t* out, uint32_t len);
+    bool eepromWrite(uint32_t address, const uint8_t* data, uint32_t len, bool verify = false);
+    void eepromSetBlockShift(uint8_t shift);
+    const std::string& eepromGetError() const { return eepromError; }
+    const I2cEepromEngine::Stats& eepromGetStats() const { return eepromStats; }
+
     // sticks3 power control
     bool tryPowerOnSticks3Pmic(uint32_t timeout);
 
 private:
+    // Bytes per Wire.requestFrom, Wire RX buffer size
+    static constexpr uint32_t READ_CHUNK_SIZE = 128;
+    // Bytes per Wire transmission, Wire TX buffer size
+    static constexpr uint32_t WRITE_CHUNK_SIZE = 128;
+
     ExternalEEPROM eeprom;
+    I2cEepromEngine::Geometry eepromGeometry;
+    I2cEepromEngine::Stats eepromStats;
+    std::string eepromError;
+
+    // Run one bulk operation on the Wire bus, keeps its stats and error
+    bool runEeprom(const std::function<bool(I2cEepromEngine&)>& op);
+
     bool probeReadableReg(uint8_t addr, uint8_t reg);
 
     static void onSlaveReceive(int len);
@@ -4,10 +4,15 @@
 #include <freertos/task.h>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 #include "lwip/inet.h"
 #include "lwip/netdb.h"
+#include "lwip/etharp.h"
+#include "lwip/netif.h"
+#include "lwip/priv/tcpip_priv.h"
 #include "ping/ping_sock.h"
+#include "Services/IcmpSweepEngine.h"
 extern "C"
 {
 #include "esp_ping.h"
@@ -30,10 +35,22 @@ struct ICMPTaskParams
 struct DiscoveryTaskParams
 {
     std::string deviceIP;
+    std::string cidr;
     int timeout_ms;
+    int ratePps;
+    bool arpFallback;
     ICMPService *service;
 };
 
+// ARP calls must run in the lwIP thread
+struct ArpCall
+{
+    tcpip_api_call_data call;
+    ip4_addr_t ip;
+    uint8_t mac[6];
+    bool found;
+};
+
 ICMPService::ICMPService() {}
 
 ICMPService::~ICMPService()
@@ -52,6 +69,14 @@ void ICMPService::cleanupICMPService()
     report.clear();
 }
 
+std::string ICMPService::getDiscoveryHelp() const {
+    return std::string("Usage: discovery [cidr] [timeout_ms] [-r <rate>] [-a]\r\nOptions:\r\n") +
+        "\tcidr          Range to sweep, e.g. 10.0.0.0/22 (default: own /24, max /20)\r\n" +
+        "\ttimeout_ms    Reply timeout, 5 to 5000 ms (default: 250)\r\n" +
+        "\t-r <rate>     Echo requests per second (default: 100)\r\n" +
+        "\t-a            ARP probe the local hosts that ignore ICMP";
+}
+
 std::string ICMPService::getPingHelp() const{
     std::string helpMenu = std::string("Usage: ping <host> [-c <count>] [-t <timeout>] [-i <interval>]\r\nOptions:\r\n ") + 
         "\t-c <count>    Number of pings (default: 5)\r\n " +
@@ -93,83 +118,198 @@ static int median_ms(std::vector<uint32_t> &v)
     return (int)((v[n / 2 - 1] + v[n / 2] + 1) / 2);
 }
 
-void ICMPService::discoveryTask(void* params){
-    auto* taskParams = static_cast<DiscoveryTaskParams*>(params);
-    std::string deviceIP = taskParams->deviceIP;
-    ICMPService* service = taskParams->service;
-    int timeoutMs = taskParams->timeout_ms;
-    ip4_addr_t targetIP;
-    uint32_t targetsResponded = 0;
+static struct netif* findLocalNetif(const ip4_addr_t& ip)
+{
+    struct netif* n;
+    NETIF_FOREACH(n) {
+        if (!netif_is_up(n) || !(n->flags & NETIF_FLAG_ETHARP)) continue;
+        uint32_t mask = netif_ip4_netmask(n)->addr;
+        if (mask && (ip.addr & mask) == (netif_ip4_addr(n)->addr & mask)) return n;
+    }
+    return nullptr;
+}
 
-    pushICMPLog("Discovery: Scanning for devices with timeout " + std::to_string(timeoutMs) + " ms... Press [ENTER] to stop.\r\n");
+static err_t arpRequestCall(tcpip_api_call_data* data)
+{
+    auto* c = reinterpret_cast<ArpCall*>(data);
+    struct netif* n = findLocalNetif(c->ip);
+    return n ? etharp_request(n, &c->ip) : ERR_RTE;
+}
 
-    if (!ip4addr_aton(deviceIP.c_str(), &targetIP))
-    {
-        pushICMPLog("Discovery: failed to parse IP address " + deviceIP);
-        delete taskParams;
-        vTaskDelete(nullptr);
-        return;
+static err_t arpIsLocalCall(tcpip_api_call_data* data)
+{
+    auto* c = reinterpret_cast<ArpCall*>(data);
+    c->found = findLocalNetif(c->ip) != nullptr;
+    return ERR_OK;
+}
+
+static err_t arpFindCall(tcpip_api_call_data* data)
+{
+    auto* c = reinterpret_cast<ArpCall*>(data);
+    struct netif* n = findLocalNetif(c->ip);
+    struct eth_addr* eth = nullptr;
+    const ip4_addr_t* ipOut = nullptr;
+
+    c->found = n && etharp_find_addr(n, &c->ip, &eth, &ipOut) >= 0 && eth;
+    if (c->found) memcpy(c->mac, eth->addr, sizeof(c->mac));
+    return ERR_OK;
+}
+
+void ICMPService::arpLookup(DiscoveredHost& host)
+{
+    ArpCall c{};
+    c.ip.addr = host.ip;
+    tcpip_api_call(arpFindCall, &c.call);
+    if (c.found) {
+        memcpy(host.mac, c.mac, sizeof(host.mac));
+        host.hasMac = true;
     }
+}
 
-    // Octets of an IPv4 addr
-    uint8_t o1 = ip4_addr1(&targetIP);
-    uint8_t o2 = ip4_addr2(&targetIP);
-    uint8_t o3 = ip4_addr3(&targetIP);
-    uint8_t deviceIndex = ip4_addr4(&targetIP);
+void ICMPService::arpProbe(std::vector<DiscoveredHost>& hosts, const std::vector<uint32_t>& targets, int timeoutMs)
+{
+    // The lwIP ARP table is small, so request and harvest in batches before entries get evicted
+    const size_t batchSize = 8;
 
-    for (uint8_t targetIndex = 1; targetIndex < 255; targetIndex++)
-    {
-        if (ICMPService::getICMPServiceStatus() == true)
-        {
-            pushICMPLog("Discovery: Stopped by user\r\n");
-            delete taskParams;
-            vTaskDelete(nullptr);
-            return;
+    for (size_t i = 0; i < targets.size() && !getICMPServiceStatus(); i += batchSize) {
+        size_t end = std::min(targets.size(), i + batchSize);
+
+        for (size_t j = i; j < end; ++j) {
+            ArpCall c{};
+            c.ip.addr = targets[j];
+            tcpip_api_call(arpRequestCall, &c.call);
         }
 
-        if (targetIndex == deviceIndex)
-            continue;
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+
+        for (size_t j = i; j < end; ++j) {
+            DiscoveredHost host{};
+            host.ip = targets[j];
+            arpLookup(host);
+            if (host.hasMac) {
+                host.viaArp = true;
+                hosts.push_back(host);
+            }
+        }
+    }
+}
 
-        // Rebuild the target IP from octets
-        IP4_ADDR(&targetIP, o1, o2, o3, targetIndex);
+void ICMPService::buildDiscoveryReport(size_t targetCount)
+{
+    std::sort(discoveredHosts.begin(), discoveredHosts.end(), [](const DiscoveredHost& a, const DiscoveredHost& b) {
+        return ntohl(a.ip) < ntohl(b.ip);
+    });
+
+    report = "IP ADDRESS       RTT        MAC                SOURCE\r\n";
+    for (const auto& host : discoveredHosts) {
+        char line[96];
+        char ipStr[16];
+        ip4_addr_t a{ host.ip };
+        ip4addr_ntoa_r(&a, ipStr, sizeof(ipStr));
+
+        char rttStr[16] = "-";
+        if (!host.viaArp) snprintf(rttStr, sizeof(rttStr), "%lu.%02lu ms",
+                                   (unsigned long)(host.rttUs / 1000), (unsigned long)(host.rttUs % 1000) / 10);
+
+        char macStr[18] = "-";
+        if (host.hasMac) snprintf(macStr, sizeof(macStr), "%02x:%02x:%02x:%02x:%02x:%02x",
+                                  host.mac[0], host.mac[1], host.mac[2], host.mac[3], host.mac[4], host.mac[5]);
+
+        snprintf(line, sizeof(line), "%-16s %-10s %-18s %s\r\n", ipStr, rttStr, macStr, host.viaArp ? "arp" : "icmp");
+        report += line;
+    }
+    report += std::to_string(discoveredHosts.size()) + " devices up, " +
+              std::to_string(targetCount - discoveredHosts.size()) + " down\r\n";
+}
 
-        // Convert to dotted string
-        char targetIPCStr[16];
-        ip4addr_ntoa_r(&targetIP, targetIPCStr, sizeof(targetIPCStr));
-        std::string targetIPStr(targetIPCStr);
+void ICMPService::discoveryTask(void* params){
+    auto* taskParams = static_cast<DiscoveryTaskParams*>(params);
+    ICMPService* service = taskParams->service;
+    int timeoutMs = taskParams->timeout_ms;
+    service->discoveredHosts.clear();
+
+    // Target list, the device's own /24 unless a range was given
+    std::string range = taskParams->cidr.empty() ? taskParams->deviceIP + "/24" : taskParams->cidr;
+    std::vector<in_addr> targets;
+    if (!IcmpSweepEngine::parseCidr(range, targets)) {
+        pushICMPLog("Discovery: invalid or too large range " + range);
+        service->discoveryReady = true;
+        delete taskParams;
+        vTaskDelete(nullptr);
+        return;
+    }
 
-        service->cleanupICMPService();
-        auto *params = new ICMPTaskParams{targetIPStr, 2, timeoutMs, 100, service};
+    in_addr device{};
+    inet_pton(AF_INET, taskParams->deviceIP.c_str(), &device);
+    targets.erase(std::remove_if(targets.begin(), targets.end(), [&](const in_addr& a) {
+        return a.s_addr == device.s_addr;
+    }), targets.end());
+
+    pushICMPLog("Discovery: Sweeping " + std::to_string(targets.size()) + " hosts in " + range +
+                " with timeout " + std::to_string(timeoutMs) + " ms at " + std::to_string(taskParams->ratePps) +
+                " pkt/s... Press [ENTER] to stop.\r\n");
+
+    IcmpSweepEngine::Config config;
+    config.timeoutMs = timeoutMs;
+    config.ratePps = taskParams->ratePps;
+    IcmpSweepEngine engine(config);
+
+    std::vector<IcmpSweepEngine::Result> alive;
+    if (!engine.sweep(targets, alive, [] { return ICMPService::getICMPServiceStatus(); })) {
+        pushICMPLog("Discovery: failed to open ICMP socket");
+        service->discoveryReady = true;
+        delete taskParams;
+        vTaskDelete(nullptr);
+        return;
+    }
 
-        xTaskCreatePinnedToCore(pingAPI, "ICMPPing", 4096, params, 1, nullptr, 1);
+    for (const auto& r : alive) {
+        DiscoveredHost host{};
+        host.ip = r.addr.s_addr;
+        host.rttUs = r.rttUs;
+        arpLookup(host);
+        service->discoveredHosts.push_back(host);
+    }
 
-        while (!service->pingReady)
-        {
-            vTaskDelay(pdMS_TO_TICKS(10));
+    // Hosts with ICMP filtered still have to answer ARP on the local segment
+    if (taskParams->arpFallback && !getICMPServiceStatus()) {
+        std::vector<uint32_t> silent;
+        for (const auto& t : targets) {
+            bool found = std::any_of(alive.begin(), alive.end(), [&](const IcmpSweepEngine::Result& r) {
+                return r.addr.s_addr == t.s_addr;
+            });
+            if (found) continue;
+
+            // Only the local segment answers ARP
+            ArpCall c{};
+            c.ip.addr = t.s_addr;
+            tcpip_api_call(arpIsLocalCall, &c.call);
+            if (c.found) silent.push_back(t.s_addr);
         }
-        if (service->pingRC == ping_rc_t::ping_ok){
-            pushICMPLog("Device found: " + targetIPStr);
-            targetsResponded++;
+        if (!silent.empty()) {
+            pushICMPLog("Discovery: ARP probing " + std::to_string(silent.size()) + " silent local hosts...");
+            arpProbe(service->discoveredHosts, silent, timeoutMs);
         }
     }
 
-    pushICMPLog(std::to_string(targetsResponded) + " devices up, pinged " + 
-        std::to_string(254 - targetsResponded) + " devices down");
+    if (getICMPServiceStatus()) pushICMPLog("Discovery: Stopped by user\r\n");
 
+    service->buildDiscoveryReport(targets.size());
     service->discoveryReady = true;
 
     delete taskParams;
     vTaskDelete(nullptr);
 }
 
-void ICMPService::startDiscoveryTask(const std::string deviceIP, int timeout_ms)
+void ICMPService::startDiscoveryTask(const std::string deviceIP, int timeout_ms, const std::string& cidr,
+                                     int ratePps, bool arpFallback)
 {
     report.clear();
     discoveryReady = false;
     stopICMPFlag = false;
 
     // Start job
-    auto* p = new DiscoveryTaskParams{deviceIP, timeout_ms, this};
+    auto* p = new DiscoveryTaskParams{deviceIP, cidr, timeout_ms, ratePps > 0 ? ratePps : 100, arpFallback, this};
     xTaskCreatePinnedToCore(discoveryTask, "ICMPDiscover", 8192, p, 1, nullptr, 0);
 }
 
@@ -9,6 +9,14 @@ enum phy_interface_t {
     phy_eth
 };
 
+struct DiscoveredHost {
+    uint32_t ip;            // network order
+    uint32_t rttUs;         // 0 for ARP only hosts
+    uint8_t mac[6];
+    bool hasMac;
+    bool viaArp;            // silent to ICMP, answered ARP
+};
+
 enum ping_rc_t {
     ping_ok,
     ping_timeout,
@@ -24,8 +32,9 @@ public:
 
     // Normal ping
     void startPingTask(const std::string& host, int count = 5, int timeout_ms = 1000, int interval_ms = 200);
-    // Discovery of devices
-    void startDiscoveryTask(const std::string deviceIP, int timeout_ms = 200);
+    // Discovery of devices, cidr empty sweeps the /24 of deviceIP
+    void startDiscoveryTask(const std::string deviceIP, int timeout_ms = 200, const std::string& cidr = "",
+                            int ratePps = 100, bool arpFallback = false);
     static void discoveryTask(void* params);
 
     // Results
@@ -37,6 +46,8 @@ public:
     const std::string& getReport() const { return report; }
     std::string getPingHelp() const;
     bool isDiscoveryReady() const { return discoveryReady; }
+    const std::vector<DiscoveredHost>& getDiscoveredHosts() const { return discoveredHosts; }
+    std::string getDiscoveryHelp() const;
 
     // Task entry
     static void pingAPI(void *pvParams);
@@ -55,6 +66,7 @@ private:
     std::string report;
     ping_rc_t pingRC = ping_rc_t::ping_error;
     bool discoveryReady = false;
+    std::vector<DiscoveredHost> discoveredHosts;
 
     // Log buffer thread safe
     static portMUX_TYPE icmpMux;
@@ -64,6 +76,9 @@ private:
 
     static void pushICMPLog(const std::string& line);
     static bool getICMPServiceStatus();
+    static void arpProbe(std::vector<DiscoveredHost>& hosts, const std::vector<uint32_t>& targets, int timeoutMs);
+    static void arpLookup(DiscoveredHost& host);
+    void buildDiscoveryReport(size_t targetCount);
     // Clears non-static variables
     void cleanupICMPService();
 };
@@ -0,0 +1,228 @@
+#include "IcmpSweepEngine.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sys/ioctl.h>
+
+#ifdef ARDUINO
+#include "lwip/inet.h"
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint8_t ICMP_ECHO_REPLY   = 0;
+    constexpr uint8_t ICMP_ECHO_REQUEST = 8;
+    constexpr size_t ICMP_HEADER_SIZE   = 8;
+    constexpr size_t ICMP_PAYLOAD_SIZE  = 24;
+}
+
+IcmpSweepEngine::IcmpSweepEngine() : IcmpSweepEngine(Config()) {}
+
+IcmpSweepEngine::IcmpSweepEngine(const Config& config) : config(config) {
+    if (this->config.ratePps == 0) this->config.ratePps = 1;
+    if (this->config.timeoutMs == 0) this->config.timeoutMs = 1;
+}
+
+uint32_t IcmpSweepEngine::nowUs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool IcmpSweepEngine::parseCidr(const std::string& cidr, std::vector<in_addr>& out, size_t maxHosts) {
+    out.clear();
+
+    std::string address = cidr;
+    int prefix = 32;
+    size_t slash = cidr.find('/');
+    if (slash != std::string::npos) {
+        address = cidr.substr(0, slash);
+        std::string bits = cidr.substr(slash + 1);
+        if (bits.empty() || bits.size() > 2 || bits.find_first_not_of("0123456789") != std::string::npos) return false;
+        prefix = std::stoi(bits);
+        if (prefix < 0 || prefix > 32) return false;
+    }
+
+    in_addr base{};
+    if (inet_pton(AF_INET, address.c_str(), &base) != 1) return false;
+
+    uint32_t mask = prefix == 0 ? 0 : 0xFFFFFFFFu << (32 - prefix);
+    uint32_t network = ntohl(base.s_addr) & mask;
+    uint64_t count = 1ULL << (32 - prefix);
+
+    uint32_t first = network;
+    uint32_t last = network + (uint32_t)(count - 1);
+    if (prefix < 31) {
+        first++;                    // network address
+        last--;                     // broadcast address
+    }
+
+    if ((uint64_t)last - first + 1 > maxHosts) return false;
+
+    out.reserve(last - first + 1);
+    for (uint64_t ip = first; ip <= last; ++ip) {
+        in_addr a{};
+        a.s_addr = htonl((uint32_t)ip);
+        out.push_back(a);
+    }
+    return true;
+}
+
+uint16_t IcmpSweepEngine::checksum(const uint8_t* data, size_t length) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += (uint16_t)((data[i] << 8) | data[i + 1]);
+    }
+    if (length & 1) sum += (uint16_t)(data[length - 1] << 8);
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+bool IcmpSweepEngine::sendEcho(int fd, const in_addr& addr, uint16_t seq) {
+    uint8_t packet[ICMP_HEADER_SIZE + ICMP_PAYLOAD_SIZE] = {};
+    packet[0] = ICMP_ECHO_REQUEST;
+    packet[1] = 0;
+    packet[4] = ident >> 8;
+    packet[5] = ident & 0xFF;
+    packet[6] = seq >> 8;
+    packet[7] = seq & 0xFF;
+    for (size_t i = 0; i < ICMP_PAYLOAD_SIZE; ++i) {
+        packet[ICMP_HEADER_SIZE + i] = 'a' + (i % 26);
+    }
+
+    uint16_t sum = checksum(packet, sizeof(packet));
+    packet[2] = sum >> 8;
+    packet[3] = sum & 0xFF;
+
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_addr = addr;
+    return ::sendto(fd, packet, sizeof(packet), 0, (sockaddr*)&sa, sizeof(sa)) == (ssize_t)sizeof(packet);
+}
+
+void IcmpSweepEngine::drainReplies(int fd, const std::vector<in_addr>& targets,
+                                   std::vector<Target>& state, std::vector<Result>& alive) {
+    uint8_t buf[128];
+
+    for (;;) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n <= 0) return;
+
+        // Raw sockets deliver the IP header first
+        size_t ipLen = (buf[0] & 0x0F) * 4;
+        if ((size_t)n < ipLen + ICMP_HEADER_SIZE) continue;
+
+        const uint8_t* icmp = buf + ipLen;
+        if (icmp[0] != ICMP_ECHO_REPLY || icmp[1] != 0) continue;
+
+        uint16_t id = (icmp[4] << 8) | icmp[5];
+        uint16_t seq = (icmp[6] << 8) | icmp[7];
+        if (id != ident || seq >= targets.size()) continue;
+
+        // Source must be the probed host, the id alone could collide with another pinger
+        uint32_t src;
+        memcpy(&src, buf + 12, sizeof(src));
+        if (src != targets[seq].s_addr) continue;
+
+        Target& t = state[seq];
+        if (t.answered) continue;
+        t.answered = true;
+        received++;
+        alive.push_back(Result{ targets[seq], nowUs() - t.sentUs });
+    }
+}
+
+bool IcmpSweepEngine::sweep(const std::vector<in_addr>& targets,
+                            std::vector<Result>& alive,
+                            const std::function<bool()>& shouldStop) {
+    alive.clear();
+    sent = 0;
+    received = 0;
+    if (targets.empty()) return true;
+    if (targets.size() > MAX_TARGETS) return false;
+
+    int fd = ::socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (fd < 0) return false;
+
+    int nb = 1;
+    ioctl(fd, FIONBIO, &nb);
+
+    // A fresh ident per sweep so late replies from a previous run are ignored
+    ident = (uint16_t)(nowUs() ^ (nowUs() >> 16) ^ (uintptr_t)this);
+
+    std::vector<Target> state(targets.size(), Target{ 0, 0, false });
+    const uint32_t intervalUs = 1000000 / config.ratePps;
+    const uint32_t timeoutUs = config.timeoutMs * 1000;
+    const uint8_t maxAttempts = config.retries + 1;
+
+    uint32_t nextSendUs = nowUs();
+    uint32_t lastSendUs = nextSendUs;
+    size_t cursor = 0;
+    uint8_t pass = 0;
+
+    for (;;) {
+        if (shouldStop && shouldStop()) break;
+
+        uint32_t now = nowUs();
+
+        // Find the next target of this pass that still needs a probe
+        while (pass < maxAttempts && cursor < targets.size() &&
+               (state[cursor].answered || state[cursor].attempts > pass)) {
+            cursor++;
+        }
+        if (cursor >= targets.size() && pass + 1 < maxAttempts && received < targets.size()) {
+            cursor = 0;
+            pass++;
+            continue;
+        }
+
+        bool sending = pass < maxAttempts && cursor < targets.size();
+        uint32_t waitUs;
+
+        if (sending) {
+            Target& t = state[cursor];
+            // A retry waits for the previous probe to time out
+            uint32_t readyUs = t.attempts ? t.sentUs + timeoutUs : now;
+            int32_t untilSlot = (int32_t)(nextSendUs - now);
+            int32_t untilReady = (int32_t)(readyUs - now);
+            int32_t until = untilSlot > untilReady ? untilSlot : untilReady;
+
+            if (until <= 0) {
+                if (sendEcho(fd, targets[cursor], (uint16_t)cursor)) sent++;
+                t.sentUs = now;
+                t.attempts++;
+                lastSendUs = now;
+                nextSendUs = (int32_t)(now - nextSendUs) > (int32_t)intervalUs ? now : nextSendUs + intervalUs;
+                cursor++;
+                drainReplies(fd, targets, state, alive);
+                continue;
+            }
+            waitUs = (uint32_t)until;
+        } else {
+            // Everything sent, give the last probe its timeout
+            int32_t remaining = (int32_t)(lastSendUs + timeoutUs - now);
+            if (remaining <= 0 || received == targets.size()) break;
+            waitUs = (uint32_t)remaining;
+        }
+
+        // Keep the stop check responsive during long waits
+        if (waitUs > 50000) waitUs = 50000;
+
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+        timeval tv{};
+        tv.tv_sec = waitUs / 1000000;
+        tv.tv_usec = waitUs % 1000000;
+        if (::select(fd + 1, &rfds, nullptr, nullptr, &tv) > 0) {
+            drainReplies(fd, targets, state, alive);
+        }
+    }
+
+    ::close(fd);
+    return true;
+}
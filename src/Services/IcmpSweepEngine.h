@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+
+#ifdef ARDUINO
+#include "lwip/sockets.h"
+#else
+#include <netinet/in.h>
+#endif
+
+// Sends ICMP echo requests to a whole target list from one raw socket and
+// matches the replies by ident/sequence, so hundreds of hosts are probed in
+// about one timeout instead of one timeout each. Sends are paced by a rate
+// limit, unanswered targets are retried. Plain BSD sockets only.
+class IcmpSweepEngine {
+public:
+    static constexpr size_t MAX_TARGETS = 4096;    // /20, sequence number is the target index
+
+    struct Config {
+        uint32_t timeoutMs = 250;       // wait for a reply after the last probe of a target
+        uint32_t ratePps = 100;         // echo requests per second
+        uint8_t retries = 1;            // extra probes for silent targets
+    };
+
+    struct Result {
+        in_addr addr;
+        uint32_t rttUs;
+    };
+
+    IcmpSweepEngine();
+    explicit IcmpSweepEngine(const Config& config);
+
+    // Returns the targets that answered, in reply order. False if the raw socket can't be opened
+    bool sweep(const std::vector<in_addr>& targets,
+               std::vector<Result>& alive,
+               const std::function<bool()>& shouldStop = nullptr);
+
+    // "a.b.c.d/nn" or a single address, usable hosts only (no network/broadcast below /31)
+    static bool parseCidr(const std::string& cidr, std::vector<in_addr>& out, size_t maxHosts = MAX_TARGETS);
+
+    size_t getSent() const { return sent; }
+    size_t getReceived() const { return received; }
+
+private:
+    struct Target {
+        uint32_t sentUs;    // wraps after ~71 min, only differences are used
+        uint8_t attempts;
+        bool answered;
+    };
+
+    bool sendEcho(int fd, const in_addr& addr, uint16_t seq);
+    void drainReplies(int fd, const std::vector<in_addr>& targets, std::vector<Target>& state, std::vector<Result>& alive);
+    static uint16_t checksum(const uint8_t* data, size_t length);
+    static uint32_t nowUs();
+
+    Config config;
+    uint16_t ident = 0;
+    size_t sent = 0;
+    size_t received = 0;
+};
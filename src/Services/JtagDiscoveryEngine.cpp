@@ -0,0 +1,428 @@
+#include "JtagDiscoveryEngine.h"
+
+#define SWD_LINE_RESET_CYCLES 62     // 50 minimum, with margin
+#define SWD_JTAG_TO_SWD 0xE79E
+#define SWD_SWD_TO_JTAG 0xE73C
+#define SWD_ACTIVATION_CODE 0x1A
+#define SWD_READ_DPIDR 0xA5
+
+JtagDiscoveryEngine::JtagDiscoveryEngine(IGpioBus& bus)
+    : bus(bus) {}
+
+bool JtagDiscoveryEngine::isValidIdcode(uint32_t id) {
+    // Bit 0 is always 1, then a JEP106 manufacturer code
+    if (!(id & 1)) return false;
+    int idcode = (id & 0x7F) >> 1;
+    int bank   = (id >> 8) & 0xF;
+    return idcode > 1 && idcode <= 126 && bank <= 8;
+}
+
+uint64_t JtagDiscoveryEngine::maskOf(const std::vector<uint8_t>& pins) {
+    uint64_t mask = 0;
+    for (auto p : pins) mask |= 1ULL << p;
+    return mask;
+}
+
+uint32_t JtagDiscoveryEngine::nextWord(uint32_t& state) {
+    // xorshift32, only needs to be distinct per pin
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+bool JtagDiscoveryEngine::step(const char* phase) {
+    ++stepsDone;
+    if (stepsDone > stepsTotal) stepsTotal = stepsDone;
+    if (progress && !progress(phase, stepsDone, stepsTotal)) {
+        aborted = true;
+        return false;
+    }
+    return true;
+}
+
+// --- JTAG ---
+
+uint64_t JtagDiscoveryEngine::jtagClock(bool tms, uint64_t high, uint64_t low) {
+    // Data changes with TCK low, the TAP samples on the rising edge and we sample with it
+    bus.write(high | (tms ? tmsMask : 0), low | (tms ? 0 : tmsMask) | tckMask);
+    if (jtagHalfPeriodUs) bus.delayUs(jtagHalfPeriodUs);
+    bus.write(tckMask, 0);
+    if (jtagHalfPeriodUs) bus.delayUs(jtagHalfPeriodUs);
+    ++cycles;
+    return bus.read();
+}
+
+void JtagDiscoveryEngine::jtagReset() {
+    for (int i = 0; i < 5; ++i) jtagClock(true);
+}
+
+void JtagDiscoveryEngine::jtagEnd() {
+    bus.write(0, tckMask);
+}
+
+void JtagDiscoveryEngine::idcodeSamples(uint8_t tck, uint8_t tms, uint64_t holdHigh, uint64_t holdLow, uint64_t* samples) {
+    tckMask = 1ULL << tck;
+    tmsMask = 1ULL << tms;
+    bus.setOutputs(tckMask | tmsMask | holdHigh | holdLow);
+    bus.write(holdHigh, holdLow | tckMask | tmsMask);
+
+    // Test-Logic-Reset loads IDCODE (or BYPASS) in the DR of every TAP
+    jtagReset();
+    jtagClock(false);   // Run-Test/Idle
+    jtagClock(true);    // Select-DR
+    jtagClock(false);   // Capture-DR
+    jtagClock(false);   // Shift-DR
+
+    for (int i = 0; i < IDCODE_SAMPLES; ++i) samples[i] = jtagClock(false);
+
+    jtagReset();
+    jtagEnd();
+}
+
+uint32_t JtagDiscoveryEngine::idcodeFor(const uint64_t* samples, uint8_t tdo) const {
+    uint64_t stream = 0;
+    for (int i = 0; i < IDCODE_SAMPLES; ++i) {
+        if ((samples[i] >> tdo) & 1) stream |= 1ULL << i;
+    }
+    if (!stream) return 0;
+
+    // TAPs in BYPASS ahead of the first IDCODE each shift out one 0
+    int skip = 0;
+    while (!((stream >> skip) & 1)) ++skip;
+    if (skip > IDCODE_SAMPLES - 32) return 0;
+
+    uint32_t id = (uint32_t)(stream >> skip);
+    return isValidIdcode(id) ? id : 0;
+}
+
+int JtagDiscoveryEngine::bypassMatch(uint8_t tck, uint8_t tms, uint8_t tdo, const std::vector<uint8_t>& drive,
+                                     uint64_t holdHigh, bool loadBypass, int& chainLength) {
+    tckMask = 1ULL << tck;
+    tmsMask = 1ULL << tms;
+    uint64_t driveMask = maskOf(drive);
+    bus.setOutputs(tckMask | tmsMask | driveMask | holdHigh);
+    bus.write(driveMask | holdHigh, tckMask | tmsMask);
+
+    jtagReset();
+    jtagClock(false);   // Run-Test/Idle
+    jtagClock(true);    // Select-DR
+    if (loadBypass) {
+        // All ones in every IR selects BYPASS, whichever driver is TDI
+        jtagClock(true);    // Select-IR
+        jtagClock(false);   // Capture-IR
+        jtagClock(false);   // Shift-IR
+        for (int i = 0; i < IR_FILL_BITS - 1; ++i) jtagClock(false);
+        jtagClock(true);    // Exit1-IR
+        jtagClock(true);    // Update-IR
+        jtagClock(true);    // Select-DR
+    }
+    jtagClock(false);   // Capture-DR
+    jtagClock(false);   // Shift-DR
+
+    // One word per driver, it comes back on TDO delayed by one bit per TAP
+    uint32_t seed = 0x9E3779B9u ^ ((uint32_t)tck << 8) ^ ((uint32_t)tms << 16) ^ ((uint32_t)tdo << 24);
+    std::vector<uint32_t> words(drive.size());
+    for (auto& w : words) w = nextWord(seed);
+
+    uint64_t stream = 0;
+    for (int i = 0; i < BYPASS_WORD_BITS + MAX_DEVICES; ++i) {
+        uint64_t high = 0, low = 0;
+        for (size_t j = 0; j < drive.size(); ++j) {
+            bool bit = i < BYPASS_WORD_BITS ? (words[j] >> i) & 1 : true;
+            if (bit) high |= 1ULL << drive[j];
+            else     low  |= 1ULL << drive[j];
+        }
+        if ((jtagClock(false, high, low) >> tdo) & 1) stream |= 1ULL << i;
+    }
+
+    jtagClock(true);    // Exit1-DR
+    jtagClock(true);    // Update-DR
+    jtagReset();
+    jtagEnd();
+
+    for (int delay = 1; delay <= MAX_DEVICES; ++delay) {
+        uint32_t seen = (uint32_t)(stream >> delay);
+        for (size_t j = 0; j < drive.size(); ++j) {
+            if (words[j] == seen) {
+                chainLength = delay;
+                return drive[j];
+            }
+        }
+    }
+    return -1;
+}
+
+bool JtagDiscoveryEngine::findTdi(uint8_t tck, uint8_t tms, uint8_t tdo, const std::vector<uint8_t>& rest,
+                                  uint8_t& tdi, int& chainLength, bool loadBypass) {
+    if (rest.empty()) return false;
+
+    int match = bypassMatch(tck, tms, tdo, rest, 0, loadBypass, chainLength);
+    if (match >= 0) {
+        tdi = (uint8_t)match;
+        return true;
+    }
+    if (!loadBypass || rest.size() == 1) return false;
+
+    // A TRST among the drivers may have reset the TAP mid-shift,
+    // try one driver at a time with the others held inactive high
+    uint64_t restMask = maskOf(rest);
+    stepsTotal += rest.size();
+    for (auto pin : rest) {
+        if (!step("BYPASS")) return false;
+        match = bypassMatch(tck, tms, tdo, { pin }, restMask & ~(1ULL << pin), true, chainLength);
+        if (match >= 0) {
+            tdi = (uint8_t)match;
+            return true;
+        }
+    }
+    return false;
+}
+
+int JtagDiscoveryEngine::findTrst(const JtagPinout& found, const std::vector<uint8_t>& rest, uint32_t id) {
+    if (rest.empty() || !id) return -1;
+
+    uint64_t restMask = maskOf(rest);
+    uint64_t tdiMask = 1ULL << found.tdi;
+    uint64_t samples[IDCODE_SAMPLES];
+
+    // IDCODE still readable with these pins held low
+    auto idcodeWith = [&](uint64_t lowMask) {
+        idcodeSamples(found.tck, found.tms, tdiMask | (restMask & ~lowMask), lowMask, samples);
+        return idcodeFor(samples, found.tdo) == id;
+    };
+
+    stepsTotal += 2;
+    if (!step("TRST") || !idcodeWith(0)) return -1;
+    if (!step("TRST") || idcodeWith(restMask)) return -1;
+
+    // Halve the set holding the TAP in reset
+    std::vector<uint8_t> candidates = rest;
+    while (candidates.size() > 1) {
+        std::vector<uint8_t> half(candidates.begin(), candidates.begin() + candidates.size() / 2);
+        ++stepsTotal;
+        if (!step("TRST")) return -1;
+        if (!idcodeWith(maskOf(half))) candidates = half;
+        else candidates.erase(candidates.begin(), candidates.begin() + candidates.size() / 2);
+    }
+    return candidates[0];
+}
+
+void JtagDiscoveryEngine::readIds(JtagPinout& found) {
+    found.ids.clear();
+    tckMask = 1ULL << found.tck;
+    tmsMask = 1ULL << found.tms;
+    uint64_t tdiMask = 1ULL << found.tdi;
+    bus.setOutputs(tckMask | tmsMask | tdiMask);
+    bus.write(tdiMask, tckMask | tmsMask);
+
+    jtagReset();
+    jtagClock(false);   // Run-Test/Idle
+    jtagClock(true);    // Select-DR
+    jtagClock(false);   // Capture-DR
+    jtagClock(false);   // Shift-DR
+
+    for (int d = 0; d < found.deviceCount; ++d) {
+        uint32_t id = 0;
+        for (int b = 0; b < 32; ++b) {
+            if ((jtagClock(false) >> found.tdo) & 1) id |= 1u << b;
+        }
+        found.ids.push_back(id);
+    }
+
+    jtagReset();
+    jtagEnd();
+}
+
+bool JtagDiscoveryEngine::findJtag(const std::vector<uint8_t>& pins, JtagPinout& out, const ProgressFn& onProgress) {
+    cycles = 0;
+    aborted = false;
+    progress = onProgress;
+    stepsDone = 0;
+
+    const size_t n = pins.size();
+    if (n < 4) return false;
+    stepsTotal = n * (n - 1);
+
+    // Pass 1, every TCK/TMS pair with all the other pins sampled as TDO
+    std::vector<Candidate> candidates;
+    uint64_t samples[IDCODE_SAMPLES];
+    for (auto tck : pins) {
+        for (auto tms : pins) {
+            if (tms == tck) continue;
+            if (!step("IDCODE")) { bus.setOutputs(0); return false; }
+
+            idcodeSamples(tck, tms, 0, 0, samples);
+            for (auto tdo : pins) {
+                if (tdo == tck || tdo == tms) continue;
+                uint32_t id = idcodeFor(samples, tdo);
+                if (id) candidates.push_back({ tck, tms, tdo, id });
+            }
+        }
+    }
+
+    auto restOf = [&](std::initializer_list<uint8_t> used) {
+        std::vector<uint8_t> rest;
+        for (auto p : pins) {
+            bool taken = false;
+            for (auto u : used) taken |= (p == u);
+            if (!taken) rest.push_back(p);
+        }
+        return rest;
+    };
+
+    // Pass 2, TDI and chain length for each IDCODE hit
+    stepsTotal += candidates.size();
+    for (const auto& c : candidates) {
+        if (!step("BYPASS")) { bus.setOutputs(0); return false; }
+
+        uint8_t tdi;
+        int chainLength = 0;
+        if (!findTdi(c.tck, c.tms, c.tdo, restOf({ c.tck, c.tms, c.tdo }), tdi, chainLength, true)) {
+            if (aborted) { bus.setOutputs(0); return false; }
+            continue;
+        }
+
+        out.tck = c.tck;
+        out.tms = c.tms;
+        out.tdo = c.tdo;
+        out.tdi = tdi;
+        out.deviceCount = chainLength;
+        readIds(out);
+        out.trst = findTrst(out, restOf({ c.tck, c.tms, c.tdo, tdi }), c.id);
+        bus.setOutputs(0);
+        return true;
+    }
+
+    // No IDCODE anywhere, the TAPs reset to BYPASS so the IR can be left
+    // alone: try every triple, still with all remaining pins driving at once
+    stepsTotal += n * (n - 1) * (n - 2);
+    for (auto tck : pins) {
+        for (auto tms : pins) {
+            if (tms == tck) continue;
+            for (auto tdo : pins) {
+                if (tdo == tck || tdo == tms) continue;
+                if (!step("BYPASS")) { bus.setOutputs(0); return false; }
+
+                uint8_t tdi;
+                int chainLength = 0;
+                if (!findTdi(tck, tms, tdo, restOf({ tck, tms, tdo }), tdi, chainLength, false)) continue;
+
+                out.tck = tck;
+                out.tms = tms;
+                out.tdo = tdo;
+                out.tdi = tdi;
+                out.deviceCount = chainLength;
+                out.trst = -1;
+                out.ids.clear();
+                bus.setOutputs(0);
+                return true;
+            }
+        }
+    }
+
+    bus.setOutputs(0);
+    return false;
+}
+
+// --- SWD ---
+
+void JtagDiscoveryEngine::swdCycle(uint64_t high, uint64_t low) {
+    bus.write(high, low | swclkMask);
+    bus.delayUs(swdHalfPeriodUs);
+    bus.write(swclkMask, 0);
+    bus.delayUs(swdHalfPeriodUs);
+    ++cycles;
+}
+
+void JtagDiscoveryEngine::swdWriteBits(uint64_t pins, uint32_t value, int length) {
+    for (int i = 0; i < length; ++i) {
+        bool bit = (value >> i) & 1;
+        swdCycle(bit ? pins : 0, bit ? 0 : pins);
+    }
+}
+
+uint64_t JtagDiscoveryEngine::swdReadBit() {
+    // The target drives on the rising edge, sample before the next one
+    uint64_t value = bus.read();
+    swdCycle(0, 0);
+    return value;
+}
+
+void JtagDiscoveryEngine::swdLineReset(uint64_t pins) {
+    for (int i = 0; i < SWD_LINE_RESET_CYCLES; ++i) swdCycle(pins, 0);
+}
+
+bool JtagDiscoveryEngine::findSwd(const std::vector<uint8_t>& pins, SwdPinout& out, const ProgressFn& onProgress) {
+    static const uint8_t alert[16] = {
+        0x92, 0xF3, 0x09, 0x62, 0x95, 0x2D, 0x85, 0x86,
+        0xE9, 0xAF, 0xDD, 0xE3, 0xA2, 0x0E, 0xBC, 0x19
+    };
+
+    cycles = 0;
+    aborted = false;
+    progress = onProgress;
+    stepsDone = 0;
+    stepsTotal = pins.size();
+    if (pins.size() < 2) return false;
+
+    const uint64_t all = maskOf(pins);
+
+    // One pass per SWCLK, every other pin is a SWDIO candidate
+    for (auto clk : pins) {
+        if (!step("SWD")) break;
+
+        swclkMask = 1ULL << clk;
+        const uint64_t io = all & ~swclkMask;
+        bus.setOutputs(all);
+        bus.write(all, 0);
+
+        // Dormant to SWD, then JTAG to SWD for older parts
+        for (int i = 0; i < 8; ++i) swdCycle(io, 0);
+        for (int i = 0; i < 16; ++i) swdWriteBits(io, alert[i], 8);
+        swdWriteBits(io, 0x00, 4);
+        swdWriteBits(io, SWD_ACTIVATION_CODE, 8);
+        swdLineReset(io);
+        swdWriteBits(io, SWD_JTAG_TO_SWD, 16);
+        swdLineReset(io);
+        swdWriteBits(io, 0x00, 4);
+        swdWriteBits(io, SWD_READ_DPIDR, 8);
+
+        // Release every candidate and read ACK, DPIDR and parity on all of them
+        bus.setOutputs(swclkMask);
+        swdCycle(0, 0);   // turnaround
+        uint64_t ack[3], data[32], parity;
+        for (auto& a : ack) a = swdReadBit();
+        for (auto& d : data) d = swdReadBit();
+        parity = swdReadBit();
+        bus.setOutputs(all);
+        swdCycle(io, 0);  // turnaround
+
+        for (auto pin : pins) {
+            if (pin == clk) continue;
+            // ACK OK is 0b001, LSB first
+            if (!((ack[0] >> pin) & 1) || ((ack[1] >> pin) & 1) || ((ack[2] >> pin) & 1)) continue;
+
+            uint32_t id = 0;
+            for (int b = 0; b < 32; ++b) {
+                if ((data[b] >> pin) & 1) id |= 1u << b;
+            }
+            bool parityBit = (parity >> pin) & 1;
+            if (__builtin_parity(id) != parityBit || !(id & 1)) continue;
+
+            out.swclk = clk;
+            out.swdio = pin;
+            out.idcode = id;
+
+            // Leave the target in JTAG like it was found
+            uint64_t swdio = 1ULL << pin;
+            swdLineReset(swdio);
+            swdWriteBits(swdio, SWD_SWD_TO_JTAG, 16);
+            bus.setOutputs(0);
+            return true;
+        }
+    }
+
+    bus.setOutputs(0);
+    return false;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Interfaces/IGpioBus.h"
+
+// Finds JTAG and SWD pinouts on a group of candidate pins.
+//
+// Every bus cycle drives and samples all candidates at once, so one pass
+// tests a whole set of roles instead of a single permutation:
+//  - IDCODE pass: for each TCK/TMS pair, every other pin is sampled as TDO
+//    while the TAP shifts its reset IDCODE out.
+//  - BYPASS pass: every remaining pin drives its own pseudo random word
+//    through the bypass chain, TDI is the pin whose word comes back on TDO
+//    and the delay gives the chain length.
+//  - TRST pass: halves of the remaining pins are held low until the IDCODE
+//    disappears.
+//  - SWD pass: for each SWCLK, the wake-up sequence is written on all other
+//    pins and the IDCODE ack is sampled on all of them.
+// When no TAP answers with an IDCODE they all reset to BYPASS, so every
+// TCK/TMS/TDO triple is then tried without loading the IR first.
+class JtagDiscoveryEngine {
+public:
+    struct JtagPinout {
+        uint8_t tck = 0;
+        uint8_t tms = 0;
+        uint8_t tdi = 0;
+        uint8_t tdo = 0;
+        int trst = -1;
+        int deviceCount = 0;
+        std::vector<uint32_t> ids;
+    };
+
+    struct SwdPinout {
+        uint8_t swclk = 0;
+        uint8_t swdio = 0;
+        uint32_t idcode = 0;
+    };
+
+    // Phase name, steps done, steps planned, return false to abort
+    using ProgressFn = std::function<bool(const char* phase, size_t done, size_t total)>;
+
+    explicit JtagDiscoveryEngine(IGpioBus& bus);
+
+    bool findJtag(const std::vector<uint8_t>& pins, JtagPinout& out, const ProgressFn& onProgress = nullptr);
+    bool findSwd(const std::vector<uint8_t>& pins, SwdPinout& out, const ProgressFn& onProgress = nullptr);
+
+    // Clock cycles issued by the last search
+    uint64_t getCycles() const { return cycles; }
+    bool wasAborted() const { return aborted; }
+
+    void setJtagHalfPeriodUs(uint32_t us) { jtagHalfPeriodUs = us; }
+    void setSwdHalfPeriodUs(uint32_t us) { swdHalfPeriodUs = us; }
+
+    static bool isValidIdcode(uint32_t id);
+
+private:
+    static constexpr int MAX_DEVICES = 32;
+    static constexpr int IR_FILL_BITS = 1024;           // 32 devices x 32 bit IR, all ones selects BYPASS
+    static constexpr int IDCODE_SAMPLES = 64;           // leading BYPASS zeros, then one IDCODE
+    static constexpr int BYPASS_WORD_BITS = 32;
+
+    struct Candidate {
+        uint8_t tck;
+        uint8_t tms;
+        uint8_t tdo;
+        uint32_t id;
+    };
+
+    IGpioBus& bus;
+    uint64_t cycles = 0;
+    bool aborted = false;
+    uint32_t jtagHalfPeriodUs = 1;     // passes are short, keep TCK slow for flying leads
+    uint32_t swdHalfPeriodUs = 5;
+
+    // Pass state, progress is reported against a running total
+    ProgressFn progress;
+    size_t stepsDone = 0;
+    size_t stepsTotal = 0;
+    bool step(const char* phase);
+
+    // JTAG
+    uint64_t tckMask = 0;
+    uint64_t tmsMask = 0;
+    uint64_t jtagClock(bool tms, uint64_t high = 0, uint64_t low = 0);
+    void jtagReset();
+    void jtagEnd();
+    void idcodeSamples(uint8_t tck, uint8_t tms, uint64_t holdHigh, uint64_t holdLow, uint64_t* samples);
+    uint32_t idcodeFor(const uint64_t* samples, uint8_t tdo) const;
+    int bypassMatch(uint8_t tck, uint8_t tms, uint8_t tdo, const std::vector<uint8_t>& drive,
+                    uint64_t holdHigh, bool loadBypass, int& chainLength);
+    bool findTdi(uint8_t tck, uint8_t tms, uint8_t tdo, const std::vector<uint8_t>& rest,
+                 uint8_t& tdi, int& chainLength, bool loadBypass);
+    int findTrst(const JtagPinout& found, const std::vector<uint8_t>& rest, uint32_t id);
+    void readIds(JtagPinout& found);
+
+    // SWD
+    uint64_t swclkMask = 0;
+    void swdCycle(uint64_t high, uint64_t low);
+    void swdWriteBits(uint64_t pins, uint32_t value, int length);
+    uint64_t swdReadBit();
+    void swdLineReset(uint64_t pins);
+
+    static uint64_t maskOf(const std::vector<uint8_t>& pins);
+    static uint32_t nextWord(uint32_t& state);
+};
@@ -35,18 +35,52 @@
 
 #include "JtagService.h"
 #include "driver/gpio.h"
+#include "soc/gpio_reg.h"
 #include "esp_timer.h"
+#include "Services/JtagTapEngine.h"
+#include "Services/SvfPlayer.h"
+#include "Services/XsvfPlayer.h"
 
-#define SWD_DELAY_US 5
-#define LINE_RESET_CLK_CYCLES 52
-#define JTAG_TO_SWD_CMD 0xE79E
-#define SWD_TO_JTAG_CMD 0xE73C
-#define SWDP_ACTIVATION_CODE 0x1A
-#define MAX_DEVICES_LEN      32                             // Maximum number of devices allowed in a single JTAG chain
-#define MIN_IR_LEN           2                              // Minimum length of instruction register per IEEE Std. 1149.1
-#define MAX_IR_LEN           32                             // Maximum length of instruction register
-#define MAX_IR_CHAIN_LEN     MAX_DEVICES_LEN * MAX_IR_LEN   // Maximum total length of JTAG chain w/ IR selected
-#define MAX_DR_LEN           4096    
+namespace {
+
+// All candidate pins in one register access, bank 1 holds GPIO 32 and up
+class RegisterGpioBus : public IGpioBus {
+public:
+    void setOutputs(uint64_t mask) override {
+        uint64_t drop = enabled & ~mask;
+        uint64_t add = mask & ~enabled;
+        if ((uint32_t)drop) REG_WRITE(GPIO_ENABLE_W1TC_REG, (uint32_t)drop);
+        if (drop >> 32)     REG_WRITE(GPIO_ENABLE1_W1TC_REG, (uint32_t)(drop >> 32));
+        if ((uint32_t)add)  REG_WRITE(GPIO_ENABLE_W1TS_REG, (uint32_t)add);
+        if (add >> 32)      REG_WRITE(GPIO_ENABLE1_W1TS_REG, (uint32_t)(add >> 32));
+        enabled = mask;
+    }
+
+    void write(uint64_t high, uint64_t low) override {
+        if ((uint32_t)low)  REG_WRITE(GPIO_OUT_W1TC_REG, (uint32_t)low);
+        if (low >> 32)      REG_WRITE(GPIO_OUT1_W1TC_REG, (uint32_t)(low >> 32));
+        if ((uint32_t)high) REG_WRITE(GPIO_OUT_W1TS_REG, (uint32_t)high);
+        if (high >> 32)     REG_WRITE(GPIO_OUT1_W1TS_REG, (uint32_t)(high >> 32));
+    }
+
+    uint64_t read() override {
+        return REG_READ(GPIO_IN_REG) | ((uint64_t)REG_READ(GPIO_IN1_REG) << 32);
+    }
+
+    void delayUs(uint32_t us) override {
+        // Long RUNTEST waits yield, the extra tick covers the partial first one
+        if (us >= 10000) {
+            vTaskDelay(pdMS_TO_TICKS(us / 1000) + 1);
+            return;
+        }
+        esp_rom_delay_us(us);
+    }
+
+private:
+    uint64_t enabled = 0;
+};
+
+}
 
 // --- JTAG ---
 
@@ -88,150 +122,19 @@ bool JtagService::tdoRead() {
     return val;
 }
 
-void JtagService::restoreIdle() {
-    tmsWrite(true);
-    for (int i = 0; i < 5; ++i) tckPulse();
-    tmsWrite(false);
-    tckPulse(); // Enter Run-Test/Idle
-}
-
-void JtagService::enterShiftDR() {
-    tmsWrite(true); tckPulse(); // Select DR
-    tmsWrite(false); tckPulse(); // Capture DR
-    tmsWrite(false); tckPulse(); // Shift DR
-}
-
-void JtagService::enterShiftIR() {
-    tmsWrite(true); tckPulse(); // Select DR
-    tmsWrite(true); tckPulse(); // Select IR
-    tmsWrite(false); tckPulse(); // Capture IR
-    tmsWrite(false); tckPulse(); // Shift IR
-}
-
-uint32_t JtagService::bitReverse(uint32_t n) {
-    uint32_t r = 0;
-    for (int i = 0; i < 32; ++i) {
-        r <<= 1;
-        r |= n & 1;
-        n >>= 1;
-    }
-    return r;
-}
-
-uint32_t JtagService::shiftArray(uint32_t pattern, int bits) {
-    uint32_t result = 0;
-    for (int i = 1; i <= bits; ++i) {
-        if (i == bits) tmsWrite(true);
-        tdiWrite(pattern & 1);
-        pattern >>= 1;
-        result <<= 1;
-        result |= tdoRead();
-    }
-    return result;
-}
-
-uint32_t JtagService::sendData(uint32_t pattern, int bits) {
-    enterShiftDR();
-    uint32_t out = shiftArray(pattern, bits);
-    tmsWrite(true); tckPulse(); // Update DR
-    tmsWrite(false); tckPulse(); // Run-Test/Idle
-    return out;
-}
-
-int JtagService::detectDevices() {
-    restoreIdle();
-    enterShiftIR();
-    tdiWrite(true);
-    for (int i = 0; i < MAX_IR_CHAIN_LEN; ++i) tckPulse();
-    tmsWrite(true); tckPulse(); // Exit1-IR
-    tmsWrite(true); tckPulse(); // Update-IR
-    tmsWrite(true); tckPulse(); // Select-DR
-    tmsWrite(false); tckPulse(); // Capture-DR
-    tmsWrite(false); tckPulse(); // Shift-DR
-
-    int x;
-    for(x = 0; x < MAX_DEVICES_LEN; x++)
-    {
-        tckPulse();
-    }
-
-    tdiWrite(false);
-    for(x = 0; x < (MAX_DEVICES_LEN - 1); x++) {
-        if(tdoRead() == false) {
-            break;
-        }
-    }
-
-    if (x > (MAX_DEVICES_LEN - 1))
-    {
-        x = 0;
-    }
-
-    tmsWrite(true); tckPulse();
-    tmsWrite(true); tckPulse();
-    tmsWrite(false); tckPulse(); // Run-Test/Idle
-    return (x);
-}
-
-void JtagService::getDeviceIDs(int count, std::vector<uint32_t>& ids) {
-    ids.clear();
-    restoreIdle();
-    enterShiftDR();
-    tdiWrite(true);
-    tmsWrite(false);
-
-    for (int i = 0; i < count; ++i) {
-        uint32_t id = 0;
-        for (int b = 0; b < 32; ++b) {
-            id <<= 1;
-            id |= tdoRead();
-        }
-        ids.push_back(bitReverse(id));
-    }
-    restoreIdle();
-}
-
-uint32_t JtagService::bypassTest(int count, uint32_t pattern) {
-    if (count <= 0 || count > MAX_DEVICES_LEN) return 0;
-    restoreIdle();
-    enterShiftIR();
-    tdiWrite(true);
-    for (int i = 0; i < count * MAX_IR_LEN; ++i) tckPulse();
-    tmsWrite(true); tckPulse(); // Exit1 IR
-    tmsWrite(true); tckPulse(); // Update IR
-    tmsWrite(false); tckPulse(); // Run Test/Idle
-    return bitReverse(sendData(pattern, 32 + count));
-}
-
-bool JtagService::isValidDeviceID(uint32_t id) {
-    int idcode = (id & 0x7F) >> 1;
-    int bank   = (id >> 8) & 0xF;
-    return idcode > 1 && idcode <= 126 && bank <= 8;
-}
-
-void JtagService::jtagInitChannels(const std::vector<uint8_t>& pins, bool pulsePins) {
+void JtagService::prepareScanPins(const std::vector<uint8_t>& pins, bool pullUp) {
     for (auto pin : pins) {
+        // GPIO function with the plain output routed and the input path on,
+        // the engine then only flips the output enable bits
+        gpio_reset_pin((gpio_num_t)pin);
+        if (!pullUp) gpio_pullup_dis((gpio_num_t)pin);
         gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT);
-        if (pulsePins) {
-            gpio_pulldown_en((gpio_num_t)pin);
-        } else {
-            gpio_pullup_en((gpio_num_t)pin);
-        }
     }
 }
 
-void JtagService::jtagResetChannels(const std::vector<uint8_t>& pins, int trstPin, bool pulsePins) {
+void JtagService::releaseScanPins(const std::vector<uint8_t>& pins) {
     for (auto pin : pins) {
-        if (trstPin >= 0 && pin == trstPin) {
-            gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT);
-            if (pulsePins) {
-                gpio_pulldown_en((gpio_num_t)pin);
-            } else {
-                gpio_pullup_en((gpio_num_t)pin);
-            }
-        } else {
-            gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT);
-        }
+        gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT);
     }
 }
 
@@ -242,230 +145,109 @@ bool JtagService::scanJtagDevice(
     int& outTRST,
     std::vector<uint32_t>& outDeviceIDs,
     bool pulsePins,
-    void (*onProgress)(size_t, size_t)
+    const ScanProgress& onProgress
 ) {
-    int channelCount = pins.size();
-    uint32_t tempDeviceId;
-    bool volatile foundPinout = false;
     outDeviceIDs.clear();
-    size_t progressCount = 0;
-    size_t maxPermutations = channelCount * (channelCount - 1) * (channelCount - 2) * (channelCount - 3);
-
-    for (auto tdi : pins) {
-        for (auto tdo : pins) {
-            if (tdi == tdo) continue;
-            for (auto tck : pins) {
-                if (tck == tdi || tck == tdo) continue;
-                for (auto tms : pins) {
-                    if (tms == tck || tms == tdo || tms == tdi) continue;
-
-                    if (onProgress) onProgress(++progressCount, maxPermutations);
-
-                    jtagInitChannels(pins, pulsePins);
-                    if (pulsePins) {
-                        for (auto ch : pins) {
-                            gpio_set_direction((gpio_num_t)ch, GPIO_MODE_INPUT);
-                            gpio_pullup_en((gpio_num_t)ch);
-                        }
-                    }
-
-                    configureJtag(tck, tms, tdi, tdo);
-                    int deviceCount = detectDevices();
-
-                    if (deviceCount <= 0) {
-                        continue;
-                    }
-
-                    uint32_t dataIn = esp_random();
-                    uint32_t dataOut = bypassTest(deviceCount, dataIn);
-
-                    if (dataIn == dataOut) {
-                        std::vector<uint32_t> ids;
-                        getDeviceIDs(deviceCount, ids);
-                        tempDeviceId = ids.empty() ? 0 : ids[0];
-
-                        if (ids.empty()) {
-                            Serial.println("       No device IDs read");
-                            continue;
-                        }
-
-                        if (!isValidDeviceID(tempDeviceId)) {
-                            continue;
-                        }
-
-                        foundPinout = true;
-                        outTDI = tdi;
-                        outTDO = tdo;
-                        outTCK = tck;
-                        outTMS = tms;
-                        outTRST = -1;
-                        outDeviceIDs = ids;
-
-                        for (auto trst : pins) {
-                            if (trst == tms || trst == tck || trst == tdo || trst == tdi) continue;
-
-                            if (onProgress) onProgress(++progressCount, maxPermutations);
-
-                            gpio_set_direction((gpio_num_t)trst, GPIO_MODE_INPUT);
-                            if (pulsePins) {
-                                gpio_pullup_en((gpio_num_t)trst);
-                            } else {
-                                gpio_pulldown_en((gpio_num_t)trst);
-                            }
-
-                            usleep(10);
-
-                            std::vector<uint32_t> tmpIDs;
-                            getDeviceIDs(1, tmpIDs);
-
-                            if (!tmpIDs.empty() && tmpIDs[0] != tempDeviceId) {
-                                outTRST = trst;
-                                break;
-                            }
-                        }
-
-                        jtagResetChannels(pins, outTRST, pulsePins);
-                        return true;
-                    }
-
-                    jtagResetChannels(pins, outTRST, pulsePins);
-                }
-            }
-        }
-    }
-
-    if (!foundPinout && onProgress) {
-        onProgress(maxPermutations, maxPermutations);
-    }
-
-    return false;
+    prepareScanPins(pins, pulsePins);
+
+    RegisterGpioBus bus;
+    JtagDiscoveryEngine engine(bus);
+    JtagDiscoveryEngine::JtagPinout found;
+    bool ok = engine.findJtag(pins, found, onProgress);
+
+    releaseScanPins(pins);
+    lastScanCycles = engine.getCycles();
+    lastScanAborted = engine.wasAborted();
+    if (!ok) return false;
+
+    outTDI = found.tdi;
+    outTDO = found.tdo;
+    outTCK = found.tck;
+    outTMS = found.tms;
+    outTRST = found.trst;
+    outDeviceIDs = found.ids;
+    return true;
 }
 
-
-
 // --- SWD ---
 
-void JtagService::swdDelay() {
-    esp_rom_delay_us(SWD_DELAY_US);
-}
-
-void JtagService::swdClockPulse() {
-    gpio_set_level((gpio_num_t)_pinSWCLK, 0);
-    swdDelay();
-    gpio_set_level((gpio_num_t)_pinSWCLK, 1);
-    swdDelay();
-}
+bool JtagService::scanSwdDevice(const std::vector<uint8_t>& pins, uint8_t& swdio, uint8_t& swclk, uint32_t& idcodeOut,
+                                const ScanProgress& onProgress) {
+    prepareScanPins(pins, true);
 
-void JtagService::swdSetReadMode() {
-    gpio_set_direction((gpio_num_t)_pinSWDIO, GPIO_MODE_INPUT);
-}
+    RegisterGpioBus bus;
+    JtagDiscoveryEngine engine(bus);
+    JtagDiscoveryEngine::SwdPinout found;
+    bool ok = engine.findSwd(pins, found, onProgress);
 
-void JtagService::swdSetWriteMode() {
-    gpio_set_direction((gpio_num_t)_pinSWDIO, GPIO_MODE_OUTPUT);
-}
+    releaseScanPins(pins);
+    lastScanCycles = engine.getCycles();
+    lastScanAborted = engine.wasAborted();
+    if (!ok) return false;
 
-void JtagService::swdWriteBit(bool value) {
-    gpio_set_level((gpio_num_t)_pinSWDIO, value);
-    swdClockPulse();
-}
-
-void JtagService::swdWriteBits(uint32_t value, int length) {
-    for (int i = 0; i < length; i++) {
-        swdWriteBit((value >> i) & 1);
-    }
-}
-
-bool JtagService::swdReadBit() {
-    bool value = gpio_get_level((gpio_num_t)_pinSWDIO);
-    swdClockPulse();
-    return value;
-}
-
-bool JtagService::swdReadAck() {
-    uint8_t ack = 0;
-    for (int i = 0; i < 3; i++) {
-        ack |= (swdReadBit() << i);
-    }
-    return ack == 0b001;
-}
-
-void JtagService::swdResetLineSWDJ() {
-    swdSetWriteMode();
-    gpio_set_level((gpio_num_t)_pinSWDIO, 1);
-    for (int i = 0; i < LINE_RESET_CLK_CYCLES + 10; ++i) {
-        swdClockPulse();
-    }
-}
-
-void JtagService::swdToJTAG() {
-    swdResetLineSWDJ();
-    swdWriteBits(SWD_TO_JTAG_CMD, 16);
-}
-
-void JtagService::swdArmWakeUp() {
-    swdSetWriteMode();
-    gpio_set_level((gpio_num_t)_pinSWDIO, 1);
-    for (int i = 0; i < 8; i++) swdClockPulse();
-
-    const uint8_t alert[16] = {
-        0x92, 0xF3, 0x09, 0x62, 0x95, 0x2D, 0x85, 0x86,
-        0xE9, 0xAF, 0xDD, 0xE3, 0xA2, 0x0E, 0xBC, 0x19
-    };
-    for (int i = 0; i < 16; i++) swdWriteBits(alert[i], 8);
-
-    swdWriteBits(0x00, 4); // idle
-    swdWriteBits(SWDP_ACTIVATION_CODE, 8);
-}
-
-bool JtagService::swdTrySWDJ(uint32_t& idcodeOut) {
-    swdArmWakeUp();
-    swdResetLineSWDJ();
-    swdWriteBits(JTAG_TO_SWD_CMD, 16);
-    swdResetLineSWDJ();
-    swdWriteBits(0x00, 4); // idle
-    swdWriteBits(0xA5, 8); // read IDCODE
-
-    swdSetReadMode();
-    swdClockPulse(); // Turnaround
-
-    if (!swdReadAck()) return false;
-
-    uint32_t idcode = 0;
-    for (int i = 0; i < 32; ++i) {
-        idcode |= (swdReadBit() << i);
-    }
-    swdReadBit(); // skip parity
-    swdSetWriteMode();
-    swdClockPulse();
-
-    idcodeOut = idcode;
+    swdio = found.swdio;
+    swclk = found.swclk;
+    idcodeOut = found.idcode;
     return true;
 }
 
-bool JtagService::scanSwdDevice(const std::vector<uint8_t>& pins, uint8_t& swdio, uint8_t& swclk, uint32_t& idcodeOut) {
-    for (auto clk : pins) {
-        for (auto io : pins) {
-            if (clk == io) continue;
-            _pinSWDIO = io;
-            _pinSWCLK = clk;
-
-            gpio_set_direction((gpio_num_t)_pinSWDIO, GPIO_MODE_OUTPUT);
-            gpio_set_direction((gpio_num_t)_pinSWCLK, GPIO_MODE_OUTPUT);
-            gpio_set_level((gpio_num_t)_pinSWDIO, 1);
-            gpio_set_level((gpio_num_t)_pinSWCLK, 1);
-
-            bool found = swdTrySWDJ(idcodeOut);
-            if (found) {
-                swdio = io;
-                swclk = clk;
-                swdToJTAG();
-                return true;
-            }
-
-            // Reset
-            gpio_set_direction((gpio_num_t)_pinSWDIO, GPIO_MODE_INPUT);
-            gpio_set_direction((gpio_num_t)_pinSWCLK, GPIO_MODE_INPUT);
-        }
-    }
-    return false;
-}
\ No newline at end of file
+// --- SVF / XSVF ---
+
+bool JtagService::playVectors(bool xsvf, const VectorSource& source, PlaybackReport& report) {
+    report = PlaybackReport();
+    if (_pinTCK < 0 || _pinTMS < 0 || _pinTDI < 0 || _pinTDO < 0) {
+        report.error = "JTAG pins are not configured";
+        return false;
+    }
+
+    std::vector<uint8_t> pins = { (uint8_t)_pinTCK, (uint8_t)_pinTMS, (uint8_t)_pinTDI, (uint8_t)_pinTDO };
+    if (_pinTRST >= 0) pins.push_back((uint8_t)_pinTRST);
+    prepareScanPins(pins, true);
+
+    RegisterGpioBus bus;
+    JtagTapEngine tap(bus);
+    tap.setPins(_pinTCK, _pinTMS, _pinTDI, _pinTDO, _pinTRST);
+    tap.begin();
+    tap.reset();
+
+    // Full speed TCK with TMS high, the TAP stays in Test-Logic-Reset
+    const uint32_t calibrationCycles = 1024;
+    int64_t calibrationStart = esp_timer_get_time();
+    tap.clock(calibrationCycles);
+    int64_t calibrationUs = esp_timer_get_time() - calibrationStart;
+    report.busMaxHz = calibrationUs > 0 ? (uint64_t)calibrationCycles * 1000000 / calibrationUs : 0;
+    tap.resetCycles();
+
+    SvfPlayer svf(tap);
+    XsvfPlayer xsvfPlayer(tap);
+    svf.setBusMaxHz(report.busMaxHz);
+    svf.begin();
+    xsvfPlayer.begin();
+
+    int64_t start = esp_timer_get_time();
+    bool fed = source([&](const uint8_t* data, size_t len) {
+        return xsvf ? xsvfPlayer.feed(data, len) : svf.feed((const char*)data, len);
+    });
+
+    bool ok;
+    if (xsvf) {
+        ok = fed && xsvfPlayer.finish();
+        report.error = xsvfPlayer.getError();
+        report.position = xsvfPlayer.getOffset();
+        report.statements = xsvfPlayer.getInstructionCount();
+        report.shiftedBits = xsvfPlayer.getShiftedBits();
+    } else {
+        ok = fed && svf.finish();
+        report.error = svf.getError();
+        report.position = svf.getLine();
+        report.statements = svf.getStatementCount();
+        report.shiftedBits = svf.getShiftedBits();
+    }
+    report.stopped = !fed && report.error.empty();
+    report.elapsedUs = (uint32_t)(esp_timer_get_time() - start);
+    report.cycles = tap.getCycles();
+
+    tap.end();
+    releaseScanPins(pins);
+    return ok;
+}
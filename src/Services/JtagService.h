@@ -37,10 +37,30 @@
 
 #include <Arduino.h>
 #include <cstdint>
+#include <functional>
+#include <string>
 #include <vector>
+#include "Services/JtagDiscoveryEngine.h"
 
 class JtagService {
 public:
+    using ScanProgress = JtagDiscoveryEngine::ProgressFn;
+
+    // A file source pushes its chunks into the sink until the sink returns false
+    using VectorSink = std::function<bool(const uint8_t*, size_t)>;
+    using VectorSource = std::function<bool(const VectorSink&)>;
+
+    struct PlaybackReport {
+        std::string error;
+        bool stopped = false;       // source gave up before the end
+        size_t position = 0;        // SVF line or XSVF byte offset of the last statement
+        size_t statements = 0;
+        uint64_t cycles = 0;
+        uint64_t shiftedBits = 0;
+        uint32_t elapsedUs = 0;
+        uint32_t busMaxHz = 0;      // TCK with no delay, measured before playing
+    };
+
     void configureJtag(uint8_t tck, uint8_t tms, uint8_t tdi, uint8_t tdo, int trst = -1);
     
     bool scanJtagDevice(
@@ -50,10 +70,18 @@ public:
         int& outTRST,
         std::vector<uint32_t>& outDeviceIDs,
         bool pulsePins,
-        void (*onProgress)(size_t, size_t)
+        const ScanProgress& onProgress = nullptr
     );
 
-    bool scanSwdDevice(const std::vector<uint8_t>& pins, uint8_t& foundIO, uint8_t& foundCLK, uint32_t& idcodeOut);
+    bool scanSwdDevice(const std::vector<uint8_t>& pins, uint8_t& foundIO, uint8_t& foundCLK, uint32_t& idcodeOut,
+                       const ScanProgress& onProgress = nullptr);
+
+    // Play SVF text or an XSVF binary on the configureJtag() pins
+    bool playVectors(bool xsvf, const VectorSource& source, PlaybackReport& report);
+
+    // Clock cycles used by the last scan, and whether it was cancelled
+    uint64_t getLastScanCycles() const { return lastScanCycles; }
+    bool wasLastScanAborted() const { return lastScanAborted; }
 
 private:
     // JTAG pins
@@ -63,39 +91,16 @@ private:
     int _pinTDO = -1;
     int _pinTRST = -1;
 
-    // SWD pins
-    int _pinSWDIO = -1;
-    int _pinSWCLK = -1;
+    uint64_t lastScanCycles = 0;
+    bool lastScanAborted = false;
 
     // JTAG helpers
     void tckPulse();
     void tdiWrite(bool val);
     void tmsWrite(bool val);
     bool tdoRead();
-    void restoreIdle();
-    void enterShiftDR();
-    void enterShiftIR();
-    uint32_t bitReverse(uint32_t n);
-    uint32_t shiftArray(uint32_t pattern, int bits);
-    uint32_t sendData(uint32_t pattern, int bits);
-    int detectDevices();
-    void getDeviceIDs(int count, std::vector<uint32_t>& ids);
-    uint32_t bypassTest(int count, uint32_t pattern);
-    bool isValidDeviceID(uint32_t id);
-    void jtagResetChannels(const std::vector<uint8_t>& pins, int trstPin, bool pulsePins);
-    void jtagInitChannels(const std::vector<uint8_t>& pins, bool pulsePins);
-
-    // SWD helpers
-    void swdClockPulse();
-    void swdSetReadMode();
-    void swdSetWriteMode();
-    bool swdReadBit();
-    void swdWriteBit(bool bit);
-    void swdWriteBits(uint32_t value, int bitLength);
-    bool swdReadAck();
-    void swdResetLineSWDJ();
-    void swdToJTAG();
-    void swdArmWakeUp();
-    bool swdTrySWDJ(uint32_t& idcodeOut);
-    void swdDelay() ;
+
+    // Scan pins are switched to outputs through the GPIO registers by the engine
+    void prepareScanPins(const std::vector<uint8_t>& pins, bool pullUp);
+    void releaseScanPins(const std::vector<uint8_t>& pins);
 };
@@ -0,0 +1,176 @@
+#include "JtagTapEngine.h"
+
+JtagTapEngine::JtagTapEngine(IGpioBus& bus)
+    : bus(bus) {}
+
+void JtagTapEngine::setPins(uint8_t tck, uint8_t tms, uint8_t tdi, uint8_t tdo, int trst) {
+    tckMask = 1ULL << tck;
+    tmsMask = 1ULL << tms;
+    tdiMask = 1ULL << tdi;
+    tdoPin = tdo;
+    trstPin = trst;
+    trstMask = trst >= 0 ? 1ULL << trst : 0;
+}
+
+void JtagTapEngine::begin() {
+    // TRST stays released until asked for
+    outputs = tckMask | tmsMask | tdiMask;
+    bus.setOutputs(outputs);
+    bus.write(tmsMask | tdiMask, tckMask);
+    state = TapState::Reset;
+}
+
+void JtagTapEngine::end() {
+    bus.write(0, tckMask);
+    bus.setOutputs(0);
+}
+
+JtagTapEngine::TapState JtagTapEngine::nextState(TapState s, bool tms) {
+    switch (s) {
+        case TapState::Reset:     return tms ? TapState::Reset    : TapState::Idle;
+        case TapState::Idle:      return tms ? TapState::DrSelect : TapState::Idle;
+        case TapState::DrSelect:  return tms ? TapState::IrSelect : TapState::DrCapture;
+        case TapState::DrCapture: return tms ? TapState::DrExit1  : TapState::DrShift;
+        case TapState::DrShift:   return tms ? TapState::DrExit1  : TapState::DrShift;
+        case TapState::DrExit1:   return tms ? TapState::DrUpdate : TapState::DrPause;
+        case TapState::DrPause:   return tms ? TapState::DrExit2  : TapState::DrPause;
+        case TapState::DrExit2:   return tms ? TapState::DrUpdate : TapState::DrShift;
+        case TapState::DrUpdate:  return tms ? TapState::DrSelect : TapState::Idle;
+        case TapState::IrSelect:  return tms ? TapState::Reset    : TapState::IrCapture;
+        case TapState::IrCapture: return tms ? TapState::IrExit1  : TapState::IrShift;
+        case TapState::IrShift:   return tms ? TapState::IrExit1  : TapState::IrShift;
+        case TapState::IrExit1:   return tms ? TapState::IrUpdate : TapState::IrPause;
+        case TapState::IrPause:   return tms ? TapState::IrExit2  : TapState::IrPause;
+        case TapState::IrExit2:   return tms ? TapState::IrUpdate : TapState::IrShift;
+        case TapState::IrUpdate:  return tms ? TapState::DrSelect : TapState::Idle;
+    }
+    return TapState::Reset;
+}
+
+bool JtagTapEngine::isStable(TapState s) {
+    return s == TapState::Reset || s == TapState::Idle || s == TapState::DrPause || s == TapState::IrPause;
+}
+
+inline uint64_t JtagTapEngine::tick(uint64_t high, uint64_t low) {
+    // Data changes with TCK low, the TAP samples it on the rising edge
+    bus.write(high, low | tckMask);
+    if (halfPeriodUs) bus.delayUs(halfPeriodUs);
+    bus.write(tckMask, 0);
+    if (halfPeriodUs) bus.delayUs(halfPeriodUs);
+    ++cycles;
+    return bus.read();
+}
+
+void JtagTapEngine::tmsBit(bool tms) {
+    tick(tms ? tmsMask : 0, tms ? 0 : tmsMask);
+    state = nextState(state, tms);
+}
+
+void JtagTapEngine::reset() {
+    for (int i = 0; i < 5; ++i) tmsBit(true);
+    state = TapState::Reset;
+}
+
+void JtagTapEngine::goTo(TapState target) {
+    if (target == TapState::Reset) {
+        reset();
+        return;
+    }
+    if (state == target) return;
+
+    // Breadth first over the 16 states, paths are at most 7 clocks
+    const int count = 16;
+    int8_t prev[count];
+    bool prevTms[count];
+    for (int i = 0; i < count; ++i) prev[i] = -1;
+
+    uint8_t queue[count];
+    int headIdx = 0, tailIdx = 0;
+    uint8_t from = (uint8_t)state;
+    queue[tailIdx++] = from;
+    prev[from] = from;
+
+    while (headIdx < tailIdx) {
+        uint8_t s = queue[headIdx++];
+        if (s == (uint8_t)target) break;
+        for (int tms = 0; tms < 2; ++tms) {
+            uint8_t n = (uint8_t)nextState((TapState)s, tms);
+            if (prev[n] >= 0) continue;
+            prev[n] = s;
+            prevTms[n] = tms;
+            queue[tailIdx++] = n;
+        }
+    }
+
+    bool path[count];
+    int length = 0;
+    for (uint8_t s = (uint8_t)target; s != from; s = prev[s]) path[length++] = prevTms[s];
+    while (length > 0) tmsBit(path[--length]);
+}
+
+void JtagTapEngine::clock(uint32_t count) {
+    // Idle and the pause states hold with TMS low, Reset with TMS high
+    bool tms = state == TapState::Reset;
+    uint64_t high = tms ? tmsMask : 0;
+    uint64_t low = tms ? 0 : tmsMask;
+    while (count--) tick(high, low);
+}
+
+void JtagTapEngine::wait(uint32_t clocks, uint32_t minUs) {
+    clock(clocks);
+    uint64_t spentUs = (uint64_t)clocks * 2 * halfPeriodUs;
+    if (minUs > spentUs) bus.delayUs(minUs - spentUs);
+}
+
+void JtagTapEngine::shift(bool ir, const uint32_t* tdi, uint32_t* tdo, size_t bits, bool exitAfter) {
+    if (bits == 0) return;
+    TapState shiftState = ir ? TapState::IrShift : TapState::DrShift;
+    goTo(shiftState);
+
+    size_t words = (bits + 31) / 32;
+    for (size_t w = 0; w < words; ++w) {
+        uint32_t in = tdi ? tdi[w] : 0xFFFFFFFF;
+        uint32_t out = 0;
+        size_t n = (w == words - 1) ? bits - w * 32 : 32;
+
+        for (size_t b = 0; b < n; ++b) {
+            bool last = exitAfter && w == words - 1 && b == n - 1;
+            uint64_t high = (in & 1) ? tdiMask : 0;
+            uint64_t low = (in & 1) ? 0 : tdiMask;
+            if (last) high |= tmsMask;
+            else low |= tmsMask;
+
+            uint64_t sampled = tick(high, low);
+            out |= (uint32_t)((sampled >> tdoPin) & 1) << b;
+            in >>= 1;
+        }
+        if (tdo) tdo[w] = out;
+    }
+
+    if (exitAfter) state = ir ? TapState::IrExit1 : TapState::DrExit1;
+}
+
+bool JtagTapEngine::matches(const uint32_t* got, const uint32_t* expected, const uint32_t* mask, size_t bits) {
+    size_t words = (bits + 31) / 32;
+    for (size_t w = 0; w < words; ++w) {
+        uint32_t care = mask ? mask[w] : 0xFFFFFFFF;
+        size_t n = bits - w * 32;
+        if (n < 32) care &= (1u << n) - 1;
+        if ((got[w] ^ expected[w]) & care) return false;
+    }
+    return true;
+}
+
+void JtagTapEngine::setTrst(TrstMode mode) {
+    if (!trstMask) return;
+
+    // Active low, Z and Absent release the line
+    if (mode == TrstMode::On || mode == TrstMode::Off) {
+        bus.write(mode == TrstMode::Off ? trstMask : 0, mode == TrstMode::On ? trstMask : 0);
+        outputs |= trstMask;
+    } else {
+        outputs &= ~trstMask;
+    }
+    bus.setOutputs(outputs);
+    if (mode == TrstMode::On) state = TapState::Reset;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Interfaces/IGpioBus.h"
+
+// Bit-banged TAP controller on four (or five) known pins. Tracks the TAP
+// state, walks the shortest TMS path between states and shifts vectors of
+// any length held as 32-bit words, LSB first. Every clock is one output
+// register write plus one TCK write, TDO comes from the input register.
+class JtagTapEngine {
+public:
+    enum class TapState : uint8_t {
+        Reset, Idle,
+        DrSelect, DrCapture, DrShift, DrExit1, DrPause, DrExit2, DrUpdate,
+        IrSelect, IrCapture, IrShift, IrExit1, IrPause, IrExit2, IrUpdate
+    };
+
+    enum class TrstMode : uint8_t { On, Off, Z, Absent };
+
+    explicit JtagTapEngine(IGpioBus& bus);
+
+    void setPins(uint8_t tck, uint8_t tms, uint8_t tdi, uint8_t tdo, int trst = -1);
+    void begin();
+    void end();
+
+    // 0 runs TCK as fast as the bus goes
+    void setHalfPeriodUs(uint32_t us) { halfPeriodUs = us; }
+    uint32_t getHalfPeriodUs() const { return halfPeriodUs; }
+
+    // Five TMS high clocks, valid from any state
+    void reset();
+
+    // Shortest TMS path, or 5 ones for Reset
+    void goTo(TapState target);
+
+    // TCK cycles in the current state, TMS held for a stable state
+    void clock(uint32_t cycles);
+
+    // Shift bits from tdi (nullptr shifts ones) into DrShift or IrShift,
+    // tdo (may be nullptr) gets what came out. With exitAfter the last bit
+    // leaves to Exit1, otherwise the TAP stays in the shift state.
+    void shift(bool ir, const uint32_t* tdi, uint32_t* tdo, size_t bits, bool exitAfter);
+
+    // Clocks in the current state, then whatever is left of minUs
+    void wait(uint32_t clocks, uint32_t minUs);
+
+    void setTrst(TrstMode mode);
+
+    TapState getState() const { return state; }
+    uint64_t getCycles() const { return cycles; }
+    void resetCycles() { cycles = 0; }
+
+    void delayUs(uint32_t us) { bus.delayUs(us); }
+
+    static TapState nextState(TapState from, bool tms);
+    static bool isStable(TapState s);
+
+    // (got ^ expected) & mask over bits, mask nullptr compares every bit
+    static bool matches(const uint32_t* got, const uint32_t* expected, const uint32_t* mask, size_t bits);
+
+private:
+    IGpioBus& bus;
+    TapState state = TapState::Reset;
+    uint64_t cycles = 0;
+    uint32_t halfPeriodUs = 0;
+
+    uint8_t tdoPin = 0;
+    int trstPin = -1;
+    uint64_t tckMask = 0;
+    uint64_t tmsMask = 0;
+    uint64_t tdiMask = 0;
+    uint64_t trstMask = 0;
+    uint64_t outputs = 0;
+
+    inline uint64_t tick(uint64_t high, uint64_t low);
+    void tmsBit(bool tms);
+};
@@ -0,0 +1,359 @@
+#include "LogicCaptureService.h"
+#include <algorithm>
+#include <esp_heap_caps.h>
+#include <soc/gpio_reg.h>
+
+// Arduino loop() runs on core 1, the sampler owns core 0 while a capture is armed
+static constexpr BaseType_t SAMPLER_CORE = 0;
+
+LogicCaptureService::~LogicCaptureService() {
+    release();
+    if (frameRelease && !running.load()) vSemaphoreDelete(frameRelease);
+}
+
+bool LogicCaptureService::configure(const std::vector<uint8_t>& newPins, uint32_t sampleRateHz) {
+    if (running.load()) return false;
+    if (newPins.empty() || newPins.size() > MAX_CHANNELS) return false;
+
+    pins = newPins;
+    channelCount = pins.size();
+    useHighBank = false;
+    for (uint8_t i = 0; i < channelCount; ++i) {
+        // GPIO_IN_REG holds GPIO 0..31, GPIO_IN1_REG the remaining ones
+        pinHighBank[i] = pins[i] >= 32;
+        pinBit[i] = pins[i] & 31;
+        if (pinHighBank[i]) useHighBank = true;
+    }
+
+    setSampleRate(sampleRateHz);
+    setTrigger(LogicTriggerEnum::None);
+    return true;
+}
+
+void LogicCaptureService::setSampleRate(uint32_t sampleRateHz) {
+    if (sampleRateHz < MIN_SAMPLE_RATE) sampleRateHz = MIN_SAMPLE_RATE;
+    if (sampleRateHz > MAX_SAMPLE_RATE) sampleRateHz = MAX_SAMPLE_RATE;
+    sampleRate = sampleRateHz;
+}
+
+void LogicCaptureService::setTrigger(LogicTriggerEnum type, uint8_t channel, uint8_t mask, uint8_t value) {
+    triggerType = type;
+    if (type == LogicTriggerEnum::Pattern) {
+        triggerMask = mask;
+        triggerValue = value & mask;
+    } else {
+        triggerMask = channel < MAX_CHANNELS ? (1u << channel) : 0;
+        triggerValue = 0;
+    }
+}
+
+/*
+Capture
+*/
+bool LogicCaptureService::start(uint32_t preTriggerSamples, uint32_t postTriggerSamples) {
+    return arm(preTriggerSamples, postTriggerSamples, false);
+}
+
+bool LogicCaptureService::startFreeRunning(uint32_t frameSamples) {
+    setTrigger(LogicTriggerEnum::None);
+    return arm(0, frameSamples, true);
+}
+
+bool LogicCaptureService::arm(uint32_t preTriggerSamples, uint32_t postTriggerSamples, bool continuous) {
+    if (running.load() || channelCount == 0) return false;
+    if (!allocate()) return false;
+    if (!frameRelease && !(frameRelease = xSemaphoreCreateBinary())) return false;
+    xSemaphoreTake(frameRelease, 0);    // drop a release left over from the last run
+
+    preTrigger = preTriggerSamples;
+    postTrigger = postTriggerSamples ? postTriggerSamples : 1;
+    freeRunning = continuous;
+    resetFrame();
+    frameReady.store(false);
+    stopRequested.store(false);
+    running.store(true);
+
+    if (xTaskCreatePinnedToCore(samplerTask, "LogicSampler", 4096, this, 1, &samplerHandle, SAMPLER_CORE) != pdPASS) {
+        samplerHandle = nullptr;
+        running.store(false);
+        return false;
+    }
+    return true;
+}
+
+void LogicCaptureService::resetFrame() {
+    entryHead = 0;
+    entryCount = 0;
+    sampleCount = 0;
+    triggerSample = 0;
+    truncated = false;
+    overruns = 0;
+    missedSamples = 0;
+    triggered.store(false);
+}
+
+bool LogicCaptureService::isFrameReady() const {
+    return frameReady.load();
+}
+
+void LogicCaptureService::nextFrame() {
+    if (!frameReady.load()) return;
+    frameReady.store(false);
+    xSemaphoreGive(frameRelease);
+}
+
+bool LogicCaptureService::bufferBusy() const {
+    return running.load() && !frameReady.load();
+}
+
+bool LogicCaptureService::stop() {
+    if (!running.load()) return true;
+    stopRequested.store(true);
+    xSemaphoreGive(frameRelease);       // wakes a free running sampler holding a frame
+
+    // The sampler checks the flag every sample, running is the last thing it writes
+    TickType_t start = xTaskGetTickCount();
+    while (running.load()) {
+        if (xTaskGetTickCount() - start > pdMS_TO_TICKS(STOP_TIMEOUT_MS)) return false;
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return true;
+}
+
+void LogicCaptureService::release() {
+    // Never free the ring under a sampler that is still writing to it
+    if (!stop()) return;
+    if (entries) {
+        heap_caps_free(entries);
+        entries = nullptr;
+    }
+    entryCapacity = 0;
+    entryHead = 0;
+    entryCount = 0;
+    sampleCount = 0;
+}
+
+bool LogicCaptureService::allocate() {
+    if (entries) return true;
+
+    // Deep ring in PSRAM when the board has it, short one in internal RAM otherwise
+    entries = (uint32_t*) heap_caps_malloc(PSRAM_ENTRIES * sizeof(uint32_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (entries) {
+        entryCapacity = PSRAM_ENTRIES;
+        return true;
+    }
+
+    entries = (uint32_t*) heap_caps_malloc(INTERNAL_ENTRIES * sizeof(uint32_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (entries) {
+        entryCapacity = INTERNAL_ENTRIES;
+        return true;
+    }
+
+    entryCapacity = 0;
+    return false;
+}
+
+void LogicCaptureService::samplerTask(void* arg) {
+    auto* self = static_cast<LogicCaptureService*>(arg);
+
+    // The sampler spins between samples, keep the idle watchdog quiet meanwhile
+    disableCore0WDT();
+    while (true) {
+        self->runCapture();
+        if (!self->freeRunning || self->stopRequested.load()) break;
+
+        // Hold the frame until it has been read, blocked so the watchdog can come back
+        self->frameReady.store(true);
+        enableCore0WDT();
+        xSemaphoreTake(self->frameRelease, portMAX_DELAY);
+        disableCore0WDT();
+        if (self->stopRequested.load()) break;
+        self->resetFrame();
+    }
+    enableCore0WDT();
+
+    self->frameReady.store(false);
+    self->samplerHandle = nullptr;
+    self->running.store(false);
+    vTaskDelete(nullptr);
+}
+
+inline uint8_t LogicCaptureService::readSample() const {
+    uint32_t low = REG_READ(GPIO_IN_REG);
+    uint32_t high = useHighBank ? REG_READ(GPIO_IN1_REG) : 0;
+
+    uint8_t sample = 0;
+    for (uint8_t i = 0; i < channelCount; ++i) {
+        uint32_t bank = pinHighBank[i] ? high : low;
+        sample |= ((bank >> pinBit[i]) & 1u) << i;
+    }
+    return sample;
+}
+
+bool LogicCaptureService::triggerHit(uint8_t prev, uint8_t sample) const {
+    switch (triggerType) {
+        case LogicTriggerEnum::Rising:  return !(prev & triggerMask) && (sample & triggerMask);
+        case LogicTriggerEnum::Falling: return (prev & triggerMask) && !(sample & triggerMask);
+        case LogicTriggerEnum::Edge:    return (prev ^ sample) & triggerMask;
+        case LogicTriggerEnum::Pattern: return (sample & triggerMask) == triggerValue;
+        default:                        return true;
+    }
+}
+
+void LogicCaptureService::runCapture() {
+    // Samples are paced on the CPU cycle counter against an absolute deadline, so no drift
+    const uint32_t period = (getCpuFrequencyMhz() * 1000000UL) / sampleRate;
+    const uint32_t lateLimit = period * 8;
+
+    uint32_t committed = 0;     // samples held in the ring
+    uint32_t postLeft = postTrigger;
+    uint8_t prev = readSample();
+    uint8_t runValue = prev;
+    uint32_t runLength = 0;
+    bool full = false;
+
+    if (triggerType == LogicTriggerEnum::None) triggered.store(true);
+
+    auto commit = [&]() -> bool {
+        if (entryCount == entryCapacity) {
+            if (triggered.load(std::memory_order_relaxed)) {
+                truncated = true;
+                return false;
+            }
+            committed -= entryRun(entries[entryHead]);
+            entryHead = (entryHead + 1) % entryCapacity;
+            entryCount--;
+        }
+
+        entries[(entryHead + entryCount) % entryCapacity] = makeEntry(runValue, runLength);
+        entryCount++;
+        committed += runLength;
+
+        // While armed, only keep what the pre-trigger depth needs
+        if (!triggered.load(std::memory_order_relaxed)) {
+            while (entryCount > 0 && committed - entryRun(entries[entryHead]) >= preTrigger) {
+                committed -= entryRun(entries[entryHead]);
+                entryHead = (entryHead + 1) % entryCapacity;
+                entryCount--;
+            }
+        }
+        return true;
+    };
+
+    // Extend the current run over sample slots that were never read
+    auto hold = [&](uint32_t n) -> bool {
+        if (triggered.load(std::memory_order_relaxed)) {
+            if (n >= postLeft) n = postLeft - 1;    // the sample about to be read ends the capture
+            postLeft -= n;
+        }
+        while (n) {
+            if (runLength == MAX_RUN) {
+                if (!commit()) return false;
+                runLength = 0;
+            }
+            uint32_t take = std::min(n, MAX_RUN - runLength);
+            runLength += take;
+            n -= take;
+        }
+        return true;
+    };
+
+    uint32_t next = ESP.getCycleCount();
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        uint32_t now;
+        while ((int32_t)((now = ESP.getCycleCount()) - next) < 0) {}
+
+        // Preempted by a higher priority task, skip the missed slots instead of bursting
+        // samples, but keep them in the trace so later timestamps don't shift
+        if (now - next > lateLimit) {
+            uint32_t missed = (now - next) / period;
+            overruns++;
+            missedSamples += missed;
+            next += missed * period;
+            if (!hold(missed)) {
+                full = true;
+                break;
+            }
+        }
+        next += period;
+
+        uint8_t sample = readSample();
+        if (!triggered.load(std::memory_order_relaxed) && triggerHit(prev, sample)) {
+            triggerSample = committed + runLength;
+            triggered.store(true);
+        }
+        prev = sample;
+
+        if (sample != runValue || runLength == MAX_RUN) {
+            if (runLength && !commit()) {
+                full = true;
+                break;
+            }
+            runValue = sample;
+            runLength = 0;
+        }
+        runLength++;
+
+        if (triggered.load(std::memory_order_relaxed) && --postLeft == 0) break;
+    }
+
+    if (!full && runLength) commit();
+    sampleCount = committed;
+}
+
+/*
+Capture buffer
+*/
+size_t LogicCaptureService::readSamples(uint32_t start, uint32_t count, std::vector<uint8_t>& out) const {
+    out.clear();
+    if (bufferBusy() || !entries || count == 0) return 0;
+    out.reserve(count);
+
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < entryCount && out.size() < count; ++i) {
+        uint32_t e = entries[(entryHead + i) % entryCapacity];
+        uint32_t run = entryRun(e);
+        if (pos + run > start) {
+            uint32_t from = start > pos ? start - pos : 0;
+            for (uint32_t r = from; r < run && out.size() < count; ++r) {
+                out.push_back(entryValue(e));
+            }
+        }
+        pos += run;
+    }
+    return out.size();
+}
+
+size_t LogicCaptureService::readChannel(uint8_t channel, uint32_t start, uint32_t count, std::vector<uint8_t>& out, uint32_t every) const {
+    out.clear();
+    if (bufferBusy() || !entries || count == 0 || channel >= channelCount) return 0;
+    if (every == 0) every = 1;
+    out.reserve(count);
+
+    uint32_t pos = 0;
+    uint32_t target = start;
+    for (uint32_t i = 0; i < entryCount && out.size() < count; ++i) {
+        uint32_t e = entries[(entryHead + i) % entryCapacity];
+        uint32_t end = pos + entryRun(e);
+        uint8_t bit = (entryValue(e) >> channel) & 1u;
+        while (target < end && out.size() < count) {
+            out.push_back(bit);
+            target += every;
+        }
+        pos = end;
+    }
+    return out.size();
+}
+
+bool LogicCaptureService::isRunning() const { return running.load(); }
+bool LogicCaptureService::isTriggered() const { return triggered.load(); }
+bool LogicCaptureService::isTruncated() const { return truncated; }
+uint32_t LogicCaptureService::getOverruns() const { return overruns; }
+uint32_t LogicCaptureService::getMissedSamples() const { return missedSamples; }
+uint32_t LogicCaptureService::getSampleCount() const { return sampleCount; }
+uint32_t LogicCaptureService::getTriggerSample() const { return triggerSample; }
+uint32_t LogicCaptureService::getSampleRate() const { return sampleRate; }
+uint32_t LogicCaptureService::getCapacity() const { return entryCapacity; }
+uint8_t LogicCaptureService::getChannelCount() const { return channelCount; }
+const std::vector<uint8_t>& LogicCaptureService::getPins() const { return pins; }
+LogicTriggerEnum LogicCaptureService::getTriggerType() const { return triggerType; }
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/semphr.h"
+#include <atomic>
+#include <vector>
+#include "Enums/LogicTriggerEnum.h"
+
+class LogicCaptureService {
+public:
+    static constexpr uint8_t MAX_CHANNELS = 8;
+    static constexpr uint32_t MAX_SAMPLE_RATE = 1000000;   // 1 MHz
+    static constexpr uint32_t MIN_SAMPLE_RATE = 10;
+
+    ~LogicCaptureService();
+
+    // Channel setup, bit i of a sample is pins[i]
+    bool configure(const std::vector<uint8_t>& pins, uint32_t sampleRateHz);
+    void setSampleRate(uint32_t sampleRateHz);
+    void setTrigger(LogicTriggerEnum type, uint8_t channel = 0, uint8_t mask = 0, uint8_t value = 0);
+
+    // Arm a capture, returns false if the buffer or the sampler task can't be created
+    bool start(uint32_t preTriggerSamples, uint32_t postTriggerSamples);
+
+    // Free running, one sampler task captures frame after frame. Each frame is held
+    // until nextFrame(), the buffer can be read while isFrameReady() is true.
+    bool startFreeRunning(uint32_t frameSamples);
+    bool isFrameReady() const;
+    void nextFrame();
+
+    // False if the sampler task did not exit, the buffer is then left alone
+    bool stop();
+    void release();
+
+    bool isRunning() const;
+    bool isTriggered() const;
+    bool isTruncated() const;
+
+    // Times the sampler was preempted past its deadline, and the sample slots it missed.
+    // Missed slots hold the last value so the trace stays on the sample grid.
+    uint32_t getOverruns() const;
+    uint32_t getMissedSamples() const;
+
+    // Capture buffer access, valid once the capture is no longer running
+    uint32_t getSampleCount() const;
+    uint32_t getTriggerSample() const;
+    uint32_t getSampleRate() const;
+    uint32_t getCapacity() const;
+    uint8_t getChannelCount() const;
+    const std::vector<uint8_t>& getPins() const;
+    LogicTriggerEnum getTriggerType() const;
+
+    // Expand packed samples [start, start + count) from the RLE buffer
+    size_t readSamples(uint32_t start, uint32_t count, std::vector<uint8_t>& out) const;
+
+    // Expand one channel as 0/1 values, decimated by 'every' samples
+    size_t readChannel(uint8_t channel, uint32_t start, uint32_t count, std::vector<uint8_t>& out, uint32_t every = 1) const;
+
+    // Visit every run in order, used by exporters
+    template <typename Fn>
+    void forEachRun(Fn&& fn) const {
+        for (uint32_t i = 0; i < entryCount; ++i) {
+            uint32_t e = entries[(entryHead + i) % entryCapacity];
+            if (!fn(entryValue(e), entryRun(e))) return;
+        }
+    }
+
+private:
+    // RLE entry: sample in the high 8 bits, run length in the low 24 bits
+    static constexpr uint32_t MAX_RUN = 0x00FFFFFF;
+    static constexpr size_t PSRAM_ENTRIES = 256 * 1024;
+    static constexpr size_t INTERNAL_ENTRIES = 8 * 1024;
+    static constexpr uint32_t STOP_TIMEOUT_MS = 1000;
+
+    static inline uint32_t makeEntry(uint8_t value, uint32_t run) { return ((uint32_t)value << 24) | run; }
+    static inline uint8_t entryValue(uint32_t e) { return e >> 24; }
+    static inline uint32_t entryRun(uint32_t e) { return e & MAX_RUN; }
+
+    static void samplerTask(void* arg);
+    bool arm(uint32_t preTriggerSamples, uint32_t postTriggerSamples, bool continuous);
+    void resetFrame();
+    bool bufferBusy() const;
+    void runCapture();
+    bool allocate();
+    inline uint8_t readSample() const;
+    bool triggerHit(uint8_t prev, uint8_t sample) const;
+
+    // Channels
+    std::vector<uint8_t> pins;
+    uint8_t pinBit[MAX_CHANNELS] = {0};
+    bool pinHighBank[MAX_CHANNELS] = {false};
+    bool useHighBank = false;
+    uint8_t channelCount = 0;
+    uint32_t sampleRate = 1000;
+
+    // Trigger
+    LogicTriggerEnum triggerType = LogicTriggerEnum::None;
+    uint8_t triggerMask = 0;
+    uint8_t triggerValue = 0;
+    uint32_t preTrigger = 0;
+    uint32_t postTrigger = 0;
+
+    // RLE ring
+    uint32_t* entries = nullptr;
+    uint32_t entryCapacity = 0;
+    uint32_t entryHead = 0;
+    uint32_t entryCount = 0;
+    uint32_t sampleCount = 0;
+    uint32_t triggerSample = 0;
+    bool truncated = false;
+    uint32_t overruns = 0;
+    uint32_t missedSamples = 0;
+
+    // Sampler task
+    TaskHandle_t samplerHandle = nullptr;
+    std::atomic<bool> running{false};
+    std::atomic<bool> triggered{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> frameReady{false};
+    bool freeRunning = false;
+    SemaphoreHandle_t frameRelease = nullptr;   // given by nextFrame() and stop()
+};
@@ -0,0 +1,308 @@
+#include "NmapScanEngine.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <deque>
+#include <sys/ioctl.h>
+
+#ifdef ARDUINO
+#include "lwip/inet.h"
+#else
+#include <arpa/inet.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+NmapScanEngine::NmapScanEngine() : NmapScanEngine(Config()) {}
+
+NmapScanEngine::NmapScanEngine(const Config& config) : config(config) {
+    if (this->config.window == 0) this->config.window = 1;
+    if (this->config.perHostWindow == 0) this->config.perHostWindow = 1;
+}
+
+uint64_t NmapScanEngine::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::vector<NmapScanEngine::Result> NmapScanEngine::scan(const std::vector<in_addr>& hosts,
+                                                         const std::vector<uint16_t>& ports,
+                                                         Layer4Protocol protocol,
+                                                         const std::function<bool()>& shouldStop) {
+    std::vector<Result> results;
+    results.reserve(hosts.size() * ports.size());
+    rtt.assign(hosts.size(), RttEstimator());
+
+    // Interleave hosts so a slow one never holds the whole window
+    std::deque<Probe> queue;
+    for (uint16_t port : ports) {
+        for (size_t h = 0; h < hosts.size(); ++h) {
+            queue.push_back(Probe{ h, port, 0, -1, 0, 0 });
+        }
+    }
+
+    const bool tcp = protocol == Layer4Protocol::TCP;
+    std::vector<size_t> hostInFlight(hosts.size(), 0);
+    std::vector<Probe> inFlight;
+    inFlight.reserve(config.window);
+
+    while (!queue.empty() || !inFlight.empty()) {
+        if (shouldStop && shouldStop()) break;
+
+        // Fill the window
+        for (size_t tries = queue.size(); tries > 0 && inFlight.size() < config.window; --tries) {
+            Probe probe = queue.front();
+            queue.pop_front();
+
+            if (hostInFlight[probe.host] >= config.perHostWindow) {
+                queue.push_back(probe);
+                continue;
+            }
+
+            int state = nmap_rc_enum::OTHER;
+            LaunchResult launched = launch(probe, hosts[probe.host], protocol, state);
+            if (launched == LaunchResult::InFlight) {
+                inFlight.push_back(probe);
+                hostInFlight[probe.host]++;
+            } else if (launched == LaunchResult::Done) {
+                results.push_back(Result{ probe.host, probe.port, state, 0 });
+            } else {
+                // Out of sockets, wait for one to free up unless nothing is running
+                if (inFlight.empty()) {
+                    results.push_back(Result{ probe.host, probe.port, nmap_rc_enum::OTHER, 0 });
+                } else {
+                    queue.push_front(probe);
+                }
+                break;
+            }
+        }
+
+        if (inFlight.empty()) continue;
+
+        // Wait for the first answer or the earliest deadline
+        fd_set rfds, wfds, efds;
+        FD_ZERO(&rfds); FD_ZERO(&wfds); FD_ZERO(&efds);
+        int maxFd = -1;
+        uint64_t earliest = inFlight.front().deadlineUs;
+        for (const auto& p : inFlight) {
+            if (tcp) { FD_SET(p.fd, &wfds); FD_SET(p.fd, &efds); }
+            else     { FD_SET(p.fd, &rfds); }
+            maxFd = std::max(maxFd, p.fd);
+            earliest = std::min(earliest, p.deadlineUs);
+        }
+
+        uint64_t now = nowUs();
+        uint64_t waitUs = earliest > now ? earliest - now : 0;
+        timeval tv{};
+        tv.tv_sec = waitUs / 1000000;
+        tv.tv_usec = waitUs % 1000000;
+
+        int rc = ::select(maxFd + 1, tcp ? nullptr : &rfds, tcp ? &wfds : nullptr, &efds, &tv);
+        if (rc < 0 && errno != EINTR) {
+            // Give up on the whole window rather than spin
+            for (auto& p : inFlight) {
+                ::close(p.fd);
+                results.push_back(Result{ p.host, p.port, nmap_rc_enum::OTHER, 0 });
+            }
+            inFlight.clear();
+            std::fill(hostInFlight.begin(), hostInFlight.end(), 0);
+            continue;
+        }
+
+        // Collect answers and expired probes
+        now = nowUs();
+        for (size_t i = 0; i < inFlight.size();) {
+            Probe& p = inFlight[i];
+            int state = PENDING;
+            bool ready = rc > 0 && (tcp ? (FD_ISSET(p.fd, &wfds) || FD_ISSET(p.fd, &efds))
+                                        : (FD_ISSET(p.fd, &rfds) || FD_ISSET(p.fd, &efds)));
+            uint32_t rttUs = 0;
+
+            if (ready) {
+                state = tcp ? finishTcp(p.fd) : finishUdp(p.fd);
+                if (state != PENDING) {
+                    rttUs = now - p.startUs;
+                    // RST and UDP replies are real round trips too
+                    if (state == TCP_OPEN || state == TCP_CLOSED || state == UDP_OPEN || state == UDP_CLOSED) {
+                        addSample(p.host, rttUs);
+                    }
+                }
+            } else if (now >= p.deadlineUs) {
+                if (p.attempt < config.maxRetries) {
+                    p.attempt++;
+                    if (tcp) {
+                        // New connect with the timeout learned so far
+                        ::close(p.fd);
+                        p.fd = -1;
+                        queue.push_front(p);
+                        hostInFlight[p.host]--;
+                        inFlight[i] = inFlight.back();
+                        inFlight.pop_back();
+                        continue;
+                    }
+                    if (sendUdpProbe(p.fd)) {
+                        p.startUs = now;
+                        p.deadlineUs = now + timeoutUs(p.host);
+                    } else {
+                        state = nmap_rc_enum::UDP_OPEN_FILTERED;
+                    }
+                } else {
+                    state = tcp ? nmap_rc_enum::TCP_FILTERED : nmap_rc_enum::UDP_OPEN_FILTERED;
+                }
+            }
+
+            if (state == PENDING) {
+                ++i;
+                continue;
+            }
+
+            ::close(p.fd);
+            results.push_back(Result{ p.host, p.port, state, rttUs });
+            hostInFlight[p.host]--;
+            inFlight[i] = inFlight.back();
+            inFlight.pop_back();
+        }
+    }
+
+    // Stopped early
+    for (auto& p : inFlight) ::close(p.fd);
+    return results;
+}
+
+NmapScanEngine::LaunchResult NmapScanEngine::launch(Probe& probe, const in_addr& addr, Layer4Protocol protocol, int& state) {
+    const bool tcp = protocol == Layer4Protocol::TCP;
+    int s = ::socket(AF_INET, tcp ? SOCK_STREAM : SOCK_DGRAM, tcp ? IPPROTO_TCP : IPPROTO_UDP);
+    if (s < 0) return LaunchResult::NoSocket;
+
+    int nb = 1;
+    if (ioctl(s, FIONBIO, &nb) < 0) {
+        ::close(s);
+        state = nmap_rc_enum::OTHER;
+        return LaunchResult::Done;
+    }
+
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(probe.port);
+    sa.sin_addr = addr;
+
+    probe.fd = s;
+    probe.startUs = nowUs();
+    probe.deadlineUs = probe.startUs + timeoutUs(probe.host);
+
+    int rc = ::connect(s, (sockaddr*)&sa, sizeof(sa));
+    if (tcp) {
+        if (rc == 0) {
+            ::close(s);
+            state = nmap_rc_enum::TCP_OPEN;
+            return LaunchResult::Done;
+        }
+        if (errno == EINPROGRESS || errno == EALREADY) return LaunchResult::InFlight;
+
+        int e = errno;
+        ::close(s);
+        if (e == ECONNREFUSED || e == ECONNRESET) state = nmap_rc_enum::TCP_CLOSED;
+        else if (e == ETIMEDOUT || e == EHOSTUNREACH || e == ENETUNREACH || e == EACCES || e == EPERM)
+            state = nmap_rc_enum::TCP_FILTERED;
+        else state = nmap_rc_enum::OTHER;
+        return LaunchResult::Done;
+    }
+
+    // UDP, connected socket so ICMP unreachable comes back as ECONNREFUSED
+    if (rc < 0 || !sendUdpProbe(s)) {
+        int e = errno;
+        ::close(s);
+        state = (e == EHOSTUNREACH || e == ENETUNREACH) ? nmap_rc_enum::UDP_OPEN_FILTERED : nmap_rc_enum::OTHER;
+        return LaunchResult::Done;
+    }
+    return LaunchResult::InFlight;
+}
+
+bool NmapScanEngine::sendUdpProbe(int fd) {
+    static const char kProbe[] = "PING\n";
+    return ::send(fd, kProbe, sizeof(kProbe) - 1, 0) >= 0;
+}
+
+int NmapScanEngine::finishTcp(int fd) {
+    int soerr = 0;
+    socklen_t len = sizeof(soerr);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &soerr, &len) < 0) return nmap_rc_enum::OTHER;
+
+    switch (soerr) {
+        case 0:
+            return nmap_rc_enum::TCP_OPEN;
+        case ECONNREFUSED:
+        case ECONNRESET:
+            return nmap_rc_enum::TCP_CLOSED;
+        case ETIMEDOUT:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case EACCES:
+        case EPERM:
+            return nmap_rc_enum::TCP_FILTERED;
+        case EINPROGRESS:
+        case EALREADY:
+            return PENDING;
+        default:
+            return nmap_rc_enum::OTHER;
+    }
+}
+
+int NmapScanEngine::finishUdp(int fd) {
+    uint8_t buf[64];
+    ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n >= 0) return nmap_rc_enum::UDP_OPEN;
+
+    switch (errno) {
+        case ECONNREFUSED:                  // ICMP port unreachable
+            return nmap_rc_enum::UDP_CLOSED;
+        case EMSGSIZE:                      // Datagram larger than the buffer
+            return nmap_rc_enum::UDP_OPEN;
+        case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+            return PENDING;
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+            return nmap_rc_enum::UDP_OPEN_FILTERED;
+        default:
+            return nmap_rc_enum::OTHER;
+    }
+}
+
+void NmapScanEngine::addSample(size_t host, uint64_t sampleUs) {
+    if (host >= rtt.size()) return;
+    RttEstimator& e = rtt[host];
+    uint32_t r = sampleUs > UINT32_MAX ? UINT32_MAX : (uint32_t)sampleUs;
+
+    if (!e.hasSample) {
+        e.srttUs = r;
+        e.rttvarUs = r / 2;
+        e.hasSample = true;
+        return;
+    }
+
+    uint32_t delta = e.srttUs > r ? e.srttUs - r : r - e.srttUs;
+    e.rttvarUs = (3 * (uint64_t)e.rttvarUs + delta) / 4;
+    e.srttUs = (7 * (uint64_t)e.srttUs + r) / 8;
+}
+
+uint64_t NmapScanEngine::timeoutUs(size_t host) const {
+    uint64_t t = (uint64_t)config.initialTimeoutMs * 1000;
+    if (host < rtt.size() && rtt[host].hasSample) {
+        t = rtt[host].srttUs + 4ULL * rtt[host].rttvarUs;
+    }
+    t = std::max<uint64_t>(t, (uint64_t)config.minTimeoutMs * 1000);
+    t = std::min<uint64_t>(t, (uint64_t)config.maxTimeoutMs * 1000);
+    return t;
+}
+
+uint32_t NmapScanEngine::getTimeoutMs(size_t host) const {
+    return timeoutUs(host) / 1000;
+}
+
+uint32_t NmapScanEngine::getSmoothedRttUs(size_t host) const {
+    return host < rtt.size() ? rtt[host].srttUs : 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+#include "Data/NmapUtils.h"
+
+#ifdef ARDUINO
+#include "lwip/sockets.h"
+#else
+#include <netinet/in.h>
+#endif
+
+// Keeps a window of non-blocking TCP connects / UDP probes in flight across
+// all hosts and multiplexes them with select(). Per host timeouts follow the
+// measured RTTs (RFC 6298 style), plain BSD sockets only.
+class NmapScanEngine {
+public:
+    struct Config {
+        size_t window = 8;                          // probes in flight, lwIP has 16 sockets in total
+        size_t perHostWindow = 8;                   // probes in flight for a single host
+        uint32_t initialTimeoutMs = CONNECT_TIMEOUT_MS;
+        uint32_t minTimeoutMs = 100;
+        uint32_t maxTimeoutMs = 2000;
+        uint8_t maxRetries = 1;                     // extra attempts before a silent port is reported
+    };
+
+    struct Result {
+        size_t host;        // index in the hosts vector
+        uint16_t port;
+        int state;          // nmap_rc_enum
+        uint32_t rttUs;     // 0 when no answer
+    };
+
+    NmapScanEngine();
+    explicit NmapScanEngine(const Config& config);
+
+    // Scan every (host, port) pair, results come back in completion order
+    std::vector<Result> scan(const std::vector<in_addr>& hosts,
+                             const std::vector<uint16_t>& ports,
+                             Layer4Protocol protocol,
+                             const std::function<bool()>& shouldStop = nullptr);
+
+    uint32_t getTimeoutMs(size_t host) const;
+    uint32_t getSmoothedRttUs(size_t host) const;
+
+private:
+    static constexpr int PENDING = -100;
+
+    enum class LaunchResult { InFlight, Done, NoSocket };
+
+    struct RttEstimator {
+        bool hasSample = false;
+        uint32_t srttUs = 0;
+        uint32_t rttvarUs = 0;
+    };
+
+    struct Probe {
+        size_t host;
+        uint16_t port;
+        uint8_t attempt;
+        int fd;
+        uint64_t startUs;
+        uint64_t deadlineUs;
+    };
+
+    LaunchResult launch(Probe& probe, const in_addr& addr, Layer4Protocol protocol, int& state);
+    bool sendUdpProbe(int fd);
+    int finishTcp(int fd);
+    int finishUdp(int fd);
+    void addSample(size_t host, uint64_t rttUs);
+    uint64_t timeoutUs(size_t host) const;
+    static uint64_t nowUs();
+
+    Config config;
+    std::vector<RttEstimator> rtt;
+};
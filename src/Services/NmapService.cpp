@@ -8,6 +8,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <unordered_set>
+#include <algorithm>
+#include <cstdint>
 
 extern "C" {
 #include <getopt.h>   // provides getopt_long
@@ -44,6 +46,7 @@ std::string NmapService::getHelpText() {
     "  -sU             UDP scan\r\n"
     "  -sn             Ping scan (disable port scan)\r\n"
     "  -v / -vv        Verbosity\r\n"
+    "  --min-parallelism <n>  Probes in flight (1-12, default 8)\r\n"
     "\r\n"
     "Examples:\r\n"
     "  nmap 192.168.1.10 -p 22,80-90 -sT -vv\r\n"
@@ -73,6 +76,7 @@ NmapOptions NmapService::parseNmapArgs(const std::vector<std::string>& tokens) {
         {"help",  no_argument,       nullptr, 'h'},
         {"ports", required_argument, nullptr, 'p'},
         {"scan",  required_argument, nullptr, 's'}, // e.g. -sT / -sU
+        {"min-parallelism", required_argument, nullptr, 'P'},
         {nullptr, 0,                 nullptr,  0 }
     };
 
@@ -97,6 +101,12 @@ NmapOptions NmapService::parseNmapArgs(const std::vector<std::string>& tokens) {
                     else nmapOptions.hasTrash = true; // unknown letter after -s
                 }
                 break;
+            case 'P': {
+                int n = optarg ? atoi(optarg) : 0;
+                if (n <= 0) nmapOptions.hasTrash = true;
+                else nmapOptions.minParallelism = n;
+                break;
+            }
             case 'v':
                 // If using double verbosity, it will add
                 ++nmapOptions.verbosity;
@@ -125,165 +135,6 @@ const std::string NmapService::getReport() {
     return this->report;
 }
 
-static int udp_probe_with_timeout(in_addr addr, uint16_t port, int timeout_ms,
-                                  const void* payload, size_t payload_len, int retries = 2)
-{
-    int s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (s < 0) return nmap_rc_enum::OTHER;
-
-    int rcvbuf = 4096;
-    (void)setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
-
-    sockaddr_in sa{
-        .sin_family = AF_INET,
-        .sin_port   = htons(port),
-        .sin_addr   = addr 
-    };
-
-    if (::connect(s, (sockaddr*)&sa, sizeof(sa)) < 0) {
-        int e = errno;
-        ::close(s);
-        if (e == EHOSTUNREACH || e == ENETUNREACH) 
-            return nmap_rc_enum::UDP_OPEN_FILTERED;
-        return nmap_rc_enum::OTHER;
-    }
-
-    timeval tv{
-        .tv_sec = timeout_ms / 1000,
-        .tv_usec = (timeout_ms % 1000) * 1000
-    };
-    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-
-    // Probe message
-    static const char kProbe[] = "PING\n";
-    const void* buf   = (payload && payload_len) ? payload : kProbe;
-    size_t      blen  = (payload && payload_len) ? payload_len : (sizeof(kProbe)-1);
-
-    uint8_t rbuf[512];
-
-    for (int attempt = 0; attempt <= retries; ++attempt) {
-        if (::send(s, buf, blen, 0) < 0) {
-            int e = errno; ::close(s);
-            if (e == EHOSTUNREACH || e == ENETUNREACH)
-                return nmap_rc_enum::UDP_OPEN_FILTERED;
-            return nmap_rc_enum::OTHER;
-        }
-
-        ssize_t n = ::recvfrom(s, rbuf, sizeof(rbuf), MSG_TRUNC, nullptr, nullptr);
-        if (n >= 0) {
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN;
-        }
-
-        int e = errno;
-        if (e == ECONNREFUSED) {           // ICMP Unreachable
-            ::close(s);
-            return nmap_rc_enum::UDP_CLOSED;
-        }
-        if (e == EMSGSIZE) {               // Datagram larger buffer
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN;
-        }
-        if (e == EAGAIN || e == EWOULDBLOCK) {
-            vTaskDelay(pdMS_TO_TICKS(10));
-            continue;                      // Retry
-        }
-        if (e == EHOSTUNREACH || e == ENETUNREACH) {
-            ::close(s);
-            return nmap_rc_enum::UDP_OPEN_FILTERED;
-        }
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    ::close(s);
-    return nmap_rc_enum::UDP_OPEN_FILTERED;
-}
-
-static int tcp_connect_with_timeout(in_addr addr, uint16_t port, int timeout_ms)
-{
-    int s = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (s < 0) 
-        return nmap_rc_enum::OTHER;
-
-    // Make socket non-blocking to avoid blocking the thread
-    int nb = 1;
-    if (ioctl(s, FIONBIO, &nb) < 0) {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    // Setup the sockaddr_in structure
-    sockaddr_in sa{
-        .sin_family = AF_INET,
-        .sin_port   = htons(port),
-        .sin_addr   = addr
-    };
-
-    int rc = ::connect(s, (sockaddr*)&sa, sizeof(sa));
-    if (rc == 0) {
-        ::close(s);
-        return nmap_rc_enum::TCP_OPEN;
-    }
-
-    // Check status of connection
-    if (errno != EINPROGRESS && errno != EALREADY) {
-        int e = errno;
-        ::close(s);
-        if (e == ECONNREFUSED || e == ECONNRESET) return nmap_rc_enum::TCP_CLOSED;     // RST
-        if (e == ETIMEDOUT || e == EHOSTUNREACH || e == ENETUNREACH || e == EACCES || e == EPERM)
-            return nmap_rc_enum::TCP_FILTERED;                                         // Silently dropped / blocked
-        return nmap_rc_enum::OTHER;
-    }
-
-    // Wait to write
-    fd_set wfds, efds;
-    FD_ZERO(&wfds); FD_ZERO(&efds);
-    FD_SET(s, &wfds); FD_SET(s, &efds);
-
-    struct timeval tv{
-        .tv_sec  = timeout_ms / 1000,
-        .tv_usec = (timeout_ms % 1000) * 1000
-    };
-
-    rc = ::select(s + 1, nullptr, &wfds, &efds, &tv);
-    if (rc == 0) {                 // handshake never completed -> should be filtered
-        ::close(s);
-        return nmap_rc_enum::TCP_FILTERED;
-    }
-    if (rc < 0)  {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    int soerr = 0;
-    socklen_t len = sizeof(soerr);
-    if (getsockopt(s, SOL_SOCKET, SO_ERROR, &soerr, &len) < 0) {
-        ::close(s);
-        return nmap_rc_enum::OTHER;
-    }
-
-    ::close(s);
-    switch (soerr)
-    {
-    case 0:
-        /* code */
-        return nmap_rc_enum::TCP_OPEN;
-    case ECONNREFUSED:
-    case ECONNRESET:
-        return nmap_rc_enum::TCP_CLOSED;
-    case ETIMEDOUT:
-    case EHOSTUNREACH:
-    case ENETUNREACH: 
-    case EACCES:
-    case EPERM:
-        return nmap_rc_enum::TCP_FILTERED;
-    default:
-        return nmap_rc_enum::OTHER;
-    }
-    return nmap_rc_enum::OTHER;
-}
-
 static bool resolveIPv4(const std::string& host, in_addr& out)
 {
     struct addrinfo hints{};
@@ -328,12 +179,11 @@ static inline void columnString(std::string& dest, const std::string& text, size
     if (text.size() < width) dest.append(width - text.size(), ' ');
 }
 
-void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t> &ports)
+bool NmapService::pingTarget(const std::string &host, in_addr &ip)
 {
-    in_addr ip{};
     if (!resolveIPv4(host, ip)) {
         this->report.append("Failed to resolve host: ").append(host).append("\r\n");
-        return;
+        return false;
     }
 
     char ipStr[INET_ADDRSTRLEN]{};
@@ -347,20 +197,69 @@ void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t
             this->report.append("Host is up (").append(std::to_string(icmpService->lastMedianMs())).append("ms latency).\r\n");
         } else {
             this->report.append("Host is down.\r\n");
-            return;
+            return false;
         }
     } else {
         this->report.append("Error: ICMP service not available.\r\n");
-        return;
+        return false;
     }
 
-    if (this->_options.pingOnly) return;
+    return true;
+}
 
-    auto columnString = [](std::string& dst, const std::string& txt, size_t width){
-        dst += txt;
-        if (txt.size() < width) dst.append(width - txt.size(), ' ');
-    };
+void NmapService::scanTargets(const std::vector<std::string> &hosts, const std::vector<uint16_t> &ports)
+{
+    // Ping every host first, only the ones up are port scanned
+    std::vector<std::string> hostReports(hosts.size());
+    std::vector<size_t> scanIndex(hosts.size(), SIZE_MAX);
+    std::vector<in_addr> scanHosts;
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        this->report.clear();
+        in_addr ip{};
+        if (pingTarget(hosts[i], ip) && !this->_options.pingOnly) {
+            scanIndex[i] = scanHosts.size();
+            scanHosts.push_back(ip);
+        }
+        hostReports[i] = this->report;
+    }
+    this->report.clear();
+
+    // All (host, port) pairs go through one engine so the window spans hosts
+    NmapScanEngine::Config config;
+    if (this->_options.minParallelism > 0) {
+        config.window = std::min<size_t>(this->_options.minParallelism, NMAP_MAX_PARALLELISM);
+        config.perHostWindow = config.window;
+    }
+    if (this->layer4Protocol == Layer4Protocol::UDP) config.maxRetries = 2;
+
+    NmapScanEngine engine(config);
+    std::vector<NmapScanEngine::Result> results;
+    if (!scanHosts.empty() && !ports.empty()) {
+        results = engine.scan(scanHosts, ports, this->layer4Protocol);
+    }
 
+    // Results come back in completion order, report them in port order
+    std::sort(results.begin(), results.end(), [](const NmapScanEngine::Result& a, const NmapScanEngine::Result& b) {
+        return a.host != b.host ? a.host < b.host : a.port < b.port;
+    });
+
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        this->report.append(hostReports[i]);
+        if (scanIndex[i] == SIZE_MAX) continue;
+
+        auto first = std::lower_bound(results.begin(), results.end(), scanIndex[i],
+            [](const NmapScanEngine::Result& r, size_t host) { return r.host < host; });
+        auto last = std::upper_bound(first, results.end(), scanIndex[i],
+            [](size_t host, const NmapScanEngine::Result& r) { return host < r.host; });
+        if (this->verbosity >= 1) {
+            this->report.append("Adaptive timeout: ").append(std::to_string(engine.getTimeoutMs(scanIndex[i]))).append("ms\r\n");
+        }
+        appendPortTable(std::vector<NmapScanEngine::Result>(first, last), ports);
+    }
+}
+
+void NmapService::appendPortTable(const std::vector<NmapScanEngine::Result> &results, const std::vector<uint16_t> &ports)
+{
     size_t portCol = std::string("PORT").size();
     for (uint16_t p : ports) {
         size_t len = std::to_string(p).size() + 4;
@@ -377,60 +276,42 @@ void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t
     report += header;
 
     int closed_ports = ports.size();
-    for (uint16_t p : ports) {
+    for (const auto& result : results) {
         std::string state;
 
-        if (this->layer4Protocol == Layer4Protocol::TCP) {
-            int st = tcp_connect_with_timeout(ip, p, CONNECT_TIMEOUT_MS);
-            switch (st) {
-                case nmap_rc_enum::TCP_OPEN:
-                    state = "open";
-                    closed_ports--;
-                    break;
-                case nmap_rc_enum::TCP_CLOSED:
-                    if (this->verbosity >= 1) 
-                        state = "closed";
-                    break;
-                case nmap_rc_enum::TCP_FILTERED:
-                    state = "filtered";
-                    closed_ports--;
-                    break;
-                default:
-                    if (this->verbosity >= 1)
-                        state = "error";
-                    break;
-            }
-        } else if (this->layer4Protocol == Layer4Protocol::UDP) {
-            int st = udp_probe_with_timeout(ip, p, CONNECT_TIMEOUT_MS, nullptr, 0);
-            switch (st) {
-                case nmap_rc_enum::UDP_OPEN:
-                    state = "open";
-                    closed_ports--;
-                    break;
-                case nmap_rc_enum::UDP_CLOSED:
-                    if (this->verbosity >= 1)
-                        state = "closed";
-                    break;
-                case nmap_rc_enum::UDP_OPEN_FILTERED:
-                    state = "open|filtered";
-                    closed_ports--;
-                    break;
-                default:
-                    if (this->verbosity >= 1) state = "error";
-                    break;
-            }
-        } else {
-            return;
+        switch (result.state) {
+            case nmap_rc_enum::TCP_OPEN:
+            case nmap_rc_enum::UDP_OPEN:
+                state = "open";
+                closed_ports--;
+                break;
+            case nmap_rc_enum::TCP_CLOSED:
+            case nmap_rc_enum::UDP_CLOSED:
+                if (this->verbosity >= 1)
+                    state = "closed";
+                break;
+            case nmap_rc_enum::TCP_FILTERED:
+                state = "filtered";
+                closed_ports--;
+                break;
+            case nmap_rc_enum::UDP_OPEN_FILTERED:
+                state = "open|filtered";
+                closed_ports--;
+                break;
+            default:
+                if (this->verbosity >= 1)
+                    state = "error";
+                break;
         }
 
         if (!state.empty()) {
             std::string row;
-            std::string portField = std::to_string(p) + (layer4Protocol == Layer4Protocol::TCP ? "/tcp" : "/udp");
+            std::string portField = std::to_string(result.port) + (layer4Protocol == Layer4Protocol::TCP ? "/tcp" : "/udp");
             columnString(row, portField, portCol);
             columnString(row, state,     stateCol);
 
             const char* svc = nmap_guess_service(
-                p,
+                result.port,
                 layer4Protocol,
                 (layer4Protocol == Layer4Protocol::TCP) ? TOP100_TCP_MAP : TOP100_UDP_MAP,
                 (layer4Protocol == Layer4Protocol::TCP) ? TOP100_TCP_MAP_COUNT : TOP100_UDP_MAP_COUNT
@@ -439,8 +320,6 @@ void NmapService::scanTarget(const std::string &host, const std::vector<uint16_t
 
             report.append(row).append("\r\n");
         }
-
-        vTaskDelay(pdMS_TO_TICKS(SMALL_DELAY_MS));
     }
 
     if (closed_ports > 0)
@@ -465,13 +344,11 @@ void NmapService::scanTask(void *pvParams)
 {
     auto *params = static_cast<NmapTaskParams *>(pvParams);
     auto &service = *params->service;
-    auto &hosts = params->targetHosts;
-    for (auto host : hosts) {
-        service.scanTarget(host, params->targetPorts);
-    }
+    // Verbosity must be known before the report is built
+    service.verbosity = params->verbosity;
+    service.scanTargets(params->targetHosts, params->targetPorts);
 
     service.ready = true;
-    service.verbosity = params->verbosity;
     delete params;
     vTaskDelete(nullptr);
 }
@@ -5,6 +5,7 @@
 #include "Transformers/ArgTransformer.h"
 #include "Services/ICMPService.h"
 #include "Data/NmapUtils.h"
+#include "Services/NmapScanEngine.h"
 
 class NmapService {
 public:
@@ -29,7 +30,9 @@ private:
     // Nmap Task, cause overflow if it runs in the main loop, so it must run in a dedicated FreeRTOS task with a larger stack
     static void scanTask(void *pvParams);
     bool isIpv4(const std::string& address);
-    void scanTarget(const std::string &host, const std::vector<uint16_t> &ports);
+    bool pingTarget(const std::string &host, in_addr &ip);
+    void scanTargets(const std::vector<std::string> &hosts, const std::vector<uint16_t> &ports);
+    void appendPortTable(const std::vector<NmapScanEngine::Result> &results, const std::vector<uint16_t> &ports);
 
     ICMPService* icmpService;
     std::vector<std::string> targetHosts;
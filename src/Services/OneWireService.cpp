@@ -104,45 +104,44 @@ uint8_t OneWireService::crc8(const uint8_t* data, uint8_t len) {
     return OneWire::crc8(data, len);
 }
 
-std::string OneWireService::executeByteCode(const std::vector<ByteCode>& bytecodes) {
-    std::string result;
+void OneWireService::executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink) {
+    CompiledByteCode program = ByteCodeTransformer::compile(bytecodes);
+    uint8_t buffer[64];
+    if (!oneWire) return;
 
-    for (const auto& code : bytecodes) {
-        switch (code.getCommand()) {
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
             case ByteCodeEnum::Start:
-            case ByteCodeEnum::Stop:
-                reset();
-                break;
-
-            case ByteCodeEnum::Write: {
-                uint8_t byte = static_cast<uint8_t>(code.getData());
-                oneWire->write(byte);
+            case ByteCodeEnum::Stop: {
+                // Presence pulse answers the reset
+                bool presence = reset();
+                sink.onEvent(op.command == ByteCodeEnum::Start ? ResultEventEnum::Start : ResultEventEnum::Stop);
+                sink.onEvent(presence ? ResultEventEnum::Ack : ResultEventEnum::Nack);
                 break;
             }
 
-            case ByteCodeEnum::Read: {
-                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                    uint8_t value = read();
-                    char hex[4];
-                    snprintf(hex, sizeof(hex), "%02X ", value);
-                    result += hex;
-                }
+            case ByteCodeEnum::Write:
+                oneWire->write_bytes(program.getData(op), op.length);
                 break;
-            }
 
-            case ByteCodeEnum::DelayMs:
-                delay(code.getRepeat());
+            case ByteCodeEnum::Read:
+                for (uint32_t done = 0; done < op.length; ) {
+                    uint32_t n = std::min<uint32_t>(sizeof(buffer), op.length - done);
+                    oneWire->read_bytes(buffer, n);
+                    sink.onData(buffer, n);
+                    done += n;
+                }
                 break;
 
             case ByteCodeEnum::DelayUs:
-                delayMicroseconds(code.getRepeat());
+                if (op.length >= 1000) delay(op.length / 1000);
+                delayMicroseconds(op.length % 1000);
                 break;
 
             default:
                 break;
         }
     }
-    return result;
 }
 
 void OneWireService::resetSearch() {
@@ -3,6 +3,8 @@
 #include <OneWire.h>
 #include <vector>
 #include "Models/ByteCode.h"
+#include "Transformers/ByteCodeTransformer.h"
+#include "Interfaces/IResultSink.h"
 #include "OneWireNg_CurrentPlatform.h"
 
 #define DS2431_FAMILY 0x2D
@@ -25,7 +27,7 @@ public:
     uint8_t crc8(const uint8_t* data, uint8_t len);
     void resetSearch();
     bool search(uint8_t* rom);
-    std::string executeByteCode(const std::vector<ByteCode>& bytecodes);
+    void executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink);
 
     // RW1990
     void writeRw1990(uint8_t pin, uint8_t* data, size_t len);
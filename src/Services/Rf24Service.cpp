@@ -25,6 +25,7 @@ bool Rf24Service::configure(
     delay(10);
     spi.begin(sckPin_, misoPin_, mosiPin_, csnPin_);
     
+    spi_ = &spi;
     radio_ = new RF24(cePin_, csnPin_);
     if (!radio_ || !radio_->begin(&spi)) return false;
     isInitialized = true;
@@ -311,4 +312,96 @@ void Rf24Service::initTembedPlus() {
     delay(50);
     digitalWrite(BOARD_PWR_EN, HIGH);
     delay(50);
-}
\ No newline at end of file
+}
+
+/*
+Sweep
+*/
+bool Rf24Service::startSweep(uint16_t listenUs) {
+    if (!isInitialized || !radio_ || !spi_) return false;
+    if (sweepRunning) return true;
+
+    // Receiver with no ACK or CRC, only the RPD bit matters
+    initRx();
+    radio_->startListening();
+    digitalWrite(cePin_, LOW);
+
+    for (uint8_t ch = 0; ch < SWEEP_CHANNELS; ++ch) {
+        channelCommands[ch][0] = W_REGISTER | RF_CH;
+        channelCommands[ch][1] = ch;
+    }
+
+    sweepListenUs = listenUs;
+    sweepCount.store(0);
+    for (auto& h : sweepHits) h.store(0);
+
+    sweepStopRequested = false;
+    sweepRunning = true;
+    if (xTaskCreatePinnedToCore(sweepTask, "Rf24Sweep", 3072, this, 1, &sweepHandle, SWEEP_CORE) != pdPASS) {
+        sweepHandle = nullptr;
+        sweepRunning = false;
+        radio_->stopListening();
+        return false;
+    }
+    return true;
+}
+
+void Rf24Service::stopSweep() {
+    if (!sweepRunning) return;
+    sweepStopRequested = true;
+
+    // The task owns the SPI bus until it clears the flag
+    while (sweepRunning) vTaskDelay(pdMS_TO_TICKS(1));
+
+    radio_->stopListening();
+    radio_->flush_rx();
+}
+
+void Rf24Service::readSweep(SweepTotals& out) const {
+    out.sweeps = sweepCount.load(std::memory_order_acquire);
+    for (uint8_t ch = 0; ch < SWEEP_CHANNELS; ++ch) {
+        out.hits[ch] = sweepHits[ch].load(std::memory_order_relaxed);
+    }
+}
+
+void Rf24Service::sweepTask(void* arg) {
+    auto* self = static_cast<Rf24Service*>(arg);
+
+    // The sweep spins between samples, keep the idle watchdog quiet meanwhile
+    disableCore0WDT();
+    self->runSweep();
+    enableCore0WDT();
+
+    self->sweepHandle = nullptr;
+    self->sweepRunning = false;
+    vTaskDelete(nullptr);
+}
+
+inline void Rf24Service::sweepCommand(const uint8_t* tx, uint8_t* rx, size_t len) {
+    digitalWrite(csnPin_, LOW);
+    spi_->transferBytes(tx, rx, len);
+    digitalWrite(csnPin_, HIGH);
+}
+
+void Rf24Service::runSweep() {
+    static const uint8_t readRpd[2] = { R_REGISTER | RPD, RF24_NOP };
+    uint8_t rx[2];
+
+    // Raw register frames, the library would rewrite CONFIG and flush on every hop
+    while (!sweepStopRequested) {
+        spi_->beginTransaction(SPISettings(spiSpeed_, MSBFIRST, SPI_MODE0));
+        for (uint8_t ch = 0; ch < SWEEP_CHANNELS; ++ch) {
+            sweepCommand(channelCommands[ch], rx, 2);
+
+            digitalWrite(cePin_, HIGH);
+            delayMicroseconds(sweepListenUs);
+            digitalWrite(cePin_, LOW);
+
+            // RPD stays latched in standby until the next RX
+            sweepCommand(readRpd, rx, 2);
+            if (rx[1] & 0x01) sweepHits[ch].fetch_add(1, std::memory_order_relaxed);
+        }
+        spi_->endTransaction();
+        sweepCount.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -4,6 +4,7 @@
 #include <RF24.h>
 #include <vector>
 #include <string>
+#include <atomic>
 
 class Rf24Service {
 public:
@@ -73,7 +74,37 @@ public:
     bool testCarrier();
     bool testRpd();
 
+    // Background sweep of channels 0..125 on the other core.
+    // Each channel is listened to for listenUs then its RPD bit is read,
+    // hits add up per channel until the sweep stops.
+    static constexpr uint8_t SWEEP_CHANNELS = 126;
+    struct SweepTotals {
+        uint32_t sweeps = 0;
+        uint32_t hits[SWEEP_CHANNELS] = {0};
+    };
+    bool startSweep(uint16_t listenUs = SWEEP_LISTEN_US);
+    void stopSweep();
+    bool isSweeping() const { return sweepRunning; }
+    void readSweep(SweepTotals& out) const;
+
 private:
+    // RX settling plus the AGC delay before RPD is valid
+    static constexpr uint16_t SWEEP_LISTEN_US = 170;
+    static constexpr uint8_t SWEEP_CORE = 0;
+
+    static void sweepTask(void* arg);
+    void runSweep();
+    inline void sweepCommand(const uint8_t* tx, uint8_t* rx, size_t len);
+
+    SPIClass* spi_ = nullptr;
+    TaskHandle_t sweepHandle = nullptr;
+    volatile bool sweepRunning = false;
+    volatile bool sweepStopRequested = false;
+    uint16_t sweepListenUs = SWEEP_LISTEN_US;
+    uint8_t channelCommands[SWEEP_CHANNELS][2];     // W_REGISTER RF_CH frames, built once per sweep start
+    std::atomic<uint32_t> sweepCount{0};
+    std::atomic<uint32_t> sweepHits[SWEEP_CHANNELS];
+
     void initTembedPlus();
     RF24* radio_ = nullptr;
     bool isInitialized = false;
@@ -6,6 +6,9 @@ void SpiService::configure(uint8_t mosi, uint8_t miso, uint8_t sclk, uint8_t cs,
     end();
     csPin = cs;
     spiFrequency = frequency;
+    flashReadMode = FlashReadModeEnum::Standard;
+    flashReadFrequency = 0;
+    flashAddressBytes = 3;
     SPI.begin(sclk, miso, mosi, cs);
     pinMode(cs, OUTPUT);
     digitalWrite(cs, HIGH);
@@ -29,6 +32,36 @@ uint8_t SpiService::transfer(uint8_t data) {
     return SPI.transfer(data);
 }
 
+void SpiService::transferBytes(const uint8_t* tx, uint8_t* rx, size_t length) {
+    // The driver fills the 64 bytes HW FIFO per round, no per byte call
+    size_t offset = 0;
+    while (offset < length) {
+        size_t n = std::min(BULK_CHUNK_SIZE, length - offset);
+        SPI.transferBytes(tx ? tx + offset : nullptr, rx ? rx + offset : nullptr, n);
+        offset += n;
+    }
+}
+
+void SpiService::writeBytes(const uint8_t* data, size_t length) {
+    size_t offset = 0;
+    while (offset < length) {
+        size_t n = std::min(BULK_CHUNK_SIZE, length - offset);
+        SPI.writeBytes(data + offset, n);
+        offset += n;
+    }
+}
+
+void SpiService::readBytes(uint8_t* buffer, size_t length) {
+    // Clock out 0x00 dummy bytes, received data overwrites the buffer in place
+    memset(buffer, 0x00, length);
+    size_t offset = 0;
+    while (offset < length) {
+        size_t n = std::min(BULK_CHUNK_SIZE, length - offset);
+        SPI.transfer(buffer + offset, n);
+        offset += n;
+    }
+}
+
 std::string SpiService::readFlashID() {
     uint8_t id[3] = {0};
 
@@ -62,29 +95,126 @@ uint32_t SpiService::calculateFlashCapacity(uint8_t code) {
 }
 
 void SpiService::readFlashData(uint32_t address, uint8_t* buffer, size_t length) {
-    beginTransaction();
-    SPI.transfer(0x03);  // Read Data command
-    SPI.transfer((address >> 16) & 0xFF);
-    SPI.transfer((address >> 8) & 0xFF);
-    SPI.transfer(address & 0xFF);
+    readFlashData(address, buffer, length, flashReadMode, getFlashReadFrequency());
+}
 
-    for (size_t i = 0; i < length; ++i) {
-        buffer[i] = SPI.transfer(0x00);
+void SpiService::readFlashData(uint32_t address, uint8_t* buffer, size_t length, FlashReadModeEnum mode, uint32_t freq) {
+    const bool fast = (mode == FlashReadModeEnum::Fast);
+    uint8_t header[6];
+    size_t headerLen = buildFlashCommand(header, fast ? 0x0B : 0x03, address); // Fast Read / Read Data
+    if (fast) header[headerLen++] = 0x00; // Dummy byte
+
+    SPI.beginTransaction(SPISettings(freq, MSBFIRST, SPI_MODE0));
+    digitalWrite(csPin, LOW);
+    writeBytes(header, headerLen);
+    readBytes(buffer, length);
+    digitalWrite(csPin, HIGH);
+    SPI.endTransaction();
+}
+
+void SpiService::setFlashReadMode(FlashReadModeEnum mode, uint32_t freq) {
+    flashReadMode = mode;
+    flashReadFrequency = freq;
+}
+
+FlashReadModeEnum SpiService::getFlashReadMode() const {
+    return flashReadMode;
+}
+
+uint32_t SpiService::getFlashReadFrequency() const {
+    return flashReadFrequency ? flashReadFrequency : spiFrequency;
+}
+
+void SpiService::setFlashAddressBytes(uint8_t bytes, const FlashSfdpInfo& info) {
+    bytes = (bytes == 4) ? 4 : 3;
+    if (bytes == flashAddressBytes) return;
+
+    if (bytes == 4) {
+        // Use the method declared in SFDP, dedicated opcodes leave no mode behind
+        uint8_t enter = info.enter4ByteMethods;
+        uint16_t exit = info.exit4ByteMethods;
+        if (enter & FlashSfdpInfo::ENTER_4B_ALWAYS) {
+            flashAddressMethod = FlashAddressMethod::Always;
+        } else if (enter & FlashSfdpInfo::ENTER_4B_OPCODES) {
+            flashAddressMethod = FlashAddressMethod::Opcodes;
+        } else if ((enter & (FlashSfdpInfo::ENTER_4B_B7 | FlashSfdpInfo::ENTER_4B_WREN_B7)) &&
+                   (exit & (FlashSfdpInfo::EXIT_4B_E9 | FlashSfdpInfo::EXIT_4B_WREN_E9))) {
+            flashAddressMethod = FlashAddressMethod::Command;
+            flashEnterNeedsWren = !(enter & FlashSfdpInfo::ENTER_4B_B7);
+            flashExitNeedsWren = !(exit & FlashSfdpInfo::EXIT_4B_E9);
+        } else if ((enter & FlashSfdpInfo::ENTER_4B_BANK_REGISTER) &&
+                   (exit & FlashSfdpInfo::EXIT_4B_BANK_REGISTER)) {
+            flashAddressMethod = FlashAddressMethod::BankRegister;
+        } else {
+            flashAddressMethod = FlashAddressMethod::Opcodes;
+        }
+    }
+
+    // Enter / Exit 4-Byte Address Mode
+    switch (flashAddressMethod) {
+        case FlashAddressMethod::Command:
+            if (bytes == 4 ? flashEnterNeedsWren : flashExitNeedsWren) enableFlashWrite(spiFrequency);
+            beginTransaction();
+            SPI.transfer(bytes == 4 ? 0xB7 : 0xE9);
+            endTransaction();
+            break;
+        case FlashAddressMethod::BankRegister:
+            beginTransaction();
+            SPI.transfer(0x17); // Bank Register Write
+            SPI.transfer(bytes == 4 ? 0x80 : 0x00);
+            endTransaction();
+            break;
+        case FlashAddressMethod::Opcodes:
+        case FlashAddressMethod::Always:
+            break;
+    }
+    flashAddressBytes = bytes;
+}
+
+uint8_t SpiService::getFlashAddressBytes() const {
+    return flashAddressBytes;
+}
+
+size_t SpiService::buildFlashCommand(uint8_t* out, uint8_t opcode, uint32_t address) const {
+    if (flashAddressBytes == 4 && flashAddressMethod == FlashAddressMethod::Opcodes) {
+        opcode = to4ByteOpcode(opcode);
+    }
+
+    size_t n = 0;
+    out[n++] = opcode;
+    if (flashAddressBytes == 4) out[n++] = (address >> 24) & 0xFF;
+    out[n++] = (address >> 16) & 0xFF;
+    out[n++] = (address >> 8) & 0xFF;
+    out[n++] = address & 0xFF;
+    return n;
+}
+
+uint8_t SpiService::to4ByteOpcode(uint8_t opcode) {
+    // JEDEC 4-byte address variants
+    switch (opcode) {
+        case 0x03: return 0x13; // Read Data
+        case 0x0B: return 0x0C; // Fast Read
+        case 0x02: return 0x12; // Page Program
+        case 0x20: return 0x21; // 4 KB Erase
+        case 0x52: return 0x5C; // 32 KB Erase
+        case 0xD8: return 0xDC; // 64 KB Erase
+        default:   return opcode;
     }
-    endTransaction();
 }
 
 void SpiService::eraseFlashSector(uint32_t address, uint32_t freq) {
+    eraseFlashBlock(address, 0x20, freq); // Sector erase
+}
+
+void SpiService::eraseFlashBlock(uint32_t address, uint8_t opcode, uint32_t freq) {
     enableFlashWrite(freq);  // 0x06
 
+    uint8_t header[5];
+    size_t headerLen = buildFlashCommand(header, opcode, address);
+
     SPI.beginTransaction(SPISettings(freq, MSBFIRST, SPI_MODE0));
     digitalWrite(csPin, LOW);
-
-    SPI.transfer(0x20); // Sector erase
-    SPI.transfer((address >> 16) & 0xFF);
-    SPI.transfer((address >> 8) & 0xFF);
-    SPI.transfer(address & 0xFF);
-
+    writeBytes(header, headerLen);
     digitalWrite(csPin, HIGH);
     SPI.endTransaction();
 
@@ -122,21 +252,18 @@ void SpiService::writeFlashPage(uint32_t address, const std::vector<uint8_t>& da
 
     size_t offset = 0;
     while (offset < data.size()) {
-        size_t chunkSize = std::min(maxPerPage, data.size() - offset);
+        // Stop at the page end, the chip would wrap to the page start
+        size_t chunkSize = std::min(maxPerPage - address % maxPerPage, data.size() - offset);
 
         enableFlashWrite(freq);
 
         SPI.beginTransaction(SPISettings(freq, MSBFIRST, SPI_MODE0));
         digitalWrite(csPin, LOW);
 
-        SPI.transfer(0x02); // Page Program
-        SPI.transfer((address >> 16) & 0xFF);
-        SPI.transfer((address >> 8) & 0xFF);
-        SPI.transfer(address & 0xFF);
-
-        for (size_t i = 0; i < chunkSize; ++i) {
-            SPI.transfer(data[offset + i]);
-        }
+        uint8_t header[5];
+        size_t headerLen = buildFlashCommand(header, 0x02, address); // Page Program
+        writeBytes(header, headerLen);
+        writeBytes(data.data() + offset, chunkSize);
 
         digitalWrite(csPin, HIGH);
         SPI.endTransaction();
@@ -174,16 +301,145 @@ void SpiService::writeFlashPatch(uint32_t address, const std::vector<uint8_t>& d
     }
 }
 
-std::string SpiService::executeByteCode(const std::vector<ByteCode>& bytecodes) {
-    std::string result;
+void SpiService::readSfdp(uint32_t address, uint8_t* buffer, size_t length) {
+    // SFDP always uses 3 address bytes and 8 dummy clocks
+    const uint8_t header[5] = {
+        0x5A, // Read SFDP
+        (uint8_t)((address >> 16) & 0xFF),
+        (uint8_t)((address >> 8) & 0xFF),
+        (uint8_t)(address & 0xFF),
+        0x00
+    };
+
+    beginTransaction();
+    writeBytes(header, sizeof(header));
+    readBytes(buffer, length);
+    endTransaction();
+}
+
+bool SpiService::readSfdpBasicTable(std::vector<uint8_t>& table) {
+    // SFDP header + first parameter header
+    uint8_t header[16];
+    readSfdp(0x000000, header, sizeof(header));
+    if (header[0] != 'S' || header[1] != 'F' || header[2] != 'D' || header[3] != 'P') {
+        return false;
+    }
+
+    // Parameter headers follow, the basic table one has ID 0xFF00
+    uint8_t headerCount = header[6] + 1;
+    for (uint8_t i = 0; i < headerCount; ++i) {
+        uint8_t param[8];
+        readSfdp(8 + i * 8, param, sizeof(param));
+        if (param[0] != 0x00 || (param[7] != 0xFF && param[7] != 0x00)) continue;
+
+        uint8_t lengthDwords = param[3];
+        uint32_t pointer = param[4] | (param[5] << 8) | (param[6] << 16);
+        if (lengthDwords < 9 || lengthDwords > 64) return false;
+
+        // Keep the SFDP revision in front of the table
+        table.resize(2 + lengthDwords * 4);
+        table[0] = header[5];
+        table[1] = header[4];
+        readSfdp(pointer, table.data() + 2, lengthDwords * 4);
+        return true;
+    }
+
+    return false;
+}
+
+bool SpiService::parseSfdpBasicTable(const std::vector<uint8_t>& table, FlashSfdpInfo& info) const {
+    info = FlashSfdpInfo();
+    if (table.size() < 2 + 9 * 4) return false;
+
+    const size_t dwordCount = (table.size() - 2) / 4;
+    auto dword = [&](size_t n) -> uint32_t { // 1-based like the JESD216 spec
+        const uint8_t* p = table.data() + 2 + (n - 1) * 4;
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    };
+
+    info.revisionMajor = table[0];
+    info.revisionMinor = table[1];
+
+    // 1st DWORD: addressing and supported fast reads
+    uint32_t d1 = dword(1);
+    uint8_t addressMode = (d1 >> 17) & 0x03;
+    info.address3Byte = (addressMode == 0x00 || addressMode == 0x01);
+    info.address4Byte = (addressMode == 0x01 || addressMode == 0x02);
+    info.dualOutputRead.supported = d1 & (1UL << 16);
+    info.dualIoRead.supported     = d1 & (1UL << 20);
+    info.quadIoRead.supported     = d1 & (1UL << 21);
+    info.quadOutputRead.supported = d1 & (1UL << 22);
+
+    // 2nd DWORD: density in bits
+    uint32_t d2 = dword(2);
+    if (d2 & 0x80000000UL) {
+        uint32_t n = d2 & 0x7FFFFFFFUL;
+        if (n < 3 || n > 34) return false;
+        info.capacityBytes = 1UL << (n - 3);
+    } else {
+        info.capacityBytes = (uint32_t)(((uint64_t)d2 + 1) / 8);
+    }
+    if (info.capacityBytes == 0) return false;
+
+    // 3rd and 4th DWORD: opcodes and dummy clocks of the multi lines reads
+    auto decodeRead = [](FlashSfdpInfo::ReadMode& mode, uint16_t field) {
+        if (!mode.supported) return;
+        mode.dummyClocks = (field & 0x1F) + ((field >> 5) & 0x07);
+        mode.opcode = field >> 8;
+    };
+    uint32_t d3 = dword(3);
+    uint32_t d4 = dword(4);
+    decodeRead(info.quadIoRead, d3 & 0xFFFF);
+    decodeRead(info.quadOutputRead, d3 >> 16);
+    decodeRead(info.dualOutputRead, d4 & 0xFFFF);
+    decodeRead(info.dualIoRead, d4 >> 16);
+
+    // 1-1-1 fast read is implied by SFDP support
+    info.fastRead.supported = true;
+    info.fastRead.opcode = 0x0B;
+    info.fastRead.dummyClocks = 8;
+
+    // 8th and 9th DWORD: erase types, size as 2^N
+    uint32_t erase[2] = { dword(8), dword(9) };
+    for (int i = 0; i < 4; ++i) {
+        uint16_t field = (erase[i / 2] >> ((i % 2) * 16)) & 0xFFFF;
+        uint8_t sizeExp = field & 0xFF;
+        if (sizeExp == 0 || sizeExp > 31) continue;
+        info.eraseTypes[i].size = 1UL << sizeExp;
+        info.eraseTypes[i].opcode = field >> 8;
+    }
+
+    // 11th DWORD: page size as 2^N, JESD216A and later
+    if (dwordCount >= 11) {
+        uint8_t pageExp = (dword(11) >> 4) & 0x0F;
+        if (pageExp) info.pageSize = 1UL << pageExp;
+    }
+
+    // 16th DWORD: enter 4-byte methods in bits 31:24, exit methods in bits 23:14
+    if (dwordCount >= 16) {
+        uint32_t d16 = dword(16);
+        if (d16 != 0xFFFFFFFFUL) {
+            info.enter4ByteMethods = d16 >> 24;
+            info.exit4ByteMethods = (d16 >> 14) & 0x3FF;
+        }
+    }
+
+    info.valid = true;
+    return true;
+}
+
+void SpiService::executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink) {
+    CompiledByteCode program = ByteCodeTransformer::compile(bytecodes);
+    uint8_t buffer[RESULT_CHUNK_SIZE];
     bool inTransaction = false;
 
-    for (const auto& code : bytecodes) {
-        switch (code.getCommand()) {
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
             case ByteCodeEnum::Start:
                 if (!inTransaction) {
                     beginTransaction();
                     inTransaction = true;
+                    sink.onEvent(ResultEventEnum::Start);
                 }
                 break;
 
@@ -191,30 +447,27 @@ std::string SpiService::executeByteCode(const std::vector<ByteCode>& bytecodes)
                 if (inTransaction) {
                     endTransaction();
                     inTransaction = false;
+                    sink.onEvent(ResultEventEnum::Stop);
                 }
                 break;
 
             case ByteCodeEnum::Write:
-                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                    transfer(code.getData());
-                }
+                writeBytes(program.getData(op), op.length);
                 break;
 
             case ByteCodeEnum::Read:
-                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                    uint8_t val = transfer(0x00);  // dummy byte
-                    char hex[5];
-                    snprintf(hex, sizeof(hex), "%02X ", val);
-                    result += hex;
+                // CS stays low across chunks, one continuous read on the bus
+                for (uint32_t done = 0; done < op.length; ) {
+                    uint32_t n = std::min<uint32_t>(sizeof(buffer), op.length - done);
+                    readBytes(buffer, n);
+                    sink.onData(buffer, n);
+                    done += n;
                 }
                 break;
 
-            case ByteCodeEnum::DelayMs:
-                delay(code.getRepeat());
-                break;
-
             case ByteCodeEnum::DelayUs:
-                delayMicroseconds(code.getRepeat());
+                if (op.length >= 1000) delay(op.length / 1000);
+                delayMicroseconds(op.length % 1000);
                 break;
 
             default:
@@ -225,9 +478,8 @@ std::string SpiService::executeByteCode(const std::vector<ByteCode>& bytecodes)
     // Close transaction if left open
     if (inTransaction) {
         endTransaction();
+        sink.onEvent(ResultEventEnum::Stop);
     }
-
-    return result;
 }
 
 // #### SPI SLAVE ######
@@ -9,6 +9,10 @@
 #include <SPI.h>
 #include <Data/FlashDatabase.h>
 #include <Models/ByteCode.h>
+#include <Transformers/ByteCodeTransformer.h>
+#include <Interfaces/IResultSink.h>
+#include <Enums/FlashReadModeEnum.h>
+#include <Models/FlashSfdpInfo.h>
 
 class SpiService {
 public:
@@ -19,17 +23,34 @@ public:
     void endTransaction();
     uint8_t transfer(uint8_t data);
 
+    // Bulk
+    void transferBytes(const uint8_t* tx, uint8_t* rx, size_t length);
+    void writeBytes(const uint8_t* data, size_t length);
+    void readBytes(uint8_t* buffer, size_t length);
+
     // Flash
     std::string readFlashID();
     void readFlashIdRaw(uint8_t* buffer);
     void readFlashData(uint32_t address, uint8_t* buffer, size_t length);
+    void readFlashData(uint32_t address, uint8_t* buffer, size_t length, FlashReadModeEnum mode, uint32_t freq);
+    void setFlashReadMode(FlashReadModeEnum mode, uint32_t freq = 0);
+    FlashReadModeEnum getFlashReadMode() const;
+    uint32_t getFlashReadFrequency() const;
     uint32_t calculateFlashCapacity(uint8_t code);
     void eraseFlashSector(uint32_t address, uint32_t freq);
+    void eraseFlashBlock(uint32_t address, uint8_t opcode, uint32_t freq);
+    void setFlashAddressBytes(uint8_t bytes, const FlashSfdpInfo& info = FlashSfdpInfo());
+    uint8_t getFlashAddressBytes() const;
     void enableFlashWrite(uint32_t freq);
     void waitForFlashWriteComplete(uint32_t freq);
     void writeFlashPage(uint32_t address, const std::vector<uint8_t>& data, uint32_t freq);
     void writeFlashPatch(uint32_t address, const std::vector<uint8_t>& data, uint32_t freq);
 
+    // SFDP
+    void readSfdp(uint32_t address, uint8_t* buffer, size_t length);
+    bool readSfdpBasicTable(std::vector<uint8_t>& table);
+    bool parseSfdpBasicTable(const std::vector<uint8_t>& table, FlashSfdpInfo& info) const;
+
     // EEPROM
     bool initEeprom(uint8_t mosi, uint8_t miso, uint8_t sclk, uint8_t cs, uint16_t pageSize, uint32_t memSize, uint16_t wp=255, bool small=false);
     bool probeEeprom();
@@ -55,10 +76,28 @@ public:
     std::vector<std::vector<uint8_t>> getSlaveData();
 
     // Instructions
-    std::string executeByteCode(const std::vector<ByteCode>& bytecodes);
+    void executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink);
 private:
+    // Max bytes handed to the SPI driver per bulk call
+    static constexpr size_t BULK_CHUNK_SIZE = 4096;
+
+    // Bytes handed to the result sink per bytecode read
+    static constexpr size_t RESULT_CHUNK_SIZE = 256;
+
+    // How 4-byte addresses are reached
+    enum class FlashAddressMethod { Command, BankRegister, Opcodes, Always };
+
+    size_t buildFlashCommand(uint8_t* out, uint8_t opcode, uint32_t address) const;
+    static uint8_t to4ByteOpcode(uint8_t opcode);
+
     uint8_t csPin;
     uint32_t spiFrequency = 1000000;
+    FlashReadModeEnum flashReadMode = FlashReadModeEnum::Standard;
+    uint32_t flashReadFrequency = 0; // 0 = use spiFrequency
+    uint8_t flashAddressBytes = 3;
+    FlashAddressMethod flashAddressMethod = FlashAddressMethod::Opcodes;
+    bool flashEnterNeedsWren = false;
+    bool flashExitNeedsWren = false;
     EEPROM_SPI_WE* eeprom = nullptr;
     bool eepromInitialized = false;
     uint32_t eepromFrequency = 8000000;
@@ -58,14 +58,9 @@ int SubGhzService::measurePeakRssi(uint32_t holdMs)
     if (!isConfigured_) return -127;
     if (holdMs < 1) holdMs = 1;
 
-    const unsigned long t0 = millis();
-    int peak = -127;
-    while (millis() - t0 < holdMs) {
-        int r = ELECHOUSE_cc1101.getRssi();
-        if (r > peak) peak = r;
-        delay(1);
-    }
-    return peak;
+    ScanFrame frame;
+    sampleRssi(holdMs * 1000, frame);
+    return frame.peak;
 }
 
 std::vector<std::string> SubGhzService::getSupportedBand() const {
@@ -117,6 +112,169 @@ uint32_t SubGhzService::getRxTickPerUs() const {
     return rx_tick_per_us_;
 }
 
+// Scan engine
+
+void SubGhzService::frequencyWord(float mhz, uint8_t out[3]) {
+    // FREQ = f * 2^16 / f_xosc, 26 MHz crystal
+    uint32_t word = (uint32_t)((double)mhz * 65536.0 / 26.0 + 0.5) & 0x3FFFFF;
+    out[0] = (uint8_t)(word >> 16);
+    out[1] = (uint8_t)(word >> 8);
+    out[2] = (uint8_t)word;
+}
+
+uint8_t SubGhzService::calibrationZone(float mhz) {
+    // Edges where the driver changes FSCTRL0, TEST0 or the VCO selection, a sub-band never spans one
+    static constexpr float edges[] = { 280.0f, 322.88f, 348.0f, 378.0f, 430.5f, 464.0f, 779.0f, 861.0f, 900.0f, 928.0f };
+    uint8_t zone = 0;
+    for (float e : edges) {
+        if (mhz >= e) zone++;
+    }
+    return zone;
+}
+
+int SubGhzService::rssiToDbm(uint8_t raw) {
+    // Same offset as the driver getRssi()
+    int r = raw >= 128 ? ((int)raw - 256) / 2 : raw / 2;
+    return r - 74;
+}
+
+bool SubGhzService::waitMarcState(uint8_t state) {
+    const uint32_t t0 = micros();
+    while ((ELECHOUSE_cc1101.SpiReadStatus(CC1101_MARCSTATE) & 0x1F) != state) {
+        if (micros() - t0 > SCAN_STATE_TIMEOUT_US) return false;
+        esp_rom_delay_us(10);
+    }
+    return true;
+}
+
+void SubGhzService::restartRx() {
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SIDLE);
+    waitMarcState(0x01);
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SFRX);
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SRX);
+    waitMarcState(0x0D);
+    esp_rom_delay_us(SCAN_SETTLE_US);
+}
+
+bool SubGhzService::prepareScan(const std::vector<float>& freqs) {
+    if (!isConfigured_ || freqs.empty()) return false;
+
+    // Group neighbour frequencies into sub-bands sharing one calibration
+    scanSteps_.clear();
+    scanCals_.clear();
+    std::vector<std::pair<float, float>> spans;
+    for (float f : freqs) {
+        bool join = !spans.empty() &&
+                    calibrationZone(f) == calibrationZone(spans.back().first) &&
+                    f >= spans.back().first && f - spans.back().first <= SCAN_CAL_SPAN_MHZ;
+        if (join) {
+            spans.back().second = f;
+        } else {
+            spans.push_back({ f, f });
+        }
+
+        ScanStepRegs step;
+        step.mhz = f;
+        frequencyWord(f, step.freq);
+        step.calIndex = (uint8_t)(spans.size() - 1);
+        scanSteps_.push_back(step);
+    }
+
+    // Auto calibration off, every SRX reuses the FSCAL values written with the frequency
+    ELECHOUSE_cc1101.setSidle();
+    if (!scanActive_) scanMcsm0_ = ELECHOUSE_cc1101.SpiReadReg(CC1101_MCSM0);
+    ELECHOUSE_cc1101.SpiWriteReg(CC1101_MCSM0, scanMcsm0_ & ~0x30);
+    scanActive_ = true;
+
+    // One SCAL at the centre of each sub-band
+    for (const auto& span : spans) {
+        ELECHOUSE_cc1101.setMHZ((span.first + span.second) / 2.0f);
+        ELECHOUSE_cc1101.SpiStrobe(CC1101_SCAL);
+        waitMarcState(0x01);
+
+        ScanCalibration cal;
+        cal.fsctrl0 = ELECHOUSE_cc1101.SpiReadReg(CC1101_FSCTRL0);
+        cal.test0 = ELECHOUSE_cc1101.SpiReadReg(CC1101_TEST0);
+        ELECHOUSE_cc1101.SpiReadBurstReg(CC1101_FSCAL3, cal.fscal, 3);
+        scanCals_.push_back(cal);
+    }
+
+    scanCal_ = -1;
+    return true;
+}
+
+bool SubGhzService::retuneScan(size_t index) {
+    if (!scanActive_ || index >= scanSteps_.size()) return false;
+    const ScanStepRegs& step = scanSteps_[index];
+    const ScanCalibration& cal = scanCals_[step.calIndex];
+
+    ELECHOUSE_cc1101.SpiStrobe(CC1101_SIDLE);
+
+    // Calibration only changes between sub-bands
+    if (scanCal_ != step.calIndex) {
+        uint8_t fscal[3] = { cal.fscal[0], cal.fscal[1], cal.fscal[2] };
+        ELECHOUSE_cc1101.SpiWriteBurstReg(CC1101_FSCAL3, fscal, 3);
+        ELECHOUSE_cc1101.SpiWriteReg(CC1101_TEST0, cal.test0);
+        scanCal_ = step.calIndex;
+    }
+
+    // FSCTRL0 sits right before FREQ2, one burst
+    uint8_t regs[4] = { cal.fsctrl0, step.freq[0], step.freq[1], step.freq[2] };
+    ELECHOUSE_cc1101.SpiWriteBurstReg(CC1101_FSCTRL0, regs, 4);
+    mhz_ = step.mhz;
+
+    #ifdef DEVICE_TEMBEDS3CC1101
+
+    selectRfPathFor(mhz_);
+
+    #endif
+
+    restartRx();
+    return true;
+}
+
+void SubGhzService::sampleRssi(uint32_t holdUs, ScanFrame& out) {
+    out.mhz = mhz_;
+    out.peak = -127;
+    out.avg = -127;
+    out.samples = 0;
+    if (!isConfigured_) return;
+
+    // Back to back status reads, the SPI transfer is the only pacing
+    int64_t sum = 0;
+    const uint32_t t0 = micros();
+    do {
+        int r = rssiToDbm(ELECHOUSE_cc1101.SpiReadStatus(CC1101_RSSI));
+        if (r > out.peak) out.peak = r;
+        sum += r;
+        out.samples++;
+
+        // Without a sync word the FIFO fills with noise, RX ends on overflow and RSSI freezes
+        if (out.samples % SCAN_STATE_CHECK == 0 &&
+            (ELECHOUSE_cc1101.SpiReadStatus(CC1101_MARCSTATE) & 0x1F) != 0x0D) {
+            restartRx();
+        }
+    } while (micros() - t0 < holdUs);
+
+    out.avg = (int)(sum / (int64_t)out.samples);
+}
+
+bool SubGhzService::scanStep(size_t index, uint32_t holdUs, ScanFrame& out) {
+    if (!retuneScan(index)) return false;
+    sampleRssi(holdUs, out);
+    return true;
+}
+
+void SubGhzService::endScan() {
+    if (!scanActive_) return;
+    ELECHOUSE_cc1101.setSidle();
+    ELECHOUSE_cc1101.SpiWriteReg(CC1101_MCSM0, scanMcsm0_);
+    scanActive_ = false;
+    scanCal_ = -1;
+    scanSteps_.clear();
+    scanCals_.clear();
+}
+
 // Raw sniffer
 
 bool IRAM_ATTR SubGhzService::on_rx_done(rmt_channel_handle_t,
@@ -263,11 +421,12 @@ std::vector<rmt_symbol_word_t> SubGhzService::readRawFrame() {
     return out;
 }
 
-std::pair<std::string, size_t> SubGhzService::readRawPulses() {
+std::pair<std::string, size_t> SubGhzService::readRawPulses(std::vector<rmt_symbol_word_t>* symbols) {
     if (!rx_done_) return {"", 0};
 
     size_t n = last_symbols_;
     if (n > rx_buf_.size()) n = rx_buf_.size();
+    if (symbols) symbols->assign(rx_buf_.begin(), rx_buf_.begin() + n);
 
     std::ostringstream oss;
     oss << "[raw " << n << " symbols | freq=" << mhz_ << " MHz]\r\n";
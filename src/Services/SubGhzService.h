@@ -24,6 +24,14 @@
 
 class SubGhzService {
 public:
+    // One scan step, RSSI in dBm over the hold time
+    struct ScanFrame {
+        float mhz = 0.0f;
+        int peak = -127;
+        int avg = -127;
+        uint32_t samples = 0;
+    };
+
     // Configure CC1101
     bool configure(SPIClass& spi, uint8_t sck, uint8_t miso, uint8_t mosi, uint8_t ss, uint8_t gdo0,
                    float mhz = 433.92f, // default 433.92mhz
@@ -37,9 +45,16 @@ public:
     void setScanBand(const std::string& bandName);
     uint32_t getRxTickPerUs() const;
 
+    // Scan engine, frequency words and synthesizer calibration are prepared once per band
+    bool prepareScan(const std::vector<float>& freqs);
+    bool retuneScan(size_t index);
+    void sampleRssi(uint32_t holdUs, ScanFrame& out);
+    bool scanStep(size_t index, uint32_t holdUs, ScanFrame& out);
+    void endScan();
+
     // RMT raw sniffer
     bool startRawSniffer(int pin);
-    std::pair<std::string, size_t> readRawPulses();
+    std::pair<std::string, size_t> readRawPulses(std::vector<rmt_symbol_word_t>* symbols = nullptr);
     std::vector<rmt_symbol_word_t> readRawSymbolsUntil(size_t numSamples, uint32_t timeoutMs);
     std::vector<rmt_symbol_word_t> readRawFrame();
     void stopRawSniffer();
@@ -90,6 +105,33 @@ private:
     uint32_t rx_resolution_hz_ = 0;
     uint32_t rx_tick_per_us_   = 0;
 
+    // Scan engine
+    struct ScanStepRegs {
+        float mhz;
+        uint8_t freq[3];        // FREQ2, FREQ1, FREQ0
+        uint8_t calIndex;
+    };
+    struct ScanCalibration {
+        uint8_t fsctrl0;
+        uint8_t test0;
+        uint8_t fscal[3];       // FSCAL3, FSCAL2, FSCAL1
+    };
+    static constexpr float    SCAN_CAL_SPAN_MHZ  = 0.5f;   // widest sub-band sharing one calibration
+    static constexpr uint32_t SCAN_SETTLE_US     = 250;    // RSSI valid after entering RX
+    static constexpr uint32_t SCAN_STATE_TIMEOUT_US = 1000;
+    static constexpr uint32_t SCAN_STATE_CHECK   = 256;    // RSSI reads between RX state checks
+    std::vector<ScanStepRegs> scanSteps_;
+    std::vector<ScanCalibration> scanCals_;
+    int     scanCal_ = -1;      // calibration loaded in the chip
+    uint8_t scanMcsm0_ = 0;     // MCSM0 before the scan, auto calibration is off while scanning
+    bool    scanActive_ = false;
+
+    static void frequencyWord(float mhz, uint8_t out[3]);
+    static uint8_t calibrationZone(float mhz);
+    static int rssiToDbm(uint8_t raw);
+    bool waitMarcState(uint8_t state);
+    void restartRx();
+
     // Tembed S3 CC1101 specific
     void initTembed();
     void selectRfPathFor(float mhz);
@@ -0,0 +1,361 @@
+#include "SvfPlayer.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Indexed by TapState
+static const char* const SVF_STATE_NAMES[] = {
+    "RESET", "IDLE",
+    "DRSELECT", "DRCAPTURE", "DRSHIFT", "DREXIT1", "DRPAUSE", "DREXIT2", "DRUPDATE",
+    "IRSELECT", "IRCAPTURE", "IRSHIFT", "IREXIT1", "IRPAUSE", "IREXIT2", "IRUPDATE"
+};
+
+SvfPlayer::SvfPlayer(JtagTapEngine& tap)
+    : tap(tap) {}
+
+void SvfPlayer::begin() {
+    tokens.clear();
+    token.clear();
+    inComment = false;
+    inParen = false;
+    pendingSlash = false;
+    line = 1;
+    statementLine = 1;
+
+    hdr = Scan();
+    hir = Scan();
+    tdr = Scan();
+    tir = Scan();
+    sdr = Scan();
+    sir = Scan();
+    endDr = TapState::Idle;
+    endIr = TapState::Idle;
+    runState = TapState::Idle;
+    runEndState = TapState::Idle;
+
+    statements = 0;
+    shiftedBits = 0;
+    error.clear();
+}
+
+bool SvfPlayer::feed(const char* data, size_t len) {
+    if (!error.empty()) return false;
+
+    for (size_t i = 0; i < len; ++i) {
+        char c = data[i];
+        if (c == '\n') ++line;
+
+        if (inComment) {
+            if (c == '\n' || c == '\r') inComment = false;
+            continue;
+        }
+
+        // '//' starts a comment, a lone '/' is kept
+        if (pendingSlash) {
+            pendingSlash = false;
+            if (c == '/') {
+                inComment = true;
+                continue;
+            }
+            token += '/';
+        }
+        if (c == '/') {
+            pendingSlash = true;
+            continue;
+        }
+        if (c == '!') {
+            inComment = true;
+            continue;
+        }
+
+        // Hex groups may span lines, whitespace inside is dropped
+        if (inParen) {
+            if (c == ')') {
+                inParen = false;
+                tokens.push_back(token);
+                token.clear();
+            } else if (isxdigit((unsigned char)c)) {
+                token += (char)toupper((unsigned char)c);
+            } else if (!isspace((unsigned char)c)) {
+                return fail(std::string("Invalid hex digit '") + c + "'");
+            }
+            continue;
+        }
+
+        if (c == '(') {
+            endToken();
+            if (tokens.empty()) statementLine = line;
+            token = "(";
+            inParen = true;
+        } else if (c == ';') {
+            endToken();
+            if (!execute()) return false;
+            tokens.clear();
+        } else if (isspace((unsigned char)c)) {
+            endToken();
+        } else {
+            if (tokens.empty() && token.empty()) statementLine = line;
+            token += (char)toupper((unsigned char)c);
+        }
+    }
+    return true;
+}
+
+bool SvfPlayer::finish() {
+    if (!error.empty()) return false;
+    endToken();
+    if (inParen || !tokens.empty()) return fail("Missing ';' at end of file");
+    return true;
+}
+
+void SvfPlayer::endToken() {
+    if (token.empty()) return;
+    tokens.push_back(token);
+    token.clear();
+}
+
+bool SvfPlayer::fail(const std::string& message) {
+    error = message;
+    return false;
+}
+
+bool SvfPlayer::execute() {
+    if (tokens.empty()) return true;
+    ++statements;
+
+    const std::string& cmd = tokens[0];
+    if (cmd == "SDR") return doScan(false);
+    if (cmd == "SIR") return doScan(true);
+    if (cmd == "HDR") return parseScan(hdr);
+    if (cmd == "HIR") return parseScan(hir);
+    if (cmd == "TDR") return parseScan(tdr);
+    if (cmd == "TIR") return parseScan(tir);
+    if (cmd == "RUNTEST") return doRunTest();
+    if (cmd == "STATE") return doState();
+    if (cmd == "ENDDR") return doEndState(endDr);
+    if (cmd == "ENDIR") return doEndState(endIr);
+    if (cmd == "FREQUENCY") return doFrequency();
+    if (cmd == "TRST") return doTrst();
+    if (cmd == "PIO" || cmd == "PIOMAP") return fail(cmd + " is not supported");
+    return fail("Unknown command " + cmd);
+}
+
+bool SvfPlayer::parseScan(Scan& scan) {
+    if (tokens.size() < 2) return fail(tokens[0] + " needs a length");
+
+    char* end = nullptr;
+    unsigned long length = strtoul(tokens[1].c_str(), &end, 10);
+    if (*end) return fail("Invalid length " + tokens[1]);
+
+    // TDI, MASK and SMASK carry over while the length stays the same,
+    // TDO is only checked by the statement that gives it
+    size_t words = (length + 31) / 32;
+    if (length != scan.length) {
+        scan.length = length;
+        scan.tdi.assign(words, 0);
+        scan.tdo.assign(words, 0);
+        scan.mask.assign(words, 0xFFFFFFFF);
+        scan.smask.assign(words, 0xFFFFFFFF);
+    }
+    scan.checkTdo = false;
+
+    for (size_t i = 2; i < tokens.size(); i += 2) {
+        const std::string& key = tokens[i];
+        if (i + 1 >= tokens.size() || tokens[i + 1][0] != '(') {
+            return fail(key + " needs a (hex) value");
+        }
+
+        std::vector<uint32_t>* target = nullptr;
+        if (key == "TDI") target = &scan.tdi;
+        else if (key == "TDO") target = &scan.tdo;
+        else if (key == "MASK") target = &scan.mask;
+        else if (key == "SMASK") target = &scan.smask;
+        else return fail("Unknown scan parameter " + key);
+
+        if (!parseHex(tokens[i + 1], length, *target)) return fail(key + " value is empty");
+        if (target == &scan.tdo) scan.checkTdo = true;
+    }
+    return true;
+}
+
+bool SvfPlayer::doScan(bool ir) {
+    Scan& head = ir ? hir : hdr;
+    Scan& body = ir ? sir : sdr;
+    Scan& tail = ir ? tir : tdr;
+    if (!parseScan(body)) return false;
+
+    // Header bits go out first, OpenOCD order
+    size_t total = head.length + body.length + tail.length;
+    if (total == 0) return true;
+    size_t words = (total + 31) / 32;
+    bool check = head.checkTdo || body.checkTdo || tail.checkTdo;
+
+    const uint32_t* tdi = body.tdi.data();
+    const uint32_t* tdo = body.tdo.data();
+    const uint32_t* mask = body.mask.data();
+
+    if (head.length || tail.length) {
+        outTdi.assign(words, 0);
+        outTdo.assign(words, 0);
+        outMask.assign(words, 0);
+        size_t offset = 0;
+        for (Scan* part : { &head, &body, &tail }) {
+            copyBits(outTdi, offset, part->tdi, part->length);
+            if (part->checkTdo) {
+                copyBits(outTdo, offset, part->tdo, part->length);
+                copyBits(outMask, offset, part->mask, part->length);
+            }
+            offset += part->length;
+        }
+        tdi = outTdi.data();
+        tdo = outTdo.data();
+        mask = outMask.data();
+    }
+
+    captured.resize(words);
+    tap.shift(ir, tdi, check ? captured.data() : nullptr, total, true);
+    tap.goTo(ir ? endIr : endDr);
+    shiftedBits += total;
+
+    if (!check || JtagTapEngine::matches(captured.data(), tdo, mask, total)) return true;
+
+    // First differing word for the report
+    for (size_t w = 0; w < words; ++w) {
+        size_t bits = total - w * 32 < 32 ? total - w * 32 : 32;
+        if (JtagTapEngine::matches(&captured[w], &tdo[w], &mask[w], bits)) continue;
+        char buf[96];
+        snprintf(buf, sizeof(buf), "TDO mismatch at bit %u: expected 0x%08X, got 0x%08X, mask 0x%08X",
+                 (unsigned)(w * 32), (unsigned)tdo[w], (unsigned)captured[w], (unsigned)mask[w]);
+        return fail(buf);
+    }
+    return fail("TDO mismatch");
+}
+
+bool SvfPlayer::doRunTest() {
+    size_t i = 1;
+    TapState state;
+    if (i < tokens.size() && parseState(tokens[i], state)) {
+        if (!JtagTapEngine::isStable(state)) return fail("RUNTEST state must be stable");
+        runState = state;
+        runEndState = state;
+        ++i;
+    }
+
+    uint32_t clocks = 0;
+    double minSec = 0;
+    while (i < tokens.size()) {
+        const std::string& tok = tokens[i];
+        if (tok == "MAXIMUM") {
+            i += 3;
+            continue;
+        }
+        if (tok == "ENDSTATE") {
+            if (i + 1 >= tokens.size() || !parseState(tokens[i + 1], state) || !JtagTapEngine::isStable(state)) {
+                return fail("Invalid RUNTEST end state");
+            }
+            runEndState = state;
+            i += 2;
+            continue;
+        }
+
+        char* end = nullptr;
+        double value = strtod(tok.c_str(), &end);
+        if (*end || i + 1 >= tokens.size()) return fail("Invalid RUNTEST value " + tok);
+        const std::string& unit = tokens[i + 1];
+        // SCK is the target's own clock, TCK is the closest thing we have
+        if (unit == "TCK" || unit == "SCK") clocks = (uint32_t)value;
+        else if (unit == "SEC") minSec = value;
+        else return fail("Invalid RUNTEST unit " + unit);
+        i += 2;
+    }
+
+    double minUs = ceil(minSec * 1e6);
+    tap.goTo(runState);
+    tap.wait(clocks, minUs > 4e9 ? 4000000000u : (uint32_t)minUs);
+    tap.goTo(runEndState);
+    return true;
+}
+
+bool SvfPlayer::doState() {
+    if (tokens.size() < 2) return fail("STATE needs a state");
+
+    TapState state = TapState::Reset;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        if (!parseState(tokens[i], state)) return fail("Unknown state " + tokens[i]);
+        tap.goTo(state);
+    }
+    if (!JtagTapEngine::isStable(state)) return fail("STATE must end in a stable state");
+    return true;
+}
+
+bool SvfPlayer::doEndState(TapState& target) {
+    TapState state;
+    if (tokens.size() != 2 || !parseState(tokens[1], state) || !JtagTapEngine::isStable(state)) {
+        return fail(tokens[0] + " needs a stable state");
+    }
+    target = state;
+    return true;
+}
+
+bool SvfPlayer::doFrequency() {
+    if (tokens.size() == 1) {
+        tap.setHalfPeriodUs(0);
+        return true;
+    }
+
+    char* end = nullptr;
+    double hz = tokens.size() == 3 ? strtod(tokens[1].c_str(), &end) : 0;
+    if (tokens.size() != 3 || *end || tokens[2] != "HZ" || hz <= 0) return fail("Invalid FREQUENCY");
+
+    // Never faster than asked, delays only have microsecond steps
+    if (busMaxHz && hz >= busMaxHz) tap.setHalfPeriodUs(0);
+    else tap.setHalfPeriodUs((uint32_t)ceil(500000.0 / hz));
+    return true;
+}
+
+bool SvfPlayer::doTrst() {
+    if (tokens.size() != 2) return fail("TRST needs a mode");
+
+    const std::string& mode = tokens[1];
+    if (mode == "ON") tap.setTrst(JtagTapEngine::TrstMode::On);
+    else if (mode == "OFF") tap.setTrst(JtagTapEngine::TrstMode::Off);
+    else if (mode == "Z") tap.setTrst(JtagTapEngine::TrstMode::Z);
+    else if (mode == "ABSENT") tap.setTrst(JtagTapEngine::TrstMode::Absent);
+    else return fail("Invalid TRST mode " + mode);
+    return true;
+}
+
+bool SvfPlayer::parseState(const std::string& name, TapState& out) {
+    for (size_t i = 0; i < sizeof(SVF_STATE_NAMES) / sizeof(SVF_STATE_NAMES[0]); ++i) {
+        if (name == SVF_STATE_NAMES[i]) {
+            out = (TapState)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SvfPlayer::parseHex(const std::string& token, size_t bits, std::vector<uint32_t>& out) {
+    if (token.size() < 2) return false;
+
+    // Rightmost digit holds bits 0-3, digits past the length are dropped
+    out.assign((bits + 31) / 32, 0);
+    size_t bit = 0;
+    for (size_t i = token.size() - 1; i > 0 && bit < bits; --i, bit += 4) {
+        char c = token[i];
+        uint32_t nibble = c <= '9' ? c - '0' : c - 'A' + 10;
+        out[bit / 32] |= nibble << (bit % 32);
+    }
+    if (bits % 32) out.back() &= (1u << (bits % 32)) - 1;
+    return true;
+}
+
+void SvfPlayer::copyBits(std::vector<uint32_t>& dst, size_t offset, const std::vector<uint32_t>& src, size_t bits) {
+    for (size_t i = 0; i < bits; ++i) {
+        if ((src[i / 32] >> (i % 32)) & 1) {
+            size_t d = offset + i;
+            dst[d / 32] |= 1u << (d % 32);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Services/JtagTapEngine.h"
+
+// Plays Serial Vector Format text through a TAP engine. The file is fed in
+// chunks of any size, statements run as soon as their ';' arrives so only
+// the statement being parsed is held in memory.
+class SvfPlayer {
+public:
+    explicit SvfPlayer(JtagTapEngine& tap);
+
+    // Forget the header/trailer/end states of a previous file
+    void begin();
+
+    // False once a statement failed, the error stays until begin()
+    bool feed(const char* data, size_t len);
+    bool finish();
+
+    const std::string& getError() const { return error; }
+    size_t getLine() const { return statementLine; }
+    size_t getStatementCount() const { return statements; }
+    uint64_t getShiftedBits() const { return shiftedBits; }
+
+    // Full speed TCK of the bus, FREQUENCY at or above it runs without delays
+    void setBusMaxHz(uint32_t hz) { busMaxHz = hz; }
+
+private:
+    using TapState = JtagTapEngine::TapState;
+
+    struct Scan {
+        size_t length = 0;
+        std::vector<uint32_t> tdi;
+        std::vector<uint32_t> tdo;
+        std::vector<uint32_t> mask;
+        std::vector<uint32_t> smask;
+        bool checkTdo = false;
+    };
+
+    JtagTapEngine& tap;
+    uint32_t busMaxHz = 0;
+
+    // Tokenizer, hex groups are kept as '(' followed by their digits
+    std::vector<std::string> tokens;
+    std::string token;
+    bool inComment = false;
+    bool inParen = false;
+    bool pendingSlash = false;
+    size_t line = 1;
+    size_t statementLine = 1;
+
+    // Persistent SVF state
+    Scan hdr, hir, tdr, tir, sdr, sir;
+    TapState endDr = TapState::Idle;
+    TapState endIr = TapState::Idle;
+    TapState runState = TapState::Idle;
+    TapState runEndState = TapState::Idle;
+
+    // Scratch for header + body + trailer
+    std::vector<uint32_t> outTdi, outTdo, outMask, captured;
+
+    size_t statements = 0;
+    uint64_t shiftedBits = 0;
+    std::string error;
+
+    void endToken();
+    bool execute();
+    bool fail(const std::string& message);
+
+    bool doScan(bool ir);
+    bool parseScan(Scan& scan);
+    bool doRunTest();
+    bool doState();
+    bool doEndState(TapState& target);
+    bool doFrequency();
+    bool doTrst();
+
+    static bool parseState(const std::string& name, TapState& out);
+    static bool parseHex(const std::string& token, size_t bits, std::vector<uint32_t>& out);
+    static void copyBits(std::vector<uint32_t>& dst, size_t offset, const std::vector<uint32_t>& src, size_t bits);
+};
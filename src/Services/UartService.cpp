@@ -2,6 +2,8 @@
 
 void UartService::configure(unsigned long baud, uint32_t config, uint8_t rx, uint8_t tx, bool inverted) {
     Serial1.end();
+    // Room for bursts at high baud while the terminal side is busy
+    Serial1.setRxBufferSize(UART_RX_RING_SIZE);
     Serial1.begin(baud, config, rx, tx, inverted);
 
     if (!buffersAllocated) {
@@ -105,47 +107,65 @@ void UartService::write(const std::string& str) {
     Serial1.write(reinterpret_cast<const uint8_t*>(str.c_str()), str.length());
 }
 
-std::string UartService::executeByteCode(const std::vector<ByteCode>& bytecodes) {
-    std::string result;
+size_t UartService::readBytes(uint8_t* buffer, size_t length) {
+    int available = Serial1.available();
+    if (available <= 0) return 0;
+    return Serial1.read(buffer, std::min<size_t>(length, available));
+}
+
+size_t UartService::writeBytes(const uint8_t* data, size_t length) {
+    return Serial1.write(data, length);
+}
+
+void UartService::startOverflowCounter() {
+    overflowCount = 0;
+    Serial1.onReceiveError([this](hardwareSerial_error_t err) {
+        if (err == UART_BUFFER_FULL_ERROR || err == UART_FIFO_OVF_ERROR) overflowCount++;
+    });
+}
+
+void UartService::stopOverflowCounter() {
+    Serial1.onReceiveError(nullptr);
+}
+
+void UartService::executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink) {
+    CompiledByteCode program = ByteCodeTransformer::compile(bytecodes);
     uint32_t timeout = 2000; // 2 secondes
-    uint32_t start;
-    uint32_t received = 0;
 
-    for (const ByteCode& code : bytecodes) {
-        switch (code.getCommand()) {
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
             case ByteCodeEnum::Write:
-                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
-                    Serial1.write(code.getData());
-                }
+                Serial1.write(program.getData(op), op.length);
                 break;
 
-            case ByteCodeEnum::Read:
-                start = millis();
-                while (received < code.getRepeat() && (millis() - start < timeout)) {
-                    if (Serial1.available()) {
-                        char c = Serial1.read();
-                        result += c;
-                        ++received;
+            case ByteCodeEnum::Read: {
+                uint32_t received = 0;
+                uint32_t start = millis();
+                while (received < op.length && (millis() - start < timeout)) {
+                    int avail = Serial1.available();
+                    if (avail > 0) {
+                        // Drain what is buffered in one go
+                        uint8_t buf[64];
+                        size_t n = std::min<size_t>({(size_t)avail, sizeof(buf), (size_t)(op.length - received)});
+                        n = Serial1.readBytes(buf, n);
+                        sink.onData(buf, n);
+                        received += n;
                     } else {
                         delay(10);
                     }
                 }
                 break;
-
-            case ByteCodeEnum::DelayMs:
-                delay(code.getRepeat());
-                break;
+            }
 
             case ByteCodeEnum::DelayUs:
-                delayMicroseconds(code.getRepeat());
+                if (op.length >= 1000) delay(op.length / 1000);
+                delayMicroseconds(op.length % 1000);
                 break;
 
             default:
                 break;
         }
     }
-
-    return result;
 }
 
 void UartService::switchBaudrate(unsigned long newBaud) {
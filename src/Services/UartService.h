@@ -9,10 +9,14 @@
 #include "hal/uart_types.h"
 #include "soc/uart_periph.h"
 #include "Models/ByteCode.h"
+#include "Transformers/ByteCodeTransformer.h"
+#include "Interfaces/IResultSink.h"
 #include <SD.h>
 #include <map>
+#include <atomic>
 
 #define UART_PORT UART_NUM_1
+#define UART_RX_RING_SIZE 4096
 
 class UartService {
 public:
@@ -32,7 +36,12 @@ public:
     bool available() const;
     void write(char c);
     void write(const std::string& str);
-    std::string executeByteCode(const std::vector<ByteCode>& bytecodes);
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t writeBytes(const uint8_t* data, size_t length);
+    void startOverflowCounter();
+    void stopOverflowCounter();
+    uint32_t getOverflowCount() const { return overflowCount; }
+    void executeByteCode(const std::vector<ByteCode>& bytecodes, IResultSink& sink);
     void switchBaudrate(unsigned long newBaud);
     void flush();
     void clearUartBuffer();
@@ -61,6 +70,7 @@ public:
     }
 private:
     XModem xmodem;
+    std::atomic<uint32_t> overflowCount{0};
     static File* currentFile;
     int32_t xmodemBlockSize = 128;
     int8_t xmodemIdSize = 1;
@@ -0,0 +1,74 @@
+#include "WifiFrameRing.h"
+#include <esp_heap_caps.h>
+#include <stddef.h>
+#include <string.h>
+
+WifiFrameRing::~WifiFrameRing() {
+    release();
+}
+
+bool WifiFrameRing::allocate() {
+    if (slots) return true;
+
+    slots = (Frame*) heap_caps_malloc(PSRAM_FRAMES * sizeof(Frame), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (slots) {
+        capacity = PSRAM_FRAMES;
+    } else {
+        slots = (Frame*) heap_caps_malloc(INTERNAL_FRAMES * sizeof(Frame), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!slots) return false;
+        capacity = INTERNAL_FRAMES;
+    }
+
+    mask = capacity - 1;
+    clear();
+    return true;
+}
+
+void WifiFrameRing::release() {
+    if (slots) heap_caps_free(slots);
+    slots = nullptr;
+    capacity = 0;
+    mask = 0;
+}
+
+void WifiFrameRing::clear() {
+    head.store(0);
+    tail.store(0);
+    received.store(0);
+    dropped.store(0);
+}
+
+bool WifiFrameRing::push(uint32_t timestampUs, int8_t rssi, uint8_t channel, uint8_t type,
+                         const uint8_t* payload, uint16_t length) {
+    if (!slots) return false;
+    received.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Frame& f = slots[h & mask];
+    f.timestampUs = timestampUs;
+    f.length = length;
+    f.captured = length < SNAP_LEN ? length : SNAP_LEN;
+    f.rssi = rssi;
+    f.channel = channel;
+    f.type = type;
+    memcpy(f.data, payload, f.captured);
+
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool WifiFrameRing::pop(Frame& out) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+
+    const Frame& f = slots[t & mask];
+    memcpy(&out, &f, offsetof(Frame, data) + f.captured);
+
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Preallocated single producer / single consumer ring of received 802.11
+// frames. The promiscuous RX callback only copies the first SNAP_LEN bytes
+// and the RX metadata into a free slot, formatting and file output happen
+// in the consumer task.
+class WifiFrameRing {
+public:
+    static constexpr uint16_t SNAP_LEN = 256;
+
+    struct Frame {
+        uint32_t timestampUs;   // rx_ctrl.timestamp, local µs
+        uint16_t length;        // on air length, FCS included
+        uint16_t captured;      // bytes in data
+        int8_t rssi;
+        uint8_t channel;
+        uint8_t type;           // wifi_promiscuous_pkt_type_t
+        uint8_t reserved;
+        uint8_t data[SNAP_LEN];
+    };
+
+    ~WifiFrameRing();
+
+    // Deep ring in PSRAM when the board has it, short one in internal RAM otherwise
+    bool allocate();
+    void release();
+    void clear();
+
+    // Producer, the RX callback
+    bool push(uint32_t timestampUs, int8_t rssi, uint8_t channel, uint8_t type,
+              const uint8_t* payload, uint16_t length);
+
+    // Consumer, returns false when empty
+    bool pop(Frame& out);
+
+    uint32_t getCapacity() const { return capacity; }
+    uint32_t getReceivedCount() const { return received.load(); }
+    uint32_t getDroppedCount() const { return dropped.load(); }
+
+private:
+    static constexpr uint32_t PSRAM_FRAMES = 1024;      // powers of two
+    static constexpr uint32_t INTERNAL_FRAMES = 64;
+
+    Frame* slots = nullptr;
+    uint32_t capacity = 0;
+    uint32_t mask = 0;
+    std::atomic<uint32_t> head{0};      // written by the producer
+    std::atomic<uint32_t> tail{0};      // written by the consumer
+    std::atomic<uint32_t> received{0};
+    std::atomic<uint32_t> dropped{0};
+};
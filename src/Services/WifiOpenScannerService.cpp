@@ -44,6 +44,11 @@ void WifiOpenScannerService::openProbeTaskThunk(void* arg) {
     vTaskDelete(nullptr);
 }
 
+void WifiOpenScannerService::setChannels(uint16_t mask, uint8_t pinned) {
+    channelMask = mask;
+    pinnedChannel = pinned;
+}
+
 bool WifiOpenScannerService::isOpenAuth(int enc) {
     return enc == WIFI_AUTH_OPEN;
 }
@@ -80,7 +85,8 @@ void WifiOpenScannerService::openProbeTask(uint32_t scanIntervalMs) {
 
 int WifiOpenScannerService::doScan(bool showHidden, unsigned long& outScanMs) {
     unsigned long t0 = millis();
-    int n = WiFi.scanNetworks(/*async=*/false, showHidden);
+    // A pinned channel is scanned alone, much shorter than a full sweep
+    int n = WiFi.scanNetworks(/*async=*/false, showHidden, /*passive=*/false, /*max_ms_per_chan=*/300, pinnedChannel);
     outScanMs = millis() - t0;
 
     // recovery 
@@ -108,6 +114,17 @@ void WifiOpenScannerService::processOneNetwork(int idx) {
     const int enc = WiFi.encryptionType(idx);
     const bool open = isOpenAuth(enc);
     const std::string ssid = getSsid(idx);
+    const int channel = WiFi.channel(idx);
+
+    // Channel skipped with the hop command
+    if (channel < 0 || channel > 15 || !(channelMask & (1u << channel))) {
+        char skip[256];
+        snprintf(skip, sizeof(skip),
+                 "[SKIP] SSID=\"%s\" CH=%d (channel excluded)",
+                 ssid.c_str(), channel);
+        pushProbeLog(skip);
+        return;
+    }
 
     // only open networks
     if (!open) {
@@ -14,6 +14,9 @@ public:
     void stopOpenProbe();
     bool isOpenProbeRunning() const { return openProbeRunning.load(); }
 
+    // Bit n set when channel n may be probed, scans only pinnedChannel when it is not 0
+    void setChannels(uint16_t channelMask, uint8_t pinnedChannel = 0);
+
     // Fetch logs from the probe task
     std::vector<std::string> fetchProbeLog();
     void clearProbeLog();
@@ -48,5 +51,7 @@ private:
 
     // State
     std::atomic<bool> openProbeRunning{false};
+    uint16_t channelMask = 0x3FFE;      // channels 1..13
+    uint8_t pinnedChannel = 0;
     TaskHandle_t openProbeHandle = nullptr;
 };
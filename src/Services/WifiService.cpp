@@ -203,89 +203,54 @@ std::string WifiService::encryptionTypeToString(wifi_auth_mode_t enc) {
     }
 }
 
-int8_t WifiService::scanRssiOnChannel(uint8_t channel)
-{
-    // reset old results
-    esp_wifi_clear_ap_list();
+bool WifiService::startPassiveSniffing(PcapTransformer::Sink pcapSink, bool decodeFrames) {
+    disconnect();
 
-    wifi_scan_config_t config{};
-    config.channel = channel;
-    config.show_hidden = true;
-    config.scan_type = WIFI_SCAN_TYPE_PASSIVE;
-    config.scan_time.passive = 200; 
+    esp_wifi_set_promiscuous(false);
+    esp_wifi_stop();
+    esp_wifi_set_promiscuous_rx_cb(nullptr);
 
-    esp_err_t err = esp_wifi_scan_start(&config, true);
-    if (err != ESP_OK) {
-        esp_wifi_clear_ap_list();
-        return -127;
+    if (isConnected()) {
+        esp_wifi_deinit();
     }
+    delay(300);
 
-    uint16_t apCount = 0;
-    err = esp_wifi_scan_get_ap_num(&apCount);
-    if (err != ESP_OK || apCount == 0) {
-        esp_wifi_clear_ap_list();
-        return -127;
+    sniffDecode = decodeFrames || pcapSink;
+    if (sniffDecode && !sniffRing.allocate()) return false;
+    sniffRing.clear();
+    sniffClockUs = 0;
+    lastFrameUs = 0;
+    {
+        std::lock_guard<std::mutex> lock(sniffMutex);
+        sniffLog.clear();
+        sniffNodes.clear();
+        sniffStats = WifiSniffStats();
     }
 
-    const uint16_t MAX_AP = 32;
-    if (apCount > MAX_AP) apCount = MAX_AP;
-
-    wifi_ap_record_t list[MAX_AP];
-    uint16_t n = apCount;
-
-    err = esp_wifi_scan_get_ap_records(&n, list);
-    if (err != ESP_OK || n == 0) {
-        esp_wifi_clear_ap_list();
-        return -127;
+    sniffPcap.reset();
+    if (pcapSink) {
+        sniffPcap.reset(new PcapTransformer(pcapSink));
+        if (!sniffPcap->begin(PcapTransformer::LINKTYPE_IEEE802_11_RADIOTAP, RADIOTAP_LEN + WifiFrameRing::SNAP_LEN)) {
+            sniffPcap.reset();
+            return false;
+        }
     }
 
-    int sum = 0;
-    for (uint16_t i = 0; i < n; ++i) {
-        sum += list[i].rssi;
+    for (uint8_t ch = 0; ch < 15; ++ch) {
+        channelFrames[ch].store(0);
+        channelBeacons[ch].store(0);
+        channelBeaconRssi[ch].store(0);
     }
 
-    esp_wifi_clear_ap_list();
-    return sum / (int)n;
-}
-
-void WifiService::pktCountCb(void* buf, wifi_promiscuous_pkt_type_t)
-{
-    (void)buf;
-    g_pktCount++;
-}
-
-uint32_t WifiService::countPacketsOnChannel(uint8_t channel, uint16_t dwellMs)
-{
-    esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
-
-    g_pktCount = 0;
-
-    esp_wifi_set_promiscuous(false);
-    esp_wifi_set_promiscuous_rx_cb(&pktCountCb);
-    esp_wifi_set_promiscuous(true);
-
-    uint32_t start = millis();
-    while (millis() - start < dwellMs) {
-        delay(1);
-    }
-
-    esp_wifi_set_promiscuous(false);
-    esp_wifi_set_promiscuous_rx_cb(nullptr);
-
-    return g_pktCount;
-}
-
-void WifiService::startPassiveSniffing() {
-    disconnect();
-
-    esp_wifi_set_promiscuous(false);
-    esp_wifi_stop();
-    esp_wifi_set_promiscuous_rx_cb(nullptr);
-
-    if (isConnected()) {
-        esp_wifi_deinit();
+    sniffRunning = true;
+    sniffTaskDone = !sniffDecode;
+    if (sniffDecode && xTaskCreatePinnedToCore(sniffTask, "WifiSniff", 6144, this, 2, &sniffTaskHandle, 1) != pdPASS) {
+        sniffTaskHandle = nullptr;
+        sniffRunning = false;
+        sniffTaskDone = true;
+        sniffPcap.reset();
+        return false;
     }
-    delay(300);
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     esp_wifi_init(&cfg);
@@ -293,60 +258,208 @@ void WifiService::startPassiveSniffing() {
 
     esp_wifi_set_promiscuous(true);
     esp_wifi_set_promiscuous_rx_cb(&WifiService::snifferCallback);
+    return true;
 }
 
 void WifiService::stopPassiveSniffing() {
     esp_wifi_set_promiscuous(false);
     esp_wifi_set_promiscuous_rx_cb(nullptr);
+
+    // The task drains what is left in the ring into sniffPcap before it exits,
+    // a full PSRAM ring going to LittleFS can take a while, wait for all of it
+    sniffRunning = false;
+    if (sniffTaskHandle) xTaskNotifyGive(sniffTaskHandle);
+    while (!sniffTaskDone) delay(1);
+    sniffTaskHandle = nullptr;
+
+    if (sniffPcap) {
+        bool ok = sniffPcap->end();
+        std::lock_guard<std::mutex> lock(sniffMutex);
+        sniffStats.saved = sniffPcap->getPacketCount();
+        sniffStats.savedBytes = sniffPcap->getBytesWritten();
+        sniffStats.pcapError = !ok;
+        sniffPcap.reset();
+    }
+
     esp_wifi_stop();
     esp_wifi_deinit();
-    sniffLog.clear();
     WiFi.mode(WIFI_STA);
     WiFi.disconnect(true);
 }
 
-void WifiService::snifferCallback(void* buf, wifi_promiscuous_pkt_type_t) {
+void WifiService::snifferCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    // Runs in the Wi-Fi task, count, copy and leave
     const wifi_promiscuous_pkt_t* pkt = reinterpret_cast<wifi_promiscuous_pkt_t*>(buf);
-    const uint8_t* payload = pkt->payload;
-    int len = pkt->rx_ctrl.sig_len;
-
-    int8_t rssi = pkt->rx_ctrl.rssi;
     uint8_t ch = pkt->rx_ctrl.channel;
+    if (ch < 15) {
+        channelFrames[ch].fetch_add(1, std::memory_order_relaxed);
+        if (type == WIFI_PKT_MGMT && pkt->rx_ctrl.sig_len > 0 && pkt->payload[0] == 0x80) {
+            channelBeacons[ch].fetch_add(1, std::memory_order_relaxed);
+            channelBeaconRssi[ch].fetch_add(pkt->rx_ctrl.rssi, std::memory_order_relaxed);
+        }
+    }
+
+    if (!sniffDecode) return;
+    sniffRing.push(pkt->rx_ctrl.timestamp, pkt->rx_ctrl.rssi, ch, (uint8_t)type,
+                   pkt->payload, pkt->rx_ctrl.sig_len);
+}
+
+void WifiService::sniffTask(void* arg) {
+    WifiService* self = static_cast<WifiService*>(arg);
+    WifiFrameRing::Frame* frame = new WifiFrameRing::Frame;
+
+    while (true) {
+        bool running = self->sniffRunning;
+        while (sniffRing.pop(*frame)) self->processFrame(*frame);
+        if (!running) break;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5));
+    }
+
+    delete frame;
+    self->sniffTaskDone = true;
+    vTaskDelete(nullptr);
+}
+
+void WifiService::processFrame(const WifiFrameRing::Frame& frame) {
+    // 32-bit µs counter wraps every ~71 minutes
+    if (sniffClockUs == 0) sniffClockUs = frame.timestampUs;
+    else sniffClockUs += (uint32_t)(frame.timestampUs - lastFrameUs);
+    lastFrameUs = frame.timestampUs;
+
+    if (sniffPcap) {
+        uint8_t radiotap[RADIOTAP_LEN];
+        size_t headerLen = buildRadiotap(frame, radiotap);
+        sniffPcap->append(sniffClockUs, radiotap, headerLen, frame.data, frame.captured, frame.length);
+    }
+
+    if (frame.captured < 2) return;
 
     uint8_t type = 0, subtype = 0;
-    extractTypeSubtype(payload, type, subtype);
-    std::string typeStr = getFrameTypeName(type, subtype);
-    std::string macStr = formatMac(payload + 10);
-
-    std::string line = "CH:" + std::to_string(ch) +
-                       " RSSI:" + std::to_string(rssi) +
-                       " Type:" + typeStr;
-
-    // Add SSID if possible
-    if (type == 0 && (subtype == 8 || subtype == 4)) {
-        std::string ssid = parseSsidFromPacket(payload, len, type, subtype);
-        if (!ssid.empty()) {
-            line += " SSID:\"" + ssid + "\"";
-        }
+    extractTypeSubtype(frame.data, type, subtype);
+
+    std::string ssid;
+    if (type == 0 && (subtype == 8 || subtype == 5 || subtype == 4)) {
+        // Probe responses carry the same fixed fields as beacons
+        ssid = parseSsidFromPacket(frame.data, frame.captured, type, subtype == 5 ? 8 : subtype);
+    }
+
+    std::string line = "CH:" + std::to_string(frame.channel) +
+                       " RSSI:" + std::to_string(frame.rssi) +
+                       " Type:" + getFrameTypeName(type, subtype);
+    if (!ssid.empty()) line += " SSID:\"" + ssid + "\"";
+    if (frame.captured >= 16) line += " MAC:" + formatMac(frame.data + 10);
+
+    std::lock_guard<std::mutex> lock(sniffMutex);
+    if (sniffLog.size() < SNIFF_LOG_MAX) sniffLog.push_back(std::move(line));
+    else sniffStats.logDropped++;
+
+    updateNode(frame, type, subtype, ssid);
+}
+
+void WifiService::updateNode(const WifiFrameRing::Frame& frame, uint8_t type, uint8_t subtype, const std::string& ssid) {
+    // Control frames only name the peers, short ones like ACK not even the transmitter
+    if (type == 1 || frame.captured < 24) return;
+
+    const uint8_t* addr1 = frame.data + 4;
+    const uint8_t* addr2 = frame.data + 10;
+    const uint8_t* addr3 = frame.data + 16;
+
+    uint64_t key = 0;
+    for (int i = 0; i < 6; ++i) key = (key << 8) | addr2[i];
+
+    auto it = sniffNodes.find(key);
+    if (it == sniffNodes.end()) {
+        if (sniffNodes.size() >= SNIFF_NODES_MAX) return;
+        WifiSniffNode node;
+        node.mac = formatMac(addr2);
+        it = sniffNodes.emplace(key, node).first;
     }
 
-    line += " MAC:" + macStr;
+    WifiSniffNode& node = it->second;
+    node.frames++;
+    node.rssi = frame.rssi;
+    node.channel = frame.channel;
+
+    // Which address is the BSSID depends on the DS bits of data frames
+    const uint8_t* bssid = addr3;
+    if (type == 2) {
+        uint8_t ds = frame.data[1] & 0x03;
+        if (ds == 0x01) bssid = addr1;          // to the AP
+        else if (ds == 0x02) bssid = addr2;     // from the AP
+        else if (ds == 0x03) return;            // WDS, no single BSSID
+    }
 
-    portENTER_CRITICAL(&sniffMux);
-    if (sniffLog.size() < 200) sniffLog.push_back(line);
-    portEXIT_CRITICAL(&sniffMux);
+    static const uint8_t broadcast[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    if (memcmp(bssid, broadcast, 6) != 0) node.bssid = formatMac(bssid);
+
+    if (type == 0 && (subtype == 8 || subtype == 5)) {
+        node.accessPoint = true;
+        if (!ssid.empty()) node.ssid = ssid;
+    } else if (type == 2 && bssid == addr2) {
+        node.accessPoint = true;
+    }
+}
+
+size_t WifiService::buildRadiotap(const WifiFrameRing::Frame& frame, uint8_t* out) {
+    // Flags, Channel and dBm antenna signal, fields naturally aligned after the 8 byte header
+    const uint32_t present = (1u << 1) | (1u << 3) | (1u << 5);
+    uint16_t freq = frame.channel == 14 ? 2484 : 2407 + 5 * frame.channel;
+    const uint16_t channelFlags = 0x0080;   // 2 GHz
+
+    out[0] = 0;                             // version
+    out[1] = 0;
+    out[2] = RADIOTAP_LEN;
+    out[3] = 0;
+    out[4] = present & 0xFF;
+    out[5] = (present >> 8) & 0xFF;
+    out[6] = (present >> 16) & 0xFF;
+    out[7] = (present >> 24) & 0xFF;
+    out[8] = 0x10;                          // frames end with the FCS
+    out[9] = 0;                             // channel is 16-bit aligned
+    out[10] = freq & 0xFF;
+    out[11] = freq >> 8;
+    out[12] = channelFlags & 0xFF;
+    out[13] = channelFlags >> 8;
+    out[14] = (uint8_t)frame.rssi;
+    return RADIOTAP_LEN;
 }
 
 std::vector<std::string> WifiService::getSniffLog() {
     std::vector<std::string> copy;
 
-    portENTER_CRITICAL(&sniffMux);
+    std::lock_guard<std::mutex> lock(sniffMutex);
     copy.swap(sniffLog);
-    portEXIT_CRITICAL(&sniffMux);
 
     return copy;
 }
 
+std::vector<WifiSniffNode> WifiService::getSniffNodes() {
+    std::vector<WifiSniffNode> nodes;
+
+    std::lock_guard<std::mutex> lock(sniffMutex);
+    nodes.reserve(sniffNodes.size());
+    for (const auto& entry : sniffNodes) nodes.push_back(entry.second);
+
+    return nodes;
+}
+
+WifiChannelCounters WifiService::getChannelCounters(uint8_t channel) const {
+    WifiChannelCounters counters;
+    if (channel >= 15) return counters;
+    counters.frames = channelFrames[channel].load();
+    counters.beacons = channelBeacons[channel].load();
+    counters.beaconRssiSum = channelBeaconRssi[channel].load();
+    return counters;
+}
+
+WifiSniffStats WifiService::getSniffStats() {
+    std::lock_guard<std::mutex> lock(sniffMutex);
+    WifiSniffStats stats = sniffStats;
+    stats.received = sniffRing.getReceivedCount();
+    stats.dropped = sniffRing.getDroppedCount();
+    return stats;
+}
+
 bool WifiService::switchChannel(uint8_t channel) {
     esp_err_t err = esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
     return err == ESP_OK;
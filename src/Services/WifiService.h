@@ -4,6 +4,12 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include "Services/WifiFrameRing.h"
+#include "Transformers/PcapTransformer.h"
 
 extern "C" {
   #include "esp_wifi.h"
@@ -29,6 +35,33 @@ struct SniffedPacket {
     uint8_t type;
 };
 
+// One transmitter seen while sniffing
+struct WifiSniffNode {
+    std::string mac;
+    std::string bssid;      // empty until a frame tells which network it belongs to
+    std::string ssid;
+    bool accessPoint = false;
+    uint32_t frames = 0;
+    int8_t rssi = 0;        // last frame
+    uint8_t channel = 0;
+};
+
+// Running totals per channel, counted in the RX callback
+struct WifiChannelCounters {
+    uint32_t frames = 0;
+    uint32_t beacons = 0;
+    int32_t beaconRssiSum = 0;
+};
+
+struct WifiSniffStats {
+    uint32_t received = 0;      // frames given by the radio
+    uint32_t dropped = 0;       // ring full
+    uint32_t logDropped = 0;    // log lines not pulled in time
+    uint32_t saved = 0;         // PCAP records
+    size_t savedBytes = 0;
+    bool pcapError = false;
+};
+
 class WifiService {
 public:
 
@@ -84,15 +117,16 @@ public:
     std::vector<WiFiNetwork> getVulnerableNetworks(const std::vector<WiFiNetwork>& networks);
     bool isVulnerable(wifi_auth_mode_t encryption) const;
     std::string encryptionTypeToString(wifi_auth_mode_t encryption);
-    int8_t scanRssiOnChannel(uint8_t channel);
-    uint32_t countPacketsOnChannel(uint8_t channel, uint16_t dwellMs);
-    static void pktCountCb(void* buf, wifi_promiscuous_pkt_type_t);
-    inline static volatile uint32_t g_pktCount = 0; // rx callback
 
     // Sniffing passif
-    void startPassiveSniffing();
+    // Frames are written to pcapSink as a radiotap PCAP when one is given.
+    // Without decodeFrames only the channel counters are kept.
+    bool startPassiveSniffing(PcapTransformer::Sink pcapSink = nullptr, bool decodeFrames = true);
     void stopPassiveSniffing();
     std::vector<std::string> getSniffLog();
+    std::vector<WifiSniffNode> getSniffNodes();
+    WifiSniffStats getSniffStats();
+    WifiChannelCounters getChannelCounters(uint8_t channel) const;
     bool switchChannel(uint8_t channel);
     static std::string getFrameTypeSubtype(const uint8_t* payload, uint8_t& type, uint8_t& subtype);
     static std::string parseSsidFromPacket(const uint8_t* payload, int len, uint8_t type, uint8_t subtype);
@@ -106,8 +140,11 @@ public:
     // Client sniffer
     static void snifferCallback(void* buf, wifi_promiscuous_pkt_type_t type);
     static void clientSnifferCallback(void* buf, wifi_promiscuous_pkt_type_t type);
-    inline static std::vector<std::string> sniffLog = {};
-    inline static portMUX_TYPE sniffMux = portMUX_INITIALIZER_UNLOCKED;
+    inline static WifiFrameRing sniffRing;
+    inline static volatile bool sniffDecode = true;
+    inline static std::atomic<uint32_t> channelFrames[15] = {};
+    inline static std::atomic<uint32_t> channelBeacons[15] = {};
+    inline static std::atomic<int32_t> channelBeaconRssi[15] = {};
     inline static portMUX_TYPE staMux = portMUX_INITIALIZER_UNLOCKED;
     inline static std::vector<std::array<uint8_t, 6>> staList = {};
     inline static uint8_t apBSSID[6] = {};
@@ -150,4 +187,27 @@ public:
             default:                     return "?";
         }
     }
+
+private:
+    static constexpr size_t SNIFF_LOG_MAX = 512;
+    static constexpr size_t SNIFF_NODES_MAX = 256;
+    static constexpr uint8_t RADIOTAP_LEN = 15;
+
+    // Consumer side of the sniff ring, formatting, aggregation and PCAP output
+    static void sniffTask(void* arg);
+    void processFrame(const WifiFrameRing::Frame& frame);
+    void updateNode(const WifiFrameRing::Frame& frame, uint8_t type, uint8_t subtype, const std::string& ssid);
+    static size_t buildRadiotap(const WifiFrameRing::Frame& frame, uint8_t* out);
+
+    TaskHandle_t sniffTaskHandle = nullptr;
+    volatile bool sniffRunning = false;
+    volatile bool sniffTaskDone = true;
+    std::unique_ptr<PcapTransformer> sniffPcap;
+    uint64_t sniffClockUs = 0;      // frame timestamps extended past the 32-bit wrap
+    uint32_t lastFrameUs = 0;
+
+    std::mutex sniffMutex;          // log, nodes and stats shared with the CLI
+    std::vector<std::string> sniffLog;
+    std::unordered_map<uint64_t, WifiSniffNode> sniffNodes;
+    WifiSniffStats sniffStats;
 };
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "XsvfPlayer.h"
+#include <cstdio>
+#include <cstring>
+
+// XAPP503 instruction codes
+enum : uint8_t {
+    XCOMPLETE = 0x00, XTDOMASK = 0x01, XSIR = 0x02, XSDR = 0x03, XRUNTEST = 0x04,
+    XREPEAT = 0x07, XSDRSIZE = 0x08, XSDRTDO = 0x09, XSETSDRMASKS = 0x0A, XSDRINC = 0x0B,
+    XSDRB = 0x0C, XSDRC = 0x0D, XSDRE = 0x0E, XSDRTDOB = 0x0F, XSDRTDOC = 0x10, XSDRTDOE = 0x11,
+    XSTATE = 0x12, XENDIR = 0x13, XENDDR = 0x14, XSIR2 = 0x15, XCOMMENT = 0x16, XWAIT = 0x17
+};
+
+XsvfPlayer::XsvfPlayer(JtagTapEngine& tap)
+    : tap(tap) {}
+
+void XsvfPlayer::begin() {
+    pending.clear();
+    consumed = 0;
+    instructionOffset = 0;
+
+    sdrSize = 0;
+    runTest = 0;
+    repeat = 32;
+    endIr = TapState::Idle;
+    endDr = TapState::Idle;
+    tdoMask.clear();
+    tdoExpected.clear();
+
+    instructions = 0;
+    shiftedBits = 0;
+    complete = false;
+    error.clear();
+}
+
+bool XsvfPlayer::feed(const uint8_t* data, size_t len) {
+    if (!error.empty()) return false;
+    if (complete) return true;
+
+    pending.insert(pending.end(), data, data + len);
+    while (!complete) {
+        size_t size = instructionSize();
+        if (size == 0) break;
+        if (!execute(&pending[consumed])) return false;
+        consumed += size;
+        instructionOffset += size;
+        ++instructions;
+    }
+
+    // Keep only the partial instruction
+    pending.erase(pending.begin(), pending.begin() + consumed);
+    consumed = 0;
+    return true;
+}
+
+bool XsvfPlayer::finish() {
+    if (!error.empty()) return false;
+    if (!complete && pending.size() > consumed) return fail("File ends inside an instruction");
+    return true;
+}
+
+bool XsvfPlayer::fail(const std::string& message) {
+    error = message;
+    return false;
+}
+
+size_t XsvfPlayer::instructionSize() const {
+    size_t avail = pending.size() - consumed;
+    if (avail == 0) return 0;
+
+    const uint8_t* p = &pending[consumed];
+    size_t dr = bytesFor(sdrSize);
+    size_t size = 1;
+
+    switch (p[0]) {
+        case XTDOMASK: case XSDR: case XSDRB: case XSDRC: case XSDRE:
+            size = 1 + dr;
+            break;
+        case XSDRTDO: case XSETSDRMASKS: case XSDRTDOB: case XSDRTDOC: case XSDRTDOE:
+            size = 1 + 2 * dr;
+            break;
+        case XSIR:
+            if (avail < 2) return 0;
+            size = 2 + bytesFor(p[1]);
+            break;
+        case XSIR2:
+            if (avail < 3) return 0;
+            size = 3 + bytesFor((p[1] << 8) | p[2]);
+            break;
+        case XRUNTEST: case XSDRSIZE:
+            size = 5;
+            break;
+        case XREPEAT: case XSTATE: case XENDIR: case XENDDR:
+            size = 2;
+            break;
+        case XWAIT:
+            size = 7;
+            break;
+        case XCOMMENT: {
+            const void* nul = memchr(p + 1, 0, avail - 1);
+            if (!nul) return 0;
+            size = (const uint8_t*)nul - p + 1;
+            break;
+        }
+        default:
+            break;
+    }
+    return avail >= size ? size : 0;
+}
+
+bool XsvfPlayer::execute(const uint8_t* ins) {
+    size_t dr = bytesFor(sdrSize);
+
+    switch (ins[0]) {
+        case XCOMPLETE:
+            complete = true;
+            return true;
+        case XTDOMASK:
+            loadVector(ins + 1, sdrSize, tdoMask);
+            return true;
+        case XSIR:
+            return shiftIr(ins[1], ins + 2);
+        case XSIR2:
+            return shiftIr((ins[1] << 8) | ins[2], ins + 3);
+        case XSDR:
+            return shiftDr(ins + 1, nullptr, true, true, true);
+        case XSDRTDO:
+            return shiftDr(ins + 1, ins + 1 + dr, true, true, true);
+        case XSDRB:
+            return shiftDr(ins + 1, nullptr, false, true, false);
+        case XSDRC:
+            return shiftDr(ins + 1, nullptr, false, false, false);
+        case XSDRE:
+            return shiftDr(ins + 1, nullptr, false, false, true);
+        case XSDRTDOB:
+            return shiftDr(ins + 1, ins + 1 + dr, true, true, false);
+        case XSDRTDOC:
+            return shiftDr(ins + 1, ins + 1 + dr, true, false, false);
+        case XSDRTDOE:
+            return shiftDr(ins + 1, ins + 1 + dr, true, false, true);
+        case XRUNTEST:
+            runTest = readBe32(ins + 1);
+            return true;
+        case XREPEAT:
+            repeat = ins[1];
+            return true;
+        case XSDRSIZE:
+            sdrSize = readBe32(ins + 1);
+            return true;
+        case XSTATE:
+            if (ins[1] > (uint8_t)TapState::IrUpdate) return fail("Invalid XSTATE");
+            tap.goTo((TapState)ins[1]);
+            return true;
+        case XENDIR:
+            endIr = ins[1] ? TapState::IrPause : TapState::Idle;
+            return true;
+        case XENDDR:
+            endDr = ins[1] ? TapState::DrPause : TapState::Idle;
+            return true;
+        case XWAIT: {
+            if (ins[1] > (uint8_t)TapState::IrUpdate || ins[2] > (uint8_t)TapState::IrUpdate) {
+                return fail("Invalid XWAIT state");
+            }
+            uint32_t us = readBe32(ins + 3);
+            tap.goTo((TapState)ins[1]);
+            tap.wait(us, us);
+            tap.goTo((TapState)ins[2]);
+            return true;
+        }
+        case XCOMMENT:
+        case XSETSDRMASKS:
+            // Comments and the obsolete address masks do nothing on their own
+            return true;
+        case XSDRINC:
+            return fail("XSDRINC is not supported");
+        default: {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "Unknown instruction 0x%02X", ins[0]);
+            return fail(buf);
+        }
+    }
+}
+
+bool XsvfPlayer::shiftDr(const uint8_t* tdiBytes, const uint8_t* tdoBytes, bool check, bool begin, bool end) {
+    if (!begin && tap.getState() != TapState::DrShift) return fail("DR continuation outside Shift-DR");
+
+    loadVector(tdiBytes, sdrSize, tdi);
+    if (tdoBytes) loadVector(tdoBytes, sdrSize, tdoExpected);
+    if (check && tdoExpected.size() != tdi.size()) return fail("XSDR without expected TDO");
+
+    size_t words = tdi.size();
+    captured.resize(words);
+    const uint32_t* mask = tdoMask.size() == words ? tdoMask.data() : nullptr;
+
+    // Only complete XSDR/XSDRTDO shifts are retried, like the XAPP058 player
+    uint32_t waitUs = runTest;
+    int retries = begin && end ? repeat : 0;
+    for (int attempt = 0;; ++attempt) {
+        tap.shift(false, tdi.data(), check ? captured.data() : nullptr, sdrSize, end);
+        shiftedBits += sdrSize;
+        if (!check || JtagTapEngine::matches(captured.data(), tdoExpected.data(), mask, sdrSize)) break;
+
+        if (attempt >= retries) {
+            char buf[96];
+            snprintf(buf, sizeof(buf), "TDO mismatch after %d retries: expected 0x%08X, got 0x%08X",
+                     attempt, (unsigned)tdoExpected[0], (unsigned)captured[0]);
+            return fail(buf);
+        }
+
+        // Back through Pause-DR and Exit2-DR, then give the device 25% more time
+        tap.goTo(TapState::DrPause);
+        waitUs += waitUs >> 2;
+    }
+
+    if (end) runTestAfter(endDr, waitUs);
+    return true;
+}
+
+bool XsvfPlayer::shiftIr(uint32_t bits, const uint8_t* tdiBytes) {
+    loadVector(tdiBytes, bits, tdi);
+    tap.shift(true, tdi.data(), nullptr, bits, true);
+    shiftedBits += bits;
+    runTestAfter(endIr, runTest);
+    return true;
+}
+
+void XsvfPlayer::runTestAfter(TapState end, uint32_t us) {
+    tap.goTo(end);
+    if (us && end == TapState::Idle) tap.wait(us, us);
+}
+
+uint32_t XsvfPlayer::readBe32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+void XsvfPlayer::loadVector(const uint8_t* bytes, uint32_t bits, std::vector<uint32_t>& out) {
+    // Most significant byte first, the last byte holds bits 0-7
+    size_t count = bytesFor(bits);
+    out.assign((bits + 31) / 32, 0);
+    for (size_t i = 0; i < count; ++i) {
+        out[i / 4] |= (uint32_t)bytes[count - 1 - i] << (8 * (i % 4));
+    }
+    if (bits % 32) out.back() &= (1u << (bits % 32)) - 1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Services/JtagTapEngine.h"
+
+// Plays Xilinx XSVF (XAPP503) binaries through a TAP engine. Bytes are fed
+// in chunks of any size, an instruction runs once all its operands arrived.
+class XsvfPlayer {
+public:
+    explicit XsvfPlayer(JtagTapEngine& tap);
+
+    void begin();
+
+    // False once an instruction failed, the error stays until begin()
+    bool feed(const uint8_t* data, size_t len);
+    bool finish();
+
+    const std::string& getError() const { return error; }
+    size_t getOffset() const { return instructionOffset; }
+    size_t getInstructionCount() const { return instructions; }
+    uint64_t getShiftedBits() const { return shiftedBits; }
+    bool isComplete() const { return complete; }
+
+private:
+    using TapState = JtagTapEngine::TapState;
+
+    JtagTapEngine& tap;
+
+    // Bytes of the instruction being received
+    std::vector<uint8_t> pending;
+    size_t consumed = 0;
+    size_t instructionOffset = 0;
+
+    // Persistent XSVF state
+    uint32_t sdrSize = 0;
+    uint32_t runTest = 0;
+    uint8_t repeat = 32;
+    TapState endIr = TapState::Idle;
+    TapState endDr = TapState::Idle;
+    std::vector<uint32_t> tdoMask;
+    std::vector<uint32_t> tdoExpected;
+    std::vector<uint32_t> tdi;
+    std::vector<uint32_t> captured;
+
+    size_t instructions = 0;
+    uint64_t shiftedBits = 0;
+    bool complete = false;
+    std::string error;
+
+    // Size of the instruction at the front of pending, 0 until it is known
+    size_t instructionSize() const;
+    bool execute(const uint8_t* ins);
+    bool fail(const std::string& message);
+
+    bool shiftDr(const uint8_t* tdiBytes, const uint8_t* tdoBytes, bool check, bool begin, bool end);
+    bool shiftIr(uint32_t bits, const uint8_t* tdiBytes);
+    void runTestAfter(TapState end, uint32_t us);
+
+    static size_t bytesFor(uint32_t bits) { return (bits + 7) / 8; }
+    static uint32_t readBe32(const uint8_t* p);
+    static void loadVector(const uint8_t* bytes, uint32_t bits, std::vector<uint32_t>& out);
+};
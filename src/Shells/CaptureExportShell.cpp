@@ -0,0 +1,64 @@
+#include "CaptureExportShell.h"
+#include <Arduino.h>
+#include "Transformers/VcdTransformer.h"
+#include "Transformers/SigrokTransformer.h"
+
+CaptureExportShell::CaptureExportShell(ITerminalView& tv,
+                                       IInput& in,
+                                       UserInputManager& uim,
+                                       LittleFsService& lfs)
+    : terminalView(tv),
+      terminalInput(in),
+      userInputManager(uim),
+      littleFsService(lfs) {}
+
+std::unique_ptr<ICaptureWriter> CaptureExportShell::open(const std::string& baseName) {
+    int choice = userInputManager.readValidatedChoiceIndex("Capture file format", formats, formatsCount, 0);
+    if (choice < 0 || choice >= (int)formatsCount - 1) return nullptr;
+
+    if (!ensureMounted()) return nullptr;
+    if (littleFsService.freeBytes() < MIN_FREE_BYTES) {
+        terminalView.println("\n❌ Not enough LittleFS space.");
+        return nullptr;
+    }
+
+    std::string defName = baseName + "_" + std::to_string(millis() % 1000000);
+    std::string name = userInputManager.readSanitizedString("File name", defName, false);
+    if (name.empty()) name = defName;
+
+    const bool vcd = choice == 0;
+    currentPath = std::string(CAPTURE_DIR) + name + (vcd ? ".vcd" : ".sr");
+    if (littleFsService.exists(currentPath)) littleFsService.removeFile(currentPath);
+
+    // Chunks are appended as the writer flushes them
+    std::string path = currentPath;
+    auto sink = [this, path](const uint8_t* data, size_t len) {
+        return littleFsService.write(path, data, len, true);
+    };
+
+    terminalView.println("Recording to " + currentPath);
+    if (vcd) return std::unique_ptr<ICaptureWriter>(new VcdTransformer(sink));
+    return std::unique_ptr<ICaptureWriter>(new SigrokTransformer(sink));
+}
+
+void CaptureExportShell::close(std::unique_ptr<ICaptureWriter>& writer) {
+    if (!writer) return;
+
+    if (writer->end()) {
+        terminalView.println("\n✅ Saved " + currentPath + " (" + std::to_string(writer->getBytesWritten()) + " bytes)");
+    } else {
+        terminalView.println("\n❌ Failed to write: " + currentPath);
+    }
+    writer.reset();
+}
+
+bool CaptureExportShell::ensureMounted() {
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("\n ❌ LittleFS not mounted.");
+            return false;
+        }
+    }
+    return true;
+}
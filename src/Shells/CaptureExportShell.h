@@ -0,0 +1,43 @@
+#pragma once
+#include <memory>
+#include <string>
+
+#include "Interfaces/ITerminalView.h"
+#include "Interfaces/IInput.h"
+#include "Interfaces/ICaptureWriter.h"
+#include "Managers/UserInputManager.h"
+#include "Services/LittleFsService.h"
+
+class CaptureExportShell {
+public:
+    CaptureExportShell(ITerminalView& tv,
+                       IInput& in,
+                       UserInputManager& uim,
+                       LittleFsService& lfs);
+
+    // Ask for a format and a file name, nullptr when cancelled or storage is unavailable
+    std::unique_ptr<ICaptureWriter> open(const std::string& baseName);
+
+    // Finish the file and report it
+    void close(std::unique_ptr<ICaptureWriter>& writer);
+
+private:
+    ITerminalView& terminalView;
+    IInput& terminalInput;
+    UserInputManager& userInputManager;
+    LittleFsService& littleFsService;
+
+    std::string currentPath;
+
+    inline static constexpr const char* formats[] = {
+        " 📄 VCD (.vcd)",
+        " 📦 Sigrok session (.sr, 1 byte per sample)",
+        " 🚪 Cancel"
+    };
+    inline static constexpr size_t formatsCount = sizeof(formats) / sizeof(formats[0]);
+
+    inline static constexpr const char* CAPTURE_DIR = "/captures/";
+    inline static constexpr size_t MIN_FREE_BYTES = 8 * 1024;
+
+    bool ensureMounted();
+};
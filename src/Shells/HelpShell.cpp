@@ -106,9 +106,9 @@ void HelpShell::cmdGeneral() {
         "profile              - Save/load pins config",
         "alias                - Create shortcut",
         "hex [number]         - Convert dec/hex/bin",
-        "logic <pin>          - Logic analyzer",
+        "logic <pin> [pin...] - Logic analyzer",
         "analogic <pin>       - Analogic plotter",
-        "wizard <pin>         - Pin activity analyzer",
+        "wizard <pin|all>     - Pin and bus analyzer, add rec to save",
         "listen <pin>         - Pin activity to audio",
         "repeat <count> <cmd> - Repeat command",
         "P                    - Enable pull-up",
@@ -147,7 +147,7 @@ void HelpShell::cmdUart() {
         "read                 - Receive ascii data",
         "raw                  - Receive raw hex data",
         "write [text]         - Send at current baud",
-        "bridge               - Full-duplex mode",
+        "bridge [stats] [cap]  - Full-duplex mode",
         "at                   - AT commands operations",
         "emulator             - Emulate UART device",
         "trigger [pattern]    - Send response on pattern",
@@ -164,7 +164,7 @@ void HelpShell::cmdUart() {
 void HelpShell::cmdHdUart() {
     printHeader("HDUART");
     static const char* const lines[] = {
-        "bridge               - Half-duplex I/O",
+        "bridge [stats] [cap]  - Half-duplex I/O",
         "config               - Configure settings",
         "[0x1 D:10 r:255]     - Instruction syntax"
     };
@@ -309,7 +309,7 @@ void HelpShell::cmdBluetooth() {
     static const char* const lines[] = {
         "scan                 - Discover devices",
         "pair <mac>           - Pair with a device",
-        "sniff                - Sniff Bluetooth data",
+        "sniff [detail]       - Sniff Bluetooth data",
         "spoof <mac>          - Spoof mac address",
         "status               - Show current status",
         "server               - Create an HID server",
@@ -328,9 +328,10 @@ void HelpShell::cmdWifi() {
         "scan                 - List Wi-Fi networks",
         "connect              - Connect to a network",
         "ping <host>          - Ping a remote host",
-        "discovery [timeout]  - Discover network devices",
-        "sniff                - Monitor Wi-Fi packets",
+        "discovery [cidr]     - Sweep network devices",
+        "sniff [pcap]         - Monitor Wi-Fi packets",
         "waterfall            - Show channel activity",
+        "hop [pin|skip] <ch>  - Channels to sniff",
         "probe                - Search for net access",
         "repeater             - Forward Wi-Fi traffic",
         "spoof ap <mac>       - Spoof AP MAC",
@@ -360,6 +361,7 @@ void HelpShell::cmdJtag() {
     static const char* const lines[] = {
         "scan swd             - Scan SWD pins",
         "scan jtag            - Scan JTAG pins",
+        "play <file>          - Play SVF/XSVF file",
         "config               - Configure settings"
     };
     printLines(lines, (int)(sizeof(lines) / sizeof(lines[0])));
@@ -380,9 +382,10 @@ void HelpShell::cmdI2s() {
 void HelpShell::cmdCan() {
     printHeader("CAN");
     static const char* const lines[] = {
-        "sniff                - Print all received frames",
+        "sniff [log] [stats]  - Print all received frames",
         "send [id]            - Send frame with given ID",
         "receive [id]         - Capture frames with ID",
+        "filter [id[/m]...]   - Set HW acceptance filters",
         "status               - State of the CAN controller",
         "config               - Configure MCP2515 settings"
     };
@@ -395,7 +398,7 @@ void HelpShell::cmdEthernet() {
         "connect              - Connect using DHCP",
         "status               - Show ETH status",
         "ping <host>          - Ping a remote host",
-        "discovery [timeout]  - Discover network devices",
+        "discovery [cidr]     - Sweep network devices",
         "ssh [h] [u] [pw] [p] - Open SSH session",
         "telnet <host> [port] - Open telnet session",
         "nc <host> <port>     - Open netcat session",
@@ -26,6 +26,9 @@ void I2cEepromShell::run(uint8_t addr) {
         return;
     }
     
+    // 24x1025 selects its upper half with the A2 position of the device address
+    i2cService.eepromSetBlockShift(std::string(kModels[selectedModelIndex]).find("1025") != std::string::npos ? 2 : 0);
+
     // Set variables
     terminalView.println(
         std::string("\n✅ EEPROM initialized: ") + kModels[selectedModelIndex]
@@ -82,8 +85,7 @@ void I2cEepromShell::cmdAnalyze() {
         start,
         eepromSize,
         [&](uint32_t addr, uint8_t* buf, uint32_t len) {
-            for (uint32_t i = 0; i < len; ++i)
-                buf[i] = i2cService.eepromReadByte(addr + i);
+            if (!i2cService.eepromRead(addr, buf, len)) memset(buf, 0xFF, len);
         }
     );
 
@@ -124,12 +126,17 @@ void I2cEepromShell::cmdRead() {
         count = eepromSize - addr;
     }
 
+    // One sequential read for the whole range
+    std::vector<uint8_t> data(count);
+    if (!i2cService.eepromRead(addr, data.data(), count)) {
+        terminalView.println("❌ Read failed: " + i2cService.eepromGetError());
+        return;
+    }
+
     const uint8_t bytesPerLine = 16;
     for (uint16_t i = 0; i < count; i += bytesPerLine) {
-        std::vector<uint8_t> line;
-        for (uint8_t j = 0; j < bytesPerLine && (i + j) < count; ++j) {
-            line.push_back(i2cService.eepromReadByte(addr + i + j));
-        }
+        auto end = data.begin() + std::min<size_t>(i + bytesPerLine, count);
+        std::vector<uint8_t> line(data.begin() + i, end);
 
         std::string formattedLine = argTransformer.toAsciiLine(addr + i, line);
         terminalView.println(formattedLine);
@@ -141,13 +148,21 @@ void I2cEepromShell::cmdWrite() {
     auto addr = argTransformer.parseHexOrDec16("0x" + addrStr);
     auto hexStr = userInputManager.readValidatedHexString("Enter byte values (e.g., 01 A5 FF...) ", 0, true);
     auto data = argTransformer.parseHexList(hexStr);
+    bool verify = userInputManager.readYesNo("Verify after write?", true);
 
-    bool ok = true;
-    for (size_t i = 0; i < data.size(); ++i) {
-        i2cService.eepromWriteByte(addr + i, data[i]);
+    // Page writes, the next page starts as soon as the chip ACKs again
+    uint32_t t0 = millis();
+    if (!i2cService.eepromWrite(addr, data.data(), data.size(), verify)) {
+        terminalView.println("\n❌ Write failed: " + i2cService.eepromGetError());
+        return;
     }
 
-    terminalView.println("\n✅ Data written.");
+    const auto& stats = i2cService.eepromGetStats();
+    terminalView.println(
+        "\n✅ Data written" + std::string(verify ? " and verified" : "") + ": " +
+        std::to_string(data.size()) + " bytes, " + std::to_string(stats.pages) + " page(s), " +
+        std::to_string(millis() - t0) + " ms."
+    );
 }
 
 void I2cEepromShell::cmdDump(bool raw) {
@@ -159,29 +174,38 @@ void I2cEepromShell::cmdDump(bool raw) {
         if (!confirm) return;
     }
 
+    // Sequential reads in blocks, one addressing per block
     const uint8_t bytesPerLine = 16;
+    const uint32_t blockSize = 1024;
+    std::vector<uint8_t> block(blockSize);
+
+    if (!raw) terminalView.println("");
+    for (uint32_t base = 0; base < count; base += blockSize) {
+        uint32_t len = std::min(blockSize, count - base);
+        if (!i2cService.eepromRead(addr + base, block.data(), len)) {
+            terminalView.println("\n❌ Read failed: " + i2cService.eepromGetError());
+            return;
+        }
 
-    if (raw) {
-        // Mode RAW
-        for (uint32_t i = 0; i < count; ++i) {
-            uint8_t value = i2cService.eepromReadByte(addr + i);
-            terminalView.print(value); 
+        if (raw) {
+            // Mode RAW
+            for (uint32_t i = 0; i < len; ++i) {
+                terminalView.print(block[i]);
+            }
+            continue;
         }
-    } else {
+
         // Mode HEX/ASCII
-        terminalView.println("");
-        for (uint32_t i = 0; i < count; i += bytesPerLine) {
-            std::vector<uint8_t> line;
-            for (uint8_t j = 0; j < bytesPerLine && (i + j) < count; ++j) {
-                line.push_back(i2cService.eepromReadByte(addr + i + j));
-
-                char c = terminalInput.readChar();
-                if (c == '\n' || c == '\r') {
-                    terminalView.println("\n❌ Dump interrupted by user.");
-                    return;
-                }
+        for (uint32_t i = 0; i < len; i += bytesPerLine) {
+            char c = terminalInput.readChar();
+            if (c == '\n' || c == '\r') {
+                terminalView.println("\n❌ Dump interrupted by user.");
+                return;
             }
-            std::string formatted = argTransformer.toAsciiLine(addr + i, line);
+
+            auto end = block.begin() + std::min(i + bytesPerLine, len);
+            std::vector<uint8_t> line(block.begin() + i, end);
+            std::string formatted = argTransformer.toAsciiLine(addr + base + i, line);
             terminalView.println(formatted);
         }
     }
@@ -190,9 +214,17 @@ void I2cEepromShell::cmdDump(bool raw) {
 void I2cEepromShell::cmdErase() {
     bool confirm = userInputManager.readYesNo("⚠️  Are you sure you want to erase the EEPROM?", false);
     if (confirm) {
+        bool verify = userInputManager.readYesNo("Verify after erase?", true);
         terminalView.println("Erasing...");
-        i2cService.eepromErase(0xFF);
-        terminalView.println("\n✅ EEPROM erased.");
+        uint32_t t0 = millis();
+        if (!i2cService.eepromErase(0xFF, verify)) {
+            terminalView.println("\n❌ Erase failed: " + i2cService.eepromGetError());
+            return;
+        }
+        terminalView.println(
+            "\n✅ EEPROM erased" + std::string(verify ? " and verified" : "") + " in " +
+            std::to_string(millis() - t0) + " ms (" + std::to_string(i2cService.eepromGetStats().pages) + " pages)."
+        );
     } else {
         terminalView.println("\n❌ Operation cancelled.");
     }
@@ -186,7 +186,8 @@ void OneWireEepromShell::cmdAnalyze() {
             auto chunk = oneWireService.eeprom2431Dump(addr, len);
             memcpy(buf, chunk.data(), len);
         },
-        32 // Block size
+        32,  // Block size
+        true // Bit-banged 1-Wire slots, keep reads off the Wi-Fi/BT core
     );
 
     // Format summary and display results
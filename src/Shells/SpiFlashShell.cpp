@@ -6,19 +6,26 @@ SpiFlashShell::SpiFlashShell(
     IInput& input,
     ArgTransformer& argTransformer,
     UserInputManager& userInputManager,
-    BinaryAnalyzer& binaryAnalyzer
+    BinaryAnalyzer& binaryAnalyzer,
+    LittleFsService& littleFsService
 )
     : spiService(spiService),
       terminalView(view),
       terminalInput(input),
       argTransformer(argTransformer),
       userInputManager(userInputManager),
-      binaryAnalyzer(binaryAnalyzer)
+      binaryAnalyzer(binaryAnalyzer),
+      littleFsService(littleFsService)
 {
     // Nothing
 }
 
 void SpiFlashShell::run() {
+    // Chip may have changed since last session
+    readModeSelected = false;
+    flashParamsLoaded = false;
+    spiService.setFlashReadMode(FlashReadModeEnum::Standard);
+
     while (true) {
         terminalView.println("\n=== SPI Flash Shell ===");
 
@@ -27,6 +34,7 @@ void SpiFlashShell::run() {
 
         // Quit
         if (index == -1 || actions[index] == "🚪 Exit Shell") {
+            spiService.setFlashAddressBytes(3);
             terminalView.println("Exiting SPI Flash Shell...\n");
             break;
         }
@@ -42,6 +50,7 @@ void SpiFlashShell::run() {
             case 6: cmdDump();    break;
             case 7: cmdDump(true); break;
             case 8: cmdErase();   break;
+            case 9: cmdSpeed();   break;
             default:
                 terminalView.println("Unknown action.\n");
                 break;
@@ -74,6 +83,42 @@ void SpiFlashShell::cmdProbe() {
 
     const FlashChipInfo* chip = findFlashInfo(id[0], id[1], id[2]);
 
+    // Read command used for dumps
+    selectReadMode(true);
+    terminalView.println("Read mode: " + FlashReadModeEnumMapper::toString(spiService.getFlashReadMode()));
+
+    // SFDP parameters
+    if (sfdpInfo.valid) {
+        std::stringstream sfdp;
+        sfdp << "SFDP: rev " << (int)sfdpInfo.revisionMajor << "." << (int)sfdpInfo.revisionMinor
+             << (sfdpFromCache ? " (cached)" : "") << "\n"
+             << "  Capacity: " << (sfdpInfo.capacityBytes >> 10) << " KB, page " << sfdpInfo.pageSize << " bytes\n"
+             << "  Addressing: " << (sfdpInfo.address3Byte ? "3" : "")
+             << (sfdpInfo.address3Byte && sfdpInfo.address4Byte ? "/" : "")
+             << (sfdpInfo.address4Byte ? "4" : "") << " bytes\n"
+             << "  Erase:";
+        for (const auto& e : sfdpInfo.eraseTypes) {
+            if (e.size == 0) continue;
+            sfdp << " " << (e.size >> 10) << "KB (0x" << std::hex << std::uppercase
+                 << std::setw(2) << std::setfill('0') << (int)e.opcode << std::dec << ")";
+        }
+        sfdp << "\n  Reads:";
+        const std::pair<const char*, const FlashSfdpInfo::ReadMode*> reads[] = {
+            {"1-1-1", &sfdpInfo.fastRead}, {"1-1-2", &sfdpInfo.dualOutputRead},
+            {"1-2-2", &sfdpInfo.dualIoRead}, {"1-1-4", &sfdpInfo.quadOutputRead},
+            {"1-4-4", &sfdpInfo.quadIoRead}
+        };
+        for (const auto& r : reads) {
+            if (!r.second->supported) continue;
+            sfdp << " " << r.first << " 0x" << std::hex << std::uppercase << std::setw(2)
+                 << std::setfill('0') << (int)r.second->opcode << std::dec
+                 << "/" << (int)r.second->dummyClocks << "clk";
+        }
+        terminalView.println(sfdp.str());
+    } else {
+        terminalView.println("SFDP: not supported");
+    }
+
     // Known in database
     if (chip) {
         terminalView.println("Manufacturer: " + std::string(chip->manufacturerName));
@@ -104,16 +149,14 @@ Flash Analyze
 */
 void SpiFlashShell::cmdAnalyze() {
     if (!checkFlashPresent()) return;
+    selectReadMode();
 
     // Start address if any
     uint32_t start = 0;
     terminalView.println("\nSPI Flash Analyze: SPI Flash from 0x00000000... Press [ENTER] to stop.");
 
     // Get flash size
-    uint8_t id[3];
-    spiService.readFlashIdRaw(id);
-    const FlashChipInfo* chip = findFlashInfo(id[0], id[1], id[2]);
-    uint32_t flashSize = chip ? chip->capacityBytes : spiService.calculateFlashCapacity(id[2]);
+    uint32_t flashSize = readFlashCapacity();
 
     // Analyze
     BinaryAnalyzer::AnalysisResult result = binaryAnalyzer.analyze(
@@ -155,6 +198,7 @@ Flash Strings
 void SpiFlashShell::cmdStrings() {
     // Check chip presence
     if (!checkFlashPresent()) return;
+    selectReadMode();
 
     // Validate and parse args
     uint8_t minStringLen = userInputManager.readValidatedUint8("Min. length of the strings:", 10);
@@ -170,10 +214,7 @@ void SpiFlashShell::cmdStrings() {
     bool inString = false;
 
     // Get flash size
-    uint8_t id[3];
-    spiService.readFlashIdRaw(id);
-    const FlashChipInfo* chip = findFlashInfo(id[0], id[1], id[2]);
-    uint32_t flashSize = chip ? chip->capacityBytes : spiService.calculateFlashCapacity(id[2]);
+    uint32_t flashSize = readFlashCapacity();
 
     // Read flash in chuncks
     for (uint32_t addr = 0; addr < flashSize; addr += blockSize) {
@@ -225,6 +266,7 @@ Flash Search
 void SpiFlashShell::cmdSearch() {
     // Check chip presence
     if (!checkFlashPresent()) return;
+    selectReadMode();
 
     auto startAddr = 0;
 
@@ -239,10 +281,7 @@ void SpiFlashShell::cmdSearch() {
     uint8_t buffer[blockSize + 32];
 
     // Get flash size
-    uint8_t id[3];
-    spiService.readFlashIdRaw(id);
-    const FlashChipInfo* chip = findFlashInfo(id[0], id[1], id[2]);
-    uint32_t flashSize = chip ? chip->capacityBytes : spiService.calculateFlashCapacity(id[2]);
+    uint32_t flashSize = readFlashCapacity();
 
     // Read flash in chunks
     for (uint32_t addr = startAddr; addr < flashSize; addr += blockSize - pattern.size()) {
@@ -308,6 +347,7 @@ Flash Read
 void SpiFlashShell::cmdRead() {
     // Check chip presence
     if (!checkFlashPresent()) return;
+    selectReadMode();
     
     auto addrStr = userInputManager.readValidatedHexString("Start address (e.g., 00FF00) ", 0, true);
     auto address = argTransformer.parseHexOrDec16("0x" + addrStr);
@@ -389,6 +429,10 @@ void SpiFlashShell::readFlashInChunksRaw(uint32_t address, uint32_t length) {
 }
 
 uint32_t SpiFlashShell::readFlashCapacity() {
+    // SFDP is authoritative when available
+    loadFlashParams();
+    if (sfdpInfo.valid) return sfdpInfo.capacityBytes;
+
     // Verify flash capacity
     uint8_t id[3];
     spiService.readFlashIdRaw(id);
@@ -467,18 +511,23 @@ void SpiFlashShell::cmdErase() {
     }
 
     uint32_t freq = state.getSpiFrequency();
-    const uint32_t sectorSize = 4096; // standard
     uint32_t flashSize = readFlashCapacity();
 
-    // Erase sectors and display progression
-    const uint32_t totalSectors = flashSize / sectorSize;
+    // Largest erase block reported by SFDP, 4 KB sector otherwise
+    FlashSfdpInfo::EraseType erase = sfdpInfo.largestErase();
+    const uint32_t blockSize = erase.size;
+    terminalView.println("Erase block: " + std::to_string(blockSize / 1024) + " KB");
+
+    // Erase blocks and display progression
+    const uint32_t totalBlocks = flashSize / blockSize;
+    const uint32_t dotEvery = std::max<uint32_t>(1, (256UL * 1024UL) / blockSize);
     terminalView.print("In progress");
-    for (uint32_t i = 0; i < totalSectors; ++i) {
-        uint32_t addr = i * sectorSize;
-        spiService.eraseFlashSector(addr, freq);
+    for (uint32_t i = 0; i < totalBlocks; ++i) {
+        uint32_t addr = i * blockSize;
+        spiService.eraseFlashBlock(addr, erase.opcode, freq);
 
         // Display a dot
-        if (i % 64 == 0) terminalView.print(".");
+        if (i % dotEvery == 0) terminalView.print(".");
     }
 
     terminalView.println("\r\nSPI Flash Erase: Complete.\n");
@@ -489,6 +538,7 @@ Flash Dump
 */
 void SpiFlashShell::cmdDump(bool raw) {
     if (!checkFlashPresent()) return;
+    selectReadMode();
 
     terminalView.println("\nSPI Flash: Full dump from 0x000000... Press [ENTER] to stop.\n");
 
@@ -508,6 +558,179 @@ void SpiFlashShell::cmdDump(bool raw) {
 }
 
 
+/*
+Flash Read Speed
+*/
+void SpiFlashShell::cmdSpeed() {
+    if (!checkFlashPresent()) return;
+    selectReadMode();
+
+    const uint32_t baseFreq = state.getSpiFrequency();
+    const uint32_t window = std::min<uint32_t>(256UL * 1024UL, readFlashCapacity());
+
+    // Configured clock first, then faster ones
+    std::vector<uint32_t> candidates = { baseFreq };
+    for (uint32_t f : { 10000000UL, 20000000UL, 40000000UL, 80000000UL }) {
+        if (f > baseFreq) candidates.push_back(f);
+    }
+
+    terminalView.println("\nSPI Flash Speed: Reading " + std::to_string(window / 1024) +
+                         " KB per test, checked against a 0x03 read at " +
+                         std::to_string(baseFreq / 1000) + " kHz...\n");
+
+    uint8_t ref[1024];
+    uint8_t buf[1024];
+    uint32_t bestFreq = 0;
+    float bestMbps = 0.0f;
+    FlashReadModeEnum bestMode = FlashReadModeEnum::Standard;
+
+    for (FlashReadModeEnum mode : { FlashReadModeEnum::Standard, FlashReadModeEnum::Fast }) {
+        if (mode == FlashReadModeEnum::Fast && spiService.getFlashReadMode() != FlashReadModeEnum::Fast) {
+            terminalView.println("  Fast Read (0x0B) not supported by this chip, skipped.");
+            break;
+        }
+
+        for (uint32_t freq : candidates) {
+            bool ok = true;
+            uint32_t elapsedUs = 0;
+            for (uint32_t addr = 0; addr < window; addr += sizeof(buf)) {
+                uint32_t n = std::min<uint32_t>(sizeof(buf), window - addr);
+                spiService.readFlashData(addr, ref, n, FlashReadModeEnum::Standard, baseFreq);
+
+                uint32_t t0 = micros();
+                spiService.readFlashData(addr, buf, n, mode, freq);
+                elapsedUs += micros() - t0;
+
+                if (memcmp(ref, buf, n) != 0) {
+                    ok = false;
+                    break;
+                }
+            }
+
+            std::stringstream line;
+            line << "  " << FlashReadModeEnumMapper::toString(mode) << " @ "
+                 << std::setw(5) << (freq / 1000000.0f) << " MHz: ";
+            if (ok && elapsedUs > 0) {
+                float mbps = (float)window / (float)elapsedUs; // bytes/us == MB/s
+                line << std::fixed << std::setprecision(2) << mbps << " MB/s";
+                if (mbps > bestMbps) {
+                    bestMbps = mbps;
+                    bestFreq = freq;
+                    bestMode = mode;
+                }
+            } else {
+                line << "data mismatch";
+            }
+            terminalView.println(line.str());
+
+            // Higher clocks will not do better once it fails
+            if (!ok) break;
+
+            char c = terminalInput.readChar();
+            if (c == '\r' || c == '\n') {
+                terminalView.println("\nSPI Flash Speed: Cancelled by user.\n");
+                return;
+            }
+        }
+    }
+
+    if (bestFreq == 0) {
+        terminalView.println("\nSPI Flash Speed: No reliable setting found.\n");
+        return;
+    }
+
+    terminalView.println("");
+    std::string best = FlashReadModeEnumMapper::toString(bestMode) + " @ " + std::to_string(bestFreq / 1000) + " kHz";
+    if (userInputManager.readYesNo("Use " + best + " for dumps?", true)) {
+        spiService.setFlashReadMode(bestMode, bestFreq);
+        terminalView.println("SPI Flash Speed: Dumps will use " + best + ".\n");
+    }
+}
+
+/*
+Flash Read Mode
+*/
+void SpiFlashShell::selectReadMode(bool force) {
+    if (readModeSelected && !force) return;
+    readModeSelected = true;
+
+    // SFDP chips always support 0x0B
+    loadFlashParams(force);
+    if (sfdpInfo.valid) {
+        spiService.setFlashReadMode(FlashReadModeEnum::Fast, spiService.getFlashReadFrequency());
+        return;
+    }
+
+    uint8_t id[3];
+    spiService.readFlashIdRaw(id);
+    bool known = findFlashInfo(id[0], id[1], id[2]) != nullptr;
+
+    // Compare the same bytes read with 0x03 and 0x0B
+    uint32_t freq = state.getSpiFrequency();
+    uint8_t standard[256];
+    uint8_t fast[256];
+    spiService.readFlashData(0, standard, sizeof(standard), FlashReadModeEnum::Standard, freq);
+    spiService.readFlashData(0, fast, sizeof(fast), FlashReadModeEnum::Fast, freq);
+
+    bool same = memcmp(standard, fast, sizeof(standard)) == 0;
+    bool uniform = std::all_of(standard, standard + sizeof(standard),
+                               [&](uint8_t b) { return b == standard[0]; });
+
+    // A blank area can't tell if 0x0B was understood, trust the database then
+    if (same && (known || !uniform)) {
+        spiService.setFlashReadMode(FlashReadModeEnum::Fast, spiService.getFlashReadFrequency());
+    } else {
+        spiService.setFlashReadMode(FlashReadModeEnum::Standard, spiService.getFlashReadFrequency());
+    }
+}
+
+/*
+Flash Parameters
+*/
+void SpiFlashShell::loadFlashParams(bool force) {
+    if (flashParamsLoaded && !force) return;
+    flashParamsLoaded = true;
+    sfdpFromCache = false;
+
+    uint8_t id[3];
+    spiService.readFlashIdRaw(id);
+    std::string path = sfdpCachePath(id);
+
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+    }
+
+    // Cached table from a previous session
+    std::vector<uint8_t> table;
+    std::string cached;
+    if (littleFsService.mounted() && littleFsService.exists(path) && littleFsService.readAll(path, cached)) {
+        table.assign(cached.begin(), cached.end());
+        sfdpFromCache = spiService.parseSfdpBasicTable(table, sfdpInfo);
+    }
+
+    // Read it from the chip
+    if (!sfdpFromCache) {
+        table.clear();
+        if (spiService.readSfdpBasicTable(table) && spiService.parseSfdpBasicTable(table, sfdpInfo)) {
+            if (littleFsService.mounted()) {
+                littleFsService.write(path, table.data(), table.size());
+            }
+        } else {
+            sfdpInfo = FlashSfdpInfo();
+        }
+    }
+
+    // Chips above 16 MB need 4-byte addresses
+    bool needs4Byte = sfdpInfo.valid && sfdpInfo.capacityBytes > (16UL << 20) && sfdpInfo.address4Byte;
+    spiService.setFlashAddressBytes(needs4Byte ? 4 : 3, sfdpInfo);
+}
+
+std::string SpiFlashShell::sfdpCachePath(const uint8_t* id) const {
+    char path[24];
+    snprintf(path, sizeof(path), "/sfdp/%02X%02X%02X.bin", id[0], id[1], id[2]);
+    return std::string(path);
+}
+
 /*
 Check Chip
 */
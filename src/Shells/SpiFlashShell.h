@@ -5,6 +5,8 @@
 #include "Managers/UserInputManager.h"
 #include "Transformers/ArgTransformer.h"
 #include "Services/SpiService.h"
+#include "Services/LittleFsService.h"
+#include "Models/FlashSfdpInfo.h"
 #include "Analyzers/BinaryAnalyzer.h"
 #include "Models/TerminalCommand.h"
 #include "States/GlobalState.h"
@@ -17,7 +19,8 @@ public:
         IInput& input,
         ArgTransformer& argTransformer,
         UserInputManager& userInputManager,
-        BinaryAnalyzer& binaryAnalyzer
+        BinaryAnalyzer& binaryAnalyzer,
+        LittleFsService& littleFsService
     );
 
     void run();
@@ -33,6 +36,7 @@ private:
         " 🗃️  Dump ASCII",
         " 🗃️  Dump RAW",
         " 💣 Erase Flash",
+        " ⚡ Read speed",
         "🚪 Exit Shell"
     };
     inline static constexpr size_t actionCount = sizeof(actions) / sizeof(actions[0]);
@@ -43,7 +47,12 @@ private:
     ArgTransformer& argTransformer;
     UserInputManager& userInputManager;
     BinaryAnalyzer& binaryAnalyzer;
+    LittleFsService& littleFsService;
     GlobalState& state = GlobalState::getInstance();
+    bool readModeSelected = false;
+    bool flashParamsLoaded = false;
+    bool sfdpFromCache = false;
+    FlashSfdpInfo sfdpInfo;
 
     void cmdProbe();
     void cmdAnalyze();
@@ -53,6 +62,10 @@ private:
     void cmdWrite();
     void cmdErase();
     void cmdDump(bool raw = false);
+    void cmdSpeed();
+    void selectReadMode(bool force = false);
+    void loadFlashParams(bool force = false);
+    std::string sfdpCachePath(const uint8_t* id) const;
     void readFlashInChunks(uint32_t address, uint32_t length);
     void readFlashInChunksRaw(uint32_t address, uint32_t length);
     uint32_t readFlashCapacity();
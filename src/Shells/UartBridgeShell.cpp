@@ -0,0 +1,190 @@
+#include "UartBridgeShell.h"
+#include <Arduino.h>
+
+UartBridgeShell::UartBridgeShell(ITerminalView& tv,
+                                 IDeviceView& dv,
+                                 IInput& in,
+                                 IInput& din,
+                                 UserInputManager& uim,
+                                 LittleFsService& lfs)
+    : terminalView(tv),
+      deviceView(dv),
+      terminalInput(in),
+      deviceInput(din),
+      userInputManager(uim),
+      littleFsService(lfs) {}
+
+void UartBridgeShell::run(const Port& port, bool capture, bool stats) {
+    if (capture && !openCapture(port.name)) return;
+
+    terminalView.println(port.name + " Bridge: In progress... Press [ANY ESP32 BUTTON] to stop.\n");
+
+    uint8_t rx[BLOCK_SIZE];
+    uint8_t tx[BLOCK_SIZE];
+    std::string echo;
+    size_t echoPos = 0;
+
+    Counters total, last;
+    uint32_t startMs = millis();
+    uint32_t lastStatsMs = startMs;
+    if (port.overflows) port.overflows();   // drop anything from before the bridge
+    const uint32_t droppedAtStart = terminalView.getDroppedBytes();
+
+    while (true) {
+        bool idle = true;
+
+        // UART -> terminal, one block per pass
+        size_t n = port.read(rx, sizeof(rx));
+        if (n > 0) {
+            idle = false;
+            total.rxBytes += n;
+            if (captureOk) captureBlock("RX", rx, n);
+
+            // Half duplex line reads back what we sent
+            if (port.halfDuplex && echoPos < echo.size()) {
+                size_t out = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (echoPos < echo.size() && rx[i] == (uint8_t)echo[echoPos]) {
+                        echoPos++;
+                        continue;
+                    }
+                    rx[out++] = rx[i];
+                }
+                n = out;
+                if (echoPos == echo.size()) {
+                    echo.clear();
+                    echoPos = 0;
+                }
+            }
+            if (n > 0) terminalView.write(rx, n);
+        }
+
+        // Terminal -> UART
+        size_t m = terminalInput.readBytes(tx, sizeof(tx));
+        if (m > 0) {
+            idle = false;
+            port.write(tx, m);
+            total.txBytes += m;
+            if (captureOk) captureBlock("TX", tx, m);
+
+            if (port.halfDuplex) {
+                if (echo.size() + m > ECHO_MAX) {
+                    echo.erase(0, echoPos);
+                    echoPos = 0;
+                    if (echo.size() + m > ECHO_MAX) echo.clear();
+                }
+                echo.append(reinterpret_cast<const char*>(tx), m);
+            }
+        }
+
+        // Counters
+        uint32_t now = millis();
+        if (now - lastStatsMs >= STATS_INTERVAL_MS) {
+            if (port.overflows) total.overflows += port.overflows();
+            total.dropped = terminalView.getDroppedBytes() - droppedAtStart;
+            showStats(total, last, now - lastStatsMs, stats);
+            last = total;
+            lastStatsMs = now;
+        }
+
+        // Device input
+        if (deviceInput.readChar() != KEY_NONE) break;
+
+        // Don't pin the core when both sides are quiet
+        if (idle) vTaskDelay(1);
+    }
+
+    if (port.overflows) total.overflows += port.overflows();
+    total.dropped = terminalView.getDroppedBytes() - droppedAtStart;
+    uint32_t elapsedMs = millis() - startMs;
+
+    terminalView.println("\r\n" + port.name + " Bridge: Stopped by user.");
+    terminalView.println("  RX " + std::to_string(total.rxBytes) + " bytes (" + formatRate(total.rxBytes, elapsedMs) + ")" +
+                         ", TX " + std::to_string(total.txBytes) + " bytes (" + formatRate(total.txBytes, elapsedMs) + ")" +
+                         ", " + std::to_string(total.overflows) + " RX overflows");
+    if (total.dropped) {
+        terminalView.println("  " + std::to_string(total.dropped) + " bytes dropped, the terminal client was too slow");
+    }
+
+    if (captureOk) {
+        flushCapture();
+        if (captureOk) terminalView.println("  Capture saved to " + capturePath);
+        else terminalView.println("  ❌ Capture write failed: " + capturePath);
+        captureOk = false;
+    }
+    terminalView.println("");
+}
+
+bool UartBridgeShell::openCapture(const std::string& baseName) {
+    if (!littleFsService.mounted()) {
+        littleFsService.begin();
+        if (!littleFsService.mounted()) {
+            terminalView.println("\n ❌ LittleFS not mounted.");
+            return false;
+        }
+    }
+    if (littleFsService.freeBytes() < MIN_FREE_BYTES) {
+        terminalView.println("\n❌ Not enough LittleFS space.");
+        return false;
+    }
+
+    std::string lower = baseName;
+    for (auto& c : lower) c = tolower(c);
+    std::string defName = lower + "_" + std::to_string(millis() % 1000000);
+    std::string name = userInputManager.readSanitizedString("File name", defName, false);
+    if (name.empty()) name = defName;
+
+    capturePath = std::string(CAPTURE_DIR) + name + ".log";
+    if (littleFsService.exists(capturePath)) littleFsService.removeFile(capturePath);
+
+    captureBuffer.clear();
+    captureBuffer.reserve(CAPTURE_FLUSH_SIZE + 256);
+    captureStartUs = micros();
+    captureOk = true;
+
+    terminalView.println("Recording to " + capturePath);
+    return true;
+}
+
+void UartBridgeShell::captureBlock(const char* dir, const uint8_t* data, size_t length) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    // "<seconds>.<micros> RX 41 42 43"
+    uint32_t t = micros() - captureStartUs;
+    char head[24];
+    snprintf(head, sizeof(head), "%lu.%06lu %s", (unsigned long)(t / 1000000), (unsigned long)(t % 1000000), dir);
+    captureBuffer += head;
+
+    for (size_t i = 0; i < length; ++i) {
+        captureBuffer += ' ';
+        captureBuffer += hex[data[i] >> 4];
+        captureBuffer += hex[data[i] & 0x0F];
+    }
+    captureBuffer += '\n';
+
+    if (captureBuffer.size() >= CAPTURE_FLUSH_SIZE) flushCapture();
+}
+
+void UartBridgeShell::flushCapture() {
+    if (captureBuffer.empty()) return;
+    if (!littleFsService.write(capturePath, captureBuffer, true)) captureOk = false;
+    captureBuffer.clear();
+}
+
+void UartBridgeShell::showStats(const Counters& now, const Counters& last, uint32_t elapsedMs, bool inTerminal) {
+    std::string line = "RX " + formatRate(now.rxBytes - last.rxBytes, elapsedMs) +
+                       " TX " + formatRate(now.txBytes - last.txBytes, elapsedMs) +
+                       " OVF " + std::to_string(now.overflows);
+    if (now.dropped) line += " DROP " + std::to_string(now.dropped);
+
+    // The screen is out of band, the terminal only when asked since it mixes with the data
+    deviceView.topBar(line, false, false);
+    if (inTerminal) terminalView.print("\r\n[bridge] " + line + "\r\n");
+}
+
+std::string UartBridgeShell::formatRate(uint64_t bytes, uint32_t ms) {
+    if (ms == 0) ms = 1;
+    uint64_t bps = bytes * 1000 / ms;
+    if (bps >= 1024) return std::to_string(bps / 1024) + "." + std::to_string((bps % 1024) * 10 / 1024) + " kB/s";
+    return std::to_string(bps) + " B/s";
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <functional>
+#include <string>
+
+#include "Interfaces/ITerminalView.h"
+#include "Interfaces/IDeviceView.h"
+#include "Interfaces/IInput.h"
+#include "Managers/UserInputManager.h"
+#include "Services/LittleFsService.h"
+
+class UartBridgeShell {
+public:
+    // What the bridge needs from a UART, all calls non blocking
+    struct Port {
+        std::string name;
+        std::function<size_t(uint8_t*, size_t)> read;           // drain the driver RX ring
+        std::function<size_t(const uint8_t*, size_t)> write;
+        std::function<uint32_t()> overflows;                    // RX ring/FIFO overflows since start
+        bool halfDuplex = false;                                // single wire, drop our own echo
+    };
+
+    UartBridgeShell(ITerminalView& tv,
+                    IDeviceView& dv,
+                    IInput& in,
+                    IInput& din,
+                    UserInputManager& uim,
+                    LittleFsService& lfs);
+
+    // Bridge until a device button is pressed
+    void run(const Port& port, bool capture, bool stats);
+
+private:
+    ITerminalView& terminalView;
+    IDeviceView& deviceView;
+    IInput& terminalInput;
+    IInput& deviceInput;
+    UserInputManager& userInputManager;
+    LittleFsService& littleFsService;
+
+    struct Counters {
+        uint64_t rxBytes = 0;
+        uint64_t txBytes = 0;
+        uint32_t overflows = 0;
+        uint32_t dropped = 0;       // terminal side, slow web client
+    };
+
+    // Capture file, hex records with a timestamp per block
+    std::string capturePath;
+    std::string captureBuffer;
+    uint32_t captureStartUs = 0;
+    bool captureOk = false;
+
+    bool openCapture(const std::string& baseName);
+    void captureBlock(const char* dir, const uint8_t* data, size_t length);
+    void flushCapture();
+
+    void showStats(const Counters& now, const Counters& last, uint32_t elapsedMs, bool inTerminal);
+    static std::string formatRate(uint64_t bytes, uint32_t ms);
+
+    inline static constexpr size_t BLOCK_SIZE = 512;
+    inline static constexpr size_t ECHO_MAX = 1024;
+    inline static constexpr uint32_t STATS_INTERVAL_MS = 1000;
+    inline static constexpr size_t CAPTURE_FLUSH_SIZE = 2048;
+    inline static constexpr const char* CAPTURE_DIR = "/captures/";
+    inline static constexpr size_t MIN_FREE_BYTES = 8 * 1024;
+};
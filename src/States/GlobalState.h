@@ -114,6 +114,7 @@ private:
     uint8_t canSckPin = 0;
     uint8_t canSiPin = 2;
     uint8_t canSoPin = 3;
+    uint8_t canIntPin = 0xFF;   // not wired, the reader polls
     uint32_t canKbps = 120;
 
     // Ethernet Default Configuration
@@ -151,6 +152,13 @@ private:
     // JTAG Default Pin
     std::vector<uint8_t> jtagScanPins = { 1, 3, 5, 7, 9 };
 
+    // JTAG pins used to play SVF/XSVF, updated by a successful scan
+    uint8_t jtagTckPin = 1;
+    uint8_t jtagTmsPin = 3;
+    uint8_t jtagTdiPin = 5;
+    uint8_t jtagTdoPin = 7;
+    uint8_t jtagTrstPin = 0xFF;   // not wired
+
     // SD Card Default Configuration
     uint8_t sdCardCsPin = 12;
     uint8_t sdCardClkPin = 40;
@@ -337,18 +345,30 @@ public:
     // JTAG
     const std::vector<uint8_t>& getJtagScanPins() const { return jtagScanPins; }
     void setJtagScanPins(const std::vector<uint8_t>& pins) { jtagScanPins = pins; }
+    uint8_t getJtagTckPin() const { return jtagTckPin; }
+    uint8_t getJtagTmsPin() const { return jtagTmsPin; }
+    uint8_t getJtagTdiPin() const { return jtagTdiPin; }
+    uint8_t getJtagTdoPin() const { return jtagTdoPin; }
+    uint8_t getJtagTrstPin() const { return jtagTrstPin; }
+    void setJtagTckPin(uint8_t pin) { jtagTckPin = pin; }
+    void setJtagTmsPin(uint8_t pin) { jtagTmsPin = pin; }
+    void setJtagTdiPin(uint8_t pin) { jtagTdiPin = pin; }
+    void setJtagTdoPin(uint8_t pin) { jtagTdoPin = pin; }
+    void setJtagTrstPin(uint8_t pin) { jtagTrstPin = pin; }
 
     // CAN
     uint8_t getCanCspin() const { return canCspin; }
     uint8_t getCanSckPin() const { return canSckPin; }
     uint8_t getCanSiPin() const { return canSiPin; }
     uint8_t getCanSoPin() const { return canSoPin; }
+    uint8_t getCanIntPin() const { return canIntPin; }
     uint32_t getCanKbps() const { return canKbps; }
 
     void setCanCspin(uint8_t pin) { canCspin = pin; }
     void setCanSckPin(uint8_t pin) { canSckPin = pin; }
     void setCanSiPin(uint8_t pin) { canSiPin = pin; }
     void setCanSoPin(uint8_t pin) { canSoPin = pin; }
+    void setCanIntPin(uint8_t pin) { canIntPin = pin; }
     void setCanKbps(uint32_t kbps) { canKbps = kbps; } 
 
     // Ethernet
@@ -567,6 +587,9 @@ public:
         #ifdef CAN_SO_PIN
             canSoPin = CAN_SO_PIN;
         #endif
+        #ifdef CAN_INT_PIN
+            canIntPin = CAN_INT_PIN;
+        #endif
         #ifdef CAN_KBPS
             canKbps = CAN_KBPS;
         #endif
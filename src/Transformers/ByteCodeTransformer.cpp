@@ -0,0 +1,36 @@
+#include "ByteCodeTransformer.h"
+
+CompiledByteCode ByteCodeTransformer::compile(const std::vector<ByteCode>& bytecodes) {
+    CompiledByteCode program;
+
+    for (const auto& code : bytecodes) {
+        uint32_t repeat = code.getRepeat();
+
+        switch (code.getCommand()) {
+            case ByteCodeEnum::Write:
+                program.appendWrite(static_cast<uint8_t>(code.getData()), repeat);
+                break;
+
+            case ByteCodeEnum::Read:
+                program.appendRead(repeat);
+                break;
+
+            case ByteCodeEnum::DelayUs:
+                program.appendDelayUs(repeat);
+                break;
+
+            case ByteCodeEnum::DelayMs:
+                program.appendDelayUs((uint64_t)repeat * 1000);
+                break;
+
+            case ByteCodeEnum::None:
+                break;
+
+            default:
+                program.appendOp(code.getCommand(), repeat);
+                break;
+        }
+    }
+
+    return program;
+}
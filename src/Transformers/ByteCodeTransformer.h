@@ -0,0 +1,11 @@
+#pragma once
+
+#include <vector>
+#include "Models/ByteCode.h"
+#include "Models/CompiledByteCode.h"
+
+class ByteCodeTransformer {
+public:
+    // Fold repeats, merge write/read runs and delays into a compact op list
+    static CompiledByteCode compile(const std::vector<ByteCode>& bytecodes);
+};
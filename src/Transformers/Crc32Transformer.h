@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, as used by zip and png), chainable over several buffers.
+// Start with crc = 0 and feed the previous result back in for the next chunk.
+class Crc32Transformer {
+public:
+    static uint32_t update(uint32_t crc, const uint8_t* data, size_t length);
+};
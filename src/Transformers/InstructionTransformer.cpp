@@ -121,9 +121,9 @@ std::vector<ByteCode> InstructionTransformer::transformByteCode(const Instructio
         } 
         
         else if (isSymbolWithRepeat(tok)) {
-            std::pair<ByteCodeEnum, uint8_t> result = parseSymbolWithRepeat(tok);
+            std::pair<ByteCodeEnum, uint32_t> result = parseSymbolWithRepeat(tok);
             ByteCodeEnum sym = result.first;
-            uint8_t repeat = result.second;
+            uint32_t repeat = result.second;
             bytecodes.emplace_back(sym, 0, 8, repeat);
         }
 
@@ -253,11 +253,12 @@ ByteCode InstructionTransformer::parseSymbol(char c) const {
     }
 }
 
-std::pair<ByteCodeEnum, uint8_t> InstructionTransformer::parseSymbolWithRepeat(const std::string& token) const {
+std::pair<ByteCodeEnum, uint32_t> InstructionTransformer::parseSymbolWithRepeat(const std::string& token) const {
     char symbol = token[0];
     size_t colonPos = token.find(':');
-    unsigned long parsed = std::stoul(token.substr(colonPos + 1));
-    uint8_t repeat = std::min(parsed, 255ul);
+    std::string digits = token.substr(colonPos + 1);
+    unsigned long parsed = digits.size() > 6 ? MAX_REPEAT : std::stoul(digits);
+    uint32_t repeat = std::min<unsigned long>(parsed, MAX_REPEAT);
 
     return { parseSymbol(symbol).getCommand(), repeat };
 }
@@ -28,5 +28,8 @@ private:
     uint8_t parseDecimal(const std::string& token) const;
     uint8_t parseCharLiteral(const std::string& token) const;
     ByteCode parseSymbol(char c) const;
-    std::pair<ByteCodeEnum, uint8_t> parseSymbolWithRepeat(const std::string& token) const;
+    std::pair<ByteCodeEnum, uint32_t> parseSymbolWithRepeat(const std::string& token) const;
+
+    // Upper bound for r:N, d:N... repeats
+    static constexpr uint32_t MAX_REPEAT = 65535;
 };
@@ -0,0 +1,75 @@
+#include "PcapTransformer.h"
+
+namespace {
+    constexpr uint32_t PCAP_MAGIC_US = 0xA1B2C3D4;
+    constexpr uint16_t PCAP_VERSION_MAJOR = 2;
+    constexpr uint16_t PCAP_VERSION_MINOR = 4;
+}
+
+PcapTransformer::PcapTransformer(Sink sink) : sink(std::move(sink)) {
+    buffer.reserve(FLUSH_SIZE + 512);
+}
+
+bool PcapTransformer::begin(uint32_t linkType, uint32_t snapLen) {
+    buffer.clear();
+    bytesWritten = 0;
+    packets = 0;
+    snapLength = snapLen;
+    ok = true;
+
+    put32(PCAP_MAGIC_US);
+    put16(PCAP_VERSION_MAJOR);
+    put16(PCAP_VERSION_MINOR);
+    put32(0);               // thiszone
+    put32(0);               // sigfigs
+    put32(snapLen);
+    put32(linkType);
+    started = true;
+
+    return flush();
+}
+
+bool PcapTransformer::append(uint64_t timestampUs, const uint8_t* header, size_t headerLen,
+                             const uint8_t* body, size_t bodyLen, size_t originalLen) {
+    if (!ok || !started) return false;
+
+    if (headerLen + bodyLen > snapLength) {
+        bodyLen = headerLen < snapLength ? snapLength - headerLen : 0;
+    }
+    size_t captured = headerLen + bodyLen;
+
+    put32((uint32_t)(timestampUs / 1000000ULL));
+    put32((uint32_t)(timestampUs % 1000000ULL));
+    put32(captured);
+    put32(headerLen + originalLen);
+    buffer.append(reinterpret_cast<const char*>(header), headerLen);
+    buffer.append(reinterpret_cast<const char*>(body), bodyLen);
+    packets++;
+
+    if (buffer.size() >= FLUSH_SIZE) return flush();
+    return ok;
+}
+
+bool PcapTransformer::end() {
+    if (!started) return false;
+    started = false;
+    return flush();
+}
+
+void PcapTransformer::put16(uint16_t v) {
+    buffer += (char)(v & 0xFF);
+    buffer += (char)(v >> 8);
+}
+
+void PcapTransformer::put32(uint32_t v) {
+    put16(v & 0xFFFF);
+    put16(v >> 16);
+}
+
+bool PcapTransformer::flush() {
+    if (buffer.empty() || !ok) return ok;
+    ok = sink(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+    if (ok) bytesWritten += buffer.size();
+    buffer.clear();
+    return ok;
+}
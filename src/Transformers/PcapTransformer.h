@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Streaming libpcap writer, microsecond timestamps, little endian.
+// Records are buffered and handed to the sink one flush block at a time.
+class PcapTransformer {
+public:
+    using Sink = std::function<bool(const uint8_t*, size_t)>;
+
+    static constexpr uint32_t LINKTYPE_IEEE802_11_RADIOTAP = 127;
+
+    explicit PcapTransformer(Sink sink);
+
+    bool begin(uint32_t linkType, uint32_t snapLen);
+
+    // One packet, the header and the body are concatenated in the record
+    bool append(uint64_t timestampUs, const uint8_t* header, size_t headerLen,
+                const uint8_t* body, size_t bodyLen, size_t originalLen);
+
+    bool end();
+
+    size_t getBytesWritten() const { return bytesWritten; }
+    uint32_t getPacketCount() const { return packets; }
+
+private:
+    static constexpr size_t FLUSH_SIZE = 4096;
+
+    void put16(uint16_t v);
+    void put32(uint32_t v);
+    bool flush();
+
+    Sink sink;
+    std::string buffer;
+    size_t bytesWritten = 0;
+    uint32_t packets = 0;
+    uint32_t snapLength = 0;
+    bool ok = true;
+    bool started = false;
+};
@@ -1,4 +1,5 @@
 #include "PinoutTransformer.h"
+#include <cstdlib>
 
 
 PinoutConfig PinoutTransformer::build(ModeEnum mode) const {
@@ -169,4 +170,16 @@ PinoutConfig PinoutTransformer::build(ModeEnum mode) const {
     }
 
     return config;
-}
\ No newline at end of file
+}
+std::vector<uint8_t> PinoutTransformer::buildPins(ModeEnum mode) const {
+    // The JTAG mapping only shows the first scan pins
+    if (mode == ModeEnum::JTAG) return state.getJtagScanPins();
+
+    std::vector<uint8_t> pins;
+    for (const auto& mapping : build(mode).getMappings()) {
+        auto pos = mapping.find("GPIO ");
+        if (pos == std::string::npos) continue;
+        pins.push_back((uint8_t)std::atoi(mapping.c_str() + pos + 5));
+    }
+    return pins;
+}
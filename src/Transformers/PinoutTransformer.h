@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+#include <cstdint>
 #include "Enums/ModeEnum.h"
 #include "Models/PinoutConfig.h"
 #include "States/GlobalState.h"
@@ -9,5 +11,8 @@ class GlobalState;
 class PinoutTransformer {
 public:
     PinoutConfig build(ModeEnum mode) const;
+
+    // GPIO numbers used by the mode, parsed from its mappings
+    std::vector<uint8_t> buildPins(ModeEnum mode) const;
     GlobalState& state = GlobalState::getInstance();
 };
\ No newline at end of file
@@ -56,6 +56,7 @@ std::string ProfileTransformer::toProfileText() {
     o << "can.sck=" << (int)gs.getCanSckPin() << "\n";
     o << "can.si=" << (int)gs.getCanSiPin() << "\n";
     o << "can.so=" << (int)gs.getCanSoPin() << "\n";
+    o << "can.int=" << (int)gs.getCanIntPin() << "\n";
     o << "can.kbps=" << gs.getCanKbps() << "\n\n";
 
     // SubGHz
@@ -323,6 +324,9 @@ bool ProfileTransformer::fromProfileText(
     if (getStr(kv, "can.so", v) && !parseU8(v, u8)) { error = "Invalid can.so";}
     else if (!v.empty()) gs.setCanSoPin(u8);
 
+    if (getStr(kv, "can.int", v) && !parseU8(v, u8)) { error = "Invalid can.int";}
+    else if (!v.empty()) gs.setCanIntPin(u8);
+
     if (getStr(kv, "can.kbps", v) && !parseU32(v, u32)) { error = "Invalid can.kbps";}
     else if (!v.empty()) gs.setCanKbps(u32);
 
@@ -0,0 +1,169 @@
+#include "SigrokTransformer.h"
+#include "Crc32Transformer.h"
+
+namespace {
+    constexpr uint32_t ZIP_LOCAL_HEADER   = 0x04034b50;
+    constexpr uint32_t ZIP_DATA_DESCRIPTOR = 0x08074b50;
+    constexpr uint32_t ZIP_CENTRAL_HEADER = 0x02014b50;
+    constexpr uint32_t ZIP_END_OF_CENTRAL = 0x06054b50;
+    constexpr uint16_t ZIP_VERSION        = 20;
+    constexpr uint16_t ZIP_FLAG_DESCRIPTOR = 0x0008;
+    constexpr uint16_t ZIP_DOS_DATE       = 0x0021;   // 1980-01-01, no RTC
+}
+
+SigrokTransformer::SigrokTransformer(Sink sink) : sink(std::move(sink)) {
+    buffer.reserve(FLUSH_SIZE + 64);
+}
+
+bool SigrokTransformer::begin(const std::vector<std::string>& channels, uint32_t sampleRateHz) {
+    if (channels.empty() || channels.size() > 8 || sampleRateHz == 0) return false;
+
+    channelNames = channels;
+    sampleRate = sampleRateHz;
+    entries.clear();
+    ok = true;
+
+    if (!writeStoredFile("version", "2")) return false;
+
+    // Sample file, sizes and crc follow the data in a descriptor
+    logicEntry = { "logic-1-1", (uint32_t)(bytesWritten + buffer.size()), 0, 0, ZIP_FLAG_DESCRIPTOR };
+    writeLocalHeader(logicEntry.name, logicEntry.flags, 0, 0);
+    streaming = true;
+
+    return flush();
+}
+
+bool SigrokTransformer::append(uint8_t sample, uint32_t samples) {
+    if (!ok || !streaming) return false;
+
+    while (samples > 0) {
+        size_t room = FLUSH_SIZE - buffer.size();
+        size_t n = samples < room ? samples : room;
+        size_t at = buffer.size();
+
+        buffer.append(n, (char)sample);
+        logicEntry.crc = Crc32Transformer::update(logicEntry.crc, reinterpret_cast<const uint8_t*>(buffer.data()) + at, n);
+        logicEntry.size += n;
+        samples -= n;
+
+        if (buffer.size() >= FLUSH_SIZE && !flush()) return false;
+    }
+    return ok;
+}
+
+bool SigrokTransformer::end() {
+    if (!streaming) return false;
+    streaming = false;
+
+    put32(ZIP_DATA_DESCRIPTOR);
+    put32(logicEntry.crc);
+    put32(logicEntry.size);
+    put32(logicEntry.size);
+    entries.push_back(logicEntry);
+
+    // Metadata last, the capture length is only known now
+    if (!writeStoredFile("metadata", buildMetadata())) return false;
+
+    writeCentralDirectory();
+    return flush();
+}
+
+void SigrokTransformer::writeLocalHeader(const std::string& name, uint16_t flags, uint32_t crc, uint32_t size) {
+    put32(ZIP_LOCAL_HEADER);
+    put16(ZIP_VERSION);
+    put16(flags);
+    put16(0);               // stored
+    put16(0);               // time
+    put16(ZIP_DOS_DATE);
+    put32(crc);
+    put32(size);            // compressed
+    put32(size);            // uncompressed
+    put16(name.size());
+    put16(0);               // extra
+    buffer += name;
+}
+
+bool SigrokTransformer::writeStoredFile(const std::string& name, const std::string& content) {
+    uint32_t crc = Crc32Transformer::update(0, reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    entries.push_back({ name, (uint32_t)(bytesWritten + buffer.size()), crc, (uint32_t)content.size(), 0 });
+
+    writeLocalHeader(name, 0, crc, content.size());
+    buffer += content;
+    return flush();
+}
+
+void SigrokTransformer::writeCentralDirectory() {
+    uint32_t start = bytesWritten + buffer.size();
+
+    for (const auto& e : entries) {
+        put32(ZIP_CENTRAL_HEADER);
+        put16(ZIP_VERSION);     // made by
+        put16(ZIP_VERSION);     // needed
+        put16(e.flags);
+        put16(0);               // stored
+        put16(0);               // time
+        put16(ZIP_DOS_DATE);
+        put32(e.crc);
+        put32(e.size);
+        put32(e.size);
+        put16(e.name.size());
+        put16(0);               // extra
+        put16(0);               // comment
+        put16(0);               // disk
+        put16(0);               // internal attributes
+        put32(0);               // external attributes
+        put32(e.offset);
+        buffer += e.name;
+    }
+
+    uint32_t size = bytesWritten + buffer.size() - start;
+    put32(ZIP_END_OF_CENTRAL);
+    put16(0);
+    put16(0);
+    put16(entries.size());
+    put16(entries.size());
+    put32(size);
+    put32(start);
+    put16(0);
+}
+
+std::string SigrokTransformer::buildMetadata() const {
+    std::string meta;
+    meta += "[global]\n";
+    if (!comment.empty()) meta += "# " + comment + "\n";
+    meta += "sigrok version=0.5.2\n\n";
+    meta += "[device 1]\n";
+    meta += "capturefile=logic-1\n";
+    meta += "total probes=" + std::to_string(channelNames.size()) + "\n";
+    meta += "samplerate=" + formatSampleRate(sampleRate) + "\n";
+    meta += "total analog=0\n";
+    for (size_t i = 0; i < channelNames.size(); ++i) {
+        meta += "probe" + std::to_string(i + 1) + "=" + channelNames[i] + "\n";
+    }
+    meta += "unitsize=1\n";
+    return meta;
+}
+
+std::string SigrokTransformer::formatSampleRate(uint32_t hz) {
+    if (hz % 1000000 == 0) return std::to_string(hz / 1000000) + " MHz";
+    if (hz % 1000 == 0)    return std::to_string(hz / 1000) + " kHz";
+    return std::to_string(hz) + " Hz";
+}
+
+void SigrokTransformer::put16(uint16_t v) {
+    buffer += (char)(v & 0xFF);
+    buffer += (char)(v >> 8);
+}
+
+void SigrokTransformer::put32(uint32_t v) {
+    put16(v & 0xFFFF);
+    put16(v >> 16);
+}
+
+bool SigrokTransformer::flush() {
+    if (buffer.empty() || !ok) return ok;
+    ok = sink(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+    if (ok) bytesWritten += buffer.size();
+    buffer.clear();
+    return ok;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Interfaces/ICaptureWriter.h"
+
+// Streaming sigrok session (.sr) writer, a stored (uncompressed) zip holding
+// "version", "metadata" and a single "logic-1-1" sample file with unitsize 1.
+// The sample file is streamed with a data descriptor, so nothing is buffered
+// beyond one flush block, but every sample costs one byte.
+class SigrokTransformer : public ICaptureWriter {
+public:
+    using Sink = std::function<bool(const uint8_t*, size_t)>;
+
+    explicit SigrokTransformer(Sink sink);
+
+    bool begin(const std::vector<std::string>& channels, uint32_t sampleRateHz) override;
+    bool append(uint8_t sample, uint32_t samples) override;
+    bool end() override;
+    size_t getBytesWritten() const override { return bytesWritten; }
+
+private:
+    static constexpr size_t FLUSH_SIZE = 2048;
+
+    struct ZipEntry {
+        std::string name;
+        uint32_t offset;
+        uint32_t crc;
+        uint32_t size;
+        uint16_t flags;
+    };
+
+    void writeLocalHeader(const std::string& name, uint16_t flags, uint32_t crc, uint32_t size);
+    bool writeStoredFile(const std::string& name, const std::string& content);
+    void writeCentralDirectory();
+    std::string buildMetadata() const;
+    static std::string formatSampleRate(uint32_t hz);
+
+    void put16(uint16_t v);
+    void put32(uint32_t v);
+    bool flush();
+
+    Sink sink;
+    std::string buffer;
+    size_t bytesWritten = 0;
+    bool ok = true;
+
+    std::vector<std::string> channelNames;
+    uint32_t sampleRate = 1;
+
+    std::vector<ZipEntry> entries;
+    ZipEntry logicEntry;
+    bool streaming = false;
+};
@@ -0,0 +1,116 @@
+#include "VcdTransformer.h"
+
+VcdTransformer::VcdTransformer(Sink sink) : sink(std::move(sink)) {
+    buffer.reserve(FLUSH_SIZE + 128);
+}
+
+bool VcdTransformer::begin(const std::vector<std::string>& channels, uint32_t sampleRateHz) {
+    if (channels.empty() || channels.size() > 8 || sampleRateHz == 0) return false;
+
+    channelCount = channels.size();
+    sampleRate = sampleRateHz;
+    sampleIndex = 0;
+    lastSample = 0;
+    started = false;
+    ok = true;
+
+    // Coarsest timescale with a whole number of ticks per sample. Rates with a prime
+    // factor other than 2 and 5 have none, they are rounded to the nearest tick.
+    static const struct { const char* unit; uint64_t perSecond; } scales[] = {
+        { "1 s", 1ULL },                   { "100 ms", 10ULL },               { "10 ms", 100ULL },
+        { "1 ms", 1000ULL },               { "100 us", 10000ULL },            { "10 us", 100000ULL },
+        { "1 us", 1000000ULL },            { "100 ns", 10000000ULL },         { "10 ns", 100000000ULL },
+        { "1 ns", 1000000000ULL },         { "100 ps", 10000000000ULL },      { "10 ps", 100000000000ULL },
+        { "1 ps", 1000000000000ULL }
+    };
+    const char* unit = nullptr;
+    ticksPerSample = 0;
+    for (const auto& s : scales) {
+        if (s.perSecond % sampleRate == 0) {
+            unit = s.unit;
+            unitsPerSecond = s.perSecond;
+            ticksPerSample = s.perSecond / sampleRate;
+            break;
+        }
+    }
+    if (!unit) {
+        // About a million ticks per sample, as long as (index % rate) * units fits 64 bits
+        for (const auto& s : scales) {
+            if (s.perSecond > UINT64_MAX / sampleRate) break;
+            unit = s.unit;
+            unitsPerSecond = s.perSecond;
+            if (s.perSecond >= (uint64_t)sampleRate * 1000000ULL) break;
+        }
+    }
+
+    buffer += "$version ESP32 Bus Pirate $end\n";
+    if (!comment.empty()) buffer += "$comment " + comment + " $end\n";
+    if (!ticksPerSample) {
+        buffer += "$comment " + std::to_string(sampleRate) + " Hz sample rate, timestamps rounded to ";
+        buffer += unit; buffer += " $end\n";
+    }
+    buffer += "$timescale "; buffer += unit; buffer += " $end\n";
+    buffer += "$scope module capture $end\n";
+    for (uint8_t i = 0; i < channelCount; ++i) {
+        buffer += "$var wire 1 ";
+        buffer += (char)('!' + i);
+        buffer += " " + channels[i] + " $end\n";
+    }
+    buffer += "$upscope $end\n";
+    buffer += "$enddefinitions $end\n";
+
+    return flush();
+}
+
+bool VcdTransformer::append(uint8_t sample, uint32_t samples) {
+    if (!ok || samples == 0) return ok;
+
+    if (!started) {
+        // Initial values for every channel
+        buffer += "#0\n$dumpvars\n";
+        writeChanges(sample, 0xFF);
+        buffer += "$end\n";
+        started = true;
+    } else if (sample != lastSample) {
+        writeTimestamp(sampleIndex);
+        writeChanges(sample, sample ^ lastSample);
+    }
+
+    lastSample = sample;
+    sampleIndex += samples;
+
+    if (buffer.size() >= FLUSH_SIZE) return flush();
+    return ok;
+}
+
+bool VcdTransformer::end() {
+    // Closing timestamp so viewers show the last state for its full duration
+    if (started) writeTimestamp(sampleIndex);
+    return flush();
+}
+
+void VcdTransformer::writeTimestamp(uint64_t index) {
+    // Exact when the period is a whole number of ticks, otherwise split to avoid
+    // overflowing on long captures and rounded, the error never accumulates
+    uint64_t t = ticksPerSample
+        ? index * ticksPerSample
+        : (index / sampleRate) * unitsPerSecond + ((index % sampleRate) * unitsPerSecond + sampleRate / 2) / sampleRate;
+    buffer += "#" + std::to_string(t) + "\n";
+}
+
+void VcdTransformer::writeChanges(uint8_t sample, uint8_t mask) {
+    for (uint8_t i = 0; i < channelCount; ++i) {
+        if (!(mask & (1u << i))) continue;
+        buffer += (sample & (1u << i)) ? '1' : '0';
+        buffer += (char)('!' + i);
+        buffer += '\n';
+    }
+}
+
+bool VcdTransformer::flush() {
+    if (buffer.empty() || !ok) return ok;
+    ok = sink(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+    if (ok) bytesWritten += buffer.size();
+    buffer.clear();
+    return ok;
+}
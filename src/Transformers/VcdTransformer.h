@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Interfaces/ICaptureWriter.h"
+
+// Streaming Value Change Dump writer, only transitions are written
+// so idle periods cost a single timestamp line
+class VcdTransformer : public ICaptureWriter {
+public:
+    using Sink = std::function<bool(const uint8_t*, size_t)>;
+
+    explicit VcdTransformer(Sink sink);
+
+    bool begin(const std::vector<std::string>& channels, uint32_t sampleRateHz) override;
+    bool append(uint8_t sample, uint32_t samples) override;
+    bool end() override;
+    size_t getBytesWritten() const override { return bytesWritten; }
+
+private:
+    static constexpr size_t FLUSH_SIZE = 1024;
+
+    void writeTimestamp(uint64_t sampleIndex);
+    void writeChanges(uint8_t sample, uint8_t mask);
+    bool flush();
+
+    Sink sink;
+    std::string buffer;
+    size_t bytesWritten = 0;
+    bool ok = true;
+
+    uint8_t channelCount = 0;
+    uint32_t sampleRate = 1;
+    uint64_t unitsPerSecond = 1000000000ULL;
+    uint64_t ticksPerSample = 0;       // 0 when the sample period is not a whole number of ticks
+    uint64_t sampleIndex = 0;
+    uint8_t lastSample = 0;
+    bool started = false;
+};
@@ -39,6 +39,10 @@ void SerialTerminalView::print(const std::string& text) {
     Serial.print(text.c_str());
 }
 
+void SerialTerminalView::write(const uint8_t* data, size_t length) {
+    Serial.write(data, length);
+}
+
 void SerialTerminalView::print(const uint8_t data) {
     Serial.write(data);
 }
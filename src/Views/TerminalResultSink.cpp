@@ -0,0 +1,70 @@
+#include "TerminalResultSink.h"
+
+TerminalResultSink::TerminalResultSink(ITerminalView& terminalView, const std::string& title, bool hex,
+                                       const std::string& writeTitle)
+    : terminalView(terminalView), title(title), writeTitle(writeTitle), hex(hex) {
+    line.reserve(hex ? HEX_BYTES_PER_LINE * 3 + 8 : RAW_CHUNK_SIZE);
+}
+
+void TerminalResultSink::onData(const uint8_t* data, size_t length) {
+    if (length == 0) return;
+    writing = false;
+    printTitle();
+    byteCount += length;
+
+    for (size_t i = 0; i < length; ++i) {
+        if (hex) {
+            char buf[4];
+            snprintf(buf, sizeof(buf), "%02X ", data[i]);
+            line += buf;
+            if (++lineBytes >= HEX_BYTES_PER_LINE) flush();
+        } else {
+            line += static_cast<char>(data[i]);
+            if (line.size() >= RAW_CHUNK_SIZE) flush();
+        }
+    }
+}
+
+void TerminalResultSink::onEvent(ResultEventEnum event) {
+    switch (event) {
+        case ResultEventEnum::Nack:
+            printTitle();
+            line += "NACK ";
+            break;
+
+        case ResultEventEnum::Stop:
+            // One line per transaction
+            if (hex) flush();
+            break;
+
+        case ResultEventEnum::Read:
+        case ResultEventEnum::Write:
+            writing = (event == ResultEventEnum::Write);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void TerminalResultSink::flush() {
+    if (line.empty()) return;
+
+    if (hex) {
+        terminalView.println(line);
+    } else {
+        terminalView.print(line);
+    }
+    line.clear();
+    lineBytes = 0;
+}
+
+void TerminalResultSink::printTitle() {
+    const std::string& current = (writing && !writeTitle.empty()) ? writeTitle : title;
+    if (printedTitle == &current) return;
+
+    // Direction changed, keep the pending bytes under their own title
+    if (printedTitle) flush();
+    printedTitle = &current;
+    if (!current.empty()) terminalView.println(current);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <Interfaces/IResultSink.h>
+#include <Interfaces/ITerminalView.h>
+
+/*
+Formats bytecode results for the terminal while the transaction runs,
+holding at most one output line in memory.
+*/
+class TerminalResultSink : public IResultSink {
+public:
+    // writeTitle labels NACKs of write phases, empty to use title for everything
+    TerminalResultSink(ITerminalView& terminalView, const std::string& title, bool hex = true,
+                       const std::string& writeTitle = "");
+
+    void onData(const uint8_t* data, size_t length) override;
+    void onEvent(ResultEventEnum event) override;
+
+    // Print pending output, to call once execution is done
+    void flush();
+
+    size_t getByteCount() const { return byteCount; }
+
+private:
+    static constexpr size_t HEX_BYTES_PER_LINE = 16;
+    static constexpr size_t RAW_CHUNK_SIZE = 256;
+
+    ITerminalView& terminalView;
+    std::string title;
+    std::string writeTitle;
+    bool hex;
+    bool writing = false;
+    std::string line;
+    size_t lineBytes = 0;
+    size_t byteCount = 0;
+    const std::string* printedTitle = nullptr;
+
+    void printTitle();
+};
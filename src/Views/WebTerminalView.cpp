@@ -22,6 +22,14 @@ void WebTerminalView::println(const std::string& text) {
     server.sendText(text + "\n");
 }
 
+void WebTerminalView::write(const uint8_t* data, size_t length) {
+    server.sendBinary(data, length); // decoded as a UTF-8 stream by the client
+}
+
+uint32_t WebTerminalView::getDroppedBytes() const {
+    return server.getDroppedBytes();
+}
+
 void WebTerminalView::printPrompt(const std::string& mode) {
     const std::string prompt = mode + "> ";
     server.sendText(prompt);
@@ -13,10 +13,12 @@ public:
     void print(const std::string& text) override;
     void print(const uint8_t data) override;
     void println(const std::string& text) override;
+    void write(const uint8_t* data, size_t length) override;
+    uint32_t getDroppedBytes() const override;
     void printPrompt(const std::string& mode) override;
     void clear() override;
     void waitPress() override;
     
 private:
-    WebSocketServer server;
+    WebSocketServer& server;
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+// Just enough of the Arduino core for services built on the host, see SPI.h.
+// Pin writes and delays are recorded so a test can drive a simulated part.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#define HIGH 0x1
+#define LOW 0x0
+#define OUTPUT 0x03
+#define INPUT 0x01
+#define IRAM_ATTR
+#define FSPI 0
+
+struct ArduinoShim {
+    std::function<void(uint8_t pin, uint8_t level)> onDigitalWrite;
+    uint64_t elapsedUs = 0;
+};
+
+inline ArduinoShim& arduinoShim() {
+    static ArduinoShim shim;
+    return shim;
+}
+
+inline void pinMode(uint8_t, uint8_t) {}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+    if (arduinoShim().onDigitalWrite) arduinoShim().onDigitalWrite(pin, level);
+}
+
+inline void delayMicroseconds(uint32_t us) { arduinoShim().elapsedUs += us; }
+inline void delay(uint32_t ms) { arduinoShim().elapsedUs += (uint64_t)ms * 1000; }
+inline unsigned long millis() { return (unsigned long)(arduinoShim().elapsedUs / 1000); }
+inline unsigned long micros() { return (unsigned long)arduinoShim().elapsedUs; }
+
+class String : public std::string {
+public:
+    String(const char* text = "") : std::string(text) {}
+};
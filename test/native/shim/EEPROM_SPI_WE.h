@@ -0,0 +1,34 @@
+#pragma once
+
+// Compile stand-in for the EEPROM_SPI_WE library, no EEPROM behind it
+
+#include <SPI.h>
+
+typedef enum EEPROM_SIZE : uint32_t { EEPROM_KBITS_0 = 0 } eeprom_size_t;
+
+typedef enum EEPROM_PAGE_SIZE {
+    EEPROM_PAGE_SIZE_16 = 16,
+    EEPROM_PAGE_SIZE_32 = 32,
+    EEPROM_PAGE_SIZE_64 = 64,
+    EEPROM_PAGE_SIZE_128 = 128,
+    EEPROM_PAGE_SIZE_256 = 256
+} eeprom_pageSize;
+
+class EEPROM_SPI_WE {
+public:
+    EEPROM_SPI_WE(SPIClass*, uint16_t, uint16_t = 999, uint32_t = 8000000) {}
+    bool init(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1, uint16_t = 999) { return false; }
+    bool probe() { return false; }
+    void setMemorySize(eeprom_size_t) {}
+    void setPageSize(eeprom_pageSize) {}
+    void setSmallEEPROM() {}
+    void write(uint32_t, uint8_t) {}
+    uint8_t read(uint32_t) { return 0xFF; }
+    template <typename T> void put(uint32_t, const T&) {}
+    template <typename T> void get(uint32_t, T&) {}
+    void putString(uint32_t, const String&) {}
+    void getString(uint32_t, String&) {}
+    void eraseCompleteEEPROM() {}
+    void eraseSector(uint32_t) {}
+    void erasePage(uint32_t) {}
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// Arduino SPIClass on the host. Every byte goes through device(), which a
+// test plugs to a simulated part, CS comes from digitalWrite in Arduino.h.
+// Driver calls are counted so tests can check how transfers are chunked.
+
+#include <Arduino.h>
+#include <vector>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings {
+public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+    std::function<uint8_t(uint8_t)> device;
+    uint32_t byteCalls = 0;                 // transfer(uint8_t)
+    std::vector<size_t> bulkCalls;          // length of each buffer call
+    uint32_t frequency = 0;
+
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+    void end() {}
+    void beginTransaction(SPISettings settings) { frequency = settings.clock; }
+    void endTransaction() {}
+
+    uint8_t transfer(uint8_t data) {
+        ++byteCalls;
+        return exchange(data);
+    }
+
+    void transfer(uint8_t* data, uint32_t size) {
+        bulkCalls.push_back(size);
+        for (uint32_t i = 0; i < size; ++i) data[i] = exchange(data[i]);
+    }
+
+    void transferBytes(const uint8_t* data, uint8_t* out, uint32_t size) {
+        bulkCalls.push_back(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            uint8_t in = exchange(data ? data[i] : 0xFF);
+            if (out) out[i] = in;
+        }
+    }
+
+    void writeBytes(const uint8_t* data, uint32_t size) {
+        bulkCalls.push_back(size);
+        for (uint32_t i = 0; i < size; ++i) exchange(data[i]);
+    }
+
+private:
+    uint8_t exchange(uint8_t data) { return device ? device(data) : 0xFF; }
+};
+
+inline SPIClass SPI;
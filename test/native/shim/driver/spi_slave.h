@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+typedef enum { SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2 } spi_host_device_t;
+
+typedef struct {
+    size_t length;
+    size_t trans_len;
+    const void* tx_buffer;
+    void* rx_buffer;
+    void* user;
+} spi_slave_transaction_t;
+
+inline int spi_slave_free(spi_host_device_t) { return 0; }
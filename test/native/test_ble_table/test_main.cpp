@@ -0,0 +1,262 @@
+#include <unity.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+#include "Services/BleAdvertisementTable.h"
+
+using Address = std::array<uint8_t, 6>;
+
+static Address addressOf(uint32_t n) {
+    return { 0xC0, 0xFF, (uint8_t)(n >> 24), (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+}
+
+static const uint8_t FLAGS_ONLY[] = { 0x02, 0x01, 0x06 };
+
+static void see(BleAdvertisementTable& table, const Address& address, uint32_t nowMs, int8_t rssi = -60,
+                const uint8_t* payload = FLAGS_ONLY, size_t len = sizeof(FLAGS_ONLY)) {
+    table.update(address.data(), 0, rssi, payload, len, nowMs);
+}
+
+// Bucket of an address with the flags payload, mirrors the table's index hash
+static size_t bucketOf(const Address& address, size_t capacity) {
+    size_t buckets = 1;
+    while (buckets < capacity * 2) buckets <<= 1;
+    uint32_t h = BleAdvertisementTable::hashPayload(FLAGS_ONLY, sizeof(FLAGS_ONLY));
+    for (uint8_t b : address) {
+        h ^= b;
+        h *= 16777619u;
+    }
+    return h & (buckets - 1);
+}
+
+// First addresses from n onwards that share one bucket
+static std::vector<Address> colliding(size_t count, size_t capacity, uint32_t n = 1) {
+    std::vector<Address> found;
+    size_t bucket = bucketOf(addressOf(n), capacity);
+    for (; found.size() < count; ++n) {
+        if (bucketOf(addressOf(n), capacity) == bucket) found.push_back(addressOf(n));
+    }
+    return found;
+}
+
+static std::vector<BleAdvertisementTable::Entry> snapshotOf(const BleAdvertisementTable& table) {
+    std::vector<BleAdvertisementTable::Entry> out(table.getCapacity());
+    out.resize(table.snapshot(out.data(), out.size()));
+    return out;
+}
+
+static bool sameAddress(const BleAdvertisementTable::Entry& e, const Address& address) {
+    return memcmp(e.address, address.data(), 6) == 0;
+}
+
+static uint32_t countOf(const BleAdvertisementTable& table, const Address& address) {
+    for (const auto& e : snapshotOf(table)) {
+        if (sameAddress(e, address)) return e.count;
+    }
+    return 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_repeats_update_counters() {
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(8));
+    Address a = addressOf(1);
+
+    see(table, a, 100, -70);
+    see(table, a, 250, -40);
+    see(table, a, 400, -55);
+
+    TEST_ASSERT_EQUAL_UINT32(1, table.size());
+    auto e = snapshotOf(table)[0];
+    TEST_ASSERT_EQUAL_UINT32(3, e.count);
+    TEST_ASSERT_EQUAL_UINT32(100, e.firstSeenMs);
+    TEST_ASSERT_EQUAL_UINT32(400, e.lastSeenMs);
+    TEST_ASSERT_EQUAL_INT(-70, e.rssiMin);
+    TEST_ASSERT_EQUAL_INT(-40, e.rssiMax);
+    TEST_ASSERT_EQUAL_INT(-55, e.rssiAvg());
+    TEST_ASSERT_EQUAL_STRING("C0:FF:00:00:00:01", e.formatAddress().c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, table.getStats().received);
+    TEST_ASSERT_EQUAL_UINT32(1, table.getStats().inserted);
+}
+
+void test_new_payload_is_a_new_entry() {
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(8));
+    Address a = addressOf(1);
+    const uint8_t other[] = { 0x02, 0x01, 0x1A };
+
+    see(table, a, 1);
+    see(table, a, 2, -60, other, sizeof(other));
+    see(table, a, 3);
+
+    TEST_ASSERT_EQUAL_UINT32(2, table.size());
+    auto snap = snapshotOf(table);
+    TEST_ASSERT_EQUAL_UINT32(2, snap[0].count);
+    TEST_ASSERT_EQUAL_UINT32(1, snap[1].count);
+    TEST_ASSERT_EQUAL_HEX8(0x1A, snap[1].payload[2]);
+}
+
+void test_lru_eviction_order() {
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(4));
+
+    for (uint32_t n = 1; n <= 4; ++n) see(table, addressOf(n), n);
+    see(table, addressOf(1), 10);       // 2 is now the least recently seen
+    see(table, addressOf(5), 11);
+
+    TEST_ASSERT_EQUAL_UINT32(4, table.size());
+    TEST_ASSERT_EQUAL_UINT32(1, table.getStats().evicted);
+
+    auto snap = snapshotOf(table);
+    const uint32_t expected[] = { 5, 1, 4, 3 };
+    TEST_ASSERT_EQUAL_UINT32(4, snap.size());
+    for (size_t i = 0; i < 4; ++i) TEST_ASSERT_TRUE(sameAddress(snap[i], addressOf(expected[i])));
+
+    // The evicted one comes back as a new entry and pushes out 3
+    see(table, addressOf(2), 12);
+    TEST_ASSERT_EQUAL_UINT32(1, countOf(table, addressOf(2)));
+    TEST_ASSERT_EQUAL_UINT32(0, countOf(table, addressOf(3)));
+    TEST_ASSERT_EQUAL_UINT32(2, table.getStats().evicted);
+}
+
+// Three entries in one bucket, the one at chainPosition (0 newest) is evicted
+static void checkChainUnlink(size_t chainPosition) {
+    const size_t capacity = 8;
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(capacity));
+
+    auto chain = colliding(3, capacity);
+    std::vector<Address> fillers;
+    for (uint32_t n = 1000; fillers.size() < capacity - 3; ++n) {
+        if (bucketOf(addressOf(n), capacity) != bucketOf(chain[0], capacity)) fillers.push_back(addressOf(n));
+    }
+
+    // Chain head is the last inserted, so chain[2] -> chain[1] -> chain[0]
+    uint32_t now = 0;
+    for (auto& a : chain) see(table, a, ++now);
+    for (auto& a : fillers) see(table, a, ++now);
+
+    // Make the victim the least recently seen, then force an eviction
+    const Address& victim = chain[2 - chainPosition];
+    for (auto& a : chain) {
+        if (a != victim) see(table, a, ++now);
+    }
+    for (auto& a : fillers) see(table, a, ++now);
+    see(table, addressOf(5000), ++now);
+    TEST_ASSERT_EQUAL_UINT32(1, table.getStats().evicted);
+    TEST_ASSERT_EQUAL_UINT32(0, countOf(table, victim));
+
+    // The rest of the chain is still found, not inserted again
+    uint32_t inserted = table.getStats().inserted;
+    for (auto& a : chain) {
+        if (a == victim) continue;
+        see(table, a, ++now);
+        TEST_ASSERT_EQUAL_UINT32(3, countOf(table, a));
+    }
+    TEST_ASSERT_EQUAL_UINT32(inserted, table.getStats().inserted);
+    TEST_ASSERT_EQUAL_UINT32(capacity, table.size());
+}
+
+void test_evict_chain_head() { checkChainUnlink(0); }
+void test_evict_chain_middle() { checkChainUnlink(1); }
+void test_evict_chain_tail() { checkChainUnlink(2); }
+
+void test_matches_reference_lru() {
+    // Tiny table with many collisions, checked against a plain list after every update
+    const size_t capacity = 5;
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(capacity));
+
+    struct Seen { Address address; uint32_t count; };
+    std::vector<Seen> reference;   // most recent first
+    uint32_t seed = 7, evictions = 0;
+
+    for (uint32_t now = 1; now <= 5000; ++now) {
+        seed = seed * 1103515245u + 12345u;
+        Address a = addressOf((seed >> 16) % 12);
+        see(table, a, now);
+
+        auto it = std::find_if(reference.begin(), reference.end(), [&](const Seen& s) { return s.address == a; });
+        Seen s = { a, 1 };
+        if (it != reference.end()) {
+            s.count = it->count + 1;
+            reference.erase(it);
+        } else if (reference.size() == capacity) {
+            reference.pop_back();
+            evictions++;
+        }
+        reference.insert(reference.begin(), s);
+
+        auto snap = snapshotOf(table);
+        TEST_ASSERT_EQUAL_UINT32(reference.size(), snap.size());
+        for (size_t i = 0; i < snap.size(); ++i) {
+            TEST_ASSERT_TRUE(sameAddress(snap[i], reference[i].address));
+            TEST_ASSERT_EQUAL_UINT32(reference[i].count, snap[i].count);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(evictions, table.getStats().evicted);
+}
+
+void test_decode_fields() {
+    BleAdvertisementTable table;
+    TEST_ASSERT_TRUE(table.allocate(4));
+
+    // Flags, complete name, Apple iBeacon
+    std::vector<uint8_t> adv = { 0x02, 0x01, 0x06, 0x05, 0x09, 'T', 'a', 'g', '1' };
+    const uint8_t beacon[] = {
+        0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15,
+        0xF7, 0x82, 0x6D, 0xA6, 0x4F, 0xA2, 0x4E, 0x98, 0x80, 0x24, 0xBC, 0x5B, 0x71, 0xE0, 0x89, 0x3E,
+        0x00, 0x01, 0x00, 0x02, 0xC5,
+    };
+    adv.insert(adv.end(), beacon, beacon + sizeof(beacon));
+    TEST_ASSERT_EQUAL_UINT32(36, adv.size());
+
+    // Over the legacy limit, cut to 31 bytes so the beacon field is dropped
+    see(table, addressOf(1), 1, -50, adv.data(), adv.size());
+    auto e = snapshotOf(table)[0];
+    TEST_ASSERT_EQUAL_UINT32(BleAdvertisementTable::MAX_PAYLOAD, e.payloadLen);
+    TEST_ASSERT_TRUE(e.connectable);
+    TEST_ASSERT_EQUAL_STRING("Tag1", e.name);
+    TEST_ASSERT_FALSE(e.hasManufacturer);
+
+    see(table, addressOf(2), 2, -50, beacon, sizeof(beacon));
+    e = snapshotOf(table)[0];
+    TEST_ASSERT_TRUE(e.hasManufacturer);
+    TEST_ASSERT_EQUAL_HEX32(0x004C, e.companyId);
+    TEST_ASSERT_EQUAL_STRING("Apple iBeacon F7826DA6-..-893E 1/2", e.describeManufacturer().c_str());
+}
+
+void test_allocate_limits() {
+    BleAdvertisementTable table;
+    see(table, addressOf(1), 1);            // ignored before allocate
+    TEST_ASSERT_EQUAL_UINT32(0, table.size());
+
+    TEST_ASSERT_FALSE(table.allocate(0));
+    TEST_ASSERT_FALSE(table.allocate(0x8000));
+    TEST_ASSERT_TRUE(table.allocate(0x7FFF));
+    TEST_ASSERT_EQUAL_UINT32(0x7FFF, table.getCapacity());
+
+    see(table, addressOf(1), 1);
+    table.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, table.size());
+    TEST_ASSERT_EQUAL_UINT32(0, table.getStats().received);
+    see(table, addressOf(1), 2);
+    TEST_ASSERT_EQUAL_UINT32(1, countOf(table, addressOf(1)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_repeats_update_counters);
+    RUN_TEST(test_new_payload_is_a_new_entry);
+    RUN_TEST(test_lru_eviction_order);
+    RUN_TEST(test_evict_chain_head);
+    RUN_TEST(test_evict_chain_middle);
+    RUN_TEST(test_evict_chain_tail);
+    RUN_TEST(test_matches_reference_lru);
+    RUN_TEST(test_decode_fields);
+    RUN_TEST(test_allocate_limits);
+    return UNITY_END();
+}
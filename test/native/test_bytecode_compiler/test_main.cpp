@@ -0,0 +1,216 @@
+#include <unity.h>
+#include <cstdint>
+#include <vector>
+#include "Transformers/ByteCodeTransformer.h"
+
+// What a bus would see: one event per byte, reads by count, and delays
+// summed as long as nothing happens in between
+struct BusEvent {
+    ByteCodeEnum command;
+    uint64_t value;
+
+    bool operator==(const BusEvent& other) const {
+        return command == other.command && value == other.value;
+    }
+};
+
+static void pushDelay(std::vector<BusEvent>& events, uint64_t us) {
+    if (!events.empty() && events.back().command == ByteCodeEnum::DelayUs) {
+        events.back().value += us;
+    } else {
+        events.push_back({ByteCodeEnum::DelayUs, us});
+    }
+}
+
+// Reference, bytecodes executed one by one
+static std::vector<BusEvent> runNaive(const std::vector<ByteCode>& codes) {
+    std::vector<BusEvent> events;
+    for (const auto& code : codes) {
+        switch (code.getCommand()) {
+            case ByteCodeEnum::Write:
+                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
+                    events.push_back({ByteCodeEnum::Write, code.getData() & 0xFF});
+                }
+                break;
+            case ByteCodeEnum::Read:
+                for (uint32_t i = 0; i < code.getRepeat(); ++i) {
+                    events.push_back({ByteCodeEnum::Read, 1});
+                }
+                break;
+            case ByteCodeEnum::DelayUs:
+                pushDelay(events, code.getRepeat());
+                break;
+            case ByteCodeEnum::DelayMs:
+                pushDelay(events, (uint64_t)code.getRepeat() * 1000);
+                break;
+            case ByteCodeEnum::None:
+                break;
+            default:
+                events.push_back({code.getCommand(), code.getRepeat()});
+                break;
+        }
+    }
+    return events;
+}
+
+// Compiled ops expanded the same way
+static std::vector<BusEvent> runCompiled(const CompiledByteCode& program) {
+    std::vector<BusEvent> events;
+    for (const auto& op : program.getOps()) {
+        switch (op.command) {
+            case ByteCodeEnum::Write: {
+                const uint8_t* data = program.getData(op);
+                for (uint32_t i = 0; i < op.length; ++i) events.push_back({ByteCodeEnum::Write, data[i]});
+                break;
+            }
+            case ByteCodeEnum::Read:
+                for (uint32_t i = 0; i < op.length; ++i) events.push_back({ByteCodeEnum::Read, 1});
+                break;
+            case ByteCodeEnum::DelayUs:
+                pushDelay(events, op.length);
+                break;
+            default:
+                events.push_back({op.command, op.length});
+                break;
+        }
+    }
+    return events;
+}
+
+static void assertSameEvents(const std::vector<ByteCode>& codes) {
+    std::vector<BusEvent> expected = runNaive(codes);
+    std::vector<BusEvent> actual = runCompiled(ByteCodeTransformer::compile(codes));
+
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        TEST_ASSERT_EQUAL_INT((int)expected[i].command, (int)actual[i].command);
+        TEST_ASSERT_EQUAL_UINT64(expected[i].value, actual[i].value);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_program() {
+    CompiledByteCode program = ByteCodeTransformer::compile({});
+    TEST_ASSERT_EQUAL_UINT32(0, program.getOps().size());
+}
+
+void test_writes_merge_into_one_op() {
+    std::vector<ByteCode> codes = {
+        ByteCode(ByteCodeEnum::Write, 0xA0),
+        ByteCode(ByteCodeEnum::Write, 0x12, 8, 3),
+        ByteCode(ByteCodeEnum::Write, 0x34),
+    };
+    CompiledByteCode program = ByteCodeTransformer::compile(codes);
+
+    TEST_ASSERT_EQUAL_UINT32(1, program.getOps().size());
+    TEST_ASSERT_EQUAL_UINT32(5, program.getOps()[0].length);
+    const uint8_t expected[] = {0xA0, 0x12, 0x12, 0x12, 0x34};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, program.getData(program.getOps()[0]), sizeof(expected));
+    assertSameEvents(codes);
+}
+
+void test_reads_merge() {
+    std::vector<ByteCode> codes = {
+        ByteCode(ByteCodeEnum::Start),
+        ByteCode(ByteCodeEnum::Read, 0, 8, 4),
+        ByteCode(ByteCodeEnum::Read, 0, 8, 6),
+        ByteCode(ByteCodeEnum::Stop),
+        ByteCode(ByteCodeEnum::Read, 0, 8, 3),
+    };
+    CompiledByteCode program = ByteCodeTransformer::compile(codes);
+
+    TEST_ASSERT_EQUAL_UINT32(4, program.getOps().size());
+    TEST_ASSERT_EQUAL_UINT32(10, program.getOps()[1].length);
+    TEST_ASSERT_EQUAL_UINT32(3, program.getOps()[3].length);
+    assertSameEvents(codes);
+}
+
+void test_mixed_delays_merge() {
+    std::vector<ByteCode> codes = {
+        ByteCode(ByteCodeEnum::Write, 0x55),
+        ByteCode(ByteCodeEnum::DelayUs, 0, 8, 250),
+        ByteCode(ByteCodeEnum::DelayMs, 0, 8, 2),
+        ByteCode(ByteCodeEnum::DelayUs, 0, 8, 1),
+        ByteCode(ByteCodeEnum::Write, 0x56),
+    };
+    CompiledByteCode program = ByteCodeTransformer::compile(codes);
+
+    TEST_ASSERT_EQUAL_UINT32(3, program.getOps().size());
+    TEST_ASSERT_EQUAL_UINT32(2251, program.getOps()[1].length);
+    assertSameEvents(codes);
+}
+
+void test_long_delays_do_not_wrap() {
+    // 72 x 60 s is 4.32e9 us, past the 32-bit op length
+    std::vector<ByteCode> codes(72, ByteCode(ByteCodeEnum::DelayMs, 0, 8, 60000));
+    CompiledByteCode program = ByteCodeTransformer::compile(codes);
+
+    uint64_t total = 0;
+    for (const auto& op : program.getOps()) {
+        TEST_ASSERT_EQUAL_INT((int)ByteCodeEnum::DelayUs, (int)op.command);
+        total += op.length;
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, program.getOps().size());
+    TEST_ASSERT_EQUAL_UINT64(4320000000ULL, total);
+    assertSameEvents(codes);
+}
+
+void test_other_commands_keep_repeat() {
+    std::vector<ByteCode> codes = {
+        ByteCode(ByteCodeEnum::None),
+        ByteCode(ByteCodeEnum::TickClock, 0, 8, 7),
+        ByteCode(ByteCodeEnum::TickClock, 0, 8, 2),
+        ByteCode(ByteCodeEnum::SetDatHigh),
+        ByteCode(ByteCodeEnum::None),
+    };
+    CompiledByteCode program = ByteCodeTransformer::compile(codes);
+
+    TEST_ASSERT_EQUAL_UINT32(3, program.getOps().size());
+    TEST_ASSERT_EQUAL_UINT32(7, program.getOps()[0].length);
+    assertSameEvents(codes);
+}
+
+void test_random_programs_match_naive() {
+    static const ByteCodeEnum commands[] = {
+        ByteCodeEnum::Write, ByteCodeEnum::Read, ByteCodeEnum::Start, ByteCodeEnum::Stop,
+        ByteCodeEnum::DelayUs, ByteCodeEnum::DelayMs, ByteCodeEnum::TickClock,
+        ByteCodeEnum::AuxHigh, ByteCodeEnum::None
+    };
+    const size_t commandCount = sizeof(commands) / sizeof(commands[0]);
+
+    // Fixed seed so a failure is reproducible
+    uint32_t seed = 0x1234567;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % range;
+    };
+
+    for (int program = 0; program < 200; ++program) {
+        std::vector<ByteCode> codes;
+        size_t length = next(40);
+        for (size_t i = 0; i < length; ++i) {
+            ByteCodeEnum command = commands[next(commandCount)];
+            uint32_t repeat = 1 + next(5);
+            if (next(2)) {
+                codes.emplace_back(command, next(256), 8, repeat);
+            } else {
+                codes.emplace_back(command, next(256));
+            }
+        }
+        assertSameEvents(codes);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_program);
+    RUN_TEST(test_writes_merge_into_one_op);
+    RUN_TEST(test_reads_merge);
+    RUN_TEST(test_mixed_delays_merge);
+    RUN_TEST(test_long_delays_do_not_wrap);
+    RUN_TEST(test_other_commands_keep_repeat);
+    RUN_TEST(test_random_programs_match_naive);
+    return UNITY_END();
+}
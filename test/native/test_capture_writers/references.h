@@ -0,0 +1,83 @@
+#pragma once
+
+// Expected files, written from the VCD (IEEE 1364) and sigrok session specs
+
+// SCL/SDA at 1 MHz: 10 x 11, 5 x 01, 3 x 00, 2 x 10
+static const char REFERENCE_VCD_1MHZ[] = R"(
+$version ESP32 Bus Pirate $end
+$timescale 1 us $end
+$scope module capture $end
+$var wire 1 ! SCL $end
+$var wire 1 " SDA $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+1!
+1"
+$end
+#10
+0!
+#15
+0"
+#18
+1!
+#20
+)";
+
+// One channel at 3 MHz, no timescale divides the period, 1 ps rounding
+static const char REFERENCE_VCD_3MHZ[] = R"(
+$version ESP32 Bus Pirate $end
+$comment trigger at sample 1 $end
+$comment 3000000 Hz sample rate, timestamps rounded to 1 ps $end
+$timescale 1 ps $end
+$scope module capture $end
+$var wire 1 ! D0 $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+1!
+$end
+#333333
+0!
+#666667
+1!
+#1000000
+)";
+
+// 1024 Hz is a whole number of 100 ps ticks
+static const char REFERENCE_VCD_1024HZ[] = R"(
+$version ESP32 Bus Pirate $end
+$timescale 100 ps $end
+$scope module capture $end
+$var wire 1 ! D0 $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+0!
+$end
+#10000000000
+1!
+#10009765625
+)";
+
+static const char REFERENCE_SIGROK_METADATA[] = R"(
+[global]
+# pulse capture
+sigrok version=0.5.2
+
+[device 1]
+capturefile=logic-1
+total probes=3
+samplerate=250 kHz
+total analog=0
+probe1=CLK
+probe2=MOSI
+probe3=CS
+unitsize=1
+)";
+
+// Raw strings above start with a newline for readability
+inline const char* reference(const char* text) { return text + 1; }
@@ -0,0 +1,215 @@
+#include <unity.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Transformers/Crc32Transformer.h"
+#include "Transformers/SigrokTransformer.h"
+#include "Transformers/VcdTransformer.h"
+#include "references.h"
+
+static std::string output;
+static size_t sinkCalls = 0;
+
+static bool collect(const uint8_t* data, size_t length) {
+    output.append(reinterpret_cast<const char*>(data), length);
+    ++sinkCalls;
+    return true;
+}
+
+void setUp() {
+    output.clear();
+    sinkCalls = 0;
+}
+
+void tearDown() {}
+
+// Bit by bit CRC-32, independent from the nibble table under test
+static uint32_t slowCrc32(const std::string& data) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (unsigned char c : data) {
+        crc ^= c;
+        for (int i = 0; i < 8; ++i) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static uint32_t le16(const std::string& s, size_t at) {
+    return (uint8_t)s[at] | ((uint8_t)s[at + 1] << 8);
+}
+
+static uint32_t le32(const std::string& s, size_t at) {
+    return le16(s, at) | (le16(s, at + 2) << 16);
+}
+
+struct ZipFile {
+    std::string name;
+    std::string content;
+    uint16_t flags;
+};
+
+// Minimal stored zip reader, entries are found through the central directory
+static std::vector<ZipFile> readZip(const std::string& zip) {
+    std::vector<ZipFile> files;
+    TEST_ASSERT_TRUE(zip.size() >= 22);
+    size_t eocd = zip.size() - 22;
+    TEST_ASSERT_EQUAL_HEX32(0x06054b50, le32(zip, eocd));
+
+    size_t count = le16(zip, eocd + 10);
+    size_t at = le32(zip, eocd + 16);
+    for (size_t i = 0; i < count; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(0x02014b50, le32(zip, at));
+        uint16_t flags = le16(zip, at + 8);
+        TEST_ASSERT_EQUAL_UINT32(0, le16(zip, at + 10));    // stored
+        uint32_t crc = le32(zip, at + 16);
+        uint32_t size = le32(zip, at + 20);
+        TEST_ASSERT_EQUAL_UINT32(size, le32(zip, at + 24));
+        size_t nameLen = le16(zip, at + 28);
+        size_t extraLen = le16(zip, at + 30);
+        size_t commentLen = le16(zip, at + 32);
+        size_t local = le32(zip, at + 42);
+        std::string name = zip.substr(at + 46, nameLen);
+
+        // Local header names the same file
+        TEST_ASSERT_EQUAL_HEX32(0x04034b50, le32(zip, local));
+        TEST_ASSERT_EQUAL_UINT32(flags, le16(zip, local + 6));
+        TEST_ASSERT_EQUAL_UINT32(nameLen, le16(zip, local + 26));
+        TEST_ASSERT_EQUAL_STRING(name.c_str(), zip.substr(local + 30, nameLen).c_str());
+        size_t data = local + 30 + nameLen + le16(zip, local + 28);
+
+        std::string content = zip.substr(data, size);
+        TEST_ASSERT_EQUAL_HEX32(slowCrc32(content), crc);
+
+        if (flags & 0x0008) {
+            // Streamed, sizes and crc in the descriptor after the data
+            size_t d = data + size;
+            TEST_ASSERT_EQUAL_HEX32(0x08074b50, le32(zip, d));
+            TEST_ASSERT_EQUAL_HEX32(crc, le32(zip, d + 4));
+            TEST_ASSERT_EQUAL_UINT32(size, le32(zip, d + 8));
+        } else {
+            TEST_ASSERT_EQUAL_HEX32(crc, le32(zip, local + 14));
+            TEST_ASSERT_EQUAL_UINT32(size, le32(zip, local + 18));
+        }
+
+        files.push_back({ name, content, flags });
+        at += 46 + nameLen + extraLen + commentLen;
+    }
+    return files;
+}
+
+void test_crc32_check_value() {
+    const char* text = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, Crc32Transformer::update(0, (const uint8_t*)text, 9));
+
+    // Chained over two buffers gives the same result
+    uint32_t crc = Crc32Transformer::update(0, (const uint8_t*)text, 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, Crc32Transformer::update(crc, (const uint8_t*)text + 4, 5));
+}
+
+void test_vcd_whole_microseconds() {
+    VcdTransformer vcd(collect);
+    TEST_ASSERT_TRUE(vcd.begin({ "SCL", "SDA" }, 1000000));
+    TEST_ASSERT_TRUE(vcd.append(0x03, 10));
+    TEST_ASSERT_TRUE(vcd.append(0x02, 5));
+    TEST_ASSERT_TRUE(vcd.append(0x00, 3));
+    TEST_ASSERT_TRUE(vcd.append(0x01, 2));
+    TEST_ASSERT_TRUE(vcd.end());
+
+    TEST_ASSERT_EQUAL_STRING(reference(REFERENCE_VCD_1MHZ), output.c_str());
+    TEST_ASSERT_EQUAL_UINT32(output.size(), vcd.getBytesWritten());
+}
+
+void test_vcd_rounded_timescale() {
+    VcdTransformer vcd(collect);
+    vcd.setComment("trigger at sample 1");
+    TEST_ASSERT_TRUE(vcd.begin({ "D0" }, 3000000));
+    TEST_ASSERT_TRUE(vcd.append(1, 1));
+    TEST_ASSERT_TRUE(vcd.append(0, 1));
+    TEST_ASSERT_TRUE(vcd.append(1, 1));
+    TEST_ASSERT_TRUE(vcd.end());
+
+    TEST_ASSERT_EQUAL_STRING(reference(REFERENCE_VCD_3MHZ), output.c_str());
+}
+
+void test_vcd_binary_rate() {
+    VcdTransformer vcd(collect);
+    TEST_ASSERT_TRUE(vcd.begin({ "D0" }, 1024));
+    TEST_ASSERT_TRUE(vcd.append(0, 1024));
+    TEST_ASSERT_TRUE(vcd.append(1, 1));
+    TEST_ASSERT_TRUE(vcd.end());
+
+    TEST_ASSERT_EQUAL_STRING(reference(REFERENCE_VCD_1024HZ), output.c_str());
+}
+
+void test_vcd_long_capture_does_not_overflow() {
+    // 10^6 seconds at 3 MHz, 10^18 ps still fits 64 bits
+    VcdTransformer vcd(collect);
+    TEST_ASSERT_TRUE(vcd.begin({ "D0" }, 3000000));
+    for (int i = 0; i < 1000; ++i) TEST_ASSERT_TRUE(vcd.append(0, 3000000000u));
+    TEST_ASSERT_TRUE(vcd.append(1, 1));
+    TEST_ASSERT_TRUE(vcd.end());
+
+    TEST_ASSERT_TRUE(output.find("\n#1000000000000000000\n1!\n") != std::string::npos);
+    TEST_ASSERT_TRUE(output.find("\n#1000000000000333333\n") != std::string::npos);
+}
+
+void test_vcd_rejects_bad_headers() {
+    VcdTransformer vcd(collect);
+    TEST_ASSERT_FALSE(vcd.begin({}, 1000));
+    TEST_ASSERT_FALSE(vcd.begin({ "D0" }, 0));
+    TEST_ASSERT_FALSE(vcd.begin(std::vector<std::string>(9, "D"), 1000));
+}
+
+void test_sigrok_session() {
+    SigrokTransformer sr(collect);
+    sr.setComment("pulse capture");
+    TEST_ASSERT_TRUE(sr.begin({ "CLK", "MOSI", "CS" }, 250000));
+
+    // More than one flush block of samples
+    std::string expected;
+    for (int i = 0; i < 600; ++i) {
+        uint8_t sample = i & 0x07;
+        uint32_t count = 1 + (i % 11);
+        TEST_ASSERT_TRUE(sr.append(sample, count));
+        expected.append(count, (char)sample);
+    }
+    TEST_ASSERT_TRUE(sr.end());
+    TEST_ASSERT_TRUE(sinkCalls > 2);
+    TEST_ASSERT_EQUAL_UINT32(output.size(), sr.getBytesWritten());
+
+    std::vector<ZipFile> files = readZip(output);
+    TEST_ASSERT_EQUAL_UINT32(3, files.size());
+
+    // Version first, then the streamed samples, metadata once the length is known
+    TEST_ASSERT_EQUAL_STRING("version", files[0].name.c_str());
+    TEST_ASSERT_EQUAL_STRING("2", files[0].content.c_str());
+
+    TEST_ASSERT_EQUAL_STRING("logic-1-1", files[1].name.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0x0008, files[1].flags);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), files[1].content.size());
+    TEST_ASSERT_TRUE(expected == files[1].content);
+
+    TEST_ASSERT_EQUAL_STRING("metadata", files[2].name.c_str());
+    TEST_ASSERT_EQUAL_STRING(reference(REFERENCE_SIGROK_METADATA), files[2].content.c_str());
+}
+
+void test_sigrok_stops_on_sink_failure() {
+    // Header and version go through, the first sample block is refused
+    size_t calls = 0;
+    SigrokTransformer sr([&calls](const uint8_t*, size_t) { return ++calls <= 2; });
+    TEST_ASSERT_TRUE(sr.begin({ "D0" }, 1000));
+    TEST_ASSERT_FALSE(sr.append(1, 100000));
+    TEST_ASSERT_FALSE(sr.append(0, 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_vcd_whole_microseconds);
+    RUN_TEST(test_vcd_rounded_timescale);
+    RUN_TEST(test_vcd_binary_rate);
+    RUN_TEST(test_vcd_long_capture_does_not_overflow);
+    RUN_TEST(test_vcd_rejects_bad_headers);
+    RUN_TEST(test_sigrok_session);
+    RUN_TEST(test_sigrok_stops_on_sink_failure);
+    return UNITY_END();
+}
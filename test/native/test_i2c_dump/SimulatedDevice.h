@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "Interfaces/II2cBus.h"
+
+// Register file behind II2cBus, with a simulated clock.
+// A pointer write sets the register pointer, reads stream from it. A read
+// stops at the first refused register, so a burst that covers one comes back
+// short and a burst starting on one is NACKed outright.
+class SimulatedDevice : public II2cBus {
+public:
+    uint8_t deviceAddress = 0x3C;
+    bool present = true;
+    bool widePointer = false;           // expects a 16-bit pointer
+    size_t driverLimit = 32;            // maxTransfer()
+    size_t deviceLimit = 0;             // reads longer than this are NACKed, 0 for none
+    std::vector<uint8_t> registers;
+    std::set<uint32_t> refused;
+
+    std::vector<size_t> reads;          // requested length of every read
+    uint32_t pointerWrites = 0;
+    uint32_t badPointers = 0;           // pointer writes of the wrong width
+
+    explicit SimulatedDevice(size_t size = 256) : registers(size) {
+        for (size_t i = 0; i < size; ++i) registers[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    bool write(uint8_t address, const uint8_t* data, size_t len, bool) override {
+        clock += TRANSACTION_US + len * BYTE_US;
+        if (!present || address != deviceAddress) return false;
+        if (len == 0) return true;
+
+        pointerWrites++;
+        if (len != (widePointer ? 2u : 1u)) badPointers++;
+        pointer = widePointer && len >= 2 ? (uint32_t)((data[0] << 8) | data[1]) : data[0];
+        return true;
+    }
+
+    size_t read(uint8_t address, uint8_t* out, size_t len) override {
+        clock += TRANSACTION_US + len * BYTE_US;
+        reads.push_back(len);
+        if (!present || address != deviceAddress || len > driverLimit) return 0;
+        if (deviceLimit && len > deviceLimit) return 0;
+
+        size_t n = 0;
+        while (n < len && pointer < registers.size() && !refused.count(pointer)) {
+            out[n++] = registers[pointer++];
+        }
+        return n;
+    }
+
+    size_t maxTransfer() const override { return driverLimit; }
+    uint32_t nowUs() override { return (uint32_t)clock; }
+    void delayUs(uint32_t us) override { clock += us; }
+
+    size_t largestReadFrom(size_t index) const {
+        size_t largest = 0;
+        for (size_t i = index; i < reads.size(); ++i) largest = reads[i] > largest ? reads[i] : largest;
+        return largest;
+    }
+
+private:
+    static constexpr uint32_t TRANSACTION_US = 30;     // start, address and stop at 400 kHz
+    static constexpr uint32_t BYTE_US = 23;
+
+    uint64_t clock = 0;
+    uint32_t pointer = 0;
+};
@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <cstddef>
+#include <vector>
+#include "Services/I2cDumpEngine.h"
+#include "SimulatedDevice.h"
+
+static size_t countValid(const I2cDumpEngine::Result& result) {
+    size_t n = 0;
+    for (bool v : result.valid) n += v;
+    return n;
+}
+
+// Registers read back match the device, the refused ones stay unknown
+static void checkDump(const SimulatedDevice& dev, const I2cDumpEngine::Result& result) {
+    for (size_t i = 0; i < result.values.size(); ++i) {
+        uint32_t reg = result.start + i;
+        bool readable = reg < dev.registers.size() && !dev.refused.count(reg);
+        TEST_ASSERT_EQUAL_INT(readable, (bool)result.valid[i]);
+        TEST_ASSERT_EQUAL_HEX8(readable ? dev.registers[reg] : 0xFF, result.values[i]);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_clean_dump_uses_full_bursts() {
+    SimulatedDevice dev;
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0, 256, false, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(8, dev.reads.size());
+    TEST_ASSERT_EQUAL_UINT32(16, result.transactions);
+    TEST_ASSERT_EQUAL_UINT16(32, result.minBurst);
+    TEST_ASSERT_EQUAL_UINT16(32, result.maxBurst);
+    TEST_ASSERT_EQUAL_UINT32(0, dev.badPointers);
+    TEST_ASSERT_TRUE(result.elapsedUs > 0);
+}
+
+void test_nack_splits_down_to_the_register() {
+    SimulatedDevice dev;
+    dev.refused = { 0x45 };
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0, 256, false, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(255, countValid(result));
+    TEST_ASSERT_EQUAL_UINT16(1, result.minBurst);
+    TEST_ASSERT_EQUAL_UINT16(32, result.maxBurst);
+    TEST_ASSERT_EQUAL_UINT32(2 * dev.reads.size(), result.transactions);
+
+    // Halving costs a few bursts, far from one transaction per register
+    TEST_ASSERT_LESS_OR_EQUAL(40, dev.reads.size());
+}
+
+void test_burst_grows_back_after_clean_run() {
+    SimulatedDevice dev;
+    dev.refused = { 0x45 };
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0, 256, false, result);
+
+    // Last single register burst, then doubling back to the driver limit
+    size_t lastSingle = 0;
+    for (size_t i = 0; i < dev.reads.size(); ++i) {
+        if (dev.reads[i] == 1) lastSingle = i;
+    }
+    TEST_ASSERT_TRUE(lastSingle > 0);
+    TEST_ASSERT_EQUAL_UINT32(32, dev.largestReadFrom(lastSingle));
+
+    // Never asks past the driver limit
+    TEST_ASSERT_EQUAL_UINT32(32, dev.largestReadFrom(0));
+}
+
+void test_scattered_refused_registers() {
+    SimulatedDevice dev;
+    dev.refused = { 0x00, 0x1F, 0x20, 0x80, 0x81, 0x82, 0xFF };
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0, 256, false, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(256 - dev.refused.size(), countValid(result));
+}
+
+void test_missing_upper_half() {
+    // Only 128 registers, everything above NACKs
+    SimulatedDevice dev(128);
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0x40, 192, false, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(64, countValid(result));
+    TEST_ASSERT_TRUE(result.any());
+}
+
+void test_absent_device() {
+    SimulatedDevice dev;
+    dev.present = false;
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0, 16, false, result);
+
+    TEST_ASSERT_FALSE(result.any());
+    TEST_ASSERT_EQUAL_UINT16(0, result.minBurst);
+    TEST_ASSERT_EQUAL_UINT16(0, result.maxBurst);
+    for (uint8_t v : result.values) TEST_ASSERT_EQUAL_HEX8(0xFF, v);
+}
+
+void test_wide_pointer() {
+    SimulatedDevice dev(4096);
+    dev.widePointer = true;
+    dev.refused = { 0xF40 };
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRegisters(dev.deviceAddress, 0xF00, 200, true, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(199, countValid(result));
+    TEST_ASSERT_EQUAL_UINT32(0, dev.badPointers);
+}
+
+void test_cancel_between_transactions() {
+    SimulatedDevice dev;
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    int calls = 0;
+    engine.readRegisters(dev.deviceAddress, 0, 256, false, result, [&]() { return ++calls > 3; });
+
+    TEST_ASSERT_TRUE(result.cancelled);
+    TEST_ASSERT_EQUAL_UINT32(3, dev.reads.size());
+    TEST_ASSERT_EQUAL_UINT32(96, countValid(result));
+    TEST_ASSERT_TRUE(result.valid[95]);
+    TEST_ASSERT_FALSE(result.valid[96]);
+}
+
+void test_raw_shrinks_to_device_limit() {
+    // Device refuses reads over 8 bytes, the driver would take 32
+    SimulatedDevice dev;
+    dev.deviceLimit = 8;
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRaw(dev.deviceAddress, 0x10, 64, result);
+
+    checkDump(dev, result);
+    TEST_ASSERT_EQUAL_UINT32(64, countValid(result));
+    TEST_ASSERT_EQUAL_UINT32(1, dev.pointerWrites);
+    TEST_ASSERT_EQUAL_UINT16(8, result.maxBurst);
+    TEST_ASSERT_EQUAL_UINT32(2 + 8, dev.reads.size());     // 32 and 16 refused, then 8 at a time
+}
+
+void test_raw_stops_where_the_stream_ends() {
+    SimulatedDevice dev;
+    dev.refused = { 0x30 };
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRaw(dev.deviceAddress, 0x10, 64, result);
+
+    TEST_ASSERT_EQUAL_UINT32(32, countValid(result));
+    TEST_ASSERT_TRUE(result.valid[31]);
+    TEST_ASSERT_FALSE(result.valid[32]);
+    TEST_ASSERT_FALSE(result.valid[63]);
+    TEST_ASSERT_EQUAL_HEX8(dev.registers[0x2F], result.values[31]);
+}
+
+void test_raw_absent_device() {
+    SimulatedDevice dev;
+    dev.present = false;
+    I2cDumpEngine engine(dev);
+    I2cDumpEngine::Result result;
+
+    engine.readRaw(dev.deviceAddress, 0, 32, result);
+
+    TEST_ASSERT_FALSE(result.any());
+    TEST_ASSERT_EQUAL_UINT32(1, result.transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, dev.reads.size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_dump_uses_full_bursts);
+    RUN_TEST(test_nack_splits_down_to_the_register);
+    RUN_TEST(test_burst_grows_back_after_clean_run);
+    RUN_TEST(test_scattered_refused_registers);
+    RUN_TEST(test_missing_upper_half);
+    RUN_TEST(test_absent_device);
+    RUN_TEST(test_wide_pointer);
+    RUN_TEST(test_cancel_between_transactions);
+    RUN_TEST(test_raw_shrinks_to_device_limit);
+    RUN_TEST(test_raw_stops_where_the_stream_ends);
+    RUN_TEST(test_raw_absent_device);
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "Interfaces/II2cBus.h"
+
+// 24Cxx EEPROM behind II2cBus, with a simulated clock.
+// Parts with 8-bit addresses and more than 256 bytes answer on one device
+// address per 256 byte block. Page writes wrap inside the page and the chip
+// NACKs everything during its internal write cycle. Sequential reads roll over
+// at the end of the block, the strictest behaviour among vendors.
+class SimulatedEeprom : public II2cBus {
+public:
+    struct Config {
+        uint8_t deviceAddress = 0x50;
+        uint32_t sizeBytes = 256;
+        uint16_t pageSize = 8;
+        uint8_t addressBytes = 1;
+        uint32_t writeCycleUs = 5000;   // 0xFFFFFFFF never ends
+        size_t maxTransfer = 128;
+    };
+
+    std::vector<uint8_t> memory;
+    uint32_t writeCycles = 0;
+    uint32_t wrappedWrites = 0;         // page writes that ran past the page end
+    uint32_t usedDevices = 0;           // bit per device address offset seen
+
+    explicit SimulatedEeprom(const Config& config)
+        : memory(config.sizeBytes, 0xFF), config(config) {}
+
+    bool write(uint8_t address, const uint8_t* data, size_t len, bool sendStop = true) override {
+        clock += TRANSACTION_US + len * BYTE_US;
+        int block = blockOf(address);
+        if (block < 0 || busy() || len > config.maxTransfer) return false;
+        if (len == 0) return true;
+        if (len < config.addressBytes) return false;
+        usedDevices |= 1u << (address - config.deviceAddress);
+
+        uint32_t word = data[0];
+        if (config.addressBytes == 2) word = (word << 8) | data[1];
+        pointer = ((uint32_t)block * blockBytes() + word) % config.sizeBytes;
+
+        size_t payload = len - config.addressBytes;
+        if (payload == 0) return true;
+        if (!sendStop) return true;     // data without a stop is never committed
+
+        // The page latch wraps, the cycle starts at the stop
+        uint32_t pageStart = pointer - pointer % config.pageSize;
+        uint32_t offset = pointer % config.pageSize;
+        if (offset + payload > config.pageSize) wrappedWrites++;
+        for (size_t i = 0; i < payload; ++i) {
+            memory[pageStart + (offset + i) % config.pageSize] = data[config.addressBytes + i];
+        }
+        pointer = pageStart + (offset + payload) % config.pageSize;
+        writeCycles++;
+        busyUntil = config.writeCycleUs == 0xFFFFFFFF ? UINT64_MAX : clock + config.writeCycleUs;
+        return true;
+    }
+
+    size_t read(uint8_t address, uint8_t* out, size_t len) override {
+        clock += TRANSACTION_US + len * BYTE_US;
+        int block = blockOf(address);
+        if (block < 0 || busy() || len > config.maxTransfer) return 0;
+        usedDevices |= 1u << (address - config.deviceAddress);
+
+        // The current address read starts where the pointer is, whatever block was addressed
+        uint32_t blockStart = pointer - pointer % blockBytes();
+        for (size_t i = 0; i < len; ++i) {
+            out[i] = memory[pointer];
+            pointer = blockStart + (pointer - blockStart + 1) % blockBytes();
+        }
+        return len;
+    }
+
+    size_t maxTransfer() const override { return config.maxTransfer; }
+    uint32_t nowUs() override { return (uint32_t)clock; }
+    void delayUs(uint32_t us) override { clock += us; }
+
+private:
+    static constexpr uint32_t TRANSACTION_US = 30;     // start, address and stop at 400 kHz
+    static constexpr uint32_t BYTE_US = 23;
+
+    Config config;
+    uint64_t clock = 0;
+    uint64_t busyUntil = 0;
+    uint32_t pointer = 0;
+
+    bool busy() const { return clock < busyUntil; }
+
+    uint32_t blockBytes() const {
+        uint32_t bytes = 1u << (8 * config.addressBytes);
+        return bytes < config.sizeBytes ? bytes : config.sizeBytes;
+    }
+
+    int blockOf(uint8_t address) const {
+        uint32_t blocks = config.sizeBytes / blockBytes();
+        if (address < config.deviceAddress || address >= config.deviceAddress + blocks) return -1;
+        return address - config.deviceAddress;
+    }
+};
@@ -0,0 +1,221 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "Services/I2cEepromEngine.h"
+#include "Transformers/Crc32Transformer.h"
+#include "SimulatedEeprom.h"
+
+// Engine geometry matching a simulated part
+static I2cEepromEngine::Geometry geometryOf(const SimulatedEeprom::Config& config) {
+    I2cEepromEngine::Geometry g;
+    g.deviceAddress = config.deviceAddress;
+    g.sizeBytes = config.sizeBytes;
+    g.pageSize = config.pageSize;
+    g.addressBytes = config.addressBytes;
+    g.blockShift = 0;
+    return g;
+}
+
+static SimulatedEeprom::Config part(uint32_t size, uint16_t page, uint8_t addressBytes, size_t maxTransfer = 128) {
+    SimulatedEeprom::Config config;
+    config.sizeBytes = size;
+    config.pageSize = page;
+    config.addressBytes = addressBytes;
+    config.maxTransfer = maxTransfer;
+    return config;
+}
+
+static std::vector<uint8_t> pattern(uint32_t len, uint32_t seed) {
+    std::vector<uint8_t> data(len);
+    for (auto& b : data) {
+        seed = seed * 1103515245u + 12345u;
+        b = (uint8_t)(seed >> 16);
+    }
+    return data;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_write_splits_at_page_boundaries() {
+    auto config = part(256, 16, 1);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    // 5..15, 16..31, 32..40
+    auto data = pattern(36, 1);
+    TEST_ASSERT_TRUE(engine.write(5, data.data(), data.size()));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.wrappedWrites);
+    TEST_ASSERT_EQUAL_UINT32(3, sim.writeCycles);
+    TEST_ASSERT_EQUAL_UINT32(3, engine.getStats().pages);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), sim.memory.data() + 5, data.size());
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim.memory[4]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim.memory[41]);
+}
+
+void test_page_wrap_without_engine() {
+    // What the engine avoids: a write past the page end lands on its start
+    auto config = part(256, 8, 1);
+    SimulatedEeprom sim(config);
+    const uint8_t frame[] = { 6, 0xA1, 0xA2, 0xA3 };
+    TEST_ASSERT_TRUE(sim.write(0x50, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(1, sim.wrappedWrites);
+    TEST_ASSERT_EQUAL_HEX8(0xA1, sim.memory[6]);
+    TEST_ASSERT_EQUAL_HEX8(0xA2, sim.memory[7]);
+    TEST_ASSERT_EQUAL_HEX8(0xA3, sim.memory[0]);
+}
+
+void test_write_chunks_at_driver_limit() {
+    // 24C256, 64 byte pages but only 32 bytes per transaction, address included
+    auto config = part(32768, 64, 2, 32);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    auto data = pattern(300, 2);
+    TEST_ASSERT_TRUE(engine.write(0x1F0, data.data(), data.size()));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.wrappedWrites);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), sim.memory.data() + 0x1F0, data.size());
+
+    std::vector<uint8_t> back(data.size());
+    TEST_ASSERT_TRUE(engine.read(0x1F0, back.data(), back.size()));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), back.data(), data.size());
+}
+
+static void checkBlockRollover(uint32_t size) {
+    // 24x04/08/16, 8-bit address and one device address per 256 bytes
+    auto config = part(size, 16, 1);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    auto data = pattern(size, size);
+    TEST_ASSERT_TRUE(engine.write(0, data.data(), size));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), sim.memory.data(), size);
+    TEST_ASSERT_EQUAL_UINT32((1u << (size / 256)) - 1, sim.usedDevices);
+
+    // One read across every block, readdressed at each boundary
+    std::vector<uint8_t> back(size);
+    TEST_ASSERT_TRUE(engine.read(0, back.data(), size));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), back.data(), size);
+
+    // Starting inside a block
+    std::vector<uint8_t> middle(300);
+    TEST_ASSERT_TRUE(engine.read(200, middle.data(), middle.size()));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data() + 200, middle.data(), middle.size());
+}
+
+void test_block_rollover_24x04() { checkBlockRollover(512); }
+void test_block_rollover_24x08() { checkBlockRollover(1024); }
+void test_block_rollover_24x16() { checkBlockRollover(2048); }
+
+void test_ack_polling_waits_for_write_cycle() {
+    auto config = part(256, 8, 1);
+    config.writeCycleUs = 3000;
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    const uint8_t data[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    TEST_ASSERT_TRUE(engine.write(0, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(2, engine.getStats().pages);
+    TEST_ASSERT_TRUE(engine.getStats().polls > 0);
+
+    // Polled until the cycle ends, not far past it
+    uint32_t waited = engine.getStats().writeWaitUs;
+    TEST_ASSERT_GREATER_OR_EQUAL(2 * 2900, waited);
+    TEST_ASSERT_LESS_OR_EQUAL(2 * 3200, waited);
+}
+
+void test_ack_polling_timeout() {
+    auto config = part(256, 8, 1);
+    config.writeCycleUs = 0xFFFFFFFF;
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    auto geometry = geometryOf(config);
+    geometry.writeTimeoutMs = 10;
+    engine.setGeometry(geometry);
+
+    const uint8_t data[4] = { 1, 2, 3, 4 };
+    TEST_ASSERT_FALSE(engine.write(0, data, sizeof(data)));
+    TEST_ASSERT_TRUE(engine.getError().find("did not end within 10 ms") != std::string::npos);
+    TEST_ASSERT_GREATER_OR_EQUAL(10000, engine.getStats().writeWaitUs);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.writeCycles);
+
+    // Still busy, the next write waits once more and gives up
+    TEST_ASSERT_FALSE(engine.write(8, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(1, sim.writeCycles);
+}
+
+void test_fill_and_verify_crc() {
+    auto config = part(4096, 32, 2, 64);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    TEST_ASSERT_TRUE(engine.fill(100, 0xA5, 1000));
+    TEST_ASSERT_TRUE(engine.verifyFill(100, 0xA5, 1000));
+    TEST_ASSERT_FALSE(engine.verifyFill(100, 0x5A, 1000));
+
+    std::vector<uint8_t> expected(1000, 0xA5);
+    uint32_t crc = 0;
+    TEST_ASSERT_TRUE(engine.crc(100, 1000, crc));
+    TEST_ASSERT_EQUAL_HEX32(Crc32Transformer::update(0, expected.data(), expected.size()), crc);
+
+    // A flipped bit is caught
+    sim.memory[700] ^= 0x10;
+    TEST_ASSERT_FALSE(engine.verifyFill(100, 0xA5, 1000));
+    TEST_ASSERT_TRUE(engine.getError().find("Verify failed") != std::string::npos);
+}
+
+void test_write_and_verify() {
+    auto config = part(2048, 16, 1);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    auto data = pattern(777, 3);
+    TEST_ASSERT_TRUE(engine.write(250, data.data(), data.size()));
+    TEST_ASSERT_TRUE(engine.verify(250, data.data(), data.size()));
+
+    data[400] ^= 1;
+    TEST_ASSERT_FALSE(engine.verify(250, data.data(), data.size()));
+}
+
+void test_range_and_progress() {
+    auto config = part(256, 8, 1);
+    SimulatedEeprom sim(config);
+    I2cEepromEngine engine(sim);
+    engine.setGeometry(geometryOf(config));
+
+    uint8_t buf[32];
+    TEST_ASSERT_FALSE(engine.read(250, buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(engine.getError().find("beyond") != std::string::npos);
+
+    // Stopped by the progress callback after the first page
+    uint32_t calls = 0;
+    TEST_ASSERT_FALSE(engine.fill(0, 0x00, 64, [&](uint32_t done, uint32_t total) {
+        ++calls;
+        return done < 8 && total == 64;
+    }));
+    TEST_ASSERT_EQUAL_UINT32(1, calls);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.writeCycles);
+    TEST_ASSERT_EQUAL_STRING("Stopped", engine.getError().c_str());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_write_splits_at_page_boundaries);
+    RUN_TEST(test_page_wrap_without_engine);
+    RUN_TEST(test_write_chunks_at_driver_limit);
+    RUN_TEST(test_block_rollover_24x04);
+    RUN_TEST(test_block_rollover_24x08);
+    RUN_TEST(test_block_rollover_24x16);
+    RUN_TEST(test_ack_polling_waits_for_write_cycle);
+    RUN_TEST(test_ack_polling_timeout);
+    RUN_TEST(test_fill_and_verify_crc);
+    RUN_TEST(test_write_and_verify);
+    RUN_TEST(test_range_and_progress);
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "Services/IcmpSweepEngine.h"
+
+static std::string text(const in_addr& addr) {
+    char buf[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+    return buf;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_single_address() {
+    std::vector<in_addr> out;
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("192.168.1.7", out));
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_EQUAL_STRING("192.168.1.7", text(out[0]).c_str());
+}
+
+void test_prefix_32_is_the_host_itself() {
+    std::vector<in_addr> out;
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("10.0.0.255/32", out));
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_EQUAL_STRING("10.0.0.255", text(out[0]).c_str());
+
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("255.255.255.255/32", out));
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_EQUAL_STRING("255.255.255.255", text(out[0]).c_str());
+}
+
+void test_prefix_31_keeps_both_addresses() {
+    // Point to point link, RFC 3021, no network or broadcast address
+    std::vector<in_addr> out;
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("10.1.2.5/31", out));
+    TEST_ASSERT_EQUAL_UINT32(2, out.size());
+    TEST_ASSERT_EQUAL_STRING("10.1.2.4", text(out[0]).c_str());
+    TEST_ASSERT_EQUAL_STRING("10.1.2.5", text(out[1]).c_str());
+}
+
+void test_prefix_30_drops_network_and_broadcast() {
+    std::vector<in_addr> out;
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("172.16.0.9/30", out));
+    TEST_ASSERT_EQUAL_UINT32(2, out.size());
+    TEST_ASSERT_EQUAL_STRING("172.16.0.9", text(out[0]).c_str());
+    TEST_ASSERT_EQUAL_STRING("172.16.0.10", text(out[1]).c_str());
+}
+
+void test_host_bits_are_masked() {
+    std::vector<in_addr> out;
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("192.168.4.77/24", out));
+    TEST_ASSERT_EQUAL_UINT32(254, out.size());
+    TEST_ASSERT_EQUAL_STRING("192.168.4.1", text(out.front()).c_str());
+    TEST_ASSERT_EQUAL_STRING("192.168.4.254", text(out.back()).c_str());
+}
+
+void test_max_targets_limit() {
+    std::vector<in_addr> out;
+
+    // /20 is 4094 hosts, the largest that fits
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("10.20.0.0/20", out));
+    TEST_ASSERT_EQUAL_UINT32(IcmpSweepEngine::MAX_TARGETS - 2, out.size());
+    TEST_ASSERT_EQUAL_STRING("10.20.0.1", text(out.front()).c_str());
+    TEST_ASSERT_EQUAL_STRING("10.20.15.254", text(out.back()).c_str());
+
+    TEST_ASSERT_FALSE(IcmpSweepEngine::parseCidr("10.20.0.0/19", out));
+    TEST_ASSERT_TRUE(out.empty());
+
+    // The caller can lower the limit
+    TEST_ASSERT_FALSE(IcmpSweepEngine::parseCidr("10.20.0.0/24", out, 253));
+    TEST_ASSERT_TRUE(IcmpSweepEngine::parseCidr("10.20.0.0/24", out, 254));
+}
+
+void test_prefix_0_is_rejected() {
+    // The whole address space, far over the limit and must not wrap
+    std::vector<in_addr> out;
+    TEST_ASSERT_FALSE(IcmpSweepEngine::parseCidr("0.0.0.0/0", out));
+    TEST_ASSERT_FALSE(IcmpSweepEngine::parseCidr("8.8.8.8/0", out));
+    TEST_ASSERT_TRUE(out.empty());
+}
+
+void test_malformed_input() {
+    std::vector<in_addr> out;
+    const char* bad[] = {
+        "", "/24", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/-1", "10.0.0.0/024",
+        "10.0.0.0/2a", "10.0.0/24", "10.0.0.256", "host.local", "10.0.0.0/24 ",
+    };
+    for (const char* cidr : bad) {
+        out.assign(3, in_addr{});
+        TEST_ASSERT_FALSE(IcmpSweepEngine::parseCidr(cidr, out));
+        TEST_ASSERT_TRUE(out.empty());
+    }
+}
+
+void test_sweep_rejects_oversized_list() {
+    IcmpSweepEngine engine;
+    std::vector<IcmpSweepEngine::Result> alive;
+
+    TEST_ASSERT_TRUE(engine.sweep({}, alive));
+    TEST_ASSERT_EQUAL_UINT32(0, engine.getSent());
+
+    std::vector<in_addr> targets(IcmpSweepEngine::MAX_TARGETS + 1);
+    TEST_ASSERT_FALSE(engine.sweep(targets, alive));
+    TEST_ASSERT_EQUAL_UINT32(0, engine.getSent());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_address);
+    RUN_TEST(test_prefix_32_is_the_host_itself);
+    RUN_TEST(test_prefix_31_keeps_both_addresses);
+    RUN_TEST(test_prefix_30_drops_network_and_broadcast);
+    RUN_TEST(test_host_bits_are_masked);
+    RUN_TEST(test_max_targets_limit);
+    RUN_TEST(test_prefix_0_is_rejected);
+    RUN_TEST(test_malformed_input);
+    RUN_TEST(test_sweep_rejects_oversized_list);
+    return UNITY_END();
+}
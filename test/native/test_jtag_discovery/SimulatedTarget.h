@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Interfaces/IGpioBus.h"
+
+// JTAG target wired to unknown GPIOs of an IGpioBus. Pins not driven by the
+// bus read high, like the TAP input pull-ups. TDO is only driven in the shift
+// states and changes on the falling edge of TCK. A device with an IDCODE
+// selects it on reset, an all ones IR selects BYPASS and any other IR keeps
+// IDCODE.
+class SimulatedTarget : public IGpioBus {
+public:
+    struct Pins {
+        uint8_t tck;
+        uint8_t tms;
+        uint8_t tdi;
+        uint8_t tdo;
+        int trst = -1;
+    };
+
+    struct Device {
+        uint8_t irLength;
+        uint32_t idcode;        // 0 for a part without IDCODE
+        bool bypass = false;
+        uint64_t shift = 0;
+        uint8_t length = 0;
+    };
+
+    enum State {
+        Reset, Idle,
+        DrSelect, DrCapture, DrShift, DrExit1, DrPause, DrExit2, DrUpdate,
+        IrSelect, IrCapture, IrShift, IrExit1, IrPause, IrExit2, IrUpdate
+    };
+
+    uint64_t risingEdges = 0;
+
+    SimulatedTarget(const Pins& pins, const std::vector<Device>& chain)
+        : pins(pins), devices(chain) {
+        resetDevices();
+    }
+
+    void setOutputs(uint64_t mask) override {
+        outputs = mask;
+        update();
+    }
+
+    void write(uint64_t high, uint64_t low) override {
+        levels = (levels | high) & ~low;
+        update();
+    }
+
+    uint64_t read() override {
+        uint64_t value = (levels & outputs) | ~outputs;
+        if (tdoDriven && !(outputs & bit(pins.tdo))) {
+            value = tdo ? value | bit(pins.tdo) : value & ~bit(pins.tdo);
+        }
+        return value;
+    }
+
+    void delayUs(uint32_t) override {}
+
+private:
+    Pins pins;
+    std::vector<Device> devices;
+    State state = Reset;
+    uint64_t outputs = 0;
+    uint64_t levels = 0;
+    bool tck = true;
+    bool tdo = true;
+    bool tdoDriven = false;
+
+    static uint64_t bit(uint8_t pin) { return 1ULL << pin; }
+
+    // What the TAP sees on one of its inputs
+    bool input(uint8_t pin) const {
+        return !(outputs & bit(pin)) || (levels & bit(pin));
+    }
+
+    static State next(State s, bool tms) {
+        static const State table[16][2] = {
+            { Idle, Reset },          { Idle, DrSelect },
+            { DrCapture, IrSelect },  { DrShift, DrExit1 },  { DrShift, DrExit1 },
+            { DrPause, DrUpdate },    { DrPause, DrExit2 },  { DrShift, DrUpdate },
+            { Idle, DrSelect },
+            { IrCapture, Reset },     { IrShift, IrExit1 },  { IrShift, IrExit1 },
+            { IrPause, IrUpdate },    { IrPause, IrExit2 },  { IrShift, IrUpdate },
+            { Idle, DrSelect }
+        };
+        return table[s][tms ? 1 : 0];
+    }
+
+    void resetDevices() {
+        for (auto& d : devices) d.bypass = d.idcode == 0;
+        state = Reset;
+        tdoDriven = false;
+    }
+
+    void update() {
+        if (pins.trst >= 0 && !input((uint8_t)pins.trst)) {
+            resetDevices();
+            tck = input(pins.tck);
+            return;
+        }
+
+        bool now = input(pins.tck);
+        if (!tck && now) risingEdge();
+        if (tck && !now) fallingEdge();
+        tck = now;
+    }
+
+    void risingEdge() {
+        ++risingEdges;
+        bool tms = input(pins.tms);
+        bool in = input(pins.tdi);
+
+        switch (state) {
+            case IrCapture:
+                for (auto& d : devices) { d.shift = 0x1; d.length = d.irLength; }
+                break;
+            case DrCapture:
+                for (auto& d : devices) {
+                    d.shift = d.bypass ? 0 : d.idcode;
+                    d.length = d.bypass ? 1 : 32;
+                }
+                break;
+            case IrShift:
+            case DrShift:
+                for (auto& d : devices) {
+                    bool out = d.shift & 1;
+                    d.shift = (d.shift >> 1) | ((uint64_t)in << (d.length - 1));
+                    in = out;
+                }
+                break;
+            default:
+                break;
+        }
+
+        state = next(state, tms);
+        if (state == IrUpdate) {
+            for (auto& d : devices) {
+                uint32_t ones = (1u << d.irLength) - 1;
+                d.bypass = (d.shift & ones) == ones || !d.idcode;
+            }
+        } else if (state == Reset) {
+            resetDevices();
+        }
+    }
+
+    void fallingEdge() {
+        tdoDriven = state == IrShift || state == DrShift;
+        tdo = tdoDriven ? (devices.back().shift & 1) : true;
+    }
+};
@@ -0,0 +1,137 @@
+#include <unity.h>
+#include <vector>
+#include "Services/JtagDiscoveryEngine.h"
+#include "SimulatedTarget.h"
+
+static const uint32_t ARM_IDCODE = 0x4BA00477;
+static const uint32_t FPGA_IDCODE = 0x0362D093;
+
+// Scrambled wiring, roles far from the pin order
+static const SimulatedTarget::Pins WIRING = { 13, 4, 21, 9, 17 };
+static const std::vector<uint8_t> CANDIDATES = { 4, 5, 9, 13, 17, 18, 21 };
+
+void setUp() {}
+void tearDown() {}
+
+static void assertPinout(const SimulatedTarget::Pins& expected, const JtagDiscoveryEngine::JtagPinout& found) {
+    TEST_ASSERT_EQUAL_UINT8(expected.tck, found.tck);
+    TEST_ASSERT_EQUAL_UINT8(expected.tms, found.tms);
+    TEST_ASSERT_EQUAL_UINT8(expected.tdi, found.tdi);
+    TEST_ASSERT_EQUAL_UINT8(expected.tdo, found.tdo);
+}
+
+void test_finds_single_tap() {
+    SimulatedTarget::Pins pins = WIRING;
+    pins.trst = -1;
+    SimulatedTarget sim(pins, { { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_TRUE(engine.findJtag(CANDIDATES, found));
+    assertPinout(pins, found);
+    TEST_ASSERT_EQUAL_INT(-1, found.trst);
+    TEST_ASSERT_EQUAL_INT(1, found.deviceCount);
+    TEST_ASSERT_EQUAL_UINT32(1, found.ids.size());
+    TEST_ASSERT_EQUAL_HEX32(ARM_IDCODE, found.ids[0]);
+    // Only the clocks sent on the real TCK reach the part
+    TEST_ASSERT_TRUE(sim.risingEdges > 0);
+    TEST_ASSERT_TRUE(engine.getCycles() > sim.risingEdges);
+}
+
+void test_finds_trst() {
+    SimulatedTarget sim(WIRING, { { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_TRUE(engine.findJtag(CANDIDATES, found));
+    assertPinout(WIRING, found);
+    TEST_ASSERT_EQUAL_INT(WIRING.trst, found.trst);
+}
+
+void test_chain_of_two() {
+    // The engine reads IDCODEs from the TDO end first
+    SimulatedTarget sim(WIRING, { { 10, FPGA_IDCODE }, { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_TRUE(engine.findJtag(CANDIDATES, found));
+    assertPinout(WIRING, found);
+    TEST_ASSERT_EQUAL_INT(2, found.deviceCount);
+    TEST_ASSERT_EQUAL_UINT32(2, found.ids.size());
+    TEST_ASSERT_EQUAL_HEX32(ARM_IDCODE, found.ids[0]);
+    TEST_ASSERT_EQUAL_HEX32(FPGA_IDCODE, found.ids[1]);
+}
+
+void test_bypass_only_target() {
+    // No IDCODE to see, found by the TCK/TMS/TDO triple search
+    SimulatedTarget::Pins pins = { 5, 18, 4, 13 };
+    SimulatedTarget sim(pins, { { 5, 0 } });
+    JtagDiscoveryEngine engine(sim);
+
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_TRUE(engine.findJtag({ 4, 5, 13, 18, 21 }, found));
+    assertPinout(pins, found);
+    TEST_ASSERT_EQUAL_INT(1, found.deviceCount);
+    TEST_ASSERT_EQUAL_INT(-1, found.trst);
+    TEST_ASSERT_EQUAL_UINT32(0, found.ids.size());
+}
+
+void test_no_target() {
+    SimulatedTarget::Pins pins = WIRING;
+    SimulatedTarget sim(pins, { { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    // TCK is not among the candidates
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_FALSE(engine.findJtag({ 4, 5, 9, 17, 18, 21 }, found));
+    TEST_ASSERT_FALSE(engine.wasAborted());
+}
+
+void test_too_few_pins() {
+    SimulatedTarget sim(WIRING, { { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    JtagDiscoveryEngine::JtagPinout found;
+    TEST_ASSERT_FALSE(engine.findJtag({ 4, 9, 13 }, found));
+    TEST_ASSERT_EQUAL_UINT64(0, engine.getCycles());
+}
+
+void test_progress_and_abort() {
+    SimulatedTarget sim(WIRING, { { 4, ARM_IDCODE } });
+    JtagDiscoveryEngine engine(sim);
+
+    size_t lastDone = 0;
+    bool monotonic = true;
+    JtagDiscoveryEngine::JtagPinout found;
+    bool ok = engine.findJtag(CANDIDATES, found, [&](const char* phase, size_t done, size_t total) {
+        monotonic &= done > lastDone && done <= total && phase != nullptr;
+        lastDone = done;
+        return done < 5;
+    });
+
+    TEST_ASSERT_FALSE(ok);
+    TEST_ASSERT_TRUE(engine.wasAborted());
+    TEST_ASSERT_TRUE(monotonic);
+    TEST_ASSERT_EQUAL_UINT32(5, lastDone);
+}
+
+void test_idcode_validation() {
+    TEST_ASSERT_TRUE(JtagDiscoveryEngine::isValidIdcode(ARM_IDCODE));
+    TEST_ASSERT_TRUE(JtagDiscoveryEngine::isValidIdcode(FPGA_IDCODE));
+    TEST_ASSERT_FALSE(JtagDiscoveryEngine::isValidIdcode(0xFFFFFFFF));
+    TEST_ASSERT_FALSE(JtagDiscoveryEngine::isValidIdcode(0x00000000));
+    TEST_ASSERT_FALSE(JtagDiscoveryEngine::isValidIdcode(ARM_IDCODE & ~1u));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_finds_single_tap);
+    RUN_TEST(test_finds_trst);
+    RUN_TEST(test_chain_of_two);
+    RUN_TEST(test_bypass_only_target);
+    RUN_TEST(test_no_target);
+    RUN_TEST(test_too_few_pins);
+    RUN_TEST(test_progress_and_abort);
+    RUN_TEST(test_idcode_validation);
+    return UNITY_END();
+}
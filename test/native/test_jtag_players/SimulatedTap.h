@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Interfaces/IGpioBus.h"
+
+// JTAG chain behind an IGpioBus, TDI -> devices[0] -> ... -> devices[n-1] -> TDO.
+// Registers shift on the rising edge of TCK and TDO changes on the falling
+// edge, like real parts. Instructions: IDCODE (1), USER (2, 8-bit register),
+// everything else selects BYPASS.
+class SimulatedTap : public IGpioBus {
+public:
+    static constexpr uint8_t TCK = 0;
+    static constexpr uint8_t TMS = 1;
+    static constexpr uint8_t TDI = 2;
+    static constexpr uint8_t TDO = 3;
+    static constexpr uint8_t TRST = 4;
+
+    static constexpr uint32_t IDCODE = 0x1;
+    static constexpr uint32_t USER = 0x2;
+
+    enum State {
+        Reset, Idle,
+        DrSelect, DrCapture, DrShift, DrExit1, DrPause, DrExit2, DrUpdate,
+        IrSelect, IrCapture, IrShift, IrExit1, IrPause, IrExit2, IrUpdate
+    };
+
+    struct Device {
+        uint8_t irLength;
+        uint32_t idcode;        // 0 for a part without IDCODE
+        uint32_t ir = 0;
+        uint8_t user = 0;
+        uint64_t irShift = 0;
+        uint64_t drShift = 0;
+        uint8_t drLength = 1;
+    };
+
+    std::vector<Device> devices;
+    State state = Reset;
+    uint64_t idleClocks = 0;
+    uint64_t drShiftClocks = 0;
+    uint64_t delayedUs = 0;
+
+    explicit SimulatedTap(const std::vector<Device>& chain) : devices(chain) {
+        resetDevices();
+    }
+
+    void setOutputs(uint64_t mask) override {
+        outputs = mask;
+        checkTrst();
+    }
+
+    void write(uint64_t high, uint64_t low) override {
+        uint64_t before = levels;
+        levels = (levels | high) & ~low;
+
+        bool tckBefore = before & bit(TCK);
+        bool tckNow = levels & bit(TCK);
+        if (!tckBefore && tckNow) risingEdge();
+        if (tckBefore && !tckNow) fallingEdge();
+        checkTrst();
+    }
+
+    uint64_t read() override {
+        return (levels & ~bit(TDO)) | (tdo ? bit(TDO) : 0);
+    }
+
+    void delayUs(uint32_t us) override { delayedUs += us; }
+
+private:
+    uint64_t outputs = 0;
+    uint64_t levels = 0;
+    bool tdo = false;
+
+    static uint64_t bit(uint8_t pin) { return 1ULL << pin; }
+
+    static State next(State s, bool tms) {
+        static const State table[16][2] = {
+            { Idle, Reset },          { Idle, DrSelect },
+            { DrCapture, IrSelect },  { DrShift, DrExit1 },  { DrShift, DrExit1 },
+            { DrPause, DrUpdate },    { DrPause, DrExit2 },  { DrShift, DrUpdate },
+            { Idle, DrSelect },
+            { IrCapture, Reset },     { IrShift, IrExit1 },  { IrShift, IrExit1 },
+            { IrPause, IrUpdate },    { IrPause, IrExit2 },  { IrShift, IrUpdate },
+            { Idle, DrSelect }
+        };
+        return table[s][tms ? 1 : 0];
+    }
+
+    void resetDevices() {
+        for (auto& d : devices) d.ir = d.idcode ? IDCODE : (1u << d.irLength) - 1;
+        state = Reset;
+    }
+
+    void checkTrst() {
+        // Active low, only while driven
+        if ((outputs & bit(TRST)) && !(levels & bit(TRST))) resetDevices();
+    }
+
+    void risingEdge() {
+        bool tms = levels & bit(TMS);
+        bool in = levels & bit(TDI);
+
+        switch (state) {
+            case IrCapture:
+                for (auto& d : devices) d.irShift = 0x1;    // 01 in the two low bits
+                break;
+            case DrCapture:
+                for (auto& d : devices) {
+                    if (d.ir == IDCODE && d.idcode) { d.drShift = d.idcode; d.drLength = 32; }
+                    else if (d.ir == USER && d.idcode) { d.drShift = d.user; d.drLength = 8; }
+                    else { d.drShift = 0; d.drLength = 1; }
+                }
+                break;
+            case IrShift:
+                for (auto& d : devices) {
+                    bool out = d.irShift & 1;
+                    d.irShift = (d.irShift >> 1) | ((uint64_t)in << (d.irLength - 1));
+                    in = out;
+                }
+                break;
+            case DrShift:
+                ++drShiftClocks;
+                for (auto& d : devices) {
+                    bool out = d.drShift & 1;
+                    d.drShift = (d.drShift >> 1) | ((uint64_t)in << (d.drLength - 1));
+                    in = out;
+                }
+                break;
+            case Idle:
+                if (!tms) ++idleClocks;
+                break;
+            default:
+                break;
+        }
+
+        state = next(state, tms);
+        if (state == IrUpdate) {
+            for (auto& d : devices) d.ir = d.irShift & ((1u << d.irLength) - 1);
+        } else if (state == DrUpdate) {
+            for (auto& d : devices) {
+                if (d.ir == USER && d.idcode) d.user = d.drShift & 0xFF;
+            }
+        } else if (state == Reset) {
+            resetDevices();
+        }
+    }
+
+    void fallingEdge() {
+        const Device& last = devices.back();
+        if (state == IrShift) tdo = last.irShift & 1;
+        else if (state == DrShift) tdo = last.drShift & 1;
+        else tdo = false;
+    }
+};
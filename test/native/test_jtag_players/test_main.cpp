@@ -0,0 +1,266 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Services/JtagTapEngine.h"
+#include "Services/SvfPlayer.h"
+#include "Services/XsvfPlayer.h"
+#include "SimulatedTap.h"
+
+static const uint32_t ARM_IDCODE = 0x4BA00477;
+
+static SimulatedTap::Device target() {
+    return SimulatedTap::Device{ 4, ARM_IDCODE };
+}
+
+static SimulatedTap::Device bypassOnly() {
+    return SimulatedTap::Device{ 1, 0 };
+}
+
+// Player, engine and simulated chain wired together
+struct Bench {
+    SimulatedTap sim;
+    JtagTapEngine tap;
+
+    explicit Bench(const std::vector<SimulatedTap::Device>& chain = { target() })
+        : sim(chain), tap(sim) {
+        tap.setPins(SimulatedTap::TCK, SimulatedTap::TMS, SimulatedTap::TDI, SimulatedTap::TDO, SimulatedTap::TRST);
+        tap.begin();
+    }
+};
+
+static bool playSvf(Bench& bench, const std::string& text, std::string* error = nullptr, size_t chunk = 0) {
+    SvfPlayer player(bench.tap);
+    player.begin();
+    bool ok = true;
+    if (chunk == 0) chunk = text.size();
+    for (size_t at = 0; ok && at < text.size(); at += chunk) {
+        ok = player.feed(text.data() + at, std::min(chunk, text.size() - at));
+    }
+    ok = ok && player.finish();
+    if (error) *error = player.getError();
+    return ok;
+}
+
+static bool playXsvf(Bench& bench, const std::vector<uint8_t>& bytes, std::string* error = nullptr, size_t chunk = 0) {
+    XsvfPlayer player(bench.tap);
+    player.begin();
+    bool ok = true;
+    if (chunk == 0) chunk = bytes.size();
+    for (size_t at = 0; ok && at < bytes.size(); at += chunk) {
+        ok = player.feed(bytes.data() + at, std::min(chunk, bytes.size() - at));
+    }
+    ok = ok && player.finish();
+    if (error) *error = player.getError();
+    return ok;
+}
+
+static const char* IDCODE_SVF =
+    "// Read the IDCODE\n"
+    "TRST OFF;\n"
+    "ENDIR IDLE;\n"
+    "ENDDR IDLE;\n"
+    "STATE RESET;\n"
+    "SIR 4 TDI (1);\n"
+    "SDR 32 TDI (00000000)\n"
+    "       TDO (4BA0\n"
+    "            0477) MASK (FFFFFFFF); ! hex groups may span lines\n";
+
+void setUp() {}
+void tearDown() {}
+
+void test_svf_reads_idcode() {
+    Bench bench;
+    std::string error;
+    TEST_ASSERT_TRUE_MESSAGE(playSvf(bench, IDCODE_SVF, &error), error.c_str());
+    TEST_ASSERT_EQUAL_INT(SimulatedTap::Idle, bench.sim.state);
+    TEST_ASSERT_EQUAL_INT((int)JtagTapEngine::TapState::Idle, (int)bench.tap.getState());
+    TEST_ASSERT_EQUAL_UINT32(SimulatedTap::IDCODE, bench.sim.devices[0].ir);
+}
+
+void test_svf_any_chunk_size() {
+    for (size_t chunk : { 1, 2, 3, 7, 64 }) {
+        Bench bench;
+        std::string error;
+        TEST_ASSERT_TRUE_MESSAGE(playSvf(bench, IDCODE_SVF, &error, chunk), error.c_str());
+    }
+}
+
+void test_svf_reports_tdo_mismatch() {
+    Bench bench;
+    std::string error;
+    TEST_ASSERT_FALSE(playSvf(bench, "SIR 4 TDI(1);\nSDR 32 TDI(0) TDO(4BA00476);\n", &error));
+    TEST_ASSERT_TRUE(error.find("TDO mismatch") != std::string::npos);
+
+    // Masked out bits don't count
+    Bench masked;
+    TEST_ASSERT_TRUE(playSvf(masked, "SIR 4 TDI(1);\nSDR 32 TDI(0) TDO(4BA00476) MASK(FFFFFFFE);\n"));
+}
+
+void test_svf_writes_and_reads_back_register() {
+    Bench bench;
+    std::string error;
+    const char* svf =
+        "SIR 4 TDI(2);\n"
+        "SDR 8 TDI(A5);\n"
+        "SDR 8 TDI(3C) TDO(A5);\n"
+        "SDR 8 TDI(00) TDO(3C);\n";
+    TEST_ASSERT_TRUE_MESSAGE(playSvf(bench, svf, &error), error.c_str());
+    TEST_ASSERT_EQUAL_HEX8(0x00, bench.sim.devices[0].user);
+}
+
+void test_svf_header_and_trailer_reach_other_devices() {
+    // Header bits are shifted first, they end up in the parts between the
+    // target and TDO: TDI -> target -> bypass only part -> TDO
+    Bench headed({ target(), bypassOnly() });
+    std::string error;
+    const char* header =
+        "HIR 1 TDI(1);\n"
+        "HDR 1 TDI(0);\n"
+        "SIR 4 TDI(1);\n"
+        "SDR 32 TDI(0) TDO(4BA00477);\n";
+    TEST_ASSERT_TRUE_MESSAGE(playSvf(headed, header, &error), error.c_str());
+    TEST_ASSERT_EQUAL_UINT32(SimulatedTap::IDCODE, headed.sim.devices[0].ir);
+    TEST_ASSERT_EQUAL_UINT32(1, headed.sim.devices[1].ir);
+
+    // Trailer bits come last and pad the parts between TDI and the target
+    Bench trailed({ bypassOnly(), target() });
+    const char* trailer =
+        "TIR 1 TDI(1);\n"
+        "TDR 1 TDI(0);\n"
+        "SIR 4 TDI(1);\n"
+        "SDR 32 TDI(0) TDO(4BA00477);\n";
+    TEST_ASSERT_TRUE_MESSAGE(playSvf(trailed, trailer, &error), error.c_str());
+    TEST_ASSERT_EQUAL_UINT32(SimulatedTap::IDCODE, trailed.sim.devices[1].ir);
+    TEST_ASSERT_EQUAL_UINT32(1, trailed.sim.devices[0].ir);
+
+    // Padding on the wrong side shifts the target's IDCODE out of place
+    Bench swapped({ bypassOnly(), target() });
+    TEST_ASSERT_FALSE(playSvf(swapped, header, &error));
+}
+
+void test_svf_runtest_clocks_and_time() {
+    Bench bench;
+    TEST_ASSERT_TRUE(playSvf(bench, "RUNTEST IDLE 100 TCK;\n"));
+    TEST_ASSERT_TRUE(bench.sim.idleClocks >= 100);
+
+    uint64_t before = bench.sim.delayedUs;
+    TEST_ASSERT_TRUE(playSvf(bench, "RUNTEST 1E-3 SEC;\n"));
+    TEST_ASSERT_EQUAL_UINT64(before + 1000, bench.sim.delayedUs);
+}
+
+void test_svf_frequency() {
+    Bench bench;
+    TEST_ASSERT_TRUE(playSvf(bench, "FREQUENCY 1E5 HZ;\n"));
+    TEST_ASSERT_EQUAL_UINT32(5, bench.tap.getHalfPeriodUs());
+
+    SvfPlayer player(bench.tap);
+    player.begin();
+    player.setBusMaxHz(500000);
+    const char* fast = "FREQUENCY 1E6 HZ;";
+    TEST_ASSERT_TRUE(player.feed(fast, strlen(fast)));
+    TEST_ASSERT_EQUAL_UINT32(0, bench.tap.getHalfPeriodUs());
+}
+
+void test_svf_trst_resets_the_chain() {
+    Bench bench;
+    TEST_ASSERT_TRUE(playSvf(bench, "SIR 4 TDI(2);\nTRST ON;\nTRST OFF;\n"));
+    TEST_ASSERT_EQUAL_UINT32(SimulatedTap::IDCODE, bench.sim.devices[0].ir);
+}
+
+void test_svf_errors() {
+    Bench bench;
+    std::string error;
+    TEST_ASSERT_FALSE(playSvf(bench, "FOO 1;\n", &error));
+    TEST_ASSERT_TRUE(error.find("Unknown command") != std::string::npos);
+    TEST_ASSERT_FALSE(playSvf(bench, "PIO (HLX);\n", &error));
+    TEST_ASSERT_FALSE(playSvf(bench, "SDR 8 TDI(12)\n", &error));
+    TEST_ASSERT_TRUE(error.find("Missing ';'") != std::string::npos);
+    TEST_ASSERT_FALSE(playSvf(bench, "STATE DRSHIFT;\n", &error));
+}
+
+// XSVF instructions, vectors are most significant byte first
+static void append(std::vector<uint8_t>& out, std::initializer_list<uint8_t> bytes) {
+    out.insert(out.end(), bytes);
+}
+
+static std::vector<uint8_t> idcodeXsvf(uint8_t lowByte) {
+    std::vector<uint8_t> x;
+    append(x, { 0x12, 0x00 });                          // XSTATE reset
+    append(x, { 0x12, 0x01 });                          // XSTATE idle
+    append(x, { 0x07, 0x02 });                          // XREPEAT 2
+    append(x, { 0x02, 0x04, 0x01 });                    // XSIR 4 bits, IDCODE
+    append(x, { 0x08, 0x00, 0x00, 0x00, 0x20 });        // XSDRSIZE 32
+    append(x, { 0x01, 0xFF, 0xFF, 0xFF, 0xFF });        // XTDOMASK
+    append(x, { 0x04, 0x00, 0x00, 0x00, 0x32 });        // XRUNTEST 50 us
+    append(x, { 0x16, 'I', 'D', 0x00 });                // XCOMMENT
+    append(x, { 0x09, 0x00, 0x00, 0x00, 0x00,           // XSDRTDO
+                0x4B, 0xA0, 0x04, lowByte });
+    append(x, { 0x00 });                                // XCOMPLETE
+    return x;
+}
+
+void test_xsvf_reads_idcode() {
+    for (size_t chunk : { 0, 1, 5 }) {
+        Bench bench;
+        std::string error;
+        TEST_ASSERT_TRUE_MESSAGE(playXsvf(bench, idcodeXsvf(0x77), &error, chunk), error.c_str());
+        TEST_ASSERT_EQUAL_UINT64(32, bench.sim.drShiftClocks);
+        TEST_ASSERT_TRUE(bench.sim.idleClocks >= 50);
+    }
+}
+
+void test_xsvf_retries_then_fails() {
+    Bench bench;
+    std::string error;
+    TEST_ASSERT_FALSE(playXsvf(bench, idcodeXsvf(0x76), &error));
+    TEST_ASSERT_TRUE(error.find("TDO mismatch after 2 retries") != std::string::npos);
+    TEST_ASSERT_EQUAL_UINT64(3 * 32, bench.sim.drShiftClocks);
+}
+
+void test_xsvf_split_dr_shift() {
+    // XSDRB/XSDRC/XSDRE keep Shift-DR across instructions, the 8-bit
+    // register ends up with the last byte shifted
+    Bench bench;
+    std::vector<uint8_t> x;
+    append(x, { 0x02, 0x04, 0x02 });                    // XSIR USER
+    append(x, { 0x08, 0x00, 0x00, 0x00, 0x08 });        // XSDRSIZE 8
+    append(x, { 0x0C, 0x11 });                          // XSDRB
+    append(x, { 0x0D, 0x22 });                          // XSDRC
+    append(x, { 0x0E, 0x5A });                          // XSDRE
+    append(x, { 0x01, 0xFF });                          // XTDOMASK
+    append(x, { 0x09, 0x00, 0x5A });                    // XSDRTDO reads it back
+    append(x, { 0x00 });
+    std::string error;
+    TEST_ASSERT_TRUE_MESSAGE(playXsvf(bench, x, &error), error.c_str());
+    TEST_ASSERT_EQUAL_HEX8(0x00, bench.sim.devices[0].user);
+    TEST_ASSERT_EQUAL_UINT64(4 * 8, bench.sim.drShiftClocks);
+}
+
+void test_xsvf_errors() {
+    Bench bench;
+    std::string error;
+    TEST_ASSERT_FALSE(playXsvf(bench, { 0x30 }, &error));
+    TEST_ASSERT_TRUE(error.find("Unknown instruction 0x30") != std::string::npos);
+    TEST_ASSERT_FALSE(playXsvf(bench, { 0x08, 0x00, 0x00 }, &error));
+    TEST_ASSERT_TRUE(error.find("File ends inside an instruction") != std::string::npos);
+    TEST_ASSERT_FALSE(playXsvf(bench, { 0x12, 0x20 }, &error));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_svf_reads_idcode);
+    RUN_TEST(test_svf_any_chunk_size);
+    RUN_TEST(test_svf_reports_tdo_mismatch);
+    RUN_TEST(test_svf_writes_and_reads_back_register);
+    RUN_TEST(test_svf_header_and_trailer_reach_other_devices);
+    RUN_TEST(test_svf_runtest_clocks_and_time);
+    RUN_TEST(test_svf_frequency);
+    RUN_TEST(test_svf_trst_resets_the_chain);
+    RUN_TEST(test_svf_errors);
+    RUN_TEST(test_xsvf_reads_idcode);
+    RUN_TEST(test_xsvf_retries_then_fails);
+    RUN_TEST(test_xsvf_split_dr_shift);
+    RUN_TEST(test_xsvf_errors);
+    return UNITY_END();
+}
@@ -0,0 +1,203 @@
+#include <unity.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Services/NmapScanEngine.h"
+
+// Local listeners on the loopback, the engine scans them like remote hosts
+
+static in_addr loopback() {
+    in_addr addr{};
+    inet_pton(AF_INET, "127.0.0.1", &addr);
+    return addr;
+}
+
+static uint16_t boundPort(int fd) {
+    sockaddr_in sa{};
+    socklen_t len = sizeof(sa);
+    getsockname(fd, (sockaddr*)&sa, &len);
+    return ntohs(sa.sin_port);
+}
+
+// Socket on an ephemeral port of 127.0.0.1
+static int openSocket(int type) {
+    int fd = ::socket(AF_INET, type, 0);
+    TEST_ASSERT_TRUE(fd >= 0);
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_addr = loopback();
+    sa.sin_port = 0;
+    TEST_ASSERT_EQUAL_INT(0, ::bind(fd, (sockaddr*)&sa, sizeof(sa)));
+    return fd;
+}
+
+static int tcpListener() {
+    int fd = openSocket(SOCK_STREAM);
+    TEST_ASSERT_EQUAL_INT(0, ::listen(fd, 64));
+    return fd;
+}
+
+// A port nobody listens on, bound then released
+static uint16_t closedPort(int type) {
+    int fd = openSocket(type);
+    uint16_t port = boundPort(fd);
+    ::close(fd);
+    return port;
+}
+
+static const NmapScanEngine::Result* find(const std::vector<NmapScanEngine::Result>& results,
+                                          size_t host, uint16_t port) {
+    for (const auto& r : results) {
+        if (r.host == host && r.port == port) return &r;
+    }
+    return nullptr;
+}
+
+static NmapScanEngine::Config fastConfig() {
+    NmapScanEngine::Config config;
+    config.window = 4;
+    config.perHostWindow = 4;
+    config.initialTimeoutMs = 200;
+    config.minTimeoutMs = 50;
+    config.maxTimeoutMs = 200;
+    config.maxRetries = 1;
+    return config;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_tcp_open_and_closed() {
+    int open1 = tcpListener();
+    int open2 = tcpListener();
+    uint16_t closed = closedPort(SOCK_STREAM);
+
+    NmapScanEngine engine(fastConfig());
+    std::vector<uint16_t> ports = { boundPort(open1), closed, boundPort(open2) };
+    auto results = engine.scan({ loopback() }, ports, Layer4Protocol::TCP);
+
+    TEST_ASSERT_EQUAL_UINT32(3, results.size());
+    TEST_ASSERT_EQUAL_INT(TCP_OPEN, find(results, 0, ports[0])->state);
+    TEST_ASSERT_EQUAL_INT(TCP_CLOSED, find(results, 0, ports[1])->state);
+    TEST_ASSERT_EQUAL_INT(TCP_OPEN, find(results, 0, ports[2])->state);
+
+    ::close(open1);
+    ::close(open2);
+}
+
+void test_tcp_every_pair_reported_once() {
+    // More probes than the window, the same listeners seen as two hosts
+    std::vector<int> listeners;
+    std::vector<uint16_t> ports;
+    for (int i = 0; i < 3; ++i) {
+        listeners.push_back(tcpListener());
+        ports.push_back(boundPort(listeners.back()));
+    }
+    for (int i = 0; i < 20; ++i) ports.push_back(closedPort(SOCK_STREAM));
+
+    NmapScanEngine engine(fastConfig());
+    std::vector<in_addr> hosts = { loopback(), loopback() };
+    auto results = engine.scan(hosts, ports, Layer4Protocol::TCP);
+
+    TEST_ASSERT_EQUAL_UINT32(hosts.size() * ports.size(), results.size());
+    for (size_t h = 0; h < hosts.size(); ++h) {
+        for (size_t p = 0; p < ports.size(); ++p) {
+            size_t seen = std::count_if(results.begin(), results.end(), [&](const NmapScanEngine::Result& r) {
+                return r.host == h && r.port == ports[p];
+            });
+            TEST_ASSERT_EQUAL_UINT32(1, seen);
+        }
+    }
+
+    for (size_t h = 0; h < hosts.size(); ++h) {
+        for (size_t p = 0; p < ports.size(); ++p) {
+            TEST_ASSERT_EQUAL_INT(p < 3 ? TCP_OPEN : TCP_CLOSED, find(results, h, ports[p])->state);
+        }
+    }
+
+    for (int fd : listeners) ::close(fd);
+}
+
+void test_udp_open_closed_and_silent() {
+    // Echo responder, answers every probe until told to stop
+    int echo = openSocket(SOCK_DGRAM);
+    timeval tv{ 0, 20000 };
+    setsockopt(echo, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::atomic<bool> running{ true };
+    std::thread responder([&]() {
+        char buf[64];
+        while (running) {
+            sockaddr_in from{};
+            socklen_t len = sizeof(from);
+            ssize_t n = ::recvfrom(echo, buf, sizeof(buf), 0, (sockaddr*)&from, &len);
+            if (n > 0) ::sendto(echo, buf, n, 0, (sockaddr*)&from, len);
+        }
+    });
+
+    // Bound but never answers, like a filtered port
+    int silent = openSocket(SOCK_DGRAM);
+    uint16_t closed = closedPort(SOCK_DGRAM);
+
+    NmapScanEngine engine(fastConfig());
+    std::vector<uint16_t> ports = { boundPort(echo), closed, boundPort(silent) };
+    auto results = engine.scan({ loopback() }, ports, Layer4Protocol::UDP);
+
+    running = false;
+    responder.join();
+    ::close(echo);
+    ::close(silent);
+
+    TEST_ASSERT_EQUAL_UINT32(3, results.size());
+    TEST_ASSERT_EQUAL_INT(UDP_OPEN, find(results, 0, ports[0])->state);
+    TEST_ASSERT_EQUAL_INT(UDP_CLOSED, find(results, 0, ports[1])->state);
+    TEST_ASSERT_EQUAL_INT(UDP_OPEN_FILTERED, find(results, 0, ports[2])->state);
+    TEST_ASSERT_TRUE(find(results, 0, ports[0])->rttUs > 0);
+}
+
+void test_timeout_follows_rtt_within_bounds() {
+    int listener = tcpListener();
+    std::vector<uint16_t> ports(10, boundPort(listener));
+
+    NmapScanEngine::Config config = fastConfig();
+    NmapScanEngine engine(config);
+    engine.scan({ loopback() }, ports, Layer4Protocol::TCP);
+
+    // Loopback answers fast, the timeout drops to the floor
+    TEST_ASSERT_TRUE(engine.getTimeoutMs(0) >= config.minTimeoutMs);
+    TEST_ASSERT_TRUE(engine.getTimeoutMs(0) <= config.maxTimeoutMs);
+    TEST_ASSERT_TRUE(engine.getSmoothedRttUs(0) < config.maxTimeoutMs * 1000);
+
+    // Unknown host keeps the initial timeout
+    TEST_ASSERT_EQUAL_UINT32(config.initialTimeoutMs, engine.getTimeoutMs(5));
+
+    ::close(listener);
+}
+
+void test_stop_request_ends_scan() {
+    std::vector<uint16_t> ports;
+    for (int i = 0; i < 50; ++i) ports.push_back(closedPort(SOCK_STREAM));
+
+    NmapScanEngine engine(fastConfig());
+    auto results = engine.scan({ loopback() }, ports, Layer4Protocol::TCP, []() { return true; });
+    TEST_ASSERT_EQUAL_UINT32(0, results.size());
+
+    size_t polls = 0;
+    results = engine.scan({ loopback() }, ports, Layer4Protocol::TCP, [&polls]() { return ++polls > 2; });
+    TEST_ASSERT_TRUE(results.size() < ports.size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_tcp_open_and_closed);
+    RUN_TEST(test_tcp_every_pair_reported_once);
+    RUN_TEST(test_udp_open_closed_and_silent);
+    RUN_TEST(test_timeout_follows_rtt_within_bounds);
+    RUN_TEST(test_stop_request_ends_scan);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Analyzers/PatternMatcher.h"
+
+struct TestPattern {
+    uint16_t id;
+    std::string text;
+    bool caseSensitive;
+};
+
+static bool operator<(const PatternMatcher::Match& a, const PatternMatcher::Match& b) {
+    return a.position != b.position ? a.position < b.position : a.id < b.id;
+}
+
+static PatternMatcher buildMatcher(const std::vector<TestPattern>& patterns) {
+    PatternMatcher matcher;
+    for (const auto& p : patterns) {
+        matcher.addPattern(p.id, (const uint8_t*)p.text.data(), p.text.size(), p.caseSensitive);
+    }
+    matcher.build();
+    return matcher;
+}
+
+static std::vector<PatternMatcher::Match> scanAll(const PatternMatcher& matcher, const std::string& text) {
+    std::vector<PatternMatcher::Match> matches;
+    matcher.scan((const uint8_t*)text.data(), text.size(), [&](const PatternMatcher::Match& m) {
+        matches.push_back(m);
+        return true;
+    });
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+// Reference, every pattern compared at every offset
+static std::vector<PatternMatcher::Match> scanNaive(const std::vector<TestPattern>& patterns, const std::string& text) {
+    std::vector<PatternMatcher::Match> matches;
+    for (const auto& p : patterns) {
+        if (p.text.empty() || p.text.size() > text.size()) continue;
+        for (size_t pos = 0; pos + p.text.size() <= text.size(); ++pos) {
+            bool hit = true;
+            for (size_t k = 0; k < p.text.size() && hit; ++k) {
+                uint8_t a = text[pos + k], b = p.text[k];
+                if (!p.caseSensitive) {
+                    a = (a >= 'A' && a <= 'Z') ? a + 32 : a;
+                    b = (b >= 'A' && b <= 'Z') ? b + 32 : b;
+                }
+                hit = a == b;
+            }
+            if (hit) matches.push_back({p.id, (uint32_t)pos});
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+static void assertSameMatches(const std::vector<PatternMatcher::Match>& expected,
+                              const std::vector<PatternMatcher::Match>& actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        TEST_ASSERT_EQUAL_UINT16(expected[i].id, actual[i].id);
+        TEST_ASSERT_EQUAL_UINT32(expected[i].position, actual[i].position);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_overlapping_patterns() {
+    // Classic Aho-Corasick set, suffixes reached through failure links
+    std::vector<TestPattern> patterns = {
+        {1, "he", false}, {2, "she", false}, {3, "his", false}, {4, "hers", false},
+    };
+    PatternMatcher matcher = buildMatcher(patterns);
+    TEST_ASSERT_TRUE(matcher.isBuilt());
+
+    auto matches = scanAll(matcher, "ushers");
+    std::vector<PatternMatcher::Match> expected = { {2, 1}, {1, 2}, {4, 2} };
+    std::sort(expected.begin(), expected.end());
+    assertSameMatches(expected, matches);
+}
+
+void test_nested_and_repeated_patterns() {
+    std::vector<TestPattern> patterns = {
+        {1, "a", false}, {2, "aa", false}, {3, "aaa", false}, {4, "ab", false},
+    };
+    PatternMatcher matcher = buildMatcher(patterns);
+    const std::string text = "aaaab";
+    assertSameMatches(scanNaive(patterns, text), scanAll(matcher, text));
+}
+
+void test_case_sensitivity() {
+    std::vector<TestPattern> patterns = {
+        {1, "password", false}, {2, "PK", true}, {3, "pk", true},
+    };
+    PatternMatcher matcher = buildMatcher(patterns);
+
+    auto matches = scanAll(matcher, "PassWord=x PK pK pk");
+    std::vector<PatternMatcher::Match> expected = { {1, 0}, {2, 11}, {3, 17} };
+    assertSameMatches(expected, matches);
+}
+
+void test_binary_patterns() {
+    const uint8_t elf[] = {0x7F, 'E', 'L', 'F'};
+    const uint8_t zeros[] = {0x00, 0x00, 0xFF};
+    PatternMatcher matcher;
+    matcher.addPattern(7, elf, sizeof(elf), true);
+    matcher.addPattern(8, zeros, sizeof(zeros), true);
+    matcher.build();
+
+    const uint8_t buf[] = {0x00, 0x00, 0x00, 0xFF, 0x7F, 'E', 'L', 'F', 0x7F, 'e', 'l', 'f'};
+    std::vector<PatternMatcher::Match> matches;
+    matcher.scan(buf, sizeof(buf), [&](const PatternMatcher::Match& m) {
+        matches.push_back(m);
+        return true;
+    });
+    std::vector<PatternMatcher::Match> expected = { {8, 1}, {7, 4} };
+    assertSameMatches(expected, matches);
+}
+
+void test_callback_stops_scan() {
+    PatternMatcher matcher = buildMatcher({ {1, "ab", false} });
+    const std::string text = "ab ab ab";
+    int calls = 0;
+    matcher.scan((const uint8_t*)text.data(), text.size(), [&](const PatternMatcher::Match&) {
+        return ++calls < 2;
+    });
+    TEST_ASSERT_EQUAL_INT(2, calls);
+}
+
+void test_random_text_matches_naive() {
+    // Small alphabet so patterns overlap a lot
+    std::vector<TestPattern> patterns = {
+        {1, "abc", false}, {2, "bca", true}, {3, "CAB", false}, {4, "aBa", true},
+        {5, "b", false}, {6, "cc", false}, {7, "abcab", false}, {8, "ABC", true},
+    };
+    PatternMatcher matcher = buildMatcher(patterns);
+
+    uint32_t seed = 12345;
+    for (int round = 0; round < 50; ++round) {
+        std::string text;
+        for (int i = 0; i < 300; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            text += "abcABC"[(seed >> 16) % 6];
+        }
+        assertSameMatches(scanNaive(patterns, text), scanAll(matcher, text));
+    }
+}
+
+void test_matches_across_chunk_boundaries() {
+    // The analyzer scans each block with the tail of the previous one in front,
+    // a match is kept when it ends inside the new block
+    std::vector<TestPattern> patterns = {
+        {1, "secret", false}, {2, "private key", false}, {3, "key", false}, {4, "\x7F" "ELF", true},
+    };
+    PatternMatcher matcher = buildMatcher(patterns);
+
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "..secret.PRIVATE KEY.x\x7F" "ELF";
+        text.append(i % 7, '-');
+    }
+    const auto expected = scanAll(matcher, text);
+    const size_t overlap = 10; // longest pattern - 1
+
+    for (size_t chunk = 1; chunk <= 64; ++chunk) {
+        std::vector<PatternMatcher::Match> matches;
+        for (size_t start = 0; start < text.size(); start += chunk) {
+            size_t from = start >= overlap ? start - overlap : 0;
+            size_t end = std::min(text.size(), start + chunk);
+            matcher.scan((const uint8_t*)text.data() + from, end - from, [&](const PatternMatcher::Match& m) {
+                size_t len = patterns[m.id - 1].text.size();
+                if (from + m.position + len > start) matches.push_back({m.id, (uint32_t)(from + m.position)});
+                return true;
+            });
+        }
+        std::sort(matches.begin(), matches.end());
+        assertSameMatches(expected, matches);
+    }
+}
+
+void test_throughput() {
+    // About the size of the analyzer tables
+    PatternMatcher matcher;
+    const char* words[] = {
+        "password", "passwd", "secret", "token", "apikey", "api_key", "private key",
+        "begin rsa", "ssh-rsa", "aws_access", "bearer", "authorization", "cookie",
+        "session", "wpa_psk", "ssid", "admin", "root:", "credential", "login",
+    };
+    for (uint16_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+        matcher.addPattern(i, (const uint8_t*)words[i], strlen(words[i]), false);
+    }
+    matcher.build();
+
+    std::vector<uint8_t> buf(4 * 1024 * 1024);
+    uint32_t seed = 1;
+    for (auto& b : buf) {
+        seed = seed * 1103515245u + 12345u;
+        b = (uint8_t)(seed >> 16);
+    }
+
+    size_t hits = 0;
+    auto begin = std::chrono::steady_clock::now();
+    matcher.scan(buf.data(), buf.size(), [&](const PatternMatcher::Match&) { ++hits; return true; });
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    // One pass whatever the pattern count, a per pattern scan was far below this
+    double mbPerS = us > 0 ? (double)buf.size() / us : 1e9;
+    char line[64];
+    snprintf(line, sizeof(line), "scan %.1f MB/s", mbPerS);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(mbPerS >= 5.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_overlapping_patterns);
+    RUN_TEST(test_nested_and_repeated_patterns);
+    RUN_TEST(test_case_sensitivity);
+    RUN_TEST(test_binary_patterns);
+    RUN_TEST(test_callback_stops_scan);
+    RUN_TEST(test_random_text_matches_naive);
+    RUN_TEST(test_matches_across_chunk_boundaries);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
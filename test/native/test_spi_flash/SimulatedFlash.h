@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// SPI NOR flash seen one byte at a time between CS edges.
+// Page Program wraps inside its 256 byte page and only clears bits, program
+// and erase need Write Enable and keep WIP set for a few status reads.
+class SimulatedFlash {
+public:
+    static constexpr uint32_t PAGE_SIZE = 256;
+    static constexpr uint32_t SECTOR_SIZE = 4096;
+
+    std::vector<uint8_t> memory;
+    uint32_t programs = 0;
+    uint32_t wrappedPrograms = 0;       // page programs that ran past the page end
+    uint32_t erases = 0;
+    uint32_t commandsWhileBusy = 0;     // anything but Read Status during WIP
+    uint32_t busyStatusReads = 2;       // WIP stays set this many status bytes
+
+    explicit SimulatedFlash(uint32_t size) : memory(size, 0xFF) {}
+
+    void select(bool low) {
+        if (low) {
+            selected = true;
+            count = 0;
+            return;
+        }
+        if (selected) finish();
+        selected = false;
+    }
+
+    uint8_t exchange(uint8_t in) {
+        if (!selected) return 0xFF;
+        size_t index = count++;
+        if (index == 0) {
+            opcode = in;
+            address = 0;
+            latch.clear();
+            if (busy && opcode != 0x05) commandsWhileBusy++;
+            if (opcode == 0x06) writeEnabled = true;
+            return 0xFF;
+        }
+
+        switch (opcode) {
+            case 0x9F: { // JEDEC ID, Winbond W25Q16
+                static const uint8_t id[3] = { 0xEF, 0x40, 0x15 };
+                return index <= 3 ? id[index - 1] : 0xFF;
+            }
+            case 0x05: { // Read Status
+                if (!busy) return 0x00;
+                if (--statusLeft == 0) busy = false;
+                return 0x01 | (writeEnabled ? 0x02 : 0x00);
+            }
+            case 0x03: // Read Data
+                if (index <= 3) { address = (address << 8) | in; return 0xFF; }
+                return readNext();
+            case 0x0B: // Fast Read, one dummy byte
+                if (index <= 3) { address = (address << 8) | in; return 0xFF; }
+                if (index == 4) return 0xFF;
+                return readNext();
+            case 0x02: // Page Program
+                if (index <= 3) { address = (address << 8) | in; return 0xFF; }
+                latch.push_back(in);
+                return 0xFF;
+            case 0x20: // Sector Erase
+                if (index <= 3) address = (address << 8) | in;
+                return 0xFF;
+            default:
+                return 0xFF;
+        }
+    }
+
+private:
+    bool selected = false;
+    bool writeEnabled = false;
+    bool busy = false;
+    uint32_t statusLeft = 0;
+    uint8_t opcode = 0;
+    uint32_t address = 0;
+    size_t count = 0;
+    std::vector<uint8_t> latch;
+
+    uint8_t readNext() {
+        uint8_t value = memory[address % memory.size()];
+        address = (address + 1) % memory.size();
+        return value;
+    }
+
+    void startCycle() {
+        writeEnabled = false;
+        busy = true;
+        statusLeft = busyStatusReads;
+    }
+
+    // Program and erase run when CS goes high
+    void finish() {
+        if (opcode == 0x02 && count > 4 && writeEnabled) {
+            uint32_t pageStart = (address % memory.size()) & ~(PAGE_SIZE - 1);
+            uint32_t offset = address % PAGE_SIZE;
+            if (offset + latch.size() > PAGE_SIZE) wrappedPrograms++;
+            for (size_t i = 0; i < latch.size(); ++i) {
+                memory[pageStart + (offset + i) % PAGE_SIZE] &= latch[i];
+            }
+            programs++;
+            startCycle();
+        } else if (opcode == 0x20 && count == 4 && writeEnabled) {
+            uint32_t start = (address % memory.size()) & ~(SECTOR_SIZE - 1);
+            std::fill(memory.begin() + start, memory.begin() + start + SECTOR_SIZE, 0xFF);
+            erases++;
+            startCycle();
+        }
+    }
+};
@@ -0,0 +1,191 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Services/SpiService.h"
+#include "SimulatedFlash.h"
+
+static const uint8_t CS_PIN = 10;
+static const size_t BULK_CHUNK = 4096;    // SpiService::BULK_CHUNK_SIZE
+
+// Service, fake SPI driver and simulated chip wired together
+struct Bench {
+    SimulatedFlash flash;
+    SpiService spi;
+
+    explicit Bench(uint32_t size = 1u << 20) : flash(size) {
+        SPI = SPIClass();
+        SPI.device = [this](uint8_t in) { return flash.exchange(in); };
+        arduinoShim().onDigitalWrite = [this](uint8_t pin, uint8_t level) {
+            if (pin == CS_PIN) flash.select(level == LOW);
+        };
+        spi.configure(11, 13, 12, CS_PIN, 8000000);
+        for (size_t i = 0; i < flash.memory.size(); ++i) flash.memory[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+
+    ~Bench() {
+        SPI.device = nullptr;
+        arduinoShim().onDigitalWrite = nullptr;
+    }
+};
+
+struct CollectSink : public IResultSink {
+    std::vector<uint8_t> data;
+    std::vector<size_t> chunks;
+
+    void onData(const uint8_t* bytes, size_t length) override {
+        data.insert(data.end(), bytes, bytes + length);
+        chunks.push_back(length);
+    }
+    void onEvent(ResultEventEnum) override {}
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_read_is_chunked_in_bulk_calls() {
+    Bench bench;
+    const uint32_t address = 0x1234;
+    const size_t length = 2 * BULK_CHUNK + 1000;
+    std::vector<uint8_t> out(length);
+
+    bench.spi.readFlashData(address, out.data(), out.size());
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bench.flash.memory.data() + address, out.data(), length);
+    TEST_ASSERT_EQUAL_UINT32(0, SPI.byteCalls);
+
+    // Command and address, then the data in driver sized chunks
+    std::vector<size_t> expected = { 4, BULK_CHUNK, BULK_CHUNK, 1000 };
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), SPI.bulkCalls.size());
+    for (size_t i = 0; i < expected.size(); ++i) TEST_ASSERT_EQUAL_UINT32(expected[i], SPI.bulkCalls[i]);
+}
+
+void test_fast_read_sends_dummy_byte() {
+    Bench bench;
+    std::vector<uint8_t> out(300);
+
+    bench.spi.setFlashReadMode(FlashReadModeEnum::Fast, 40000000);
+    bench.spi.readFlashData(0xFFE00, out.data(), out.size());
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bench.flash.memory.data() + 0xFFE00, out.data(), out.size());
+    TEST_ASSERT_EQUAL_UINT32(5, SPI.bulkCalls[0]);
+    TEST_ASSERT_EQUAL_UINT32(40000000, SPI.frequency);
+}
+
+void test_page_write_splits_at_page_boundaries() {
+    Bench bench;
+    std::fill(bench.flash.memory.begin(), bench.flash.memory.end(), 0xFF);
+
+    // 0x1F0..0x1FF, 0x200..0x2FF, 0x300..0x3FF, 0x400..0x41F
+    const uint32_t address = 0x1F0;
+    std::vector<uint8_t> data(16 + 256 + 256 + 32);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (uint8_t)(i ^ 0x5A);
+
+    bench.spi.writeFlashPage(address, data, 8000000);
+
+    TEST_ASSERT_EQUAL_UINT32(4, bench.flash.programs);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.flash.wrappedPrograms);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.flash.commandsWhileBusy);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data.data(), bench.flash.memory.data() + address, data.size());
+    TEST_ASSERT_EQUAL_HEX8(0xFF, bench.flash.memory[address - 1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, bench.flash.memory[address + data.size()]);
+}
+
+void test_page_write_aligned() {
+    Bench bench;
+    std::fill(bench.flash.memory.begin(), bench.flash.memory.end(), 0xFF);
+
+    std::vector<uint8_t> data(1024, 0x00);
+    bench.spi.writeFlashPage(0x8000, data, 8000000);
+
+    TEST_ASSERT_EQUAL_UINT32(4, bench.flash.programs);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.flash.wrappedPrograms);
+
+    // Header then one bulk call per page
+    size_t pageCalls = 0;
+    for (size_t n : SPI.bulkCalls) pageCalls += (n == 256);
+    TEST_ASSERT_EQUAL_UINT32(4, pageCalls);
+}
+
+void test_patch_rewrites_one_sector() {
+    Bench bench;
+    const std::vector<uint8_t> before(bench.flash.memory.begin() + 0x3000, bench.flash.memory.begin() + 0x4000);
+    const std::vector<uint8_t> patch = { 0xDE, 0xAD, 0xBE, 0xEF };
+
+    bench.spi.writeFlashPatch(0x30FE, patch, 8000000);
+
+    TEST_ASSERT_EQUAL_UINT32(1, bench.flash.erases);
+    TEST_ASSERT_EQUAL_UINT32(16, bench.flash.programs);
+    TEST_ASSERT_EQUAL_UINT32(0, bench.flash.commandsWhileBusy);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(patch.data(), bench.flash.memory.data() + 0x30FE, patch.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(before.data(), bench.flash.memory.data() + 0x3000, 0xFE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(before.data() + 0x102, bench.flash.memory.data() + 0x3102, 0x1000 - 0x102);
+}
+
+void test_bytecode_read_streams_to_sink() {
+    Bench bench;
+    std::vector<ByteCode> codes = {
+        ByteCode(ByteCodeEnum::Start),
+        ByteCode(ByteCodeEnum::Write, 0x03),
+        ByteCode(ByteCodeEnum::Write, 0x00),
+        ByteCode(ByteCodeEnum::Write, 0x10),
+        ByteCode(ByteCodeEnum::Write, 0x00),
+        ByteCode(ByteCodeEnum::Read, 0, 8, 600),
+        ByteCode(ByteCodeEnum::Stop),
+    };
+    CollectSink sink;
+    bench.spi.executeByteCode(codes, sink);
+
+    TEST_ASSERT_EQUAL_UINT32(600, sink.data.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bench.flash.memory.data() + 0x1000, sink.data.data(), 600);
+    TEST_ASSERT_EQUAL_UINT32(3, sink.chunks.size());
+    TEST_ASSERT_EQUAL_UINT32(0, SPI.byteCalls);
+
+    // The four writes merged into one bulk call
+    TEST_ASSERT_EQUAL_UINT32(4, SPI.bulkCalls[0]);
+}
+
+void test_jedec_id() {
+    Bench bench;
+    TEST_ASSERT_EQUAL_STRING("EF 40 15", bench.spi.readFlashID().c_str());
+}
+
+void test_read_throughput_per_length() {
+    // Host side cost per read length, the chip answers instantly so only
+    // the per call overhead of the service and the driver shows up
+    Bench bench(4u << 20);
+    const size_t total = 4u << 20;
+    std::vector<uint8_t> out(total);
+
+    for (size_t length : { (size_t)64, (size_t)256, BULK_CHUNK, (size_t)65536 }) {
+        SPI.bulkCalls.clear();
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t at = 0; at < total; at += length) {
+            bench.spi.readFlashData(at, out.data() + at, length);
+        }
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+        char line[96];
+        snprintf(line, sizeof(line), "read %6u bytes per call: %.1f MB/s, %u driver calls",
+                 (unsigned)length, us > 0 ? (double)total / us : 0.0, (unsigned)SPI.bulkCalls.size());
+        TEST_MESSAGE(line);
+
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(bench.flash.memory.data(), out.data(), total);
+        size_t reads = total / length;
+        size_t chunksPerRead = (length + BULK_CHUNK - 1) / BULK_CHUNK;
+        TEST_ASSERT_EQUAL_UINT32(reads * (1 + chunksPerRead), SPI.bulkCalls.size());
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_is_chunked_in_bulk_calls);
+    RUN_TEST(test_fast_read_sends_dummy_byte);
+    RUN_TEST(test_page_write_splits_at_page_boundaries);
+    RUN_TEST(test_page_write_aligned);
+    RUN_TEST(test_patch_rewrites_one_sector);
+    RUN_TEST(test_bytecode_read_streams_to_sink);
+    RUN_TEST(test_jedec_id);
+    RUN_TEST(test_read_throughput_per_length);
+    return UNITY_END();
+}
@@ -11,6 +11,7 @@ let bridgeMode = false;
 let fsTotalBytes = 0;
 let fsUsedBytes  = 0;
 let isUploading  = false;
+let binaryDecoder = new TextDecoder("utf-8"); // invalid bytes shown as U+FFFD
 const filePanel = document.getElementById("file-panel");
 const filePanelOverlay = document.getElementById("file-panel-overlay");
 
@@ -20,19 +21,23 @@ const filePanelOverlay = document.getElementById("file-panel-overlay");
 
 function connectSocket() {
   socket = new WebSocket("ws://" + window.location.host + "/ws");
+  socket.binaryType = "arraybuffer"; // raw bytes that are not valid UTF-8
 
   socket.onopen = function () {
     hideWsLostPopup();
     bridgeMode = false;
     pendingEchoLines = 0;
+    binaryDecoder = new TextDecoder("utf-8"); // no half character from the old socket
     console.log("[WebSocket] Connected");
   };
 
   socket.onmessage = function (event) {
     const output = document.getElementById("output");
-    const lines = event.data.split("\n");
+    // Binary frames may end in the middle of a character, the decoder keeps it for the next one
+    const data = typeof event.data === "string" ? event.data : binaryDecoder.decode(event.data, { stream: true });
+    const lines = data.split("\n");
 
-    if (event.data.includes("Bridge: Stopped by user.")) {
+    if (data.includes("Bridge: Stopped by user.")) {
       bridgeMode = false;
       console.log("[WebSocket] Bridge mode exited.");
     }
@@ -47,7 +52,7 @@ function connectSocket() {
 
     output.value += lines.join("\n");
     output.scrollTop = output.scrollHeight;
-    console.log("[WebSocket] Recv:", event.data);
+    console.log("[WebSocket] Recv:", data);
   };
 
   socket.onerror = function (error) {